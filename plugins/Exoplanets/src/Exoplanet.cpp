@@ -157,6 +157,7 @@ Exoplanet::Exoplanet(const QVariantMap& map)
 				periodList.append(0);
 		}
 	}
+	StelUtils::spheToRect(RA, DE, XYZ);
 
 	initialized = true;
 }
@@ -546,7 +547,7 @@ void Exoplanet::update(double deltaTime)
 	labelsFader.update((int)(deltaTime*1000));
 }
 
-void Exoplanet::draw(StelCore* core, StelPainter *painter)
+void Exoplanet::draw(StelCore* core, StelPainter *painter, StelPointCatalog::MarkerBatch& markers)
 {
 	bool visible;
 	StelSkyDrawer* sd = core->getSkyDrawer();
@@ -556,13 +557,8 @@ void Exoplanet::draw(StelCore* core, StelPainter *painter)
 	if (hasHabitableExoplanets)
 		color = habitableExoplanetMarkerColor;
 
-	StelUtils::spheToRect(RA, DE, XYZ);
 	double mag = getVMagnitudeWithExtinction(core);
 
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_ONE, GL_ONE);
-	painter->setColor(color[0], color[1], color[2], 1);
-
 	if (timelineMode)
 	{
 		visible = isDiscovered(core);
@@ -586,14 +582,14 @@ void Exoplanet::draw(StelCore* core, StelPainter *painter)
 
 	if (mag <= mlimit)
 	{		
-		Exoplanet::markerTexture->bind();
 		float size = getAngularSize(NULL)*M_PI/180.*painter->getProjector()->getPixelPerRadAtCenter();
 		float shift = 5.f + size/1.6f;
 
-		painter->drawSprite2dMode(XYZ, distributionMode ? 4.f : 5.f);
+		markers.add(XYZ, distributionMode ? 4.f : 5.f, color);
 
 		if (labelsFader.getInterstate()<=0.f && !distributionMode && (mag+1.f)<mlimit && smgr->getFlagLabels() && showDesignations)
 		{
+			painter->setColor(color[0], color[1], color[2], 1);
 			painter->drawText(XYZ, getNameI18n(), 0, shift, shift, false);
 		}
 	}
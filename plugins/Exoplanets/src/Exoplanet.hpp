@@ -29,6 +29,7 @@
 #include "StelObject.hpp"
 #include "StelTextureTypes.hpp"
 #include "StelFader.hpp"
+#include "StelPointCatalog.hpp"
 
 //! @ingroup exoplanets
 typedef struct
@@ -153,7 +154,8 @@ private:
 	static bool habitableMode;
 	static bool showDesignations;
 
-	void draw(StelCore* core, StelPainter *painter);
+	//! Draw the label of the planetary system and add its marker to markers.
+	void draw(StelCore* core, StelPainter *painter, StelPointCatalog::MarkerBatch& markers);
 
 	int EPCount;
 	int PHEPCount;
@@ -27,7 +27,8 @@
 #include "StelModuleMgr.hpp"
 #include "StelObjectMgr.hpp"
 #include "StelTextureMgr.hpp"
-#include "StelJsonParser.hpp"
+#include "StelSkyDrawer.hpp"
+#include "StelJsonCache.hpp"
 #include "StelFileMgr.hpp"
 #include "StelUtils.hpp"
 #include "StelTranslator.hpp"
@@ -117,6 +118,7 @@ Exoplanets::~Exoplanets()
 void Exoplanets::deinit()
 {
 	ep.clear();
+	catalog.clear();
 	Exoplanet::markerTexture.clear();
 	texPointer.clear();
 }
@@ -224,12 +226,12 @@ void Exoplanets::draw(StelCore* core)
 	StelProjectorP prj = core->getProjection(StelCore::FrameJ2000);
 	StelPainter painter(prj);
 	painter.setFont(font);
-	
-	foreach (const ExoplanetP& eps, ep)
-	{
-		if (eps && eps->initialized)
-			eps->draw(core, &painter);
-	}
+	StelPointCatalog::MarkerBatch markers(&painter);
+
+	// All the markers are drawn in one batch
+	foreach (int i, catalog.findVisible(core, prj, Exoplanet::distributionMode ? 99.f : core->getSkyDrawer()->getLimitMagnitude()))
+		ep.at(i)->draw(core, &painter, markers);
+	markers.draw(Exoplanet::markerTexture);
 
 	if (GETSTELMODULE(StelObjectMgr)->getFlagSelectedObjectPointer())
 		drawPointer(core, painter);
@@ -259,30 +261,15 @@ void Exoplanets::drawPointer(StelCore* core, StelPainter& painter)
 	}
 }
 
-QList<StelObjectP> Exoplanets::searchAround(const Vec3d& av, double limitFov, const StelCore*) const
+QList<StelObjectP> Exoplanets::searchAround(const Vec3d& av, double limitFov, const StelCore* core) const
 {
 	QList<StelObjectP> result;
 
 	if (!flagShowExoplanets)
 		return result;
 
-	Vec3d v(av);
-	v.normalize();
-	double cosLimFov = cos(limitFov * M_PI/180.);
-	Vec3d equPos;
-
-	foreach(const ExoplanetP& eps, ep)
-	{
-		if (eps->initialized)
-		{
-			equPos = eps->XYZ;
-			equPos.normalize();
-			if (equPos[0]*v[0] + equPos[1]*v[1] + equPos[2]*v[2]>=cosLimFov)
-			{
-				result.append(qSharedPointerCast<StelObject>(eps));
-			}
-		}
-	}
+	foreach(int i, catalog.findAround(core, av, limitFov))
+		result.append(qSharedPointerCast<StelObject>(ep.at(i)));
 
 	return result;
 }
@@ -519,7 +506,7 @@ QVariantMap Exoplanets::loadEPMap(QString path)
 		qWarning() << "[Exoplanets] Cannot open " << QDir::toNativeSeparators(path);
 	else
 	{
-		map = StelJsonParser::parse(jsonFile.readAll()).toMap();
+		map = StelJsonCache::load(path);
 		jsonFile.close();
 	}
 	return map;
@@ -561,6 +548,16 @@ void Exoplanets::setEPMap(const QVariantMap& map)
 		}
 
 	}
+
+	// Same magnitudes as Exoplanet::getVMagnitude() out of the distribution mode
+	QVector<Vec3d> positions;
+	QVector<float> magnitudes;
+	foreach(const ExoplanetP& eps, ep)
+	{
+		positions.append(eps->XYZ);
+		magnitudes.append(eps->Vmag<99 ? eps->Vmag : 6.f);
+	}
+	catalog.setPositions(StelApp::getInstance().getCore(), positions, magnitudes);
 }
 
 int Exoplanets::getJsonFileFormatVersion(void)
@@ -574,7 +571,7 @@ int Exoplanets::getJsonFileFormatVersion(void)
 	}
 
 	QVariantMap map;
-	map = StelJsonParser::parse(&jsonEPCatalogFile).toMap();
+	map = StelJsonCache::load(jsonCatalogPath, QStringList("version"));
 	jsonEPCatalogFile.close();
 	if (map.contains("version"))
 	{
@@ -597,7 +594,7 @@ bool Exoplanets::checkJsonFileFormat()
 	QVariantMap map;
 	try
 	{
-		map = StelJsonParser::parse(&jsonEPCatalogFile).toMap();
+		map = StelJsonCache::load(jsonCatalogPath, QStringList("version"));
 		jsonEPCatalogFile.close();
 	}
 	catch (std::runtime_error& e)
@@ -23,6 +23,7 @@
 #include "StelObject.hpp"
 #include "StelFader.hpp"
 #include "StelTextureTypes.hpp"
+#include "StelPointCatalog.hpp"
 #include "Exoplanet.hpp"
 #include <QFont>
 #include <QVariantMap>
@@ -330,6 +331,8 @@ private:
 
 	StelTextureSP texPointer;
 	QList<ExoplanetP> ep;
+	//! Positions of ep, for drawing and searching
+	StelPointCatalog catalog;
 
 	// variables and functions for the updater
 	UpdateState updateState;
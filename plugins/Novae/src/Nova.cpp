@@ -71,6 +71,7 @@ Nova::Nova(const QVariantMap& map)
 	RA = StelUtils::getDecAngle(map.value("RA").toString());
 	Dec = StelUtils::getDecAngle(map.value("Dec").toString());	
 	distance = map.value("distance").toDouble();
+	StelUtils::spheToRect(RA, Dec, XYZ);
 
 	initialized = true;
 }
@@ -302,9 +303,7 @@ void Nova::draw(StelCore* core, StelPainter* painter)
 	float size, shift;
 	double mag;
 
-	StelUtils::spheToRect(RA, Dec, XYZ);
 	mag = getVMagnitudeWithExtinction(core);
-	sd->preDrawPointSource(painter);
 	float mlimit = sd->getLimitMagnitude();
 
 	if (mag <= mlimit)
@@ -320,6 +319,4 @@ void Nova::draw(StelCore* core, StelPainter* painter)
 			painter->drawText(XYZ, name, 0, shift, shift, false);
 		}
 	}
-
-	sd->postDrawPointSource(painter);
 }
@@ -77,6 +77,7 @@ private:
 
 	Vec3d XYZ;                         // holds J2000 position
 
+	//! Draw the nova. The point sources of the sky drawer must be prepared.
 	void draw(StelCore* core, StelPainter* painter);
 
 	// Nova
@@ -24,12 +24,13 @@
 #include "StelLocaleMgr.hpp"
 #include "StelModuleMgr.hpp"
 #include "StelObjectMgr.hpp"
-#include "StelJsonParser.hpp"
+#include "StelJsonCache.hpp"
 #include "StelFileMgr.hpp"
 #include "StelUtils.hpp"
 #include "StelPainter.hpp"
 #include "StelTranslator.hpp"
 #include "StelTextureMgr.hpp"
+#include "StelSkyDrawer.hpp"
 #include "LabelMgr.hpp"
 #include "Nova.hpp"
 #include "Novae.hpp"
@@ -193,14 +194,13 @@ void Novae::draw(StelCore* core)
 	StelProjectorP prj = core->getProjection(StelCore::FrameJ2000);
 	StelPainter painter(prj);
 	painter.setFont(font);
-	
-	foreach (const NovaP& n, nova)
-	{
-		if (n && n->initialized)
-		{
-			n->draw(core, &painter);
-		}
-	}
+	StelSkyDrawer* sd = core->getSkyDrawer();
+
+	// All the point sources are drawn in one batch
+	sd->preDrawPointSource(&painter);
+	foreach (int i, catalog.findVisible(core, prj))
+		nova.at(i)->draw(core, &painter);
+	sd->postDrawPointSource(&painter);
 
 	if (GETSTELMODULE(StelObjectMgr)->getFlagSelectedObjectPointer())
 	{
@@ -231,27 +231,12 @@ void Novae::drawPointer(StelCore* core, StelPainter &painter)
 	}
 }
 
-QList<StelObjectP> Novae::searchAround(const Vec3d& av, double limitFov, const StelCore*) const
+QList<StelObjectP> Novae::searchAround(const Vec3d& av, double limitFov, const StelCore* core) const
 {
 	QList<StelObjectP> result;
 
-	Vec3d v(av);
-	v.normalize();
-	double cosLimFov = cos(limitFov * M_PI/180.);
-	Vec3d equPos;
-
-	foreach(const NovaP& n, nova)
-	{
-		if (n->initialized)
-		{
-			equPos = n->XYZ;
-			equPos.normalize();
-			if (equPos[0]*v[0] + equPos[1]*v[1] + equPos[2]*v[2]>=cosLimFov)
-			{
-				result.append(qSharedPointerCast<StelObject>(n));
-			}
-		}
-	}
+	foreach(int i, catalog.findAround(core, av, limitFov))
+		result.append(qSharedPointerCast<StelObject>(nova.at(i)));
 
 	return result;
 }
@@ -428,7 +413,7 @@ QVariantMap Novae::loadNovaeMap(QString path)
 		qWarning() << "[Novae] cannot open" << QDir::toNativeSeparators(path);
 	else
 	{
-		map = StelJsonParser::parse(jsonFile.readAll()).toMap();
+		map = StelJsonCache::load(path);
 		jsonFile.close();
 	}
 	return map;
@@ -456,6 +441,11 @@ void Novae::setNovaeMap(const QVariantMap& map)
 			nova.append(n);
 
 	}
+
+	QVector<Vec3d> positions;
+	foreach(const NovaP& n, nova)
+		positions.append(n->XYZ);
+	catalog.setPositions(StelApp::getInstance().getCore(), positions);
 }
 
 int Novae::getJsonFileVersion(void)
@@ -469,7 +459,7 @@ int Novae::getJsonFileVersion(void)
 	}
 
 	QVariantMap map;
-	map = StelJsonParser::parse(&novaeJsonFile).toMap();
+	map = StelJsonCache::load(novaeJsonPath, QStringList("version"));
 	if (map.contains("version"))
 	{
 		jsonVersion = map.value("version").toInt();
@@ -492,7 +482,7 @@ bool Novae::checkJsonFileFormat()
 	QVariantMap map;
 	try
 	{
-		map = StelJsonParser::parse(&novaeJsonFile).toMap();
+		map = StelJsonCache::load(novaeJsonPath, QStringList("version"));
 		novaeJsonFile.close();
 	}
 	catch (std::runtime_error& e)
@@ -691,7 +681,7 @@ float Novae::getLowerLimitBrightness()
 	}
 
 	QVariantMap map;
-	map = StelJsonParser::parse(&novaeJsonFile).toMap();
+	map = StelJsonCache::load(novaeJsonPath, QStringList("limit"));
 	if (map.contains("limit"))
 	{
 		lowerLimit = map.value("limit").toFloat();
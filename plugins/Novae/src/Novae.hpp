@@ -24,6 +24,7 @@
 #include "StelFader.hpp"
 #include "Nova.hpp"
 #include "StelTextureTypes.hpp"
+#include "StelPointCatalog.hpp"
 #include <QFont>
 #include <QVariantMap>
 #include <QDateTime>
@@ -221,6 +222,8 @@ private:
 
 	StelTextureSP texPointer;
 	QList<NovaP> nova;
+	//! Positions of nova, for drawing and searching
+	StelPointCatalog catalog;
 	QHash<QString, double> novalist;
 
 	// variables and functions for the updater
@@ -102,6 +102,7 @@ Pulsar::Pulsar(const QVariantMap& map)
 	{
 		pderivative = getP1(period, pfrequency);
 	}
+	StelUtils::spheToRect(RA, DE, XYZ);
 
 	initialized = true;
 }
@@ -373,35 +374,31 @@ void Pulsar::update(double deltaTime)
 	labelsFader.update((int)(deltaTime*1000));
 }
 
-void Pulsar::draw(StelCore* core, StelPainter *painter)
+void Pulsar::draw(StelCore* core, StelPainter *painter, StelPointCatalog::MarkerBatch& markers)
 {
 	StelSkyDrawer* sd = core->getSkyDrawer();
 	double mag = getVMagnitudeWithExtinction(core);
-	StelUtils::spheToRect(RA, DE, XYZ);
 
 	Vec3d win;
 	// Check visibility of pulsar
 	if (!(painter->getProjector()->projectCheck(XYZ, win)))
 		return;
 
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_ONE, GL_ONE);
-	if (glitch>0 && glitchFlag)
-		painter->setColor(glitchColor[0], glitchColor[1], glitchColor[2], 1.f);
-	else
-		painter->setColor(markerColor[0], markerColor[1], markerColor[2], 1.f);
 	float mlimit = sd->getLimitMagnitude();
 
 	if (mag <= mlimit)
 	{		
-		Pulsar::markerTexture->bind();
 		float size = getAngularSize(NULL)*M_PI/180.*painter->getProjector()->getPixelPerRadAtCenter();
 		float shift = 5.f + size/1.6f;		
 
-		painter->drawSprite2dMode(XYZ, distributionMode ? 4.f : 5.f);
+		markers.add(XYZ, distributionMode ? 4.f : 5.f, (glitch>0 && glitchFlag) ? glitchColor : markerColor);
 
 		if (labelsFader.getInterstate()<=0.f && !distributionMode && (mag+2.f)<mlimit)
 		{
+			if (glitch>0 && glitchFlag)
+				painter->setColor(glitchColor[0], glitchColor[1], glitchColor[2], 1.f);
+			else
+				painter->setColor(markerColor[0], markerColor[1], markerColor[2], 1.f);
 			painter->drawText(XYZ, designation, 0, shift, shift, false);
 		}
 	}
@@ -29,6 +29,7 @@
 #include "StelObject.hpp"
 #include "StelTextureTypes.hpp"
 #include "StelFader.hpp"
+#include "StelPointCatalog.hpp"
 
 class StelPainter;
 
@@ -97,7 +98,8 @@ private:
 	static Vec3f markerColor;
 	static Vec3f glitchColor;
 
-	void draw(StelCore* core, StelPainter *painter);
+	//! Draw the label of the pulsar and add its marker to markers.
+	void draw(StelCore* core, StelPainter *painter, StelPointCatalog::MarkerBatch& markers);
 
 	//! Variables for description of properties of pulsars
 	QString designation;	//! The designation of the pulsar (J2000 pulsar name)
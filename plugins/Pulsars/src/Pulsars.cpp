@@ -26,7 +26,8 @@
 #include "StelModuleMgr.hpp"
 #include "StelObjectMgr.hpp"
 #include "StelTextureMgr.hpp"
-#include "StelJsonParser.hpp"
+#include "StelSkyDrawer.hpp"
+#include "StelJsonCache.hpp"
 #include "StelFileMgr.hpp"
 #include "StelUtils.hpp"
 #include "StelTranslator.hpp"
@@ -120,6 +121,7 @@ Pulsars::~Pulsars()
 void Pulsars::deinit()
 {
 	psr.clear();
+	catalog.clear();
 	Pulsar::markerTexture.clear();
 	texPointer.clear();
 }
@@ -229,12 +231,12 @@ void Pulsars::draw(StelCore* core)
 	StelProjectorP prj = core->getProjection(StelCore::FrameJ2000);
 	StelPainter painter(prj);
 	painter.setFont(font);
-	
-	foreach (const PulsarP& pulsar, psr)
-	{
-		if (pulsar && pulsar->initialized)
-			pulsar->draw(core, &painter);
-	}
+	StelPointCatalog::MarkerBatch markers(&painter);
+
+	// All the markers are drawn in one batch
+	foreach (int i, catalog.findVisible(core, prj, Pulsar::distributionMode ? 99.f : core->getSkyDrawer()->getLimitMagnitude()))
+		psr.at(i)->draw(core, &painter, markers);
+	markers.draw(Pulsar::markerTexture);
 
 	if (GETSTELMODULE(StelObjectMgr)->getFlagSelectedObjectPointer())
 		drawPointer(core, painter);
@@ -266,30 +268,15 @@ void Pulsars::drawPointer(StelCore* core, StelPainter& painter)
 	}
 }
 
-QList<StelObjectP> Pulsars::searchAround(const Vec3d& av, double limitFov, const StelCore*) const
+QList<StelObjectP> Pulsars::searchAround(const Vec3d& av, double limitFov, const StelCore* core) const
 {
 	QList<StelObjectP> result;
 
 	if (!flagShowPulsars)
 		return result;
 
-	Vec3d v(av);
-	v.normalize();
-	double cosLimFov = cos(limitFov * M_PI/180.);
-	Vec3d equPos;
-
-	foreach(const PulsarP& pulsar, psr)
-	{
-		if (pulsar->initialized)
-		{
-			equPos = pulsar->XYZ;
-			equPos.normalize();
-			if (equPos[0]*v[0] + equPos[1]*v[1] + equPos[2]*v[2]>=cosLimFov)
-			{
-				result.append(qSharedPointerCast<StelObject>(pulsar));
-			}
-		}
-	}
+	foreach(int i, catalog.findAround(core, av, limitFov))
+		result.append(qSharedPointerCast<StelObject>(psr.at(i)));
 
 	return result;
 }
@@ -442,7 +429,7 @@ QVariantMap Pulsars::loadPSRMap(QString path)
 		qWarning() << "[Pulsars] Cannot open" << QDir::toNativeSeparators(path);
 	else
 	{
-		map = StelJsonParser::parse(jsonFile.readAll()).toMap();
+		map = StelJsonCache::load(path);
 		jsonFile.close();
 	}
 	return map;
@@ -468,6 +455,16 @@ void Pulsars::setPSRMap(const QVariantMap& map)
 			psr.append(pulsar);
 
 	}
+
+	// Same magnitudes as Pulsar::getVMagnitude() out of the distribution mode
+	QVector<Vec3d> positions;
+	QVector<float> magnitudes;
+	foreach(const PulsarP& pulsar, psr)
+	{
+		positions.append(pulsar->XYZ);
+		magnitudes.append(pulsar->distance + 6.f);
+	}
+	catalog.setPositions(StelApp::getInstance().getCore(), positions, magnitudes);
 }
 
 int Pulsars::getJsonFileFormatVersion(void)
@@ -481,7 +478,7 @@ int Pulsars::getJsonFileFormatVersion(void)
 	}
 
 	QVariantMap map;
-	map = StelJsonParser::parse(&jsonPSRCatalogFile).toMap();
+	map = StelJsonCache::load(jsonCatalogPath, QStringList("version"));
 	if (map.contains("version"))
 	{
 		jsonVersion = map.value("version").toInt();
@@ -504,7 +501,7 @@ bool Pulsars::checkJsonFileFormat()
 	QVariantMap map;
 	try
 	{
-		map = StelJsonParser::parse(&jsonPSRCatalogFile).toMap();
+		map = StelJsonCache::load(jsonCatalogPath, QStringList("version"));
 		jsonPSRCatalogFile.close();
 	}
 	catch (std::runtime_error& e)
@@ -23,6 +23,7 @@
 #include "StelObject.hpp"
 #include "StelFader.hpp"
 #include "StelTextureTypes.hpp"
+#include "StelPointCatalog.hpp"
 #include "Pulsar.hpp"
 #include <QFont>
 #include <QVariantMap>
@@ -264,6 +265,8 @@ private:
 
 	StelTextureSP texPointer;
 	QList<PulsarP> psr;
+	//! Positions of psr, for drawing and searching
+	StelPointCatalog catalog;
 
 	int PsrCount;
 
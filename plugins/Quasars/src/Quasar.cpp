@@ -64,6 +64,7 @@ Quasar::Quasar(const QVariantMap& map)
 	qRA = StelUtils::getDecAngle(map.value("RA").toString());
 	qDE = StelUtils::getDecAngle(map.value("DE").toString());
 	redshift = map.value("z").toFloat();
+	StelUtils::spheToRect(qRA, qDE, XYZ);
 
 	initialized = true;
 }
@@ -166,7 +167,7 @@ void Quasar::update(double deltaTime)
 	labelsFader.update((int)(deltaTime*1000));
 }
 
-void Quasar::draw(StelCore* core, StelPainter& painter)
+void Quasar::draw(StelCore* core, StelPainter& painter, StelPointCatalog::MarkerBatch& markers)
 {
 	StelSkyDrawer* sd = core->getSkyDrawer();
 
@@ -175,26 +176,18 @@ void Quasar::draw(StelCore* core, StelPainter& painter)
 	float size, shift=0;
 	double mag;
 
-	StelUtils::spheToRect(qRA, qDE, XYZ);
 	mag = getVMagnitudeWithExtinction(core);	
 
 	if (distributionMode)
 	{
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_ONE, GL_ONE);
-		painter.setColor(markerColor[0], markerColor[1], markerColor[2], 1);
-
-		Quasar::markerTexture->bind();
 		//size = getAngularSize(NULL)*M_PI/180.*painter.getProjector()->getPixelPerRadAtCenter();
 		if (labelsFader.getInterstate()<=0.f)
 		{
-			painter.drawSprite2dMode(XYZ, 4);			
+			markers.add(XYZ, 4, markerColor);
 		}
 	}
 	else
 	{
-		sd->preDrawPointSource(&painter);
-	
 		if (mag <= sd->getLimitMagnitude())
 		{
 			sd->computeRCMag(mag, &rcMag);
@@ -207,8 +200,6 @@ void Quasar::draw(StelCore* core, StelPainter& painter)
 				painter.drawText(XYZ, designation, 0, shift, shift, false);
 			}
 		}
-
-		sd->postDrawPointSource(&painter);
 	}
 }
 
@@ -29,6 +29,7 @@
 #include "StelObject.hpp"
 #include "StelTextureTypes.hpp"
 #include "StelFader.hpp"
+#include "StelPointCatalog.hpp"
 
 class StelPainter;
 
@@ -89,7 +90,9 @@ private:
 	static bool distributionMode;
 	static Vec3f markerColor;
 
-	void draw(StelCore* core, StelPainter& painter);
+	//! Draw the quasar, or add its marker to markers in the distribution mode.
+	//! The point sources of the sky drawer must be prepared, except in the distribution mode.
+	void draw(StelCore* core, StelPainter& painter, StelPointCatalog::MarkerBatch& markers);
 	//! Calculate a color of quasar
 	//! @param b_v value of B-V color index
 	unsigned char BvToColorIndex(float b_v);
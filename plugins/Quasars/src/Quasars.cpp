@@ -27,7 +27,8 @@
 #include "StelModuleMgr.hpp"
 #include "StelObjectMgr.hpp"
 #include "StelTextureMgr.hpp"
-#include "StelJsonParser.hpp"
+#include "StelSkyDrawer.hpp"
+#include "StelJsonCache.hpp"
 #include "StelFileMgr.hpp"
 #include "StelUtils.hpp"
 #include "StelTranslator.hpp"
@@ -122,6 +123,7 @@ Quasars::~Quasars()
 void Quasars::deinit()
 {
 	QSO.clear();
+	catalog.clear();
 	Quasar::markerTexture.clear();
 	texPointer.clear();
 }
@@ -231,12 +233,17 @@ void Quasars::draw(StelCore* core)
 	StelProjectorP prj = core->getProjection(StelCore::FrameJ2000);
 	StelPainter painter(prj);
 	painter.setFont(font);
-	
-	foreach (const QuasarP& quasar, QSO)
-	{
-		if (quasar && quasar->initialized)
-			quasar->draw(core, painter);
-	}
+	StelSkyDrawer* sd = core->getSkyDrawer();
+	StelPointCatalog::MarkerBatch markers(&painter);
+
+	// All the quasars are drawn in one batch of point sources or markers
+	if (!Quasar::distributionMode)
+		sd->preDrawPointSource(&painter);
+	foreach (int i, catalog.findVisible(core, prj, Quasar::distributionMode ? 99.f : sd->getLimitMagnitude()))
+		QSO.at(i)->draw(core, painter, markers);
+	if (!Quasar::distributionMode)
+		sd->postDrawPointSource(&painter);
+	markers.draw(Quasar::markerTexture);
 
 	if (GETSTELMODULE(StelObjectMgr)->getFlagSelectedObjectPointer())
 		drawPointer(core, painter);
@@ -268,30 +275,15 @@ void Quasars::drawPointer(StelCore* core, StelPainter& painter)
 	}
 }
 
-QList<StelObjectP> Quasars::searchAround(const Vec3d& av, double limitFov, const StelCore*) const
+QList<StelObjectP> Quasars::searchAround(const Vec3d& av, double limitFov, const StelCore* core) const
 {
 	QList<StelObjectP> result;
 
 	if (!flagShowQuasars)
 		return result;
 
-	Vec3d v(av);
-	v.normalize();
-	double cosLimFov = cos(limitFov * M_PI/180.);
-	Vec3d equPos;
-
-	foreach(const QuasarP& quasar, QSO)
-	{
-		if (quasar->initialized)
-		{
-			equPos = quasar->XYZ;
-			equPos.normalize();
-			if (equPos[0]*v[0] + equPos[1]*v[1] + equPos[2]*v[2]>=cosLimFov)
-			{
-				result.append(qSharedPointerCast<StelObject>(quasar));
-			}
-		}
-	}
+	foreach(int i, catalog.findAround(core, av, limitFov))
+		result.append(qSharedPointerCast<StelObject>(QSO.at(i)));
 
 	return result;
 }
@@ -446,7 +438,7 @@ QVariantMap Quasars::loadQSOMap(QString path)
 		qWarning() << "[Quasars] Cannot open" << QDir::toNativeSeparators(path);
 	else
 	{
-		map = StelJsonParser::parse(jsonFile.readAll()).toMap();
+		map = StelJsonCache::load(path);
 		jsonFile.close();
 	}
 	return map;
@@ -472,6 +464,15 @@ void Quasars::setQSOMap(const QVariantMap& map)
 			QSO.append(quasar);
 
 	}
+
+	QVector<Vec3d> positions;
+	QVector<float> magnitudes;
+	foreach(const QuasarP& quasar, QSO)
+	{
+		positions.append(quasar->XYZ);
+		magnitudes.append(quasar->VMagnitude);
+	}
+	catalog.setPositions(StelApp::getInstance().getCore(), positions, magnitudes);
 }
 
 int Quasars::getJsonFileFormatVersion(void)
@@ -485,7 +486,7 @@ int Quasars::getJsonFileFormatVersion(void)
 	}
 
 	QVariantMap map;
-	map = StelJsonParser::parse(&catalogJsonFile).toMap();
+	map = StelJsonCache::load(catalogJsonPath, QStringList("version"));
 	if (map.contains("version"))
 	{
 		jsonVersion = map.value("version").toInt();
@@ -508,7 +509,7 @@ bool Quasars::checkJsonFileFormat()
 	QVariantMap map;
 	try
 	{
-		map = StelJsonParser::parse(&catalogJsonFile).toMap();
+		map = StelJsonCache::load(catalogJsonPath, QStringList("version"));
 		catalogJsonFile.close();
 	}
 	catch (std::runtime_error& e)
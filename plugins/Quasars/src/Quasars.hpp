@@ -22,6 +22,7 @@
 #include "StelObjectModule.hpp"
 #include "StelObject.hpp"
 #include "StelTextureTypes.hpp"
+#include "StelPointCatalog.hpp"
 #include "Quasar.hpp"
 #include <QFont>
 #include <QVariantMap>
@@ -255,6 +256,8 @@ private:
 
 	StelTextureSP texPointer;
 	QList<QuasarP> QSO;
+	//! Positions of QSO, for drawing and searching
+	StelPointCatalog catalog;
 
 	// variables and functions for the updater
 	UpdateState updateState;
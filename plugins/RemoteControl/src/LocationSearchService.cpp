@@ -40,10 +40,8 @@ LocationSearchService::LocationSearchService(const QByteArray &serviceName, QObj
 void LocationSearchService::mainLocationManagerUpdated()
 {
 	//this is run in the main thread
-	locMgrMutex.lock();
-	//copy the contents of the location manager
+	//copy the contents of the location manager, which guards its locations and indexes against the HTTP threads
 	locMgr.setLocations(StelApp::getInstance().getLocationMgr().getAll());
-	locMgrMutex.unlock();
 }
 
 void LocationSearchService::getImpl(const QByteArray& operation, const APIParameters &parameters, APIServiceResponse &response)
@@ -61,20 +59,27 @@ void LocationSearchService::getImpl(const QByteArray& operation, const APIParame
 
 		//the filtering in the app is provided by QSortFilterProxyModel in the view
 		//we dont have that luxury, but we make sure the filtering happens in the separate HTTP thread
-		locMgrMutex.lock();
-		LocationMap allItems = locMgr.getAllMap();
-		locMgrMutex.unlock();
-
 		QJsonArray results;
-		const QList<QString>& list = allItems.keys();
+		if(!term.contains(QRegExp("[*?\\[]")))
+		{
+			//plain text is looked up in the name index of the location manager, most populated first
+			const QStringList list = locMgr.findLocationIDs(term, locMgr.getAllMap().size());
+			results = QJsonArray::fromStringList(list);
+		}
+		else
+		{
+			LocationMap allItems = locMgr.getAllMap();
 
-		//use a regexp in wildcard mode, the app does the same
-		QRegExp exp(term,Qt::CaseInsensitive, QRegExp::Wildcard);
+			const QList<QString>& list = allItems.keys();
 
-		for(QList<QString>::const_iterator it = list.begin();it!=list.end();++it)
-		{
-			if(it->contains(exp))
-				results.append(*it);
+			//use a regexp in wildcard mode, the app does the same
+			QRegExp exp(term,Qt::CaseInsensitive, QRegExp::Wildcard);
+
+			for(QList<QString>::const_iterator it = list.begin();it!=list.end();++it)
+			{
+				if(it->contains(exp))
+					results.append(*it);
+			}
 		}
 
 		response.writeJSON(QJsonDocument(results));
@@ -90,9 +95,7 @@ void LocationSearchService::getImpl(const QByteArray& operation, const APIParame
 		float longitude = sLongitude.toFloat();
 		float radius = sRadius.toFloat();
 
-		locMgrMutex.lock();
 		LocationMap results = locMgr.pickLocationsNearby(sPlanet,longitude,latitude,radius);
-		locMgrMutex.unlock();
 
 		response.writeJSON(QJsonDocument(QJsonArray::fromStringList(results.keys())));
 	}
@@ -22,7 +22,6 @@
 
 #include "AbstractAPIService.hpp"
 #include "StelLocationMgr.hpp"
-#include <QMutex>
 
 //! @ingroup remoteControl
 //! Provides predefined location search functionality, using the StelLocationMgr.
@@ -49,8 +48,8 @@ private slots:
 	void mainLocationManagerUpdated();
 private:
 	//the location mgr is actually copied to be used in HTTP threads without blocking the main app
+	//its queries can run in several threads
 	StelLocationMgr locMgr;
-	QMutex locMgrMutex;
 };
 
 
@@ -618,19 +618,8 @@ void Satellite::update(double)
 		velocity                 = pSatWrapper->getTEMEVel();
 		latLongSubPointPosition  = pSatWrapper->getSubPoint();
 		height                   = latLongSubPointPosition[2];
-		if (height <= 0.0)
-		{
-			// The orbit is no longer valid.  Causes include very out of date
-			// TLE, system date and time out of a reasonable range, and orbital
-			// degradation and re-entry of a satellite.  In any of these cases
-			// we might end up with a problem - usually a crash of Stellarium
-			// because of a div/0 or something.  To prevent this, we turn off
-			// the satellite.
-			qWarning() << "Satellite has invalid orbit:" << name << id;
-			orbitValid = false;
-			displayed = false; // He shouldn't be displayed!
+		if (!checkOrbit())
 			return;
-		}
 
 		elAzPosition             = pSatWrapper->getAltAz();
 		elAzPosition.normalize();
@@ -644,6 +633,50 @@ void Satellite::update(double)
 	}
 }
 
+void Satellite::update(const SatellitePropagator& propagator, int index)
+{
+	if (pSatWrapper && orbitValid)
+	{
+		epochTime = propagator.getEpoch();
+		pSatWrapper->setPropagatedEpoch(epochTime);
+		position                 = propagator.getPosition(index);
+		velocity                 = propagator.getVelocity(index);
+		latLongSubPointPosition  = propagator.getSubPoint(index);
+		height                   = latLongSubPointPosition[2];
+		if (!checkOrbit())
+			return;
+
+		elAzPosition             = propagator.getAltAz(index);
+		elAzPosition.normalize();
+
+		range      = propagator.getRange(index);
+		rangeRate  = propagator.getRangeRate(index);
+		visibility = propagator.getVisibility(index);
+		phaseAngle = propagator.getPhaseAngle(index);
+
+		// Compute orbit points to draw orbit line.
+		if (orbitDisplayed) computeOrbitPoints();
+	}
+}
+
+bool Satellite::checkOrbit()
+{
+	if (height <= 0.0)
+	{
+		// The orbit is no longer valid.  Causes include very out of date
+		// TLE, system date and time out of a reasonable range, and orbital
+		// degradation and re-entry of a satellite.  In any of these cases
+		// we might end up with a problem - usually a crash of Stellarium
+		// because of a div/0 or something.  To prevent this, we turn off
+		// the satellite.
+		qWarning() << "Satellite has invalid orbit:" << name << id;
+		orbitValid = false;
+		displayed = false; // He shouldn't be displayed!
+		return false;
+	}
+	return true;
+}
+
 double Satellite::getDoppler(double freq) const
 {
 	double result;
@@ -32,6 +32,7 @@
 #include "StelTextureTypes.hpp"
 #include "StelSphereGeometry.hpp"
 #include "gSatWrapper.hpp"
+#include "SatellitePropagator.hpp"
 
 
 class StelPainter;
@@ -140,6 +141,9 @@ public:
 
 	// calculate faders, new position
 	void update(double deltaTime);
+	//! Same as update(), with the position computed by propagator.
+	//! @param index the index of the satellite in propagator.
+	void update(const SatellitePropagator& propagator, int index);
 
 	double getDoppler(double freq) const;
 	static float showLabels;
@@ -168,6 +172,9 @@ public:
 	float calculateIlluminatedFraction() const;
 
 private:
+	//! Turn off the satellite if the propagated height is not positive.
+	//! @return false if the orbit is not valid.
+	bool checkOrbit();
 	//draw orbits methods
 	void computeOrbitPoints();
 	void drawOrbit(StelPainter& painter);
@@ -0,0 +1,187 @@
+/*
+ * Stellarium Satellites plugin
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include "SatellitePropagator.hpp"
+#include "gSatWrapper.hpp"
+#include "StelUtils.hpp"
+
+#include "gsatellite/gSatTEME.hpp"
+#include "gsatellite/gTime.hpp"
+#include "gsatellite/mathUtils.hpp"
+#include "gsatellite/stdsat.h"
+
+#include <cmath>
+#include <QtConcurrent>
+
+// Number of satellites propagated by one thread in one go
+static const int chunkSize = 256;
+// Below this number of satellites, they are propagated in the calling thread
+static const int minParallelSatellites = 4*chunkSize;
+
+SatellitePropagator::Observer SatellitePropagator::computeObserver(double epoch, double latitude, double longitude, double altitude,
+								    const Vec3d& sunEquinoxEqPos, bool sunAboveHorizon)
+{
+	Observer o;
+	o.epoch = epoch;
+	o.thetaGMST = gTime(epoch).toThetaGMST();
+	// Same as gTime::toThetaLMST()
+	const double theta = fmod(o.thetaGMST + longitude * KDEG2RAD, K2PI);
+	const double radLatitude = latitude * KDEG2RAD;
+	o.sinLatitude = sin(radLatitude);
+	o.cosLatitude = cos(radLatitude);
+	o.sinTheta = sin(theta);
+	o.cosTheta = cos(theta);
+
+	// Same ellipsoid as gSatWrapper::calcObserverECIPosition()
+	const double c = 1/std::sqrt(1 + __f*(__f - 2)*Sqr(o.sinLatitude));
+	const double sq = Sqr(1 - __f)*c;
+	const double r = (KEARTHRADIUS*c + altitude/1000.)*o.cosLatitude;
+	o.position.set(r*o.cosTheta, r*o.sinTheta, (KEARTHRADIUS*sq + altitude/1000.)*o.sinLatitude);
+	o.velocity.set(-KMFACTOR*o.position[1], KMFACTOR*o.position[0], 0.);
+
+	// Same as gSatWrapper::getSunECIPos()
+	o.sunPosition.set(sunEquinoxEqPos[0]*AU, sunEquinoxEqPos[1]*AU, sunEquinoxEqPos[2]*AU);
+	o.sunPosition = o.sunPosition + o.position;
+	o.sunAboveHorizon = sunAboveHorizon;
+	return o;
+}
+
+int SatellitePropagator::add(gSatTEME* satellite)
+{
+	satellites.append(satellite);
+	const int n = satellites.size();
+	x.resize(n);
+	y.resize(n);
+	z.resize(n);
+	vx.resize(n);
+	vy.resize(n);
+	vz.resize(n);
+	subLatitude.resize(n);
+	subLongitude.resize(n);
+	subHeight.resize(n);
+	south.resize(n);
+	east.resize(n);
+	zenith.resize(n);
+	range.resize(n);
+	rangeRate.resize(n);
+	phaseAngle.resize(n);
+	visibility.resize(n);
+	chunks.clear();
+	return n-1;
+}
+
+void SatellitePropagator::clear()
+{
+	satellites.clear();
+	chunks.clear();
+	x.clear();
+	y.clear();
+	z.clear();
+	vx.clear();
+	vy.clear();
+	vz.clear();
+	subLatitude.clear();
+	subLongitude.clear();
+	subHeight.clear();
+	south.clear();
+	east.clear();
+	zenith.clear();
+	range.clear();
+	rangeRate.clear();
+	phaseAngle.clear();
+	visibility.clear();
+}
+
+void SatellitePropagator::solve(const Observer& o, int begin, int end)
+{
+	for (int i=begin; i<end; ++i)
+	{
+		gSatTEME* sat = satellites[i];
+		sat->setEpoch(o.epoch, o.thetaGMST);
+		const gVector& pos = sat->getPos();
+		const gVector& vel = sat->getVel();
+		const gVector& subPoint = sat->getSubPoint();
+		x[i] = pos[0];
+		y[i] = pos[1];
+		z[i] = pos[2];
+		vx[i] = vel[0];
+		vy[i] = vel[1];
+		vz[i] = vel[2];
+		subLatitude[i] = subPoint[0];
+		subLongitude[i] = subPoint[1];
+		subHeight[i] = subPoint[2];
+
+		// As in gSatWrapper::getAltAz() and getSlantRange()
+		const Vec3d satPos(pos[0], pos[1], pos[2]);
+		const Vec3d slantRange = satPos - o.position;
+		const Vec3d slantRangeVelocity = Vec3d(vel[0], vel[1], vel[2]) - o.velocity;
+		south[i] = o.sinLatitude*o.cosTheta*slantRange[0] + o.sinLatitude*o.sinTheta*slantRange[1] - o.cosLatitude*slantRange[2];
+		east[i] = -o.sinTheta*slantRange[0] + o.cosTheta*slantRange[1];
+		zenith[i] = o.cosLatitude*o.cosTheta*slantRange[0] + o.cosLatitude*o.sinTheta*slantRange[1] + o.sinLatitude*slantRange[2];
+		range[i] = slantRange.length();
+		rangeRate[i] = slantRange.dot(slantRangeVelocity)/range[i];
+
+		// As in gSatWrapper::getVisibilityPredict() and getPhaseAngle()
+		const double sunSatAngle = o.sunPosition.angle(satPos);
+		if (zenith[i] <= 0)
+			visibility[i] = NOT_VISIBLE;
+		else if (o.sunAboveHorizon)
+			visibility[i] = RADAR_SUN;
+		else
+			visibility[i] = satPos.length()*cos(sunSatAngle - (M_PI/2)) > KEARTHRADIUS ? VISIBLE : RADAR_NIGHT;
+		phaseAngle[i] = sunSatAngle;
+	}
+}
+
+struct SatellitePropagator::ChunkSolver
+{
+	ChunkSolver(SatellitePropagator* propagator, const Observer& observer) : propagator(propagator), observer(observer) {}
+	void operator()(const Chunk& c) const
+	{
+		propagator->solve(observer, c.begin, c.end);
+	}
+	SatellitePropagator* propagator;
+	const Observer& observer;
+};
+
+void SatellitePropagator::propagate(const Observer& observer)
+{
+	epoch = observer.epoch;
+	if (satellites.isEmpty())
+		return;
+
+	if (satellites.size()<minParallelSatellites)
+	{
+		solve(observer, 0, satellites.size());
+		return;
+	}
+
+	if (chunks.isEmpty())
+	{
+		const int count = satellites.size();
+		for (int begin=0; begin<count; begin+=chunkSize)
+		{
+			Chunk c;
+			c.begin = begin;
+			c.end = qMin(begin+chunkSize, count);
+			chunks.append(c);
+		}
+	}
+	QtConcurrent::blockingMap(chunks, ChunkSolver(this, observer));
+}
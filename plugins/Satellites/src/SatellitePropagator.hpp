@@ -0,0 +1,120 @@
+/*
+ * Stellarium Satellites plugin
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _SATELLITEPROPAGATOR_HPP_
+#define _SATELLITEPROPAGATOR_HPP_
+
+#include "VecMath.hpp"
+
+#include <QVector>
+
+class gSatTEME;
+
+//! @class SatellitePropagator
+//! Propagates many satellites to the same epoch in one pass.
+//! gSatWrapper computes the position of the observer and of the Sun for each
+//! satellite, and each call looks up the location and the SolarSystem module.
+//! Here they are computed once per epoch in an Observer, then the satellites are
+//! propagated with SGP4 in chunks spread over the global thread pool. The results
+//! are stored as structure of arrays, in the order the satellites were added.
+//! The results are the same as those of gSatWrapper::getTEMEPos(), getTEMEVel(),
+//! getSubPoint(), getAltAz(), getSlantRange(), getVisibilityPredict() and getPhaseAngle().
+//! @note The SGP4 state of each satellite is still its own gSatTEME record, so a satellite
+//! must not be propagated by other code while propagate() runs.
+//! @ingroup satellites
+class SatellitePropagator
+{
+public:
+	//! The positions shared by all the satellites at one epoch.
+	struct Observer
+	{
+		double epoch;		//!< Julian Day (UT)
+		double thetaGMST;	//!< Greenwich mean sidereal time (radians)
+		double sinLatitude, cosLatitude;
+		double sinTheta, cosTheta;	//!< of the local mean sidereal time
+		Vec3d position;		//!< observer ECI position (km)
+		Vec3d velocity;		//!< observer ECI velocity (km/s)
+		Vec3d sunPosition;	//!< Sun ECI position (km)
+		bool sunAboveHorizon;
+	};
+
+	SatellitePropagator() : epoch(0.) {}
+
+	//! Compute the shared positions, as gSatWrapper::calcObserverECIPosition() and getSunECIPos() do.
+	//! @param epoch Julian Day (UT) of the propagation.
+	//! @param latitude, longitude observer location in degrees.
+	//! @param altitude observer altitude in meters.
+	//! @param sunEquinoxEqPos topocentric position of the Sun in the equinox equatorial frame (AU).
+	//! @param sunAboveHorizon true if the geometric altitude of the Sun is positive.
+	static Observer computeObserver(double epoch, double latitude, double longitude, double altitude,
+					const Vec3d& sunEquinoxEqPos, bool sunAboveHorizon);
+
+	//! Add a satellite. It must outlive the propagator or be removed by clear().
+	//! @return the index of the results of the satellite.
+	int add(gSatTEME* satellite);
+	//! Remove all satellites.
+	void clear();
+	//! Number of satellites.
+	int size() const {return satellites.size();}
+
+	//! Propagate all satellites to the epoch of observer.
+	//! Small sets are propagated in the calling thread.
+	void propagate(const Observer& observer);
+	//! Julian Day of the results.
+	double getEpoch() const {return epoch;}
+
+	//! TEME position (km).
+	Vec3d getPosition(int i) const {return Vec3d(x[i], y[i], z[i]);}
+	//! TEME velocity (km/s).
+	Vec3d getVelocity(int i) const {return Vec3d(vx[i], vy[i], vz[i]);}
+	//! Latitude and longitude (degrees) and altitude (km) of the subpoint.
+	Vec3d getSubPoint(int i) const {return Vec3d(subLatitude[i], subLongitude[i], subHeight[i]);}
+	//! Topocentric position (km), in the frame of gSatWrapper::getAltAz().
+	Vec3d getAltAz(int i) const {return Vec3d(south[i], east[i], zenith[i]);}
+	double getRange(int i) const {return range[i];}
+	double getRangeRate(int i) const {return rangeRate[i];}
+	//! One of RADAR_SUN, VISIBLE, RADAR_NIGHT, NOT_VISIBLE.
+	int getVisibility(int i) const {return visibility[i];}
+	double getPhaseAngle(int i) const {return phaseAngle[i];}
+
+private:
+	//! A range of satellites propagated by one thread.
+	struct Chunk
+	{
+		int begin;
+		int end;
+	};
+
+	struct ChunkSolver;
+
+	//! Propagate the satellites in [begin, end).
+	void solve(const Observer& observer, int begin, int end);
+
+	QVector<gSatTEME*> satellites;
+	QVector<Chunk> chunks;
+	double epoch;
+	// Results
+	QVector<double> x, y, z, vx, vy, vz;
+	QVector<double> subLatitude, subLongitude, subHeight;
+	QVector<double> south, east, zenith;
+	QVector<double> range, rangeRate, phaseAngle;
+	QVector<int> visibility;
+};
+
+#endif // _SATELLITEPROPAGATOR_HPP_
@@ -1547,11 +1547,43 @@ void Satellites::update(double deltaTime)
 
 	hintFader.update((int)(deltaTime*1000));
 
+	// All displayed satellites are propagated together, the position of the
+	// observer and of the Sun are computed once for all of them.
+	QVector<Satellite*> displayedSatellites;
+	QVector<gSatTEME*> models;
+	displayedSatellites.reserve(satellites.size());
+	models.reserve(satellites.size());
 	foreach(const SatelliteP& sat, satellites)
 	{
-		if (sat->initialized && sat->displayed)
-			sat->update(deltaTime);
+		if (sat->initialized && sat->displayed && sat->orbitValid && sat->pSatWrapper)
+		{
+			displayedSatellites.append(sat.data());
+			models.append(sat->pSatWrapper->getTEME());
+		}
 	}
+	// The satellites are taken again each frame, as they may have been deleted.
+	// Only the propagator is rebuilt when the models change.
+	propagatedSatellites = displayedSatellites;
+	if (models!=propagatedModels)
+	{
+		propagator.clear();
+		foreach (gSatTEME* model, models)
+			propagator.add(model);
+		propagatedModels = models;
+	}
+	if (propagatedSatellites.isEmpty())
+		return;
+
+	StelCore* core = StelApp::getInstance().getCore();
+	const StelLocation& loc = core->getCurrentLocation();
+	const PlanetP sun = GETSTELMODULE(SolarSystem)->getSun();
+	// We have "true" JD from core, satellites don't need JDE!
+	const SatellitePropagator::Observer observer = SatellitePropagator::computeObserver(
+		core->getJD() + Satellite::timeShift, loc.latitude, loc.longitude, loc.altitude,
+		sun->getEquinoxEquatorialPos(core), sun->getAltAzPosGeometric(core)[2] > 0.0);
+	propagator.propagate(observer);
+	for (int i=0; i<propagatedSatellites.size(); ++i)
+		propagatedSatellites[i]->update(propagator, i);
 }
 
 void Satellites::draw(StelCore* core)
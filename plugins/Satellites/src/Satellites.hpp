@@ -531,6 +531,13 @@ private:
 	QList<SatelliteP> satellites;
 	SatellitesListModel* satelliteListModel;
 
+	//! Propagates the displayed satellites in update().
+	SatellitePropagator propagator;
+	//! The satellites propagated in the last update(), and the SGP4 models added
+	//! to #propagator. The models change when new TLE elements are set.
+	QVector<Satellite*> propagatedSatellites;
+	QVector<gSatTEME*> propagatedModels;
+
 	QHash<QString, double> qsMagList;
 	
 	//! Union of the groups used by all loaded satellites - see @ref groups.
@@ -58,6 +58,11 @@ public:
 
 	void setEpoch(double ai_julianDaysEpoch);
 
+	//! The SGP4 model of the satellite, for SatellitePropagator.
+	gSatTEME* getTEME() { return pSatellite; }
+	//! Set the epoch after SatellitePropagator propagated the model to it.
+	void setPropagatedEpoch(double ai_julianDaysEpoch) { epoch = ai_julianDaysEpoch; }
+
 	// Operation getTEMEPos
 	//! @brief This operation isolate gSatTEME getPos operation.
 	//! @return Vec3d with TEME position. Units measured in Km.
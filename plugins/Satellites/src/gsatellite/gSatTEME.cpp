@@ -102,7 +102,25 @@ void gSatTEME::setEpoch(gTime ai_time)
 	m_Vel[ 0]     = vo[ 0];
 	m_Vel[ 1]     = vo[ 1];
 	m_Vel[ 2]     = vo[ 2];
-	m_SubPoint    = computeSubPoint( ai_time);
+	m_SubPoint    = computeSubPoint( ai_time.toThetaGMST());
+}
+
+void gSatTEME::setEpoch(double ai_time, double ai_thetaGMST)
+{
+	double ro[3];
+	double vo[3];
+	// same arithmetic as setEpoch(gTime), the results are identical
+	double dtsince = (ai_time - satrec.jdsatepoch)*KSEC_PER_DAY/KSEC_PER_MIN;
+	// call the propagator to get the initial state vector value
+	sgp4(CONSTANTS_SET, satrec,  dtsince, ro,  vo);
+
+	m_Position[ 0]= ro[ 0];
+	m_Position[ 1]= ro[ 1];
+	m_Position[ 2]= ro[ 2];
+	m_Vel[ 0]     = vo[ 0];
+	m_Vel[ 1]     = vo[ 1];
+	m_Vel[ 2]     = vo[ 2];
+	m_SubPoint    = computeSubPoint( ai_thetaGMST);
 }
 
 void gSatTEME::setMinSinceKepEpoch(double ai_minSinceKepEpoch)
@@ -122,17 +140,17 @@ void gSatTEME::setMinSinceKepEpoch(double ai_minSinceKepEpoch)
 	m_Vel[ 0]     = vo[ 0];
 	m_Vel[ 1]     = vo[ 1];
 	m_Vel[ 2]     = vo[ 2];
-	m_SubPoint    = computeSubPoint( Epoch);
+	m_SubPoint    = computeSubPoint( Epoch.toThetaGMST());
 }
 
-gVector gSatTEME::computeSubPoint(gTime ai_Time)
+gVector gSatTEME::computeSubPoint(double ai_thetaGMST)
 {
 
 	gVector resultVector(3); // (0) Latitude, (1) Longitude, (2) altitude
 	double theta, r, e2, phi, c;
 
 	theta = AcTan(m_Position[1], m_Position[0]); // radians
-	resultVector[ LONGITUDE] = fmod((theta - ai_Time.toThetaGMST()), K2PI);  //radians
+	resultVector[ LONGITUDE] = fmod((theta - ai_thetaGMST), K2PI);  //radians
 
 
 	r = std::sqrt(Sqr(m_Position[0]) + Sqr(m_Position[1]));
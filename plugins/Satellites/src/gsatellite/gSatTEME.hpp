@@ -78,6 +78,14 @@ public:
 		return setEpoch( time);
 	}
 
+	// Operation: setEpoch( double ai_time, double ai_thetaGMST)
+	//! @brief Set compute epoch for prediction, with its Greenwich sidereal time
+	//! @details Used when many satellites are propagated to the same epoch, so
+	//! that the sidereal time is computed once for all of them.
+	//! @param[in] 	ai_time double variable storing the compute epoch time in Julian Days.
+	//! @param[in] 	ai_thetaGMST gTime(ai_time).toThetaGMST()
+	void setEpoch(double ai_time, double ai_thetaGMST);
+
 	// Operation: setMinSinceKepEpoch( double ai_minSinceKepEpoch)
 	//! @brief Set compute epoch for prediction in minutes since Keplerian data Epoch
 	//! @param[in] 	ai_minSinceKepEpoch Time since Keplerian Epoch measured in minutes
@@ -91,7 +99,7 @@ public:
 	//!    x: position[0]
 	//!    y: position[1]
 	//!    z: position[2]
-	gVector getPos()
+	const gVector& getPos() const
 	{
 		return m_Position;
 	}
@@ -102,7 +110,7 @@ public:
 	//!    x: Vel[0]\n
 	//!    y: Vel[1]\n
 	//!    z: Vel[2]\n
-	gVector getVel()
+	const gVector& getVel() const
 	{
 		return m_Vel;
 	}
@@ -119,7 +127,7 @@ public:
 	//!    Latitude:  Coord[0]  measured in degrees\n
 	//!    Longitude: Coord[1]  measured in degrees\n
 	//!	   Altitude:  Coord[2]  measured in Km.\n
-	gVector getSubPoint()
+	const gVector& getSubPoint() const
 	{
 		return m_SubPoint;
 	}
@@ -135,13 +143,12 @@ private:
 	//! @details To implement this operation, next references has been used:
 	//!	   Orbital Coordinate Systems, Part III  By Dr. T.S. Kelso
 	//!	   http://www.celestrak.com/columns/v02n03/
-	//! @param[in] ai_Time Epoch time for subpoint calculation. (of course, this must be
-	//!    refactorized to be computed in the setEpoch function)
+	//! @param[in] ai_thetaGMST Greenwich sidereal time of the epoch, in radians.
 	//! @return gVector Geographical coordinates\n
 	//!    Latitude:  Coord[0]  measured in degrees\n
 	//!    Longitude: Coord[1]  measured in degrees\n
 	//!	   Altitude:  Coord[2]  measured in Km.\n
-	gVector computeSubPoint( gTime ai_time);
+	gVector computeSubPoint(double ai_thetaGMST);
 
 
 	// sgp4 proceses variables
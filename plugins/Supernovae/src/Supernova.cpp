@@ -62,6 +62,7 @@ Supernova::Supernova(const QVariantMap& map)
 	snde = StelUtils::getDecAngle(map.value("delta").toString());
 	note = map.value("note").toString();
 	distance = map.value("distance").toDouble();
+	StelUtils::spheToRect(snra, snde, XYZ);
 
 	initialized = true;
 }
@@ -238,9 +239,7 @@ void Supernova::draw(StelCore* core, StelPainter& painter)
 	float size, shift;
 	double mag;
 
-	StelUtils::spheToRect(snra, snde, XYZ);
 	mag = getVMagnitudeWithExtinction(core);
-	sd->preDrawPointSource(&painter);
 	float mlimit = sd->getLimitMagnitude();
 	
 	if (mag <= mlimit)
@@ -255,6 +254,4 @@ void Supernova::draw(StelCore* core, StelPainter& painter)
 			painter.drawText(XYZ, designation, 0, shift, shift, false);
 		}
 	}
-
-	sd->postDrawPointSource(&painter);
 }
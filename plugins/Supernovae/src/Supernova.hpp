@@ -78,6 +78,7 @@ private:
 
 	static StelTextureSP hintTexture;
 
+	//! Draw the supernova. The point sources of the sky drawer must be prepared.
 	void draw(StelCore* core, StelPainter& painter);
 
 	// Supernova
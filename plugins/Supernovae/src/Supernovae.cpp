@@ -26,7 +26,8 @@
 #include "StelModuleMgr.hpp"
 #include "StelObjectMgr.hpp"
 #include "StelTextureMgr.hpp"
-#include "StelJsonParser.hpp"
+#include "StelSkyDrawer.hpp"
+#include "StelJsonCache.hpp"
 #include "StelFileMgr.hpp"
 #include "StelUtils.hpp"
 #include "StelTranslator.hpp"
@@ -199,12 +200,13 @@ void Supernovae::draw(StelCore* core)
 	StelProjectorP prj = core->getProjection(StelCore::FrameJ2000);
 	StelPainter painter(prj);
 	painter.setFont(font);
-	
-	foreach (const SupernovaP& sn, snstar)
-	{
-		if (sn && sn->initialized)
-			sn->draw(core, painter);
-	}
+	StelSkyDrawer* sd = core->getSkyDrawer();
+
+	// All the point sources are drawn in one batch
+	sd->preDrawPointSource(&painter);
+	foreach (int i, catalog.findVisible(core, prj))
+		snstar.at(i)->draw(core, painter);
+	sd->postDrawPointSource(&painter);
 
 	if (GETSTELMODULE(StelObjectMgr)->getFlagSelectedObjectPointer())
 		drawPointer(core, painter);
@@ -234,27 +236,12 @@ void Supernovae::drawPointer(StelCore* core, StelPainter& painter)
 	}
 }
 
-QList<StelObjectP> Supernovae::searchAround(const Vec3d& av, double limitFov, const StelCore*) const
+QList<StelObjectP> Supernovae::searchAround(const Vec3d& av, double limitFov, const StelCore* core) const
 {
 	QList<StelObjectP> result;
 
-	Vec3d v(av);
-	v.normalize();
-	double cosLimFov = cos(limitFov * M_PI/180.);
-	Vec3d equPos;
-
-	foreach(const SupernovaP& sn, snstar)
-	{
-		if (sn->initialized)
-		{
-			equPos = sn->XYZ;
-			equPos.normalize();
-			if (equPos[0]*v[0] + equPos[1]*v[1] + equPos[2]*v[2]>=cosLimFov)
-			{
-				result.append(qSharedPointerCast<StelObject>(sn));
-			}
-		}
-	}
+	foreach(int i, catalog.findAround(core, av, limitFov))
+		result.append(qSharedPointerCast<StelObject>(snstar.at(i)));
 
 	return result;
 }
@@ -388,7 +375,7 @@ QVariantMap Supernovae::loadSNeMap(QString path)
 		qWarning() << "[Supernovae] cannot open" << QDir::toNativeSeparators(path);
 	else
 	{
-		map = StelJsonParser::parse(jsonFile.readAll()).toMap();
+		map = StelJsonCache::load(path);
 		jsonFile.close();
 	}
 	return map;
@@ -416,6 +403,11 @@ void Supernovae::setSNeMap(const QVariantMap& map)
 			snstar.append(sn);
 
 	}
+
+	QVector<Vec3d> positions;
+	foreach(const SupernovaP& sn, snstar)
+		positions.append(sn->XYZ);
+	catalog.setPositions(StelApp::getInstance().getCore(), positions);
 }
 
 int Supernovae::getJsonFileVersion(void)
@@ -429,7 +421,7 @@ int Supernovae::getJsonFileVersion(void)
 	}
 
 	QVariantMap map;
-	map = StelJsonParser::parse(&sneJsonFile).toMap();
+	map = StelJsonCache::load(sneJsonPath, QStringList("version"));
 	if (map.contains("version"))
 	{
 		jsonVersion = map.value("version").toInt();
@@ -452,7 +444,7 @@ bool Supernovae::checkJsonFileFormat()
 	QVariantMap map;
 	try
 	{
-		map = StelJsonParser::parse(&sneJsonFile).toMap();
+		map = StelJsonCache::load(sneJsonPath, QStringList("version"));
 		sneJsonFile.close();
 	}
 	catch (std::runtime_error& e)
@@ -475,7 +467,7 @@ float Supernovae::getLowerLimitBrightness()
 	}
 
 	QVariantMap map;
-	map = StelJsonParser::parse(&sneJsonFile).toMap();
+	map = StelJsonCache::load(sneJsonPath, QStringList("limit"));
 	if (map.contains("limit"))
 	{
 		lowerLimit = map.value("limit").toFloat();
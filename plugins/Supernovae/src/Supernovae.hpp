@@ -23,6 +23,7 @@
 #include "StelObject.hpp"
 #include "StelFader.hpp"
 #include "StelTextureTypes.hpp"
+#include "StelPointCatalog.hpp"
 #include "Supernova.hpp"
 #include <QFont>
 #include <QVariantMap>
@@ -218,6 +219,8 @@ private:
 
 	StelTextureSP texPointer;
 	QList<SupernovaP> snstar;
+	//! Positions of snstar, for drawing and searching
+	StelPointCatalog catalog;
 	QHash<QString, double> snlist;
 
 	// variables and functions for the updater
@@ -58,6 +58,7 @@
 #include <QStringList>
 #include <QDir>
 #include <QSignalMapper>
+#include <QThread>
 
 #include <QDebug>
 
@@ -87,6 +88,7 @@ StelPluginInfo TelescopeControlStelPluginInterface::getPluginInfo() const
 // Constructor and destructor
 TelescopeControl::TelescopeControl()
 	: toolbarButton(NULL)
+	, ioThread(NULL)
 	, useTelescopeServerLogs(false)
 	, useServerExecutables(false)
 	, telescopeDialog(NULL)
@@ -113,6 +115,10 @@ TelescopeControl::~TelescopeControl()
 // init(), update(), draw(),  getCallOrder()
 void TelescopeControl::init()
 {
+	ioThread = new QThread(this);
+	ioThread->setObjectName("TelescopeControl I/O");
+	ioThread->start();
+
 	//TODO: I think I've overdone the try/catch...
 	try
 	{
@@ -230,6 +236,11 @@ void TelescopeControl::deinit()
 {
 	//Destroy all clients first in order to avoid displaying a TCP error
 	deleteAllTelescopes();
+	if (ioThread)
+	{
+		ioThread->quit();
+		ioThread->wait();
+	}
 
 	QHash<int, QProcess*>::const_iterator iterator = telescopeServerProcess.constBegin();
 	while(iterator != telescopeServerProcess.constEnd())
@@ -440,19 +451,16 @@ void TelescopeControl::telescopeGoto(int slotNumber, const Vec3d &j2000Pos)
 
 void TelescopeControl::communicate(void)
 {
-	if (!telescopeClients.empty())
-	{
-		QMap<int, TelescopeClientP>::const_iterator telescope = telescopeClients.constBegin();
-		while (telescope != telescopeClients.end())
-		{
-			logAtSlot(telescope.key());//If there's no log, it will be ignored
-			if(telescope.value()->prepareCommunication())
-			{
-				telescope.value()->performCommunication();
-			}
-			telescope++;
-		}
-	}
+	// The communication itself is performed in the I/O thread
+	foreach (const TelescopeClientP& telescope, telescopeClients)
+		telescope->updatePosition();
+}
+
+void TelescopeControl::stopCommunication(const TelescopeClientP& telescope)
+{
+	// The client only lives in the I/O thread while it is running
+	if (ioThread && ioThread->isRunning())
+		QMetaObject::invokeMethod(telescope.data(), "stopCommunication", Qt::BlockingQueuedConnection);
 }
 
 
@@ -464,6 +472,8 @@ void TelescopeControl::deleteAllTelescopes()
 	//TODO: I really hope that this won't cause a memory leak...
 	//foreach (TelescopeClient* telescope, telescopeClients)
 	//	delete telescope;
+	foreach (const TelescopeClientP& telescope, telescopeClients)
+		stopCommunication(telescope);
 	telescopeClients.clear();
 }
 
@@ -1253,7 +1263,12 @@ bool TelescopeControl::startClientAtSlot(int slotNumber, ConnectionType connecti
 			for (int i = 0; i < circles.size(); ++i)
 				newTelescope->addOcular(circles[i]);
 
+		//From now on, the log of the slot is only used by the I/O thread
+		addLogAtSlot(slotNumber);
+		newTelescope->setLogStream(telescopeServerLogStreams.value(slotNumber));
 		telescopeClients.insert(slotNumber, TelescopeClientP(newTelescope));
+		newTelescope->moveToThread(ioThread);
+		QMetaObject::invokeMethod(newTelescope, "startCommunication", Qt::QueuedConnection);
 		return true;
 	}
 
@@ -1278,6 +1293,7 @@ bool TelescopeControl::stopClientAtSlot(int slotNumber)
 	{
 		GETSTELMODULE(StelObjectMgr)->unSelect();
 	}
+	stopCommunication(telescopeClients.value(slotNumber));
 	telescopeClients.remove(slotNumber);
 
 	//This is not needed by every client
@@ -1560,6 +1576,6 @@ void TelescopeControl::removeLogAtSlot(int slot)
 void TelescopeControl::logAtSlot(int slot)
 {
 	if(telescopeServerLogStreams.contains(slot))
-		log_file = telescopeServerLogStreams.value(slot);
+		setLogFile(telescopeServerLogStreams.value(slot));
 }
 
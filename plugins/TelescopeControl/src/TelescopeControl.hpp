@@ -48,6 +48,7 @@
 #include <QTextStream>
 #include <QVariant>
 
+class QThread;
 class StelObject;
 class StelPainter;
 class StelProjector;
@@ -279,8 +280,10 @@ private:
 	//! Draw a nice animated pointer around the object if it's selected
 	void drawPointer(const StelProjectorP& prj, const StelCore* core, StelPainter& sPainter);
 
-	//! Perform the communication with the telescope servers
+	//! Update the positions of the telescopes with the positions received by the I/O thread
 	void communicate(void);
+	//! Stop the communication of a client in the I/O thread, so that it can be deleted
+	void stopCommunication(const TelescopeClientP& telescope);
 	
 	LinearFader labelFader;
 	LinearFader reticleFader;
@@ -305,6 +308,8 @@ private:
 	
 	//! Contains the initialized telescope client objects representing the telescopes that Stellarium is connected to or attempting to connect to.
 	QMap<int, TelescopeClientP> telescopeClients;
+	//! Thread in which the clients communicate with the telescopes, so that the rendering is not blocked.
+	QThread* ioThread;
 	//! Contains QProcess objects of the currently running telescope server processes that have been launched by Stellarium.
 	QHash<int, QProcess*> telescopeServerProcess;
 	QStringList telescopeServers;
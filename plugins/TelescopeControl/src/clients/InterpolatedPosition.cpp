@@ -25,6 +25,12 @@
 
 #include "InterpolatedPosition.hpp"
 
+#ifdef Q_OS_WIN
+	#include <windows.h> // GetSystemTimeAsFileTime()
+#else
+	#include <sys/time.h>
+#endif
+
 InterpolatedPosition::InterpolatedPosition() :
 		end_position(positions+(sizeof(positions)/sizeof(positions[0])))
 {
@@ -71,6 +77,12 @@ Vec3d InterpolatedPosition::get(qint64 now) const
 		return Vec3d(0,0,0);
 	}
 
+	// After the last position, e.g. without time delay
+	if (now >= position_pointer->client_micros)
+	{
+		return Vec3d(position_pointer->pos);
+	}
+
 	const Position *p = position_pointer;
 	do
 	{
@@ -97,3 +109,27 @@ Vec3d InterpolatedPosition::get(qint64 now) const
 
 	return Vec3d(p->pos);
 }
+
+//! returns the current system time in microseconds since the Epoch
+//! Prior to revision 6308, it was necessary to put put this method in an
+//! #ifdef block, as duplicate function definition caused errors during static
+//! linking.
+qint64 getNow(void)
+{
+// At the moment this can't be done in a platform-independent way with Qt
+// (QDateTime and QTime don't support microsecond precision)
+	qint64 t;
+	//StelCore *core = StelApp::getInstance().getCore();
+#ifdef Q_OS_WIN
+	FILETIME file_time;
+	GetSystemTimeAsFileTime(&file_time);
+	t = (*((__int64*)(&file_time))/10) - 86400000000LL*134774;
+#else
+	struct timeval tv;
+	gettimeofday(&tv,0);
+	t = tv.tv_sec * 1000000LL + tv.tv_usec;
+#endif
+	// GZ JDfix for 0.14 I am 99.9% sure we no longer need the anti-correction
+	//return t - core->getDeltaT(StelUtils::getJDFromSystem())*1000000; // Delta T anti-correction
+	return t;
+}
@@ -32,6 +32,9 @@
 
 #include "VecMath.hpp"
 
+//! The current system time in microseconds since the Epoch, the time of the positions.
+qint64 getNow(void);
+
 //! A telescope's position at a given time.
 //! This structure used to be defined inline in TelescopeTCP.
 struct Position
@@ -0,0 +1,69 @@
+/*
+ * Stellarium Telescope Control Plug-in
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _SINGLE_PRODUCER_QUEUE_HPP_
+#define _SINGLE_PRODUCER_QUEUE_HPP_
+
+#include <QAtomicInt>
+
+//! A lock-free FIFO queue between two threads, holding up to Size-1 elements.
+//! Only one thread may call push() and only one thread may call pop().
+//! TelescopeClient uses it to pass the positions received by the I/O thread
+//! to the main thread, and the GOTO commands the other way.
+template<class T, int Size> class SingleProducerQueue
+{
+public:
+	SingleProducerQueue() : head(0), tail(0) {}
+
+	//! Called by the producer thread.
+	//! @return false if the queue is full, the value is then dropped.
+	bool push(const T& value)
+	{
+		// Only the producer writes tail
+		const int t = tail.load();
+		const int next = (t+1) % Size;
+		if (next == head.loadAcquire())
+			return false;
+		elements[t] = value;
+		tail.storeRelease(next);
+		return true;
+	}
+
+	//! Called by the consumer thread.
+	//! @return false if the queue is empty.
+	bool pop(T& value)
+	{
+		// Only the consumer writes head
+		const int h = head.load();
+		if (h == tail.loadAcquire())
+			return false;
+		value = elements[h];
+		head.storeRelease((h+1) % Size);
+		return true;
+	}
+
+	bool isEmpty() const {return head.loadAcquire() == tail.loadAcquire();}
+
+private:
+	T elements[Size];
+	QAtomicInt head; // next element to pop
+	QAtomicInt tail; // next element to push
+};
+
+#endif // _SINGLE_PRODUCER_QUEUE_HPP_
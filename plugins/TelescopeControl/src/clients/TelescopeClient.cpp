@@ -26,6 +26,7 @@
 #include "TelescopeClient.hpp"
 #include "TelescopeClientDirectLx200.hpp"
 #include "TelescopeClientDirectNexStar.hpp"
+#include "LogFile.hpp"
 #include "StelUtils.hpp"
 #include "StelTranslator.hpp"
 #include "StelCore.hpp"
@@ -35,16 +36,18 @@
 #include <QDebug>
 #include <QHostAddress>
 #include <QHostInfo>
+#include <QCoreApplication>
 #include <QRegExp>
+#include <QSocketNotifier>
 #include <QString>
 #include <QTcpSocket>
 #include <QTextStream>
+#include <QThread>
+#include <QTimer>
 
-#ifdef Q_OS_WIN
-	#include <windows.h> // GetSystemTimeAsFileTime()
-#else
-	#include <sys/time.h>
-#endif
+// Interval of the communication steps of the I/O thread [ms], about one frame.
+// The data received are handled as soon as they arrive.
+static const int communicationInterval = 20;
 
 
 TelescopeClient *TelescopeClient::create(const QString &url)
@@ -116,11 +119,149 @@ TelescopeClient *TelescopeClient::create(const QString &url)
 }
 
 
-TelescopeClient::TelescopeClient(const QString &name) : name(name)
+TelescopeClient::TelescopeClient(const QString &name, Equinox eq)
+	: name(name)
+	, equinox(eq)
+	, time_delay(0)
+	, connected(0)
+	, timer(NULL)
+	, notifier(NULL)
+	, watchedDescriptor(-1)
+	, logStream(NULL)
 {
 	nameI18n = name;
 }
 
+//! estimates where the telescope is by interpolation in the stored
+//! telescope positions:
+Vec3d TelescopeClient::getJ2000EquatorialPos(const StelCore*) const
+{
+	const qint64 now = getNow() - time_delay;
+	return interpolatedPosition.get(now);
+}
+
+void TelescopeClient::telescopeGoto(const Vec3d &j2000Pos)
+{
+	if (!isConnected())
+		return;
+
+	Vec3d position = j2000Pos;
+	if (equinox == EquinoxJNow)
+	{
+		const StelCore* core = StelApp::getInstance().getCore();
+		position = core->j2000ToEquinoxEqu(j2000Pos);
+	}
+	if (!gotoQueue.push(position))
+	{
+		qDebug() << "TelescopeClient(" << name << ")::telescopeGoto: "<< "communication is too slow, I will ignore this command";
+		return;
+	}
+	// Send it now rather than at the next step
+	QMetaObject::invokeMethod(this, "communicate", Qt::QueuedConnection);
+}
+
+void TelescopeClient::updatePosition(void)
+{
+	Position position;
+	while (positionQueue.pop(position))
+	{
+		if (position.client_micros == INT64_MAX)
+		{
+			interpolatedPosition.reset();
+			continue;
+		}
+		if (equinox == EquinoxJNow)
+		{
+			const StelCore* core = StelApp::getInstance().getCore();
+			position.pos = core->equinoxEquToJ2000(position.pos);
+		}
+		interpolatedPosition.add(position.pos, position.client_micros, position.server_micros, position.status);
+	}
+}
+
+void TelescopeClient::publishPosition(const Vec3d &position, qint64 serverTime, int status)
+{
+	Position p;
+	p.pos = position;
+	p.server_micros = serverTime;
+	p.client_micros = getNow();
+	p.status = status;
+	if (!positionQueue.push(p))
+		qDebug() << "TelescopeClient(" << name << ")::publishPosition: "<< "the main thread is too slow, I will ignore this position";
+}
+
+void TelescopeClient::resetPosition(void)
+{
+	Position p;
+	p.pos.set(0., 0., 0.);
+	p.server_micros = INT64_MAX;
+	p.client_micros = INT64_MAX;
+	p.status = 0;
+	positionQueue.push(p);
+}
+
+void TelescopeClient::watchDescriptor(int fd)
+{
+#ifdef Q_OS_WIN
+	Q_UNUSED(fd);
+#else
+	watchedDescriptor = fd;
+#endif
+}
+
+void TelescopeClient::startCommunication(void)
+{
+	Q_ASSERT(thread() == QThread::currentThread());
+	setLogFile(logStream);
+	timer = new QTimer(this);
+	connect(timer, SIGNAL(timeout()), this, SLOT(communicate()));
+	timer->start(communicationInterval);
+	if (watchedDescriptor >= 0)
+	{
+		notifier = new QSocketNotifier(watchedDescriptor, QSocketNotifier::Read, this);
+		connect(notifier, SIGNAL(activated(int)), this, SLOT(communicate()));
+	}
+	communicate();
+}
+
+void TelescopeClient::stopCommunication(void)
+{
+	Q_ASSERT(thread() == QThread::currentThread());
+	delete timer;
+	timer = NULL;
+	delete notifier;
+	notifier = NULL;
+	setLogFile(logStream);
+	closeConnection();
+	connected.storeRelease(0);
+	moveToThread(QCoreApplication::instance()->thread());
+}
+
+void TelescopeClient::communicate(void)
+{
+	// A GOTO command may still be queued after the end of the communication
+	if (!timer)
+		return;
+
+	setLogFile(logStream);
+
+	const bool ready = prepareCommunication();
+	Vec3d position;
+	while (gotoQueue.pop(position))
+	{
+		if (ready)
+			performGoto(position);
+	}
+	if (ready)
+		performCommunication();
+
+	const bool open = isConnectionOpen();
+	connected.storeRelease(open ? 1 : 0);
+	// A closed descriptor would be reported as readable forever
+	if (notifier && !open)
+		notifier->setEnabled(false);
+}
+
 QString TelescopeClient::getInfoString(const StelCore* core, const InfoStringGroup& flags) const
 {
 	QString str;
@@ -137,40 +278,10 @@ QString TelescopeClient::getInfoString(const StelCore* core, const InfoStringGro
 	return str;
 }
 
-//! returns the current system time in microseconds since the Epoch
-//! Prior to revision 6308, it was necessary to put put this method in an
-//! #ifdef block, as duplicate function definition caused errors during static
-//! linking.
-qint64 getNow(void)
-{
-// At the moment this can't be done in a platform-independent way with Qt
-// (QDateTime and QTime don't support microsecond precision)
-	qint64 t;
-	//StelCore *core = StelApp::getInstance().getCore();
-#ifdef Q_OS_WIN
-	FILETIME file_time;
-	GetSystemTimeAsFileTime(&file_time);
-	t = (*((__int64*)(&file_time))/10) - 86400000000LL*134774;
-#else
-	struct timeval tv;
-	gettimeofday(&tv,0);
-	t = tv.tv_sec * 1000000LL + tv.tv_usec;
-#endif
-	// GZ JDfix for 0.14 I am 99.9% sure we no longer need the anti-correction
-	//return t - core->getDeltaT(StelUtils::getJDFromSystem())*1000000; // Delta T anti-correction
-	return t;
-}
-
 TelescopeTCP::TelescopeTCP(const QString &name, const QString &params, Equinox eq)
-	: TelescopeClient(name)
-	, port(0)
-	, tcpSocket(new QTcpSocket())
-	, end_of_timeout(0)
-	, time_delay(0)
-	, equinox(eq)
+	: TelescopeClient(name, eq)
+	, connection(NULL)
 {
-	hangup();
-	
 	// Example params:
 	// localhost:10000:500000
 	// split into:
@@ -180,6 +291,7 @@ TelescopeTCP::TelescopeTCP(const QString &name, const QString &params, Equinox e
 
 	QRegExp paramRx("^([^:]*):(\\d+):(\\d+)$");
 	QString host;
+	int port = 0;
 
 	if (paramRx.exactMatch(params))
 	{
@@ -218,6 +330,7 @@ TelescopeTCP::TelescopeTCP(const QString &name, const QString &params, Equinox e
 	}
 	//BM: is info.addresses().isEmpty() if there's no error?
 	//qDebug() << "TelescopeClient::create(): Host addresses:" << info.addresses();
+	QHostAddress address;
 	foreach(const QHostAddress& resolvedAddress, info.addresses())
 	{
 		//For now, Stellarium's telescope servers support only IPv4
@@ -233,299 +346,19 @@ TelescopeTCP::TelescopeTCP(const QString &name, const QString &params, Equinox e
 		return;
 	}
 	
-	end_of_timeout = -0x8000000000000000LL;
-	
-	interpolatedPosition.reset();
-	
-	connect(tcpSocket, SIGNAL(connected()), this, SLOT(socketConnected()));
-	connect(tcpSocket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(socketFailed(QAbstractSocket::SocketError)));
-}
-
-void TelescopeTCP::hangup(void)
-{
-	if (tcpSocket->isValid())
-	{
-		tcpSocket->abort();// Or maybe tcpSocket->close()?
-	}
-	
-	readBufferEnd = readBuffer;
-	writeBufferEnd = writeBuffer;
-	wait_for_connection_establishment = false;
-	
-	interpolatedPosition.reset();
-}
-
-//! queues a GOTO command with the specified position to the write buffer.
-//! For the data format of the command see the
-//! "Stellarium telescope control protocol" text file
-void TelescopeTCP::telescopeGoto(const Vec3d &j2000Pos)
-{
-	if (!isConnected())
-		return;
-
-	Vec3d position = j2000Pos;
-	if (equinox == EquinoxJNow)
-	{
-		const StelCore* core = StelApp::getInstance().getCore();
-		position = core->j2000ToEquinoxEqu(j2000Pos);
-	}
-
-	if (writeBufferEnd - writeBuffer + 20 < (int)sizeof(writeBuffer))
-	{
-		const double ra_signed = atan2(position[1], position[0]);
-		//Workaround for the discrepancy in precision between Windows/Linux/PPC Macs and Intel Macs:
-		const double ra = (ra_signed >= 0) ? ra_signed : (ra_signed + 2.0 * M_PI);
-		const double dec = atan2(position[2], std::sqrt(position[0]*position[0]+position[1]*position[1]));
-		unsigned int ra_int = (unsigned int)floor(0.5 + ra*(((unsigned int)0x80000000)/M_PI));
-		int dec_int = (int)floor(0.5 + dec*(((unsigned int)0x80000000)/M_PI));
-		// length of packet:
-		*writeBufferEnd++ = 20;
-		*writeBufferEnd++ = 0;
-		// type of packet:
-		*writeBufferEnd++ = 0;
-		*writeBufferEnd++ = 0;
-		// client_micros:
-		qint64 now = getNow();
-		*writeBufferEnd++ = now;
-		now>>=8;
-		*writeBufferEnd++ = now;
-		now>>=8;
-		*writeBufferEnd++ = now;
-		now>>=8;
-		*writeBufferEnd++ = now;
-		now>>=8;
-		*writeBufferEnd++ = now;
-		now>>=8;
-		*writeBufferEnd++ = now;
-		now>>=8;
-		*writeBufferEnd++ = now;
-		now>>=8;
-		*writeBufferEnd++ = now;
-		// ra:
-		*writeBufferEnd++ = ra_int;
-		ra_int>>=8;
-		*writeBufferEnd++ = ra_int;
-		ra_int>>=8;
-		*writeBufferEnd++ = ra_int;
-		ra_int>>=8;
-		*writeBufferEnd++ = ra_int;
-		// dec:
-		*writeBufferEnd++ = dec_int;
-		dec_int>>=8;
-		*writeBufferEnd++ = dec_int;
-		dec_int>>=8;
-		*writeBufferEnd++ = dec_int;
-		dec_int>>=8;
-		*writeBufferEnd++ = dec_int;
-	}
-	else
-	{
-		qDebug() << "TelescopeTCP(" << name << ")::telescopeGoto: "<< "communication is too slow, I will ignore this command";
-	}
-}
-
-void TelescopeTCP::performWriting(void)
-{
-	const int to_write = writeBufferEnd - writeBuffer;
-	const int rc = tcpSocket->write(writeBuffer, to_write);
-	if (rc < 0)
-	{
-		//TODO: Better error message. See the Qt documentation.
-		qDebug() << "TelescopeTCP(" << name << ")::performWriting: "
-			<< "write failed: " << tcpSocket->errorString();
-		hangup();
-	}
-	else if (rc > 0)
-	{
-		if (rc >= to_write)
-		{
-			// everything written
-			writeBufferEnd = writeBuffer;
-		}
-		else
-		{
-			// partly written
-			memmove(writeBuffer, writeBuffer + rc, to_write - rc);
-			writeBufferEnd -= rc;
-		}
-	}
-}
-
-//! try to read some data from the telescope server
-void TelescopeTCP::performReading(void)
-{
-	const int to_read = readBuffer + sizeof(readBuffer) - readBufferEnd;
-	const int rc = tcpSocket->read(readBufferEnd, to_read);
-	if (rc < 0)
-	{
-		//TODO: Better error warning. See the Qt documentation.
-		qDebug() << "TelescopeTCP(" << name << ")::performReading: " << "read failed: " << tcpSocket->errorString();
-		hangup();
-	}
-	else if (rc == 0)
-	{
-		qDebug() << "TelescopeTCP(" << name << ")::performReading: " << "server has closed the connection";
-		hangup();
-	}
-	else
-	{
-		readBufferEnd += rc;
-		char *p = readBuffer;
-		// parse the data in the read buffer:
-		while (readBufferEnd - p >= 2)
-		{
-			const int size = (int)(((unsigned char)(p[0])) | (((unsigned int)(unsigned char)(p[1])) << 8));
-			if (size > (int)sizeof(readBuffer) || size < 4)
-			{
-				qDebug() << "TelescopeTCP(" << name << ")::performReading: " << "bad packet size: " << size;
-				hangup();
-				return;
-			}
-			if (size > readBufferEnd - p)
-			{
-				// wait for complete packet
-				break;
-			}
-			const int type = (int)(((unsigned char)(p[2])) | (((unsigned int)(unsigned char)(p[3])) << 8));
-			// dispatch:
-			switch (type)
-			{
-				case 0:
-				{
-				// We have received position information.
-				// For the data format of the message see the
-				// "Stellarium telescope control protocol"
-					if (size < 24)
-					{
-						qDebug() << "TelescopeTCP(" << name << ")::performReading: " << "type 0: bad packet size: " << size;
-						hangup();
-						return;
-					}
-					const qint64 server_micros = (qint64)
-						(((quint64)(unsigned char)(p[ 4])) |
-						(((quint64)(unsigned char)(p[ 5])) <<  8) |
-						(((quint64)(unsigned char)(p[ 6])) << 16) |
-						(((quint64)(unsigned char)(p[ 7])) << 24) |
-						(((quint64)(unsigned char)(p[ 8])) << 32) |
-						(((quint64)(unsigned char)(p[ 9])) << 40) |
-						(((quint64)(unsigned char)(p[10])) << 48) |
-						(((quint64)(unsigned char)(p[11])) << 56));
-					const unsigned int ra_int =
-						((unsigned int)(unsigned char)(p[12])) |
-						(((unsigned int)(unsigned char)(p[13])) <<  8) |
-						(((unsigned int)(unsigned char)(p[14])) << 16) |
-						(((unsigned int)(unsigned char)(p[15])) << 24);
-					const int dec_int =
-						(int)(((unsigned int)(unsigned char)(p[16])) |
-						     (((unsigned int)(unsigned char)(p[17])) <<  8) |
-						     (((unsigned int)(unsigned char)(p[18])) << 16) |
-						     (((unsigned int)(unsigned char)(p[19])) << 24));
-					const int status =
-						(int)(((unsigned int)(unsigned char)(p[20])) |
-						     (((unsigned int)(unsigned char)(p[21])) <<  8) |
-						     (((unsigned int)(unsigned char)(p[22])) << 16) |
-						     (((unsigned int)(unsigned char)(p[23])) << 24));
-
-					const double ra  =  ra_int * (M_PI/(unsigned int)0x80000000);
-					const double dec = dec_int * (M_PI/(unsigned int)0x80000000);
-					const double cdec = cos(dec);
-					Vec3d position(cos(ra)*cdec, sin(ra)*cdec, sin(dec));
-					Vec3d j2000Position = position;
-					if (equinox == EquinoxJNow)
-					{
-						const StelCore* core = StelApp::getInstance().getCore();
-						j2000Position = core->equinoxEquToJ2000(position);
-					}
-					interpolatedPosition.add(j2000Position, getNow(), server_micros, status);
-				}
-				break;
-				default:
-					qDebug() << "TelescopeTCP(" << name << ")::performReading: " << "ignoring unknown packet, type: " << type;
-				break;
-			}
-			p += size;
-		}
-		if (p >= readBufferEnd)
-		{
-			// everything handled
-			readBufferEnd = readBuffer;
-		}
-		else
-		{
-			// partly handled
-			memmove(readBuffer, p, readBufferEnd - p);
-			readBufferEnd -= (p - readBuffer);
-		}
-	}
-}
-
-//! estimates where the telescope is by interpolation in the stored
-//! telescope positions:
-Vec3d TelescopeTCP::getJ2000EquatorialPos(const StelCore*) const
-{
-	const qint64 now = getNow() - time_delay;
-	return interpolatedPosition.get(now);
-}
-
-//! checks if the socket is connected, tries to connect if it is not
-//@return true if the socket is connected
-bool TelescopeTCP::prepareCommunication()
-{
-	if(tcpSocket->state() == QAbstractSocket::ConnectedState)
-	{
-		if(wait_for_connection_establishment)
-		{
-			wait_for_connection_establishment = false;
-			qDebug() << "TelescopeTCP(" << name << ")::prepareCommunication: Connection established";
-		}
-		return true;
-	}
-	else if(wait_for_connection_establishment)
-	{
-		const qint64 now = getNow();
-		if (now > end_of_timeout)
-		{
-			end_of_timeout = now + 1000000;
-			qDebug() << "TelescopeTCP(" << name << ")::prepareCommunication: Connection attempt timed out";
-			hangup();
-		}
-	}
-	else
-	{
-		const qint64 now = getNow();
-		if (now < end_of_timeout) 
-			return false; //Don't try to reconnect for some time
-		end_of_timeout = now + 5000000;
-		tcpSocket->connectToHost(address, port);
-		wait_for_connection_establishment = true;
-		qDebug() << "TelescopeTCP(" << name << ")::prepareCommunication: Attempting to connect to host" << address.toString() << "at port" << port;
-	}
-	return false;
-}
-
-void TelescopeTCP::performCommunication()
-{
-	if (tcpSocket->state() == QAbstractSocket::ConnectedState)
-	{
-		performWriting();
-		
-		if (tcpSocket->bytesAvailable() > 0)
-		{
-			//If performReading() is called when there are no bytes to read,
-			//it closes the connection
-			performReading();
-		}
-	}
+	// A child, so that it is moved to the I/O thread with the client
+	connection = new TelescopeTCPConnection(name, address, port, this);
+	connect(connection, SIGNAL(readyRead()), this, SLOT(communicate()));
+	connect(connection, SIGNAL(positionReceived(Vec3d,qint64,int)), this, SLOT(receivePosition(Vec3d,qint64,int)));
+	connect(connection, SIGNAL(connectionReset()), this, SLOT(forgetPosition()));
 }
 
-void TelescopeTCP::socketConnected(void)
+void TelescopeTCP::receivePosition(const Vec3d &position, qint64 serverTime, int status)
 {
-	qDebug() << "TelescopeTCP(" << name <<"): turning off Nagle algorithm.";
-	tcpSocket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+	publishPosition(position, serverTime, status);
 }
 
-//TODO: More informative error messages?
-void TelescopeTCP::socketFailed(QAbstractSocket::SocketError)
+void TelescopeTCP::forgetPosition(void)
 {
-	qDebug() << "TelescopeTCP(" << name << "): TCP socket error:\n" << tcpSocket->errorString();
+	resetPosition();
 }
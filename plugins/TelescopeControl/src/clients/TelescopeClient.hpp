@@ -26,6 +26,7 @@
 #ifndef _TELESCOPE_HPP_
 #define _TELESCOPE_HPP_
 
+#include <QAtomicInt>
 #include <QHostAddress>
 #include <QHostInfo>
 #include <QList>
@@ -36,11 +37,14 @@
 #include "StelApp.hpp"
 #include "StelObject.hpp"
 #include "InterpolatedPosition.hpp"
+#include "SingleProducerQueue.hpp"
+#include "TelescopeTCPConnection.hpp"
 
+class QSocketNotifier;
+class QTextStream;
+class QTimer;
 class StelCore;
 
-qint64 getNow(void);
-
 enum Equinox {
 	EquinoxJ2000,
 	EquinoxJNow
@@ -50,6 +54,12 @@ enum Equinox {
 //! This class used to be called Telescope, but it has been renamed
 //! to TelescopeClient in order to resolve a compiler/linker conflict
 //! with the identically named Telescope class in Stellarium's main code.
+//! The clients are created in the main thread, then TelescopeControl moves them
+//! to its I/O thread, where they communicate with the telescopes without blocking
+//! the rendering. The public methods are called in the main thread: the GOTO
+//! commands and the positions received from the telescope pass between the
+//! threads through lock-free queues, and the state of the connection is atomic.
+//! The protected virtual methods are only called in the I/O thread.
 class TelescopeClient : public QObject, public StelObject
 {
 	Q_OBJECT
@@ -74,27 +84,89 @@ public:
 	//! @return a QString containing an HMTL encoded description of the Telescope.
 	QString getInfoString(const StelCore* core, const InfoStringGroup& flags) const;
 	QString getType(void) const {return "Telescope";}
+	//! Estimates where the telescope is by interpolation in the received positions.
+	Vec3d getJ2000EquatorialPos(const StelCore* core=0) const;
 	virtual double getAngularSize(const StelCore*) const {Q_ASSERT(0); return 0;}	// TODO
 		
 	// Methods specific to telescope
-	virtual void telescopeGoto(const Vec3d &j2000Pos) = 0;
-	virtual bool isConnected(void) const = 0;
-	virtual bool hasKnownPosition(void) const = 0;
+	//! Queues a GOTO command, it is sent to the telescope by the I/O thread.
+	void telescopeGoto(const Vec3d &j2000Pos);
+	//! Whether the connection was open at the last communication step.
+	bool isConnected(void) const {return connected.loadAcquire()!=0;}
+	bool hasKnownPosition(void) const {return interpolatedPosition.isKnown();}
+	//! Adds the positions received since the last call to the interpolated
+	//! positions. Called by TelescopeControl::update().
+	void updatePosition(void);
 	void addOcular(double fov) {if (fov>=0.0) oculars.push_back(fov);}
 	const QList<double> &getOculars(void) const {return oculars;}
-	
+	//! Sets the log of the telescope server code used by this client.
+	//! Only the thread of the client writes to it once the communication is started.
+	void setLogStream(QTextStream* stream) {logStream = stream;}
+
+public slots:
+	//! Starts the communication in the thread of this object.
+	//! Invoked by TelescopeControl after moving the client to its I/O thread.
+	void startCommunication(void);
+	//! Stops the communication and moves this object back to the main
+	//! thread, so that it can be deleted there.
+	void stopCommunication(void);
+
+protected:
+	TelescopeClient(const QString &name, Equinox eq = EquinoxJ2000);
+
+	//! Checks the connection, tries to establish it if needed.
+	//! @return true if GOTO commands can be sent.
 	virtual bool prepareCommunication() {return false;}
+	//! Sends and receives the pending data, without blocking.
 	virtual void performCommunication() {}
+	//! Sends a GOTO command.
+	//! @param position the target in the equinox of the telescope.
+	virtual void performGoto(const Vec3d &position) = 0;
+	virtual bool isConnectionOpen(void) const = 0;
+	//! Closes the connection at the end of the communication.
+	virtual void closeConnection(void) {}
+
+	//! Publishes a position received from the telescope to the main thread.
+	//! @param position the position in the equinox of the telescope.
+	void publishPosition(const Vec3d &position, qint64 serverTime, int status);
+	//! Forgets the positions published before, e.g. after a disconnection.
+	void resetPosition(void);
+	//! Watches a file descriptor, so that communicate() is called as soon as
+	//! data arrive. Not available on Windows, where the descriptors of the
+	//! serial ports cannot be watched: communicate() is then only called
+	//! periodically.
+	void watchDescriptor(int fd);
 
-protected:
-	TelescopeClient(const QString &name);
 	QString nameI18n;
 	const QString name;
+	Equinox equinox;
+	//! Delay of the displayed position [microseconds], the positions are interpolated.
+	int time_delay;
+
+protected slots:
+	//! A step of the communication. Called periodically, when data arrive,
+	//! and when a GOTO command is queued.
+	void communicate(void);
+
 private:
 	virtual bool isInitialized(void) const {return true;}
 	float getSelectPriority(const StelCore* core) const {Q_UNUSED(core); return -10.f;}
 private:
 	QList<double> oculars; // fov of the oculars
+
+	// Used in the main thread
+	InterpolatedPosition interpolatedPosition;
+	// Published in the I/O thread, a position with client_micros==INT64_MAX resets the interpolation
+	SingleProducerQueue<Position, 64> positionQueue;
+	// Queued in the main thread, in the equinox of the telescope
+	SingleProducerQueue<Vec3d, 16> gotoQueue;
+	QAtomicInt connected;
+
+	// Used in the I/O thread
+	QTimer* timer;
+	QSocketNotifier* notifier;
+	int watchedDescriptor;
+	QTextStream* logStream;
 };
 
 //! Example Telescope class. A physical telescope does not exist.
@@ -113,7 +185,9 @@ public:
 		desired_pos[2] = XYZ[2] = 0.0;
 	}
 	~TelescopeClientDummy(void) {}
-	bool isConnected(void) const
+	
+private:
+	bool isConnectionOpen(void) const
 	{
 		return true;
 	}
@@ -125,23 +199,16 @@ public:
 			XYZ *= (1.0/std::sqrt(lq));
 		else
 			XYZ = desired_pos;
+		publishPosition(XYZ, getNow(), 0);
 		return true;
 	}
-	void telescopeGoto(const Vec3d &j2000Pos)
+	void performGoto(const Vec3d &j2000Pos)
 	{
 		desired_pos = j2000Pos;
 		desired_pos.normalize();
 	}
-	bool hasKnownPosition(void) const
-	{
-		return true;
-	}
-	Vec3d getJ2000EquatorialPos(const StelCore*) const
-	{
-		return XYZ;
-	}
 	
-private:
+
 	Vec3d XYZ; // j2000 position
 	Vec3d desired_pos;
 };
@@ -151,57 +218,35 @@ private:
 //! the "Stellarium telescope control protocol" over TCP/IP.
 //! The "Stellarium telescope control protocol" is specified in a seperate
 //! document along with the telescope server software.
+//! The socket and the protocol are in TelescopeTCPConnection, this class
+//! passes the commands and the positions between it and the main thread.
 class TelescopeTCP : public TelescopeClient
 {
 	Q_OBJECT
 public:
 	TelescopeTCP(const QString &name, const QString &params, Equinox eq = EquinoxJ2000);
-	~TelescopeTCP(void)
-	{
-		hangup();
-	}
-	bool isConnected(void) const
-	{
-		//return (tcpSocket->isValid() && !wait_for_connection_establishment);
-		return (tcpSocket->state() == QAbstractSocket::ConnectedState);
-	}
+	~TelescopeTCP(void) {}
 	
 private:
-	Vec3d getJ2000EquatorialPos(const StelCore* core=0) const;
-	bool prepareCommunication();
-	void performCommunication();
-	void telescopeGoto(const Vec3d &j2000Pos);
+	bool isConnectionOpen(void) const
+	{
+		return connection && connection->isOpen();
+	}
+	bool prepareCommunication() {return connection->prepareCommunication();}
+	void performCommunication() {connection->performCommunication();}
+	void performGoto(const Vec3d &position) {connection->sendGoto(position);}
+	void closeConnection(void) {connection->hangup();}
 	bool isInitialized(void) const
 	{
-		return (!address.isNull());
+		return connection!=NULL;
 	}
-	void performReading(void);
-	void performWriting(void);
 	
 private:
-	void hangup(void);
-	QHostAddress address;
-	unsigned int port;
-	QTcpSocket * tcpSocket;
-	bool wait_for_connection_establishment;
-	qint64 end_of_timeout;
-	char readBuffer[120];
-	char *readBufferEnd;
-	char writeBuffer[120];
-	char *writeBufferEnd;
-	int time_delay;
-
-	InterpolatedPosition interpolatedPosition;
-	virtual bool hasKnownPosition(void) const
-	{
-		return interpolatedPosition.isKnown();
-	}
-
-	Equinox equinox;
+	TelescopeTCPConnection* connection;
 	
 private slots:
-	void socketConnected(void);
-	void socketFailed(QAbstractSocket::SocketError socketError);
+	void receivePosition(const Vec3d &position, qint64 serverTime, int status);
+	void forgetPosition(void);
 };
 
 #endif // _TELESCOPE_HPP_
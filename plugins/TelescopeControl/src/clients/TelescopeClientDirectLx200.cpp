@@ -35,9 +35,7 @@
 #include <QStringList>
 
 TelescopeClientDirectLx200::TelescopeClientDirectLx200 (const QString &name, const QString &parameters, Equinox eq)
-	: TelescopeClient(name)
-	, time_delay(0)
-	, equinox(eq)
+	: TelescopeClient(name, eq)
 	, lx200(NULL)
 	, long_format_used(false)
 	, answers_received(false)
@@ -45,8 +43,6 @@ TelescopeClientDirectLx200::TelescopeClientDirectLx200 (const QString &name, con
 	, queue_get_position(true)
 	, next_pos_time(0)
 {
-	interpolatedPosition.reset();
-	
 	//Extract parameters
 	//Format: "serial_port_name:time_delay"
 	QRegExp paramRx("^([^:]*):(\\d+)$");
@@ -89,6 +85,7 @@ TelescopeClientDirectLx200::TelescopeClientDirectLx200 (const QString &name, con
 	
 	// lx200 will be deleted in the destructor of Server
 	addConnection(lx200);
+	watchDescriptor(lx200->getFd());
 	
 	long_format_used = false; // unknown
 	last_ra = 0;
@@ -98,18 +95,8 @@ TelescopeClientDirectLx200::TelescopeClientDirectLx200 (const QString &name, con
 }
 
 //! queues a GOTO command
-void TelescopeClientDirectLx200::telescopeGoto(const Vec3d &j2000Pos)
+void TelescopeClientDirectLx200::performGoto(const Vec3d &position)
 {
-	if (!isConnected())
-		return;
-
-	Vec3d position = j2000Pos;
-	if (equinox == EquinoxJNow)
-	{
-		const StelCore* core = StelApp::getInstance().getCore();
-		position = core->j2000ToEquinoxEqu(j2000Pos);
-	}
-
 	//if (writeBufferEnd - writeBuffer + 20 < (int)sizeof(writeBuffer))
 	//TODO: See the else clause, think how to do the same thing
 	{
@@ -135,14 +122,6 @@ void TelescopeClientDirectLx200::gotoReceived(unsigned int ra_int, int dec_int)
 	lx200->sendGoto(ra_int, dec_int);
 }
 
-//! estimates where the telescope is by interpolation in the stored
-//! telescope positions:
-Vec3d TelescopeClientDirectLx200::getJ2000EquatorialPos(const StelCore*) const
-{
-	const qint64 now = getNow() - time_delay;
-	return interpolatedPosition.get(now);
-}
-
 bool TelescopeClientDirectLx200::prepareCommunication()
 {
 	//TODO: Nothing to prepare?
@@ -151,7 +130,8 @@ bool TelescopeClientDirectLx200::prepareCommunication()
 
 void TelescopeClientDirectLx200::performCommunication()
 {
-	step(10000);
+	// Only handle the data already received: this is called when data arrive
+	step(0);
 }
 
 void TelescopeClientDirectLx200::communicationResetReceived(void)
@@ -161,7 +141,7 @@ void TelescopeClientDirectLx200::communicationResetReceived(void)
 	next_pos_time = -0x8000000000000000LL;
 	
 #ifndef QT_NO_DEBUG
-	*log_file << Now() << "TelescopeClientDirectLx200::communicationResetReceived" << endl;
+	*getLogFile() << Now() << "TelescopeClientDirectLx200::communicationResetReceived" << endl;
 #endif
 
 	if (answers_received)
@@ -188,7 +168,7 @@ void TelescopeClientDirectLx200::raReceived(unsigned int ra_int)
 	answers_received = true;
 	last_ra = ra_int;
 #ifndef QT_NO_DEBUG
-	*log_file << Now() << "TelescopeClientDirectLx200::raReceived: " << ra_int << endl;
+	*getLogFile() << Now() << "TelescopeClientDirectLx200::raReceived: " << ra_int << endl;
 #endif
 }
 
@@ -198,7 +178,7 @@ void TelescopeClientDirectLx200::decReceived(unsigned int dec_int)
 {
 	answers_received = true;
 #ifndef QT_NO_DEBUG
-	*log_file << Now() << "TelescopeClientDirectLx200::decReceived: " << dec_int << endl;
+	*getLogFile() << Now() << "TelescopeClientDirectLx200::decReceived: " << dec_int << endl;
 #endif
 	const int lx200_status = 0;
 	sendPosition(last_ra, dec_int, lx200_status);
@@ -218,7 +198,7 @@ void TelescopeClientDirectLx200::step(long long int timeout_micros)
 	Server::step(timeout_micros);
 }
 
-bool TelescopeClientDirectLx200::isConnected(void) const
+bool TelescopeClientDirectLx200::isConnectionOpen(void) const
 {
 	return (!lx200->isClosed());//TODO
 }
@@ -237,11 +217,5 @@ void TelescopeClientDirectLx200::sendPosition(unsigned int ra_int, int dec_int,
 	const double dec = dec_int * (M_PI/(unsigned int)0x80000000);
 	const double cdec = cos(dec);
 	Vec3d position(cos(ra)*cdec, sin(ra)*cdec, sin(dec));
-	Vec3d j2000Position = position;
-	if (equinox == EquinoxJNow)
-	{
-		const StelCore* core = StelApp::getInstance().getCore();
-		j2000Position = core->equinoxEquToJ2000(position);
-	}
-	interpolatedPosition.add(j2000Position, getNow(), server_micros, status);
+	publishPosition(position, server_micros, status);
 }
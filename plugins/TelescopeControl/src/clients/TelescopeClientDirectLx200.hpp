@@ -50,10 +50,6 @@ public:
 		//hangup();
 	}
 	
-	//======================================================================
-	// Methods inherited from TelescopeClient
-	bool isConnected(void) const;
-	
 	//======================================================================
 	// Methods inherited from Server
 	virtual void step(long long int timeout_micros);
@@ -65,10 +61,10 @@ public:
 private:
 	//======================================================================
 	// Methods inherited from TelescopeClient
-	Vec3d getJ2000EquatorialPos(const StelCore* core=0) const;
+	bool isConnectionOpen(void) const;
 	bool prepareCommunication();
 	void performCommunication();
-	void telescopeGoto(const Vec3d &j2000Pos);
+	void performGoto(const Vec3d &position);
 	bool isInitialized(void) const;
 	
 	//======================================================================
@@ -79,15 +75,6 @@ private:
 	
 private:
 	void hangup(void);
-	int time_delay;
-	
-	InterpolatedPosition interpolatedPosition;
-	virtual bool hasKnownPosition(void) const
-	{
-		return interpolatedPosition.isKnown();
-	}
-
-	Equinox equinox;
 	
 	//======================================================================
 	// Members inherited from ServerLx200
@@ -35,16 +35,12 @@
 #include <QStringList>
 
 TelescopeClientDirectNexStar::TelescopeClientDirectNexStar(const QString &name, const QString &parameters, Equinox eq)
-	: TelescopeClient(name)
-	, time_delay(0)
-	, equinox(eq)
+	: TelescopeClient(name, eq)
 	, nexstar(NULL)
 	, last_ra(0)
 	, queue_get_position(true)
 	, next_pos_time(0)
 {
-	interpolatedPosition.reset();
-	
 	//Extract parameters
 	//Format: "serial_port_name:time_delay"
 	QRegExp paramRx("^([^:]*):(\\d+)$");
@@ -87,6 +83,7 @@ TelescopeClientDirectNexStar::TelescopeClientDirectNexStar(const QString &name,
 	
 	//This connection will be deleted in the destructor of Server
 	addConnection(nexstar);
+	watchDescriptor(nexstar->getFd());
 	
 	last_ra = 0;
 	queue_get_position = true;
@@ -94,18 +91,8 @@ TelescopeClientDirectNexStar::TelescopeClientDirectNexStar(const QString &name,
 }
 
 //! queues a GOTO command
-void TelescopeClientDirectNexStar::telescopeGoto(const Vec3d &j2000Pos)
+void TelescopeClientDirectNexStar::performGoto(const Vec3d &position)
 {
-	if (!isConnected())
-		return;
-
-	Vec3d position = j2000Pos;
-	if (equinox == EquinoxJNow)
-	{
-		const StelCore* core = StelApp::getInstance().getCore();
-		position = core->j2000ToEquinoxEqu(j2000Pos);
-	}
-
 	//if (writeBufferEnd - writeBuffer + 20 < (int)sizeof(writeBuffer))
 	//TODO: See the else clause, think how to do the same thing
 	{
@@ -131,14 +118,6 @@ void TelescopeClientDirectNexStar::gotoReceived(unsigned int ra_int, int dec_int
 	nexstar->sendGoto(ra_int, dec_int);
 }
 
-//! estimates where the telescope is by interpolation in the stored
-//! telescope positions:
-Vec3d TelescopeClientDirectNexStar::getJ2000EquatorialPos(const StelCore*) const
-{
-	const qint64 now = getNow() - time_delay;
-	return interpolatedPosition.get(now);
-}
-
 bool TelescopeClientDirectNexStar::prepareCommunication()
 {
 	//TODO: Nothing to prepare?
@@ -147,7 +126,8 @@ bool TelescopeClientDirectNexStar::prepareCommunication()
 
 void TelescopeClientDirectNexStar::performCommunication()
 {
-	step(10000);
+	// Only handle the data already received: this is called when data arrive
+	step(0);
 }
 
 void TelescopeClientDirectNexStar::communicationResetReceived(void)
@@ -156,7 +136,7 @@ void TelescopeClientDirectNexStar::communicationResetReceived(void)
 	next_pos_time = -0x8000000000000000LL;
 	
 #ifndef QT_NO_DEBUG
-	*log_file << Now() << "TelescopeClientDirectNexStar::communicationResetReceived" << endl;
+	*getLogFile() << Now() << "TelescopeClientDirectNexStar::communicationResetReceived" << endl;
 #endif
 }
 
@@ -165,7 +145,7 @@ void TelescopeClientDirectNexStar::raReceived(unsigned int ra_int)
 {
 	last_ra = ra_int;
 #ifndef QT_NO_DEBUG
-	*log_file << Now() << "TelescopeClientDirectNexStar::raReceived: " << ra_int << endl;
+	*getLogFile() << Now() << "TelescopeClientDirectNexStar::raReceived: " << ra_int << endl;
 #endif
 }
 
@@ -174,7 +154,7 @@ void TelescopeClientDirectNexStar::raReceived(unsigned int ra_int)
 void TelescopeClientDirectNexStar::decReceived(unsigned int dec_int)
 {
 #ifndef QT_NO_DEBUG
-	*log_file << Now() << "TelescopeClientDirectNexStar::decReceived: " << dec_int << endl;
+	*getLogFile() << Now() << "TelescopeClientDirectNexStar::decReceived: " << dec_int << endl;
 #endif
 	const int nexstar_status = 0;
 	sendPosition(last_ra, dec_int, nexstar_status);
@@ -193,7 +173,7 @@ void TelescopeClientDirectNexStar::step(long long int timeout_micros)
 	Server::step(timeout_micros);
 }
 
-bool TelescopeClientDirectNexStar::isConnected(void) const
+bool TelescopeClientDirectNexStar::isConnectionOpen(void) const
 {
 	return (!nexstar->isClosed());//TODO
 }
@@ -212,11 +192,5 @@ void TelescopeClientDirectNexStar::sendPosition(unsigned int ra_int, int dec_int
 	const double dec = dec_int * (M_PI/(unsigned int)0x80000000);
 	const double cdec = cos(dec);
 	Vec3d position(cos(ra)*cdec, sin(ra)*cdec, sin(dec));
-	Vec3d j2000Position = position;
-	if (equinox == EquinoxJNow)
-	{
-		const StelCore* core = StelApp::getInstance().getCore();
-		j2000Position = core->equinoxEquToJ2000(position);
-	}
-	interpolatedPosition.add(j2000Position, getNow(), server_micros, status);
+	publishPosition(position, server_micros, status);
 }
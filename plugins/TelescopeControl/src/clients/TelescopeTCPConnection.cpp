@@ -0,0 +1,308 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include "TelescopeTCPConnection.hpp"
+#include "InterpolatedPosition.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#include <QDebug>
+
+TelescopeTCPConnection::TelescopeTCPConnection(const QString& name, const QHostAddress& address, quint16 port, QObject* parent)
+	: QObject(parent)
+	, name(name)
+	, address(address)
+	, port(port)
+	// A child, so that it is moved to the I/O thread with the connection
+	, tcpSocket(new QTcpSocket(this))
+	, wait_for_connection_establishment(false)
+	, end_of_timeout(-0x8000000000000000LL)
+	, readBufferEnd(readBuffer)
+	, writeBufferEnd(writeBuffer)
+{
+	connect(tcpSocket, SIGNAL(connected()), this, SLOT(socketConnected()));
+	connect(tcpSocket, SIGNAL(readyRead()), this, SIGNAL(readyRead()));
+	connect(tcpSocket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(socketFailed(QAbstractSocket::SocketError)));
+}
+
+void TelescopeTCPConnection::hangup(void)
+{
+	if (tcpSocket->isValid())
+	{
+		tcpSocket->abort();// Or maybe tcpSocket->close()?
+	}
+	
+	readBufferEnd = readBuffer;
+	writeBufferEnd = writeBuffer;
+	wait_for_connection_establishment = false;
+	
+	emit connectionReset();
+}
+
+//! queues a GOTO command with the specified position to the write buffer.
+//! For the data format of the command see the
+//! "Stellarium telescope control protocol" text file
+void TelescopeTCPConnection::sendGoto(const Vec3d &position)
+{
+	if (writeBufferEnd - writeBuffer + 20 < (int)sizeof(writeBuffer))
+	{
+		const double ra_signed = atan2(position[1], position[0]);
+		//Workaround for the discrepancy in precision between Windows/Linux/PPC Macs and Intel Macs:
+		const double ra = (ra_signed >= 0) ? ra_signed : (ra_signed + 2.0 * M_PI);
+		const double dec = atan2(position[2], std::sqrt(position[0]*position[0]+position[1]*position[1]));
+		unsigned int ra_int = (unsigned int)floor(0.5 + ra*(((unsigned int)0x80000000)/M_PI));
+		int dec_int = (int)floor(0.5 + dec*(((unsigned int)0x80000000)/M_PI));
+		// length of packet:
+		*writeBufferEnd++ = 20;
+		*writeBufferEnd++ = 0;
+		// type of packet:
+		*writeBufferEnd++ = 0;
+		*writeBufferEnd++ = 0;
+		// client_micros:
+		qint64 now = getNow();
+		*writeBufferEnd++ = now;
+		now>>=8;
+		*writeBufferEnd++ = now;
+		now>>=8;
+		*writeBufferEnd++ = now;
+		now>>=8;
+		*writeBufferEnd++ = now;
+		now>>=8;
+		*writeBufferEnd++ = now;
+		now>>=8;
+		*writeBufferEnd++ = now;
+		now>>=8;
+		*writeBufferEnd++ = now;
+		now>>=8;
+		*writeBufferEnd++ = now;
+		// ra:
+		*writeBufferEnd++ = ra_int;
+		ra_int>>=8;
+		*writeBufferEnd++ = ra_int;
+		ra_int>>=8;
+		*writeBufferEnd++ = ra_int;
+		ra_int>>=8;
+		*writeBufferEnd++ = ra_int;
+		// dec:
+		*writeBufferEnd++ = dec_int;
+		dec_int>>=8;
+		*writeBufferEnd++ = dec_int;
+		dec_int>>=8;
+		*writeBufferEnd++ = dec_int;
+		dec_int>>=8;
+		*writeBufferEnd++ = dec_int;
+	}
+	else
+	{
+		qDebug() << "TelescopeTCPConnection(" << name << ")::sendGoto: "<< "communication is too slow, I will ignore this command";
+	}
+}
+
+void TelescopeTCPConnection::performWriting(void)
+{
+	const int to_write = writeBufferEnd - writeBuffer;
+	const int rc = tcpSocket->write(writeBuffer, to_write);
+	if (rc < 0)
+	{
+		//TODO: Better error message. See the Qt documentation.
+		qDebug() << "TelescopeTCPConnection(" << name << ")::performWriting: "
+			<< "write failed: " << tcpSocket->errorString();
+		hangup();
+	}
+	else if (rc > 0)
+	{
+		if (rc >= to_write)
+		{
+			// everything written
+			writeBufferEnd = writeBuffer;
+		}
+		else
+		{
+			// partly written
+			memmove(writeBuffer, writeBuffer + rc, to_write - rc);
+			writeBufferEnd -= rc;
+		}
+	}
+}
+
+//! try to read some data from the telescope server
+void TelescopeTCPConnection::performReading(void)
+{
+	const int to_read = readBuffer + sizeof(readBuffer) - readBufferEnd;
+	const int rc = tcpSocket->read(readBufferEnd, to_read);
+	if (rc < 0)
+	{
+		//TODO: Better error warning. See the Qt documentation.
+		qDebug() << "TelescopeTCPConnection(" << name << ")::performReading: " << "read failed: " << tcpSocket->errorString();
+		hangup();
+	}
+	else if (rc == 0)
+	{
+		qDebug() << "TelescopeTCPConnection(" << name << ")::performReading: " << "server has closed the connection";
+		hangup();
+	}
+	else
+	{
+		readBufferEnd += rc;
+		char *p = readBuffer;
+		// parse the data in the read buffer:
+		while (readBufferEnd - p >= 2)
+		{
+			const int size = (int)(((unsigned char)(p[0])) | (((unsigned int)(unsigned char)(p[1])) << 8));
+			if (size > (int)sizeof(readBuffer) || size < 4)
+			{
+				qDebug() << "TelescopeTCPConnection(" << name << ")::performReading: " << "bad packet size: " << size;
+				hangup();
+				return;
+			}
+			if (size > readBufferEnd - p)
+			{
+				// wait for complete packet
+				break;
+			}
+			const int type = (int)(((unsigned char)(p[2])) | (((unsigned int)(unsigned char)(p[3])) << 8));
+			// dispatch:
+			switch (type)
+			{
+				case 0:
+				{
+				// We have received position information.
+				// For the data format of the message see the
+				// "Stellarium telescope control protocol"
+					if (size < 24)
+					{
+						qDebug() << "TelescopeTCPConnection(" << name << ")::performReading: " << "type 0: bad packet size: " << size;
+						hangup();
+						return;
+					}
+					const qint64 server_micros = (qint64)
+						(((quint64)(unsigned char)(p[ 4])) |
+						(((quint64)(unsigned char)(p[ 5])) <<  8) |
+						(((quint64)(unsigned char)(p[ 6])) << 16) |
+						(((quint64)(unsigned char)(p[ 7])) << 24) |
+						(((quint64)(unsigned char)(p[ 8])) << 32) |
+						(((quint64)(unsigned char)(p[ 9])) << 40) |
+						(((quint64)(unsigned char)(p[10])) << 48) |
+						(((quint64)(unsigned char)(p[11])) << 56));
+					const unsigned int ra_int =
+						((unsigned int)(unsigned char)(p[12])) |
+						(((unsigned int)(unsigned char)(p[13])) <<  8) |
+						(((unsigned int)(unsigned char)(p[14])) << 16) |
+						(((unsigned int)(unsigned char)(p[15])) << 24);
+					const int dec_int =
+						(int)(((unsigned int)(unsigned char)(p[16])) |
+						     (((unsigned int)(unsigned char)(p[17])) <<  8) |
+						     (((unsigned int)(unsigned char)(p[18])) << 16) |
+						     (((unsigned int)(unsigned char)(p[19])) << 24));
+					const int status =
+						(int)(((unsigned int)(unsigned char)(p[20])) |
+						     (((unsigned int)(unsigned char)(p[21])) <<  8) |
+						     (((unsigned int)(unsigned char)(p[22])) << 16) |
+						     (((unsigned int)(unsigned char)(p[23])) << 24));
+
+					const double ra  =  ra_int * (M_PI/(unsigned int)0x80000000);
+					const double dec = dec_int * (M_PI/(unsigned int)0x80000000);
+					const double cdec = cos(dec);
+					Vec3d position(cos(ra)*cdec, sin(ra)*cdec, sin(dec));
+					emit positionReceived(position, server_micros, status);
+				}
+				break;
+				default:
+					qDebug() << "TelescopeTCPConnection(" << name << ")::performReading: " << "ignoring unknown packet, type: " << type;
+				break;
+			}
+			p += size;
+		}
+		if (p >= readBufferEnd)
+		{
+			// everything handled
+			readBufferEnd = readBuffer;
+		}
+		else
+		{
+			// partly handled
+			memmove(readBuffer, p, readBufferEnd - p);
+			readBufferEnd -= (p - readBuffer);
+		}
+	}
+}
+
+//! checks if the socket is connected, tries to connect if it is not
+//@return true if the socket is connected
+bool TelescopeTCPConnection::prepareCommunication()
+{
+	if(tcpSocket->state() == QAbstractSocket::ConnectedState)
+	{
+		if(wait_for_connection_establishment)
+		{
+			wait_for_connection_establishment = false;
+			qDebug() << "TelescopeTCPConnection(" << name << ")::prepareCommunication: Connection established";
+		}
+		return true;
+	}
+	else if(wait_for_connection_establishment)
+	{
+		const qint64 now = getNow();
+		if (now > end_of_timeout)
+		{
+			end_of_timeout = now + 1000000;
+			qDebug() << "TelescopeTCPConnection(" << name << ")::prepareCommunication: Connection attempt timed out";
+			hangup();
+		}
+	}
+	else
+	{
+		const qint64 now = getNow();
+		if (now < end_of_timeout) 
+			return false; //Don't try to reconnect for some time
+		end_of_timeout = now + 5000000;
+		tcpSocket->connectToHost(address, port);
+		wait_for_connection_establishment = true;
+		qDebug() << "TelescopeTCPConnection(" << name << ")::prepareCommunication: Attempting to connect to host" << address.toString() << "at port" << port;
+	}
+	return false;
+}
+
+void TelescopeTCPConnection::performCommunication()
+{
+	if (tcpSocket->state() == QAbstractSocket::ConnectedState)
+	{
+		performWriting();
+		
+		if (tcpSocket->bytesAvailable() > 0)
+		{
+			//If performReading() is called when there are no bytes to read,
+			//it closes the connection
+			performReading();
+		}
+	}
+}
+
+void TelescopeTCPConnection::socketConnected(void)
+{
+	qDebug() << "TelescopeTCPConnection(" << name <<"): turning off Nagle algorithm.";
+	tcpSocket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+}
+
+//TODO: More informative error messages?
+void TelescopeTCPConnection::socketFailed(QAbstractSocket::SocketError)
+{
+	qDebug() << "TelescopeTCPConnection(" << name << "): TCP socket error:\n" << tcpSocket->errorString();
+}
@@ -0,0 +1,83 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _TELESCOPETCPCONNECTION_HPP_
+#define _TELESCOPETCPCONNECTION_HPP_
+
+#include <QHostAddress>
+#include <QObject>
+#include <QString>
+#include <QTcpSocket>
+
+#include "VecMath.hpp"
+
+//! @class TelescopeTCPConnection
+//! The I/O part of TelescopeTCP: the TCP connection to a telescope server, and the
+//! "Stellarium telescope control protocol" spoken on it. It lives in the I/O thread
+//! with its client, and does not depend on StelCore, so that it can be tested with
+//! a stand-in server. None of its methods block.
+class TelescopeTCPConnection : public QObject
+{
+	Q_OBJECT
+public:
+	//! @param name the name of the telescope, for the log.
+	TelescopeTCPConnection(const QString& name, const QHostAddress& address, quint16 port, QObject* parent=NULL);
+
+	bool isOpen(void) const {return tcpSocket->state() == QAbstractSocket::ConnectedState;}
+	//! Checks if the socket is connected, tries to connect if it is not.
+	//! @return true if the socket is connected.
+	bool prepareCommunication(void);
+	//! Writes the queued commands and handles the packets received.
+	void performCommunication(void);
+	//! Queues a GOTO command, written by the next performCommunication().
+	//! @param position the target in the equinox of the telescope.
+	void sendGoto(const Vec3d& position);
+	//! Closes the connection and drops the data which was not sent or handled.
+	void hangup(void);
+
+signals:
+	//! Data arrived, performCommunication() handles it.
+	void readyRead(void);
+	//! A position was received from the telescope server.
+	//! @param position the position in the equinox of the telescope.
+	void positionReceived(const Vec3d& position, qint64 serverTime, int status);
+	//! The connection was closed, the positions received before are obsolete.
+	void connectionReset(void);
+
+private slots:
+	void socketConnected(void);
+	void socketFailed(QAbstractSocket::SocketError socketError);
+
+private:
+	void performReading(void);
+	void performWriting(void);
+
+	const QString name;
+	const QHostAddress address;
+	const quint16 port;
+	QTcpSocket* tcpSocket;
+	bool wait_for_connection_establishment;
+	qint64 end_of_timeout;
+	char readBuffer[120];
+	char *readBufferEnd;
+	char writeBuffer[120];
+	char *writeBufferEnd;
+};
+
+#endif // _TELESCOPETCPCONNECTION_HPP_
@@ -135,7 +135,7 @@ void Connection::performWriting(void)
 	{
 		if (ERRNO != EINTR && ERRNO != EAGAIN)
 		{
-			*log_file << Now() << "Connection::performWriting: writeNonblocking failed: "
+			*getLogFile() << Now() << "Connection::performWriting: writeNonblocking failed: "
 			                   << STRERROR(ERRNO) << endl;
 		hangup();
 		}
@@ -145,12 +145,12 @@ void Connection::performWriting(void)
 	#ifdef DEBUG5
 		if (isAsciiConnection())
 		{
-			*log_file << Now() << "Connection::performWriting: writeNonblocking("
+			*getLogFile() << Now() << "Connection::performWriting: writeNonblocking("
 			                   << to_write << ") returned "
 			                   << rc << "; ";
 			for (int i = 0; i < rc; i++)
-				*log_file << write_buff[i];
-			*log_file << endl;
+				*getLogFile() << write_buff[i];
+			*getLogFile() << endl;
 		}
 	#endif
 		if (rc >= to_write)
@@ -175,13 +175,13 @@ void Connection::performReading(void)
 	{
 		if (ERRNO == ECONNRESET)
 		{
-			*log_file << Now() << "Connection::performReading: "
+			*getLogFile() << Now() << "Connection::performReading: "
 			                      "client has closed the connection" << endl;
 			hangup();
 		} 
 		else if (ERRNO != EINTR && ERRNO != EAGAIN)
 		{
-			*log_file << Now() << "Connection::performReading: readNonblocking failed: "
+			*getLogFile() << Now() << "Connection::performReading: readNonblocking failed: "
 			                   << STRERROR(ERRNO) << endl;
 			hangup();
 		}
@@ -190,7 +190,7 @@ void Connection::performReading(void)
 	{
 		if (isTcpConnection())
 		{
-			*log_file << Now() << "Connection::performReading: "
+			*getLogFile() << Now() << "Connection::performReading: "
 			                      "client has closed the connection" << endl;
 			hangup();
 		}
@@ -200,11 +200,11 @@ void Connection::performReading(void)
 	#ifdef DEBUG5
 		if (isAsciiConnection())
 		{
-			*log_file << Now() << "Connection::performReading: readNonblocking returned "
+			*getLogFile() << Now() << "Connection::performReading: readNonblocking returned "
 			                   << rc << "; ";
 			for (int i = 0; i < rc; i++)
-				*log_file << read_buff_end[i];
-			*log_file << endl;
+				*getLogFile() << read_buff_end[i];
+			*getLogFile() << endl;
 		}
 	#endif
 	
@@ -214,12 +214,12 @@ void Connection::performReading(void)
 		if (p >= read_buff_end)
 		{
 			// everything handled
-			//*log_file << Now() << "Connection::performReading: everything handled" << endl;
+			//*getLogFile() << Now() << "Connection::performReading: everything handled" << endl;
 			read_buff_end = read_buff;
 		}
 		else if (p > read_buff)
 		{
-			//*log_file << Now() << "Connection::performReading: partly handled: "
+			//*getLogFile() << Now() << "Connection::performReading: partly handled: "
 			//          << (p-read_buff) << endl;
 			// partly handled
 			memmove(read_buff, p, read_buff_end - p);
@@ -236,7 +236,7 @@ void Connection::dataReceived(const char *&p, const char *read_buff_end)
 		                        (((unsigned int)(unsigned char)(p[1])) << 8) );
 		if (size > (int)sizeof(read_buff) || size < 4)
 		{
-			*log_file << Now() << "Connection::dataReceived: "
+			*getLogFile() << Now() << "Connection::dataReceived: "
 		                              "bad packet size: " << size << endl;
 			hangup();
 			return;
@@ -256,7 +256,7 @@ void Connection::dataReceived(const char *&p, const char *read_buff_end)
 			{
 				if (size < 12)
 				{
-					*log_file << Now() << "Connection::dataReceived: "
+					*getLogFile() << Now() << "Connection::dataReceived: "
 					                      "type 0: bad packet size: " << size << endl;
 					hangup();
 					return;
@@ -282,7 +282,7 @@ void Connection::dataReceived(const char *&p, const char *read_buff_end)
 				                 (((unsigned int)(unsigned char)(p[18])) << 16) |
 				                 (((unsigned int)(unsigned char)(p[19])) << 24) );
 				#ifdef DEBUG5
-				*log_file << Now() << "Connection::dataReceived: "
+				*getLogFile() << Now() << "Connection::dataReceived: "
 				                   << PrintRaDec(ra_int, dec_int)
 				                   << endl;
 				#endif
@@ -293,7 +293,7 @@ void Connection::dataReceived(const char *&p, const char *read_buff_end)
 			
 			default:
 			//No other types of commands are acceptable at the moment
-				*log_file << Now()
+				*getLogFile() << Now()
 				          << "Connection::dataReceived: "
 				             "ignoring unknown packet, type: "
 				          << type
@@ -310,7 +310,7 @@ void Connection::sendPosition(unsigned int ra_int, int dec_int, int status)
 	if (!IS_INVALID_SOCKET(fd))
 	{
 	#ifdef DEBUG5
-		*log_file << Now() << "Connection::sendPosition: "
+		*getLogFile() << Now() << "Connection::sendPosition: "
 		                   << PrintRaDec(ra_int, dec_int)
 		                   << endl;
 	#endif
@@ -350,7 +350,7 @@ void Connection::sendPosition(unsigned int ra_int, int dec_int, int status)
 		}
 		else
 		{
-			*log_file << Now() << "Connection::sendPosition: "
+			*getLogFile() << Now() << "Connection::sendPosition: "
 			                      "communication is too slow, I will ignore this command"
 			                   << endl;
 		}
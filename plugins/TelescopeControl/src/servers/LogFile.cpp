@@ -20,6 +20,7 @@
 #include "LogFile.hpp"
 
 #include <QTextStream>
+#include <QThreadStorage>
 
 QTextStream &operator<<(QTextStream &o, const Now &now)
 {
@@ -39,4 +40,20 @@ QTextStream &operator<<(QTextStream &o, const Now &now)
 	return o;
 }
 
-QTextStream * log_file = NULL;
+struct ThreadLogFile
+{
+	ThreadLogFile(void) : stream(NULL) {}
+	QTextStream *stream;
+};
+
+static QThreadStorage<ThreadLogFile> threadLogFiles;
+
+QTextStream *getLogFile(void)
+{
+	return threadLogFiles.localData().stream;
+}
+
+void setLogFile(QTextStream *stream)
+{
+	threadLogFiles.localData().stream = stream;
+}
@@ -38,6 +38,10 @@ public:
 
 QTextStream &operator<<(QTextStream &o, const Now &now);
 
-extern QTextStream *log_file;
+//! The log of the calling thread.
+//! Each thread has its own: the main thread of TelescopeControl logs to the
+//! slot being started, while its I/O thread logs to the client it communicates with.
+QTextStream *getLogFile(void);
+void setLogFile(QTextStream *stream);
 
 #endif
@@ -110,7 +110,7 @@ int Lx200CommandSetSelectedRa::readAnswerFromBuffer(const char *&buff,
 	{
 		case '0':
 			#ifdef DEBUG4
-			*log_file << Now()
+			*getLogFile() << Now()
 			          << "Lx200CommandSetSelectedRa::readAnswerFromBuffer:"
 			             "ra invalid"
 			          << endl;
@@ -120,7 +120,7 @@ int Lx200CommandSetSelectedRa::readAnswerFromBuffer(const char *&buff,
 		
 		case '1':
 			#ifdef DEBUG4
-			*log_file << Now()
+			*getLogFile() << Now()
 			          << "Lx200CommandSetSelectedRa::readAnswerFromBuffer:"
 			             "ra valid"
 			          << endl;
@@ -130,7 +130,7 @@ int Lx200CommandSetSelectedRa::readAnswerFromBuffer(const char *&buff,
 		
 		default:
 			#ifdef DEBUG4
-			*log_file << Now()
+			*getLogFile() << Now()
 			          << "Lx200CommandSetSelectedRa::readAnswerFromBuffer:"
 			             "strange: unexpected char"
 			          << endl;
@@ -195,7 +195,7 @@ int Lx200CommandSetSelectedDec::readAnswerFromBuffer(const char *&buff,
 	{
 		case '0':
 			#ifdef DEBUG4
-			*log_file << Now()
+			*getLogFile() << Now()
 			          << "Lx200CommandSetSelectedDec::readAnswerFromBuffer:"
 			             "dec invalid"
 			          << endl;
@@ -205,7 +205,7 @@ int Lx200CommandSetSelectedDec::readAnswerFromBuffer(const char *&buff,
 		
 		case '1':
 			#ifdef DEBUG4
-			*log_file << Now()
+			*getLogFile() << Now()
 			          << "Lx200CommandSetSelectedDec::readAnswerFromBuffer:"
 			             "dec valid"
 			          << endl;
@@ -215,7 +215,7 @@ int Lx200CommandSetSelectedDec::readAnswerFromBuffer(const char *&buff,
 		
 		default:
 			#ifdef DEBUG4
-			*log_file << Now()
+			*getLogFile() << Now()
 			          << "Lx200CommandSetSelectedDec::readAnswerFromBuffer:"
 			             "strange: unexpected char"
 			          << endl;
@@ -269,7 +269,7 @@ int Lx200CommandGotoSelected::readAnswerFromBuffer(const char *&buff,
 	{
 		case '0':
 			#ifdef DEBUG4
-			*log_file << Now()
+			*getLogFile() << Now()
 			          << "Lx200CommandGotoSelected::readAnswerFromBuffer: "
 			             "slew ok"
 			          << endl;
@@ -284,7 +284,7 @@ int Lx200CommandGotoSelected::readAnswerFromBuffer(const char *&buff,
 			{
 				// the AutoStar 494 returns just '1', nothing else
 				#ifdef DEBUG4
-				*log_file << Now()
+				*getLogFile() << Now()
 				          << "Lx200CommandGotoSelected::readAnswerFromBuffer: "
 				             "slew failed ("
 				          << ((char)first_byte)
@@ -306,7 +306,7 @@ int Lx200CommandGotoSelected::readAnswerFromBuffer(const char *&buff,
 					break;
 			}
 			#ifdef DEBUG4
-			*log_file << Now()
+			*getLogFile() << Now()
 			<< "Lx200CommandGotoSelected::readAnswerFromBuffer: "
 			   "slew failed ("
 			<< ((char)first_byte)
@@ -321,7 +321,7 @@ int Lx200CommandGotoSelected::readAnswerFromBuffer(const char *&buff,
 		
 		default:
 			#ifdef DEBUG4
-			*log_file << Now()
+			*getLogFile() << Now()
 			          << "Lx200CommandGotoSelected::readAnswerFromBuffer: "
 			             "slew returns something weird"
 			          << endl;
@@ -373,7 +373,7 @@ int Lx200CommandGetRa::readAnswerFromBuffer(const char *&buff,
 	if (*p++ != ':')
 	{
 		#ifdef DEBUG4
-		*log_file << Now()
+		*getLogFile() << Now()
 		          << "Lx200CommandGetRa::readAnswerFromBuffer: "
 		             "error: ':' expected"
 		          << endl;
@@ -399,7 +399,7 @@ int Lx200CommandGetRa::readAnswerFromBuffer(const char *&buff,
 			break;
 		
 		default:
-			*log_file << Now()
+			*getLogFile() << Now()
 			          << "Lx200CommandGetRa::readAnswerFromBuffer: "
 			             "error: '.' or ':' expected"
 			          << endl;
@@ -408,7 +408,7 @@ int Lx200CommandGetRa::readAnswerFromBuffer(const char *&buff,
 	
 	if (*p++ != '#')
 	{
-		*log_file << Now()
+		*getLogFile() << Now()
 		          << "Lx200CommandGetRa::readAnswerFromBuffer: "
 		             "error: '#' expected"
 		          << endl;
@@ -416,7 +416,7 @@ int Lx200CommandGetRa::readAnswerFromBuffer(const char *&buff,
 	}
 	
 	#ifdef DEBUG4
-	*log_file << Now()
+	*getLogFile() << Now()
 	          << "Lx200CommandGetRa::readAnswerFromBuffer: "
 	          << "RA = "
 	          << qSetPadChar('0')
@@ -482,7 +482,7 @@ int Lx200CommandGetDec::readAnswerFromBuffer(const char *&buff,
 		
 		default:
 			#ifdef DEBUG4
-			*log_file << Now()
+			*getLogFile() << Now()
 			          << "Lx200CommandGetDec::readAnswerFromBuffer: "
 			             "error: '+' or '-' expected"
 			          << endl;
@@ -494,7 +494,7 @@ int Lx200CommandGetDec::readAnswerFromBuffer(const char *&buff,
 	dec *= 10; dec += ((*p++) - '0');
 	if (*p++ != ((char)223))
 	{
-		*log_file << Now()
+		*getLogFile() << Now()
 		          << "Lx200CommandGetDec::readAnswerFromBuffer: "
 		             "error: degree sign expected"
 		          << endl;
@@ -516,7 +516,7 @@ int Lx200CommandGetDec::readAnswerFromBuffer(const char *&buff,
 			dec *= 10; dec += ((*p++) - '0');
 			if (*p++ != '#')
 			{
-				*log_file << Now()
+				*getLogFile() << Now()
 				          << "Lx200CommandGetDec::readAnswerFromBuffer: "
 				             "error: '#' expected"
 				          << endl;
@@ -525,14 +525,14 @@ int Lx200CommandGetDec::readAnswerFromBuffer(const char *&buff,
 			break;
 		
 		default:
-			*log_file << Now()
+			*getLogFile() << Now()
 			          << "Lx200CommandGetDec::readAnswerFromBuffer: "
 			             "error: '#' or ':' expected"
 			          << endl;
 			return -1;
 	}
 	#ifdef DEBUG4
-	*log_file << Now()
+	*getLogFile() << Now()
 	          << "Lx200CommandGetDec::readAnswerFromBuffer: "
 	          << "Dec = " << (sign_dec?'-':'+')
 	          << qSetPadChar('0')
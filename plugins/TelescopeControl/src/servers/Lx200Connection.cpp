@@ -54,7 +54,7 @@ void Lx200Connection::resetCommunication(void)
 	read_buff_end = read_buff;
 	write_buff_end = write_buff;
 	#ifdef DEBUG4
-	*log_file << Now() << "Lx200Connection::resetCommunication" << endl;
+	*getLogFile() << Now() << "Lx200Connection::resetCommunication" << endl;
 	#endif
 	// wait 10 seconds before sending the next command in order to read
 	// and ignore data coming from the telescope:
@@ -94,7 +94,7 @@ void Lx200Connection::sendGoto(unsigned int ra_int, int dec_int)
 	else
 	{
 		#ifdef DEBUG4
-		*log_file << Now() << "Lx200Connection::sendGoto: ignoring command" << endl;
+		*getLogFile() << Now() << "Lx200Connection::sendGoto: ignoring command" << endl;
 		#endif
 	}
 }
@@ -111,7 +111,7 @@ bool Lx200Connection::writeFrontCommandToBuffer(void)
 	{
 #ifdef DEBUG4
 		/*
-		*log_file << Now() << "Lx200Connection::writeFrontCommandToBuffer("
+		*getLogFile() << Now() << "Lx200Connection::writeFrontCommandToBuffer("
 		                   << (*command_list.front()) << "): delayed for "
 		                   << (next_send_time-now) << endl;
 		*/
@@ -142,7 +142,7 @@ bool Lx200Connection::writeFrontCommandToBuffer(void)
 			}
 		}
 		#ifdef DEBUG4
-		*log_file << Now()
+		*getLogFile() << Now()
 		          << "Lx200Connection::writeFrontCommandToBuffer("
 		          << (*command_list.front())
 		          << "): queued"
@@ -157,7 +157,7 @@ void Lx200Connection::dataReceived(const char *&p, const char *read_buff_end)
 {
 	if (isClosed())
 	{
-		*log_file << Now() << "Lx200Connection::dataReceived: strange: fd is closed" << endl;
+		*getLogFile() << Now() << "Lx200Connection::dataReceived: strange: fd is closed" << endl;
 	}
 	else if (command_list.empty())
 	{
@@ -169,7 +169,7 @@ void Lx200Connection::dataReceived(const char *&p, const char *read_buff_end)
 		else
 		{
 			#ifdef DEBUG4
-			*log_file << Now()
+			*getLogFile() << Now()
 			          << "Lx200Connection::dataReceived: error: command_list is empty"
 			          << endl;
 			#endif
@@ -178,7 +178,7 @@ void Lx200Connection::dataReceived(const char *&p, const char *read_buff_end)
 	}
 	else if (command_list.front()->needsNoAnswer())
 	{
-		*log_file << Now() << "Lx200Connection::dataReceived: "
+		*getLogFile() << Now() << "Lx200Connection::dataReceived: "
 		                      "strange: command("
 		                   << *command_list.front()
 		                   << ") needs no answer"
@@ -191,7 +191,7 @@ void Lx200Connection::dataReceived(const char *&p, const char *read_buff_end)
 		{
 			if (!command_list.front()->hasBeenWrittenToBuffer())
 			{
-				*log_file << Now()
+				*getLogFile() << Now()
 				          << "Lx200Connection::dataReceived: "
 				             "strange: no answer expected"
 				          << endl;
@@ -200,7 +200,7 @@ void Lx200Connection::dataReceived(const char *&p, const char *read_buff_end)
 			}
 			const int rc=command_list.front()->readAnswerFromBuffer(p, read_buff_end);
 			/*
-			*log_file << Now()
+			*getLogFile() << Now()
 			          << "Lx200Connection::dataReceived: "
 			          << *command_list.front()
 			          << "->readAnswerFromBuffer returned "
@@ -241,7 +241,7 @@ void Lx200Connection::prepareSelectFds(fd_set &read_fds,
 			// the lazy telescope, propably AutoStar 494
 			// has not sent the full answer
 			#ifdef DEBUG4
-			*log_file << Now() << "Lx200Connection::prepareSelectFds: "
+			*getLogFile() << Now() << "Lx200Connection::prepareSelectFds: "
 			                      "dequeueing command("
 			                   << *command_list.front()
 			                   << ") because of timeout"
@@ -271,7 +271,7 @@ void Lx200Connection::flushCommandList(void)
 		{
 			if (writeFrontCommandToBuffer())
 			{
-				//*log_file << Now()
+				//*getLogFile() << Now()
 				//          << "Lx200Connection::flushCommandList: "
 				//          << (*command_list.front())
 				//          << "::writeFrontCommandToBuffer ok"
@@ -291,7 +291,7 @@ void Lx200Connection::flushCommandList(void)
 			}
 			else
 			{
-				//*log_file << Now() << "Lx200Connection::flushCommandList: "
+				//*getLogFile() << Now() << "Lx200Connection::flushCommandList: "
 				//                   << (*command_list.front())
 				//                   << "::writeFrontCommandToBuffer failed/delayed" << endl;
 				break;
@@ -305,7 +305,7 @@ void Lx200Connection::sendCommand(Lx200Command *command)
 	if (command)
 	{
 		#ifdef DEBUG4
-		*log_file << Now()
+		*getLogFile() << Now()
 		          << "Lx200Connection::sendCommand("
 		          << *command
 		          << ")"
@@ -313,7 +313,7 @@ void Lx200Connection::sendCommand(Lx200Command *command)
 		#endif
 		command_list.push_back(command);
 		flushCommandList();
-		//*log_file << Now() << "Lx200Connection::sendCommand(" << *command << ") end"
+		//*getLogFile() << Now() << "Lx200Connection::sendCommand(" << *command << ") end"
 		//          << endl;
 	}
 }
@@ -80,7 +80,7 @@ bool NexStarCommandGotoPosition::writeCommandToBuffer(char *&p,char *end)
 
 	has_been_written_to_buffer = true;
 	#ifdef DEBUG5
-	*log_file << Now() << "NexStarCommandGotoPosition::writeCommandToBuffer:"
+	*getLogFile() << Now() << "NexStarCommandGotoPosition::writeCommandToBuffer:"
 	          << b << endl;
 	#endif
 	
@@ -95,14 +95,14 @@ int NexStarCommandGotoPosition::readAnswerFromBuffer(const char *&buff, const ch
 	if (*buff=='#')
 	{
 		#ifdef DEBUG4
-		*log_file << Now() << "NexStarCommandGotoPosition::readAnswerFromBuffer: slew ok"
+		*getLogFile() << Now() << "NexStarCommandGotoPosition::readAnswerFromBuffer: slew ok"
 		          << endl;
 		#endif
 	}
 	else
 	{
 		#ifdef DEBUG4
-		*log_file << Now() << "NexStarCommandGotoPosition::readAnswerFromBuffer: slew failed." << endl;
+		*getLogFile() << Now() << "NexStarCommandGotoPosition::readAnswerFromBuffer: slew failed." << endl;
 		#endif
 	}
 	buff++;
@@ -147,7 +147,7 @@ int NexStarCommandGetRaDec::readAnswerFromBuffer(const char *&buff, const char *
 	if (*p++ != ',')
 	{
 		#ifdef DEBUG4
-		*log_file << Now() << "NexStarCommandGetRaDec::readAnswerFromBuffer: "
+		*getLogFile() << Now() << "NexStarCommandGetRaDec::readAnswerFromBuffer: "
 		                      "error: ',' expected" << endl;
 		#endif
 		return -1;
@@ -167,7 +167,7 @@ int NexStarCommandGetRaDec::readAnswerFromBuffer(const char *&buff, const char *
 	if (*p++ != '#')
 	{
 		#ifdef DEBUG4
-		*log_file << Now() << "NexStarCommandGetRaDec::readAnswerFromBuffer: "
+		*getLogFile() << Now() << "NexStarCommandGetRaDec::readAnswerFromBuffer: "
 		                      "error: '#' expected" << endl;
 		#endif
 		return -1;
@@ -175,7 +175,7 @@ int NexStarCommandGetRaDec::readAnswerFromBuffer(const char *&buff, const char *
 	
 	
 	#ifdef DEBUG4
-	*log_file << Now() << "NexStarCommandGetRaDec::readAnswerFromBuffer: "
+	*getLogFile() << Now() << "NexStarCommandGetRaDec::readAnswerFromBuffer: "
 	                      "ra = " << ra << ", dec = " << dec
 	          << endl;
 	#endif
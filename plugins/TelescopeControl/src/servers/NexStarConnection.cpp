@@ -45,7 +45,7 @@ void NexStarConnection::resetCommunication(void)
 	read_buff_end = read_buff;
 	write_buff_end = write_buff;
 #ifdef DEBUG4
-	*log_file << Now() << "NexStarConnection::resetCommunication" << endl;
+	*getLogFile() << Now() << "NexStarConnection::resetCommunication" << endl;
 #endif
 }
 
@@ -58,12 +58,12 @@ void NexStarConnection::dataReceived(const char *&p,const char *read_buff_end)
 {
 	if (isClosed())
 	{
-		*log_file << Now() << "NexStarConnection::dataReceived: strange: fd is closed" << endl;
+		*getLogFile() << Now() << "NexStarConnection::dataReceived: strange: fd is closed" << endl;
 	}
 	else if (command_list.empty())
 	{
 		#ifdef DEBUG4
-		*log_file << Now() << "NexStarConnection::dataReceived: "
+		*getLogFile() << Now() << "NexStarConnection::dataReceived: "
 		                      "error: command_list is empty" << endl;
 		#endif
 		resetCommunication();
@@ -71,7 +71,7 @@ void NexStarConnection::dataReceived(const char *&p,const char *read_buff_end)
 	}
 	else if (command_list.front()->needsNoAnswer())
 	{
-		*log_file << Now() << "NexStarConnection::dataReceived: "
+		*getLogFile() << Now() << "NexStarConnection::dataReceived: "
 		                      "strange: command(" << *command_list.front()
 		                   << ") needs no answer" << endl;
 	}
@@ -80,7 +80,7 @@ void NexStarConnection::dataReceived(const char *&p,const char *read_buff_end)
 		while(true)
 		{
 			const int rc=command_list.front()->readAnswerFromBuffer(p, read_buff_end);
-			//*log_file << Now() << "NexStarConnection::dataReceived: "
+			//*getLogFile() << Now() << "NexStarConnection::dataReceived: "
 			//                   << *command_list.front() << "->readAnswerFromBuffer returned "
 			//                   << rc << endl;
 			if (rc <= 0)
@@ -109,7 +109,7 @@ void NexStarConnection::sendCommand(NexStarCommand *command)
 	if (command)
 	{
 		#ifdef DEBUG4
-		*log_file << Now() << "NexStarConnection::sendCommand(" << *command
+		*getLogFile() << Now() << "NexStarConnection::sendCommand(" << *command
 			  << ")" << endl;
 		#endif
 			command_list.push_back(command);
@@ -119,7 +119,7 @@ void NexStarConnection::sendCommand(NexStarCommand *command)
 				                          write_buff_end,
 				                          write_buff+sizeof(write_buff)))
 			{
-				//*log_file << Now() << "NexStarConnection::sendCommand: "
+				//*getLogFile() << Now() << "NexStarConnection::sendCommand: "
 				//                   << (*command_list.front())
 				//                   << "::writeCommandToBuffer ok" << endl;
 				if (command_list.front()->needsNoAnswer())
@@ -136,13 +136,13 @@ void NexStarConnection::sendCommand(NexStarCommand *command)
 			}
 			else
 			{
-				//*log_file << Now() << "NexStarConnection::sendCommand: "
+				//*getLogFile() << Now() << "NexStarConnection::sendCommand: "
 				//                   << (*command_list.front())
 				//                   << "::writeCommandToBuffer failed" << endl;
 				break;
 			}
 		}
-		//*log_file << Now() << "NexStarConnection::sendCommand(" << *command << ") end"
+		//*getLogFile() << Now() << "NexStarConnection::sendCommand(" << *command << ") end"
 		//                   << endl;
 	}
 }
@@ -43,7 +43,7 @@ SerialPort::SerialPort(Server &server, const char *serial_device)
 	handle = CreateFile(serial_device, GENERIC_READ|GENERIC_WRITE, 0, 0, OPEN_EXISTING, 0, 0);
 	if (handle == INVALID_HANDLE_VALUE)
 	{
-		*log_file << Now() << "SerialPort::SerialPort(" << serial_device << "): "
+		*getLogFile() << Now() << "SerialPort::SerialPort(" << serial_device << "): "
 		                      "CreateFile() failed: " << GetLastError() << endl;
 	}
 	else
@@ -56,14 +56,14 @@ SerialPort::SerialPort(Server &server, const char *serial_device)
 		timeouts.WriteTotalTimeoutConstant = 0;
 		if (!SetCommTimeouts(handle, &timeouts))
 		{
-			*log_file << Now() << "SerialPort::SerialPort(" << serial_device << "): "
+			*getLogFile() << Now() << "SerialPort::SerialPort(" << serial_device << "): "
 			                      "SetCommTimeouts() failed: " << GetLastError() << endl;
 		}
 		else
 		{
 			if (!GetCommState(handle, &dcb_original))
 			{
-				*log_file << Now() << "SerialPort::SerialPort(" << serial_device << "): "
+				*getLogFile() << Now() << "SerialPort::SerialPort(" << serial_device << "): "
 				                      "GetCommState() failed: " << GetLastError() << endl;
 			}
 			else
@@ -73,14 +73,14 @@ SerialPort::SerialPort(Server &server, const char *serial_device)
 				dcb.DCBlength = sizeof(dcb);
 				if (!BuildCommDCB("9600,n,8,1", &dcb))
 				{
-					*log_file << Now() << "SerialPort::SerialPort(" << serial_device << "): "
+					*getLogFile() << Now() << "SerialPort::SerialPort(" << serial_device << "): "
 						              "BuildCommDCB() failed: " << GetLastError() << endl;
 				}
 				else
 				{
 					if (!SetCommState(handle,&dcb))
 					{
-						*log_file << Now() << "SerialPort::SerialPort(" << serial_device << "): "
+						*getLogFile() << Now() << "SerialPort::SerialPort(" << serial_device << "): "
 							              "SetCommState() failed: " << GetLastError() << endl;
 					}
 					else
@@ -98,21 +98,21 @@ SerialPort::SerialPort(Server &server, const char *serial_device)
 	fd = open(serial_device, O_RDWR|O_NOCTTY);
 	if (fd < 0)
 	{
-		*log_file << Now() << "SerialPort::SerialPort(" << serial_device << "): "
+		*getLogFile() << Now() << "SerialPort::SerialPort(" << serial_device << "): "
 		                      "open() failed: " << strerror(errno) << endl;
 	}
 	else
 	{
 		if (SETNONBLOCK(fd) < 0)
 		{
-			*log_file << Now() << "SerialPort::SerialPort(" << serial_device << "): "
+			*getLogFile() << Now() << "SerialPort::SerialPort(" << serial_device << "): "
 			                      "fcntl(O_NONBLOCK) failed: " << STRERROR(ERRNO) << endl;
 		}
 		else
 		{
 			if (tcgetattr(fd,&termios_original) < 0)
 			{
-				*log_file << Now() << "SerialPort::SerialPort(" << serial_device << "): "
+				*getLogFile() << Now() << "SerialPort::SerialPort(" << serial_device << "): "
 				                      "tcgetattr failed: " << strerror(errno) << endl;
 			}
 			else
@@ -129,7 +129,7 @@ SerialPort::SerialPort(Server &server, const char *serial_device)
 				termios_new.c_cc[VMIN] = 1;
 				if (tcsetattr(fd,TCSAFLUSH,&termios_new) < 0)
 				{
-					*log_file << Now() << "SerialPort::SerialPort(" << serial_device << "): "
+					*getLogFile() << Now() << "SerialPort::SerialPort(" << serial_device << "): "
 					                      "tcsetattr failed: " << strerror(errno) << endl;
 				}
 				else
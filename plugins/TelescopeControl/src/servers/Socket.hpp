@@ -86,6 +86,8 @@ public:
 	}
 	virtual bool isTcpConnection() const { return false; }
 	virtual void sendPosition(unsigned int ra_int, int dec_int, int status) {Q_UNUSED(ra_int); Q_UNUSED(dec_int); Q_UNUSED(status);}
+	//! The descriptor of the connection, to watch it for incoming data.
+	int getFd() const {return (int)fd;}
 	
 protected:
 	Socket(Server &server, SOCKET fd) : server(server), fd(fd) {}
@@ -31,28 +31,31 @@
 #include <QDir>
 #include <QBuffer>
 #include <QThread>
+#include <QDateTime>
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <stdexcept>
 #include <stdio.h>
 
-// #include <QNetworkDiskCache>
+#include <QNetworkDiskCache>
+
+// How long a cached JSON description is used without asking the server, in days
+static const int cachedDescriptionLifetime = 30;
 
 // Init statics
 QNetworkAccessManager* MultiLevelJsonBase::networkAccessManager = NULL;
+StelTileLoader MultiLevelJsonBase::tileLoader;
 
 QNetworkAccessManager& MultiLevelJsonBase::getNetworkAccessManager()
 {
 	if (networkAccessManager==NULL)
 	{
 		networkAccessManager = new QNetworkAccessManager(&StelApp::getInstance());
-// Cache on JSON files doesn't work, and I don't know why.
-// There may be a problem in Qt for text objects caching (compression is activated in cache)
-// 		QNetworkDiskCache* cache = new QNetworkDiskCache(networkAccessManager);
-// 		QString cachePath = StelApp::getInstance().getCacheDir();
-// 		cache->setCacheDirectory(cachePath+"/JSONCache");
-// 		networkAccessManager->setCache(cache);
+		// The descriptions of the tiles seen before are read from the disk when panning back, see startDownload()
+		QNetworkDiskCache* cache = new QNetworkDiskCache(networkAccessManager);
+		cache->setCacheDirectory(StelFileMgr::getCacheDir()+"/JSONCache");
+		networkAccessManager->setCache(cache);
 		connect(networkAccessManager, SIGNAL(finished(QNetworkReply*)), &StelApp::getInstance(), SLOT(reportFileDownloadFinished(QNetworkReply*)));
 	}
 	return *networkAccessManager;
@@ -111,7 +114,7 @@ void MultiLevelJsonBase::initFromUrl(const QString& url)
 {
 	const MultiLevelJsonBase* parent = qobject_cast<MultiLevelJsonBase*>(QObject::parent());
 	contructorUrl = url;
-	if (!url.startsWith("http://") && (parent==NULL || !parent->getBaseUrl().startsWith("http://")))
+	if (!isRemoteUrl(url) && (parent==NULL || !isRemoteUrl(parent->getBaseUrl())))
 	{
 		// Assume a local file
 		QString fileName = StelFileMgr::findFile(url);
@@ -158,28 +161,101 @@ void MultiLevelJsonBase::initFromUrl(const QString& url)
 		// This is useful to reduce bandwidth when the user moves rapidely
 		deletionDelay = 0.001;
 		QUrl qurl;
-		if (url.startsWith("http://"))
+		if (isRemoteUrl(url))
 		{
 			qurl.setUrl(url);
 		}
 		else
 		{
-			Q_ASSERT(parent->getBaseUrl().startsWith("http://"));
+			Q_ASSERT(isRemoteUrl(parent->getBaseUrl()));
 			qurl.setUrl(parent->getBaseUrl()+url);
 		}
-		Q_ASSERT(httpReply==NULL);
-		QNetworkRequest req(qurl);
-		req.setRawHeader("User-Agent", StelUtils::getApplicationName().toLatin1());
-		httpReply = getNetworkAccessManager().get(req);
-		//qDebug() << "Started downloading " << httpReply->request().url().path();
-		Q_ASSERT(httpReply->error()==QNetworkReply::NoError);
-		//qDebug() << httpReply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool();
-		connect(httpReply, SIGNAL(finished()), this, SLOT(downloadFinished()));
-		//connect(httpReply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(downloadError(QNetworkReply::NetworkError)));
-		//connect(httpReply, SIGNAL(destroyed()), this, SLOT(replyDestroyed()));
+		downloadUrl = qurl;
 		downloading = true;
 		QString turl = qurl.toString();
 		baseUrl = turl.left(turl.lastIndexOf('/')+1);
+		// The sub tiles wait for a loading slot, see requestDownload()
+		if (parent==NULL)
+			startDownload();
+	}
+}
+
+bool MultiLevelJsonBase::isRemoteUrl(const QString& url)
+{
+	return url.startsWith("http://") || url.startsWith("file://");
+}
+
+// The descriptions of a survey do not change, but the servers seldom say so. Qt validates a cached reply
+// on the network before using it, even with PreferCache, when it has no expiration date or when the server
+// asks for it (Cache-Control: no-cache or must-revalidate): the JSON descriptions were never read from the
+// cache. Their cached copy is made fresh before being requested again.
+static void keepCachedDescriptionFresh(QAbstractNetworkCache* cache, const QUrl& url)
+{
+	if (cache==NULL)
+		return;
+	QNetworkCacheMetaData metaData = cache->metaData(url);
+	if (!metaData.isValid())
+		return;
+	QNetworkCacheMetaData::RawHeaderList headers;
+	foreach (const QNetworkCacheMetaData::RawHeader& header, metaData.rawHeaders())
+	{
+		const QByteArray name = header.first.toLower();
+		if (name!="cache-control" && name!="pragma" && name!="expires")
+			headers << header;
+	}
+	const QDateTime now = QDateTime::currentDateTimeUtc();
+	if (headers.size()==metaData.rawHeaders().size() && metaData.expirationDate().isValid() && metaData.expirationDate()>now)
+		return;
+	metaData.setRawHeaders(headers);
+	metaData.setExpirationDate(now.addDays(cachedDescriptionLifetime));
+	metaData.setSaveToDisk(true);
+	cache->updateMetaData(metaData);
+}
+
+void MultiLevelJsonBase::startDownload()
+{
+	Q_ASSERT(httpReply==NULL);
+	QNetworkRequest req(downloadUrl);
+	req.setRawHeader("User-Agent", StelUtils::getApplicationName().toLatin1());
+	req.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
+	keepCachedDescriptionFresh(getNetworkAccessManager().cache(), downloadUrl);
+	httpReply = getNetworkAccessManager().get(req);
+	//qDebug() << "Started downloading " << httpReply->request().url().path();
+	Q_ASSERT(httpReply->error()==QNetworkReply::NoError);
+	//qDebug() << httpReply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool();
+	connect(httpReply, SIGNAL(finished()), this, SLOT(downloadFinished()));
+	//connect(httpReply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(downloadError(QNetworkReply::NetworkError)));
+	//connect(httpReply, SIGNAL(destroyed()), this, SLOT(replyDestroyed()));
+}
+
+void MultiLevelJsonBase::requestDownload(double priority)
+{
+	if (!downloading || errorOccured)
+		return;
+	if (tileLoader.request(this, priority) && httpReply==NULL && loadThread==NULL)
+		startDownload();
+}
+
+void MultiLevelJsonBase::cancelLoading()
+{
+	// The parsing thread cannot be interrupted, only the download. A tile which is parsing
+	// holds its slot until jsonLoadFinished().
+	if (httpReply)
+	{
+		disconnect(httpReply, SIGNAL(finished()), this, SLOT(downloadFinished()));
+		httpReply->abort();
+		httpReply->deleteLater();
+		httpReply = NULL;
+	}
+}
+
+void MultiLevelJsonBase::updateTileLoading()
+{
+	foreach (const QObject* tile, tileLoader.update())
+	{
+		MultiLevelJsonBase* t = qobject_cast<MultiLevelJsonBase*>(const_cast<QObject*>(tile));
+		if (t)
+			t->cancelLoading();
 	}
 }
 
@@ -208,6 +284,7 @@ void MultiLevelJsonBase::initFromQVariantMap(const QVariantMap& map)
 // Destructor
 MultiLevelJsonBase::~MultiLevelJsonBase()
 {
+	tileLoader.release(this);
 	if (httpReply)
 	{
 		//qDebug() << "Abort: " << httpReply->request().url().path();
@@ -295,6 +372,7 @@ void MultiLevelJsonBase::downloadFinished()
 	Q_ASSERT(downloading);
 	if (httpReply->error()!=QNetworkReply::NoError)
 	{
+		tileLoader.release(this);
 		if (httpReply->error()!=QNetworkReply::OperationCanceledError)
 			qWarning() << "WARNING : Problem while downloading JSON description for " << httpReply->request().url().path() << ": "<< httpReply->errorString();
 		errorOccured = true;
@@ -309,6 +387,7 @@ void MultiLevelJsonBase::downloadFinished()
 	if (content.isEmpty())
 	{
 		qWarning() << "WARNING : empty JSON description for " << httpReply->request().url().path();
+		tileLoader.release(this);
 		errorOccured = true;
 		httpReply->deleteLater();
 		httpReply=NULL;
@@ -322,6 +401,7 @@ void MultiLevelJsonBase::downloadFinished()
 	httpReply=NULL;
 
 	Q_ASSERT(loadThread==NULL);
+	tileLoader.hold(this);
 	loadThread = new JsonLoadThread(this, content, qZcompressed, gzCompressed);
 	connect(loadThread, SIGNAL(finished()), this, SLOT(jsonLoadFinished()));
 	loadThread->start(QThread::LowestPriority);
@@ -334,6 +414,7 @@ void MultiLevelJsonBase::jsonLoadFinished()
 	delete loadThread;
 	loadThread = NULL;
 	downloading = false;
+	tileLoader.release(this);
 	if (errorOccured)
 		return;
 	try
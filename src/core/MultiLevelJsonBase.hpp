@@ -20,9 +20,11 @@
 #define _MULTILEVELJSONBASE_HPP_
 
 #include "StelSkyLayer.hpp"
+#include "StelTileLoader.hpp"
 
 #include <QList>
 #include <QString>
+#include <QUrl>
 #include <QVariantMap>
 #include <QNetworkReply>
 
@@ -69,6 +71,13 @@ public:
 	//! It will practically occur after the delay passed as argument to deleteUnusedTiles() has expired.
 	void scheduleChildsDeletion();
 
+	//! Return the scheduler of the loading of the tiles of all the layers.
+	static StelTileLoader& getTileLoader() {return tileLoader;}
+
+	//! Give the loading slots for the next frame, and cancel the loading of the tiles which were not requested in this frame.
+	//! Must be called once per frame, after drawing all the layers.
+	static void updateTileLoading();
+
 private slots:
 	//! Called when the download for the JSON file terminated.
 	void downloadFinished();
@@ -112,10 +121,28 @@ protected:
 	//! Load the element information from a JSON file
 	static QVariantMap loadFromJSON(QIODevice& input, bool qZcompressed=false, bool gzCompressed=false);
 
+	//! Request to download the JSON description of a sub tile, it starts when the tile gets a loading slot.
+	//! Must be called in each frame while the description is wanted.
+	void requestDownload(double priority);
+
+	//! Stop the loading of the tile, because it is no longer requested.
+	//! The loading starts again at the next request.
+	virtual void cancelLoading();
+
+	//! Return whether the JSON description at url is downloaded, as for http:// URLs.
+	//! file:// URLs are downloaded too, so that a local tile tree behaves as a remote survey.
+	static bool isRemoteUrl(const QString& url);
+
 private:
 	//! Return the base URL prefixed to relative URL
 	QString getBaseUrl() const {return baseUrl;}
 
+	//! Start the download of the JSON description from downloadUrl
+	void startDownload();
+
+	// The URL of the JSON description of a remote sub tile, downloaded when requested
+	QUrl downloadUrl;
+
 	// Used to download remote JSON files if needed
 	class QNetworkReply* httpReply;
 
@@ -137,6 +164,8 @@ private:
 	static class QNetworkAccessManager* networkAccessManager;
 
 	static QNetworkAccessManager& getNetworkAccessManager();
+
+	static StelTileLoader tileLoader;
 };
 
 #endif // _MULTILEVELJSONBASE_HPP_
@@ -57,6 +57,17 @@ float Extinction::airmass(float cosZ, const bool apparent_z) const
 	}
 }
 
+float Extinction::airmassTable[Extinction::AIRMASS_TABLE_SIZE+1];
+const bool Extinction::airmassTableInitialized = Extinction::initAirmassTable();
+
+bool Extinction::initAirmassTable()
+{
+	const Extinction ext;
+	for (int i=0; i<=AIRMASS_TABLE_SIZE; ++i)
+		airmassTable[i] = ext.airmass(-0.035f + i*(1.035f/AIRMASS_TABLE_SIZE), false);
+	return true;
+}
+
 /* ***************************************************************************************************** */
 
 // The following 4 are to be configured, the rest is derived.
@@ -31,6 +31,8 @@
 #include "VecMath.hpp"
 #include "StelProjector.hpp"
 
+#include <algorithm>
+
 //! @class Extinction
 //! This class performs extinction computations, following literature from atmospheric optics and astronomy.
 //! Airmass computations are limited to meaningful altitudes.
@@ -70,6 +72,15 @@ public:
 		*mag += airmass(altAzPos[2], false) * ext_coeff;
 	}
 
+	//! Same as forward(), with the airmass interpolated in a precomputed table instead of evaluated.
+	//! Meant for the many stars drawn each frame. The airmass differs from the exact one by less than
+	//! 0.002 above the horizon and 0.013 down to -2 degrees.
+	//! @param sinAlt the z component of the NORMALIZED geometrical altAz position vector.
+	void forwardTabulated(float sinAlt, float* mag) const
+	{
+		*mag += tabulatedAirmass(sinAlt) * ext_coeff;
+	}
+
 	//! Compute inverse extinction effect for arrays of size num position vectors and magnitudes.
 	//! @param altAzPos are the NORMALIZED (!!) (geometrical) star position vectors, and their z components sin(geometric_altitude).
 	//! Note that forward/backward are no absolute reverse operations!
@@ -101,6 +112,34 @@ private:
 	//! Rozenberg is infinite at Z=92.17 deg, Young at Z=93.6 deg, so this function RETURNS SUBHORIZONTAL_AIRMASS BELOW -2 DEGREES!
 	float airmass(float cosZ, const bool apparent_z=true) const;
 
+	//! Geometrical airmass (apparent_z = false) interpolated in airmassTable.
+	float tabulatedAirmass(float cosZ) const
+	{
+		if (cosZ<-0.035f)
+		{
+			switch (undergroundExtinctionMode)
+			{
+				case UndergroundExtinctionZero:
+					return 0.f;
+				case UndergroundExtinctionMax:
+					return 42.f;
+				case UndergroundExtinctionMirror:
+					cosZ = -0.035f - (cosZ+0.035f);
+			}
+		}
+		const float u = (std::min(cosZ, 1.f)+0.035f) * (AIRMASS_TABLE_SIZE/1.035f);
+		const int i = std::min((int)u, AIRMASS_TABLE_SIZE-1);
+		return airmassTable[i] + (u-i)*(airmassTable[i+1]-airmassTable[i]);
+	}
+
+	//! Number of intervals of airmassTable.
+	static const int AIRMASS_TABLE_SIZE = 1024;
+	//! airmass(cosZ, false) at regular steps of cosZ from -0.035 (-2 degrees) to 1.
+	//! It depends on no parameter, so it is computed once when the program starts.
+	static float airmassTable[AIRMASS_TABLE_SIZE+1];
+	static const bool airmassTableInitialized;
+	static bool initAirmassTable();
+
 	//! k, magnitudes/airmass, in [0.00, ... 1.00], (default 0.20).
 	float ext_coeff;
 
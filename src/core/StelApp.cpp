@@ -635,6 +635,8 @@ void StelApp::draw()
 		module->draw(core);
 	}
 	core->postDraw();
+	// The textures bound in this frame are kept
+	textureMgr->update();
 	applyRenderBuffer();
 }
 
@@ -0,0 +1,157 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include "StelCompiledCache.hpp"
+#include "StelFileMgr.hpp"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <stdexcept>
+
+StelCompiledCache::StelCompiledCache(const QString& sourcePath, const QString& cacheName, quint32 magic, quint32 version, SourceCheck check)
+	: sourcePath(sourcePath)
+	, magic(magic)
+	, version(version)
+	, check(check)
+	, sourceMtime(0)
+	, mapped(NULL)
+	, in(NULL)
+	, saveFile(NULL)
+	, out(NULL)
+{
+	const QFileInfo info(sourcePath);
+	sourceSize = info.size();
+	if (check==CheckModificationTime)
+		sourceMtime = info.lastModified().toMSecsSinceEpoch();
+	// One compiled copy per source file, as the user and installation directories may have files of the same name
+	const QByteArray pathHash = QCryptographicHash::hash(info.absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+	cachePath = StelFileMgr::getCacheDir() + "/" + cacheName + "/" + QString::fromLatin1(pathHash.left(16)) + ".bin";
+}
+
+StelCompiledCache::~StelCompiledCache()
+{
+	closeRead();
+	if (saveFile)
+	{
+		delete out;
+		saveFile->cancelWriting();
+		delete saveFile;
+	}
+}
+
+void StelCompiledCache::setSourceData(const QByteArray& data)
+{
+	sourceSize = data.size();
+	sourceHash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+QDataStream* StelCompiledCache::beginRead()
+{
+	Q_ASSERT(check==CheckModificationTime || !sourceHash.isEmpty());
+	closeRead();
+	readFile.setFileName(cachePath);
+	if (!readFile.open(QIODevice::ReadOnly))
+		return NULL;
+	// Map the file instead of reading it, only the parsed records are copied
+	mapped = readFile.size()>0 ? readFile.map(0, readFile.size()) : NULL;
+	readData = mapped ? QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), readFile.size()) : readFile.readAll();
+	in = new QDataStream(readData);
+	in->setVersion(QDataStream::Qt_5_0);
+
+	quint32 cachedMagic, cachedVersion;
+	QString cachedPath;
+	qint64 cachedSize, cachedMtime;
+	QByteArray cachedHash;
+	*in >> cachedMagic >> cachedVersion >> cachedPath >> cachedSize >> cachedMtime >> cachedHash;
+	if (in->status()!=QDataStream::Ok || cachedMagic!=magic || cachedVersion!=version || cachedPath!=sourcePath
+	    || cachedSize!=sourceSize || cachedMtime!=sourceMtime || cachedHash!=sourceHash)
+	{
+		closeRead();
+		return NULL;
+	}
+	return in;
+}
+
+bool StelCompiledCache::endRead()
+{
+	const bool ok = in && in->status()==QDataStream::Ok;
+	closeRead();
+	if (!ok)
+		qWarning() << "Compiled file" << QDir::toNativeSeparators(cachePath) << "is damaged, loading" << QDir::toNativeSeparators(sourcePath);
+	return ok;
+}
+
+void StelCompiledCache::closeRead()
+{
+	delete in;
+	in = NULL;
+	readData.clear();
+	if (mapped)
+		readFile.unmap(mapped);
+	mapped = NULL;
+	readFile.close();
+}
+
+QDataStream* StelCompiledCache::beginWrite()
+{
+	Q_ASSERT(check==CheckModificationTime || !sourceHash.isEmpty());
+	Q_ASSERT(saveFile==NULL);
+	try
+	{
+		StelFileMgr::makeSureDirExistsAndIsWritable(QFileInfo(cachePath).absolutePath());
+	}
+	catch (std::runtime_error& e)
+	{
+		qWarning() << "Cannot write compiled file:" << e.what();
+		return NULL;
+	}
+
+	saveFile = new QSaveFile(cachePath);
+	if (!saveFile->open(QIODevice::WriteOnly))
+	{
+		qWarning() << "Cannot write compiled file" << QDir::toNativeSeparators(cachePath) << saveFile->errorString();
+		delete saveFile;
+		saveFile = NULL;
+		return NULL;
+	}
+	out = new QDataStream(saveFile);
+	out->setVersion(QDataStream::Qt_5_0);
+	*out << magic << version << sourcePath << sourceSize << sourceMtime << sourceHash;
+	return out;
+}
+
+void StelCompiledCache::endWrite()
+{
+	if (!saveFile)
+		return;
+	const bool ok = out->status()==QDataStream::Ok;
+	delete out;
+	out = NULL;
+	if (!ok)
+		saveFile->cancelWriting();
+	if (!saveFile->commit())
+		qWarning() << "Cannot write compiled file" << QDir::toNativeSeparators(cachePath) << saveFile->errorString();
+	delete saveFile;
+	saveFile = NULL;
+}
@@ -0,0 +1,96 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _STELCOMPILEDCACHE_HPP_
+#define _STELCOMPILEDCACHE_HPP_
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+#include <QString>
+
+class QSaveFile;
+
+//! @class StelCompiledCache
+//! Compiled copy of a data file in the cache directory.
+//! Parsing some data files takes a long time at each start, e.g. the JSON catalogues of the plugins,
+//! ssystem.ini or the list of locations, so their parsed contents are written to a binary file, one
+//! per source file, in a subdirectory of the cache directory. The compiled copy starts with a header
+//! which identifies its format and its source file, and it is only read while it matches the source.
+//! It is read from a memory mapped file, and written through a QSaveFile so that an interrupted write
+//! does not leave a partial copy. The records which follow the header are up to the caller.
+class StelCompiledCache
+{
+public:
+	//! How the compiled copy is matched with its source file.
+	enum SourceCheck
+	{
+		CheckModificationTime,	//!< Size and modification time: the source file is not read
+		CheckContentHash	//!< Size and SHA-1 hash of the contents, set with setSourceData()
+	};
+
+	//! @param sourcePath the parsed file.
+	//! @param cacheName the subdirectory of the cache directory where the compiled copy is written.
+	//! @param magic identifies the format of the records.
+	//! @param version the version of the format, the copies of the other versions are ignored.
+	StelCompiledCache(const QString& sourcePath, const QString& cacheName, quint32 magic, quint32 version, SourceCheck check=CheckModificationTime);
+	~StelCompiledCache();
+
+	//! The contents of the source file, required before reading or writing with CheckContentHash.
+	void setSourceData(const QByteArray& data);
+
+	//! Open the compiled copy and check its header.
+	//! @return the stream of the records which follow the header, or NULL if the copy is missing or out of date.
+	QDataStream* beginRead();
+	//! Close the compiled copy after reading its records.
+	//! @return false, with a warning, if the records could not be read: the caller then loads the source file.
+	bool endRead();
+
+	//! Create a new compiled copy and write its header.
+	//! @return the stream of the records, or NULL if the copy cannot be written. The cache is optional,
+	//! so the errors are only logged.
+	QDataStream* beginWrite();
+	//! Replace the previous compiled copy by the new one.
+	void endWrite();
+
+	//! Path of the compiled copy.
+	QString getCachePath() const {return cachePath;}
+
+private:
+	//! Unmap and close the compiled copy.
+	void closeRead();
+
+	QString sourcePath;
+	QString cachePath;
+	quint32 magic;
+	quint32 version;
+	SourceCheck check;
+	qint64 sourceSize;
+	qint64 sourceMtime;
+	QByteArray sourceHash;
+
+	QFile readFile;
+	uchar* mapped;
+	QByteArray readData;
+	QDataStream* in;
+	QSaveFile* saveFile;
+	QDataStream* out;
+};
+
+#endif // _STELCOMPILEDCACHE_HPP_
@@ -83,6 +83,10 @@ StelCore::StelCore()
 	, de431Available(false)
 	, de430Active(false)
 	, de431Active(false)
+	, projectorRequests(0)
+	, projectorAllocations(0)
+	, projectorRequestsLastFrame(0)
+	, projectorAllocationsLastFrame(0)
 {
 	setObjectName("StelCore");
 	registerMathMetaTypes();
@@ -290,16 +294,45 @@ const StelGeodesicGrid* StelCore::getGeodesicGrid(int maxLevel) const
 	}
 	else if (maxLevel>geodesicGrid->getMaxLevel())
 	{
-		delete geodesicGrid;
-		geodesicGrid = new StelGeodesicGrid(maxLevel);
+		// Only the new levels are computed, the zones of the existing ones do not change
+		geodesicGrid->extend(maxLevel);
 	}
 	return geodesicGrid;
 }
 
+StelProjectorP StelCore::getCachedProjector(const CachedProjector& entry) const
+{
+	++projectorRequests;
+	if (!entry.prj.isNull() && entry.projType==currentProjectionType && entry.params==currentProjectorParams)
+		return entry.prj;
+	return StelProjectorP();
+}
+
+void StelCore::setCachedProjector(CachedProjector& entry, const StelProjectorP& prj) const
+{
+	++projectorAllocations;
+	entry.prj = prj;
+	entry.projType = currentProjectionType;
+	entry.params = currentProjectorParams;
+}
+
+void StelCore::invalidateProjectorCache()
+{
+	for (int i=0; i<=FrameGalactic; ++i)
+	{
+		projectorCache[i][0].prj.clear();
+		projectorCache[i][1].prj.clear();
+	}
+}
+
 StelProjectorP StelCore::getProjection2d() const
 {
-	StelProjectorP prj(new StelProjector2d());
+	StelProjectorP prj = getCachedProjector(projector2dCache);
+	if (!prj.isNull())
+		return prj;
+	prj = StelProjectorP(new StelProjector2d());
 	prj->init(currentProjectorParams);
+	setCachedProjector(projector2dCache, prj);
 	return prj;
 }
 
@@ -353,27 +386,48 @@ StelProjectorP StelCore::getProjection(StelProjector::ModelViewTranformP modelVi
 // Get an instance of projector using the current display parameters from Navigation, StelMovementMgr
 StelProjectorP StelCore::getProjection(FrameType frameType, RefractionMode refractionMode) const
 {
+	if (frameType<=FrameUninitialized || frameType>FrameGalactic)
+	{
+		qDebug() << "Unknown reference frame type: " << (int)frameType << ".";
+		Q_ASSERT(0);
+		return getProjection2d();
+	}
+
+	// Same test as in the modelview transform functions
+	const bool refraction = !(refractionMode==RefractionOff || skyDrawer==NULL || (refractionMode==RefractionAuto && skyDrawer->getFlagHasAtmosphere()==false));
+	CachedProjector& entry = projectorCache[frameType][refraction ? 1 : 0];
+	StelProjectorP prj = getCachedProjector(entry);
+	if (!prj.isNull())
+		return prj;
+
 	switch (frameType)
 	{
 		case FrameAltAz:
-			return getProjection(getAltAzModelViewTransform(refractionMode));
+			prj = getProjection(getAltAzModelViewTransform(refractionMode));
+			break;
 		case FrameHeliocentricEclipticJ2000:
-			return getProjection(getHeliocentricEclipticModelViewTransform(refractionMode));
+			prj = getProjection(getHeliocentricEclipticModelViewTransform(refractionMode));
+			break;
 		case FrameObservercentricEclipticJ2000:
-			return getProjection(getObservercentricEclipticJ2000ModelViewTransform(refractionMode));
+			prj = getProjection(getObservercentricEclipticJ2000ModelViewTransform(refractionMode));
+			break;
 		case FrameObservercentricEclipticOfDate:
-			return getProjection(getObservercentricEclipticOfDateModelViewTransform(refractionMode));
+			prj = getProjection(getObservercentricEclipticOfDateModelViewTransform(refractionMode));
+			break;
 		case FrameEquinoxEqu:
-			return getProjection(getEquinoxEquModelViewTransform(refractionMode));
+			prj = getProjection(getEquinoxEquModelViewTransform(refractionMode));
+			break;
 		case FrameJ2000:
-			return getProjection(getJ2000ModelViewTransform(refractionMode));
+			prj = getProjection(getJ2000ModelViewTransform(refractionMode));
+			break;
 		case FrameGalactic:
-			 return getProjection(getGalacticModelViewTransform(refractionMode));
+			prj = getProjection(getGalacticModelViewTransform(refractionMode));
+			break;
 		default:
-			qDebug() << "Unknown reference frame type: " << (int)frameType << ".";
+			Q_ASSERT(0);
 	}
-	Q_ASSERT(0);
-	return getProjection2d();
+	setCachedProjector(entry, prj);
+	return prj;
 }
 
 StelToneReproducer* StelCore::getToneReproducer()
@@ -438,6 +492,7 @@ void StelCore::windowHasBeenResized(float x, float y, float width, float height)
 	currentProjectorParams.viewportXywh.set(x, y, width, height);
 	currentProjectorParams.viewportCenter.set(x+(0.5+currentProjectorParams.viewportCenterOffset.v[0])*width, y+(0.5+currentProjectorParams.viewportCenterOffset.v[1])*height);
 	currentProjectorParams.viewportFovDiameter = qMin(width,height);
+	invalidateProjectorCache();
 }
 
 /*************************************************************************
@@ -445,6 +500,13 @@ void StelCore::windowHasBeenResized(float x, float y, float width, float height)
 *************************************************************************/
 void StelCore::update(double deltaTime)
 {
+	// A new frame starts
+	projectorRequestsLastFrame = projectorRequests;
+	projectorAllocationsLastFrame = projectorAllocations;
+	projectorRequests = 0;
+	projectorAllocations = 0;
+	invalidateProjectorCache();
+
 	// Update the position of observation and time and recompute planet positions etc...
 	updateTime(deltaTime);
 
@@ -667,6 +729,7 @@ void StelCore::lookAtJ2000(const Vec3d& pos, const Vec3d& aup)
 			      s[2],u[2],-f[2],0.,
 			      0.,0.,0.,1.);
 	invertMatAltAzModelView = matAltAzModelView.inverse();
+	invalidateProjectorCache();
 }
 
 Vec3d StelCore::altAzToEquinoxEqu(const Vec3d& v, RefractionMode refMode) const
@@ -847,6 +910,7 @@ StelProjector::ModelViewTranformP StelCore::getGalacticModelViewTransform(Refrac
 // called in update() (for every frame)
 void StelCore::updateTransformMatrices()
 {
+	invalidateProjectorCache();
 	matAltAzToEquinoxEqu = position->getRotAltAzToEquatorial(getJD(), getJDE());
 	matEquinoxEquToAltAz = matAltAzToEquinoxEqu.transpose();
 
@@ -159,12 +159,15 @@ public:
 	//! Update core state after drawing modules.
 	void postDraw();
 
-	//! Get a new instance of a simple 2d projection. This projection cannot be used to project or unproject but
+	//! Get an instance of a simple 2d projection. This projection cannot be used to project or unproject but
 	//! only for 2d painting
+	//! The instance is shared by all the callers until the projection parameters change.
 	StelProjectorP getProjection2d() const;
 
-	//! Get a new instance of projector using a modelview transformation corresponding to the given frame.
+	//! Get an instance of projector using a modelview transformation corresponding to the given frame.
 	//! If not specified the refraction effect is included if atmosphere is on.
+	//! The instance is shared by all the callers of the current frame with the same frame type and refraction,
+	//! until the projection parameters change. It must not be called from other threads than the main one.
 	StelProjectorP getProjection(FrameType frameType, RefractionMode refractionMode=RefractionAuto) const;
 
 	//! Get a new instance of projector using the given modelview transformation.
@@ -182,6 +185,7 @@ public:
 	const StelSkyDrawer* getSkyDrawer() const;
 
 	//! Get an instance of StelGeodesicGrid which is garanteed to allow for at least maxLevel levels
+	//! The instance is extended when a deeper level is requested: the previous search results are then invalid.
 	const StelGeodesicGrid* getGeodesicGrid(int maxLevel) const;
 
 	//! Get the instance of movement manager.
@@ -208,6 +212,12 @@ public:
 	//! Set vision direction
 	void lookAtJ2000(const Vec3d& pos, const Vec3d& up);
 
+	//! Get the number of projectors requested from getProjection(FrameType, RefractionMode) and getProjection2d()
+	//! during the last frame.
+	int getProjectorRequestsLastFrame() const {return projectorRequestsLastFrame;}
+	//! Get the number of projectors which were actually created for these requests during the last frame.
+	int getProjectorAllocationsLastFrame() const {return projectorAllocationsLastFrame;}
+
 	Vec3d altAzToEquinoxEqu(const Vec3d& v, RefractionMode refMode=RefractionAuto) const;
 	Vec3d equinoxEquToAltAz(const Vec3d& v, RefractionMode refMode=RefractionAuto) const;
 	Vec3d altAzToJ2000(const Vec3d& v, RefractionMode refMode=RefractionAuto) const;
@@ -675,6 +685,26 @@ private:
 	// Parameters to use when creating new instances of StelProjector
 	StelProjector::StelProjectorParams currentProjectorParams;
 
+	//! A projector handed out by getProjection() and the parameters it was created with.
+	struct CachedProjector
+	{
+		StelProjectorP prj;
+		ProjectionType projType;
+		StelProjector::StelProjectorParams params;
+	};
+	//! Projectors of the current frame by frame type, without and with refraction.
+	mutable CachedProjector projectorCache[FrameGalactic+1][2];
+	mutable CachedProjector projector2dCache;
+	//! Get the cached projector of entry, if it was created with the current parameters.
+	StelProjectorP getCachedProjector(const CachedProjector& entry) const;
+	//! Store prj as the cached projector of entry.
+	void setCachedProjector(CachedProjector& entry, const StelProjectorP& prj) const;
+	//! Drop the cached projectors, when the modelview matrices changed.
+	void invalidateProjectorCache();
+	// Counters of the current and the last frame
+	mutable int projectorRequests, projectorAllocations;
+	int projectorRequestsLastFrame, projectorAllocationsLastFrame;
+
 	void updateTransformMatrices();
 	void updateTime(double deltaTime);
 	void updateMaximumFov();
@@ -88,42 +88,54 @@ static const TopLevelTriangle icosahedron_triangles[20] =
         {{ 8, 9, 5}}  //  8
     };
 
-StelGeodesicGrid::StelGeodesicGrid(const int lev) : maxLevel(lev<0?0:lev), lastMaxSearchlevel(-1)
+StelGeodesicGrid::StelGeodesicGrid(const int lev) : maxLevel(0), triangles(0)
 {
-	if (maxLevel > 0)
-	{
-		triangles = new Triangle*[maxLevel+1];
-		int nr_of_triangles = 20;
-		for (int i=0;i<maxLevel;i++)
-		{
-			triangles[i] = new Triangle[nr_of_triangles];
-			nr_of_triangles *= 4;
-		}
-		for (int i=0;i<20;i++)
-		{
-			const int *const corners = icosahedron_triangles[i].corners;
-			initTriangle(0,i,
-			             icosahedron_corners[corners[0]],
-			             icosahedron_corners[corners[1]],
-			             icosahedron_corners[corners[2]]);
-		}
-	}
-	else
-	{
-		triangles = 0;
-	}
-	cacheSearchResult = new GeodesicSearchResult(*this);
+	extend(lev);
 }
 
 StelGeodesicGrid::~StelGeodesicGrid(void)
 {
+	clearSearchCache();
 	if (maxLevel > 0)
 	{
 		for (int i=maxLevel-1;i>=0;i--) delete[] triangles[i];
 		delete[] triangles;
 	}
-	delete cacheSearchResult;
-	cacheSearchResult = NULL;
+}
+
+void StelGeodesicGrid::extend(int newMaxLevel)
+{
+	if (newMaxLevel <= maxLevel)
+		return;
+	// The results hold arrays for each level of the grid
+	clearSearchCache();
+	Triangle **newTriangles = new Triangle*[newMaxLevel+1];
+	int nr_of_triangles = 20;
+	for (int i=0;i<newMaxLevel;i++)
+	{
+		newTriangles[i] = (i<maxLevel) ? triangles[i] : new Triangle[nr_of_triangles];
+		nr_of_triangles *= 4;
+	}
+	delete[] triangles;
+	triangles = newTriangles;
+	const int firstLevel = maxLevel;
+	maxLevel = newMaxLevel;
+	for (int i=0;i<20;i++)
+	{
+		const int *const corners = icosahedron_triangles[i].corners;
+		initTriangle(0,i,
+		             icosahedron_corners[corners[0]],
+		             icosahedron_corners[corners[1]],
+		             icosahedron_corners[corners[2]],
+		             firstLevel);
+	}
+}
+
+void StelGeodesicGrid::clearSearchCache(void)
+{
+	foreach (const CachedSearch& cached, searchCache)
+		delete cached.result;
+	searchCache.clear();
 }
 
 void StelGeodesicGrid::getTriangleCorners(int lev,int index,
@@ -205,24 +217,29 @@ int StelGeodesicGrid::getPartnerTriangle(int lev, int index) const
 void StelGeodesicGrid::initTriangle(int lev,int index,
 								const Vec3f &c0,
 								const Vec3f &c1,
-								const Vec3f &c2)
+								const Vec3f &c2,
+								int firstLevel)
 {
 	Q_ASSERT((c0^c1)*c2 >= 0.0);
 	Triangle &t(triangles[lev][index]);
-	t.e0 = c1+c2;
-	t.e0.normalize();
-	t.e1 = c2+c0;
-	t.e1.normalize();
-	t.e2 = c0+c1;
-	t.e2.normalize();
+	// The triangles of the existing levels only give the corners of the new ones
+	if (lev >= firstLevel)
+	{
+		t.e0 = c1+c2;
+		t.e0.normalize();
+		t.e1 = c2+c0;
+		t.e1.normalize();
+		t.e2 = c0+c1;
+		t.e2.normalize();
+	}
 	lev++;
 	if (lev < maxLevel)
 	{
 		index *= 4;
-		initTriangle(lev,index+0,c0,t.e2,t.e1);
-		initTriangle(lev,index+1,t.e2,c1,t.e0);
-		initTriangle(lev,index+2,t.e1,t.e0,c2);
-		initTriangle(lev,index+3,t.e0,t.e1,t.e2);
+		initTriangle(lev,index+0,c0,t.e2,t.e1,firstLevel);
+		initTriangle(lev,index+1,t.e2,c1,t.e0,firstLevel);
+		initTriangle(lev,index+2,t.e1,t.e0,c2,firstLevel);
+		initTriangle(lev,index+3,t.e0,t.e1,t.e2,firstLevel);
 	}
 }
 
@@ -312,7 +329,7 @@ int StelGeodesicGrid::getZoneNumberForPoint(const Vec3f &v,int searchLevel) cons
 
 // First iteration on the icosahedron base triangles
 void StelGeodesicGrid::searchZones(const QVector<SphericalCap>& convex,
-                               int **inside_list,int **border_list,
+                               QVector<int> *inside_list,QVector<int> *border_list,
                                int maxSearchLevel) const
 {
 	if (maxSearchLevel < 0) maxSearchLevel = 0;
@@ -359,7 +376,7 @@ void StelGeodesicGrid::searchZones(int lev,int index,
                                const bool *corner0_inside,
                                const bool *corner1_inside,
                                const bool *corner2_inside,
-                               int **inside_list,int **border_list,
+                               QVector<int> *inside_list,QVector<int> *border_list,
                                const int maxSearchLevel) const
 {
 #if defined __STRICT_ANSI__ || !defined __GNUC__
@@ -389,20 +406,16 @@ void StelGeodesicGrid::searchZones(int lev,int index,
 	if (halfs_used_count == 0)
 	{
 		// this triangle(lev,index) lies inside all halfspaces
-		**inside_list = index;
-		(*inside_list)++;
+		inside_list[lev].append(index);
 	}
 	else
 	{
-		(*border_list)--;
-		**border_list = index;
+		border_list[lev].append(index);
 		if (lev < maxSearchLevel)
 		{
 			const Triangle &t(triangles[lev][index]);
 			lev++;
 			index <<= 2;
-			inside_list++;
-			border_list++;
 #if defined __STRICT_ANSI__ || !defined __GNUC__
 			bool *edge0_inside = new bool[convex.size()];
 			bool *edge1_inside = new bool[convex.size()];
@@ -456,58 +469,127 @@ end:
 const GeodesicSearchResult* StelGeodesicGrid::search(const QVector<SphericalCap>& convex, int maxSearchLevel) const
 {
 	// Try to use the cached version
-	if (maxSearchLevel==lastMaxSearchlevel && convex==lastSearchRegion)
+	for (int i=0;i<searchCache.size();i++)
 	{
-		return cacheSearchResult;
+		if (searchCache.at(i).maxSearchLevel==maxSearchLevel && searchCache.at(i).region==convex)
+		{
+			if (i>0)
+				searchCache.move(i, 0);
+			return searchCache.first().result;
+		}
 	}
-	// Else recompute it and update cache parameters
-	lastMaxSearchlevel = maxSearchLevel;
-	lastSearchRegion = convex;
-	cacheSearchResult->search(convex, maxSearchLevel);
-	return cacheSearchResult;
+	// Else recompute it in the least recently used result
+	CachedSearch cached;
+	if (searchCache.size()<searchCacheSize)
+		cached.result = new GeodesicSearchResult(*this);
+	else
+		cached.result = searchCache.takeLast().result;
+	cached.region = convex;
+	cached.maxSearchLevel = maxSearchLevel;
+	cached.result->search(convex, maxSearchLevel);
+	searchCache.prepend(cached);
+	return cached.result;
 }
 
 
 GeodesicSearchResult::GeodesicSearchResult(const StelGeodesicGrid &grid)
 		:grid(grid),
-		zones(new int*[grid.getMaxLevel()+1]),
-		inside(new int*[grid.getMaxLevel()+1]),
-		border(new int*[grid.getMaxLevel()+1])
+		levels(grid.getMaxLevel()+1),
+		inside(grid.getMaxLevel()+1),
+		border(grid.getMaxLevel()+1),
+		insideBits(grid.getMaxLevel()+1),
+		borderBits(grid.getMaxLevel()+1),
+		insideBitsValid(grid.getMaxLevel()+1, false),
+		borderBitsValid(grid.getMaxLevel()+1, false)
+{
+}
+
+GeodesicSearchResult::~GeodesicSearchResult(void)
 {
-	for (int i=0;i<=grid.getMaxLevel();i++)
+}
+
+void GeodesicSearchResult::search(const QVector<SphericalCap>& convex, int maxSearchLevel)
+{
+	for (int i=levels-1;i>=0;i--)
 	{
-		zones[i] = new int[StelGeodesicGrid::nrOfZones(i)];
+		// Keeps the capacity, so that searching similar regions does not allocate
+		inside[i].resize(0);
+		border[i].resize(0);
 	}
+	insideBitsValid.fill(false);
+	borderBitsValid.fill(false);
+	grid.searchZones(convex,inside.data(),border.data(),maxSearchLevel);
 }
 
-GeodesicSearchResult::~GeodesicSearchResult(void)
+const GeodesicZoneBits& GeodesicSearchResult::getInsideZones(int level) const
+{
+	level = clampLevel(level);
+	GeodesicZoneBits& bits = insideBits[level];
+	if (!insideBitsValid.at(level))
+	{
+		bits.reset(StelGeodesicGrid::nrOfZones(level));
+		// A zone inside the region at level l covers 4^(level-l) consecutive zones at level
+		for (int l=0;l<=level;l++)
+		{
+			const int shift = (level-l)<<1;
+			foreach (int zone, inside.at(l))
+				bits.insertRange(zone<<shift, 1<<shift);
+		}
+		insideBitsValid[level] = true;
+	}
+	return bits;
+}
+
+const GeodesicZoneBits& GeodesicSearchResult::getBorderZones(int level) const
 {
-	for (int i=grid.getMaxLevel();i>=0;i--)
+	level = clampLevel(level);
+	GeodesicZoneBits& bits = borderBits[level];
+	if (!borderBitsValid.at(level))
 	{
-		delete[] zones[i];
+		bits.reset(StelGeodesicGrid::nrOfZones(level));
+		foreach (int zone, border.at(level))
+			bits.insert(zone);
+		borderBitsValid[level] = true;
 	}
-	delete[] border;
-	delete[] inside;
-	delete[] zones;
+	return bits;
 }
 
-void GeodesicSearchResult::search(const QVector<SphericalCap>& convex, int maxSearchLevel)
+void GeodesicZoneBits::reset(int nr)
+{
+	nrOfZones = nr;
+	words.fill(0, (nr+63)>>6);
+}
+
+void GeodesicZoneBits::insertRange(int first, int count)
+{
+	const int last = first+count;
+	// Partial words at the ends, whole words in between
+	while (first<last && (first&63))
+		insert(first++);
+	for (;first+64<=last;first+=64)
+		words[first>>6] = ~Q_UINT64_C(0);
+	while (first<last)
+		insert(first++);
+}
+
+int GeodesicZoneBits::count(void) const
 {
-	for (int i=grid.getMaxLevel();i>=0;i--)
+	int result = 0;
+	foreach (quint64 w, words)
 	{
-		inside[i] = zones[i];
-		border[i] = zones[i]+StelGeodesicGrid::nrOfZones(i);
+		for (;w;result++)
+			w &= w-1;
 	}
-	grid.searchZones(convex,inside,border,maxSearchLevel);
+	return result;
 }
 
 void GeodesicSearchInsideIterator::reset(void)
 {
 	level = 0;
 	maxCount = 1<<(maxLevel<<1); // 4^maxLevel
-	indexP = r.zones[0];
-	endP = r.inside[0];
-	index = (*indexP) * maxCount;
+	indexP = r.inside.at(0).constData();
+	endP = indexP + r.inside.at(0).size();
+	index = (indexP < endP) ? (*indexP) * maxCount : 0;
 	count = (indexP < endP) ? 0 : maxCount;
 }
 
@@ -525,8 +607,8 @@ int GeodesicSearchInsideIterator::next(void)
 	{
 		level++;
 		maxCount >>= 2;
-		indexP = r.zones[level];
-		endP = r.inside[level];
+		indexP = r.inside.at(level).constData();
+		endP = indexP + r.inside.at(level).size();
 		if (indexP < endP)
 		{
 			index = (*indexP) * maxCount;
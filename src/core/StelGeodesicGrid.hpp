@@ -37,6 +37,8 @@ Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
 
 #include "StelSphereGeometry.hpp"
 
+#include <QList>
+
 class GeodesicSearchResult;
 
 //! @class StelGeodesicGrid
@@ -44,6 +46,8 @@ class GeodesicSearchResult;
 //! level 0: just the icosahedron, 20 zones
 //! level 1: 80 zones, level 2: 320 zones, ...
 //! Each zone has a unique integer number in the range [0,getNrOfZones()-1].
+//! The zone numbers of a level do not depend on the maximum level, so that the grid can be extended
+//! to deeper levels without changing the zones of the existing ones.
 class StelGeodesicGrid
 {
 public:
@@ -51,6 +55,10 @@ public:
 	~StelGeodesicGrid(void);
 	
 	int getMaxLevel(void) const {return maxLevel;}
+
+	//! Add the levels up to newMaxLevel, only the triangles of the new levels are computed.
+	//! The search results returned before are no longer valid afterwards.
+	void extend(int newMaxLevel);
 	
 	static int nrOfZones(int level) {return (20<<(level<<1));} // 20*4^level
 	
@@ -77,10 +85,15 @@ public:
 	int getPartnerTriangle(int lev, int index) const;
 	
 	//! Return a search result matching the given spatial region
-	//! The result is cached, meaning that it is very fast to search the same region consecutively
-	//! @return a GeodesicSearchResult instance which must be used with GeodesicSearchBorderIterator and GeodesicSearchInsideIterator
+	//! The results of the last few regions are cached, so that the regions searched in each frame
+	//! (e.g. the viewport for the stars and the surroundings of the mouse for picking) are searched only once.
+	//! @return a GeodesicSearchResult instance which must be used with GeodesicSearchBorderIterator and GeodesicSearchInsideIterator,
+	//! or through its zone bitsets. It stays valid until the search of searchCacheSize other regions.
 	const GeodesicSearchResult* search(const QVector<SphericalCap>& convex, int maxSearchLevel) const;
 
+	//! The number of search results kept by search().
+	static const int searchCacheSize = 4;
+
 private:
 	friend class GeodesicSearchResult;
 	
@@ -90,23 +103,23 @@ private:
 	//! each half space. If this is not the case,
 	//! the result may be inaccurate, because it is assumed, that
 	//! a zone lies in a half space when its 3 corners lie in this half space.
-	//! inside[l] points to the begin of an integer array of size nrOfZones(l),
-	//! border[l] points to one after the end of the same integer array.
-	//! The array will be filled from the beginning with the inside zone numbers
-	//! and from the end with the border zone numbers of the given level l
-	//! for 0<=l<=getMaxLevel().
+	//! The inside zone numbers of the level l are appended to inside[l],
+	//! and the border zone numbers to border[l], for 0<=l<=getMaxLevel().
 	//! inside[l] will not contain zones that are already contained
 	//! in inside[l1] for some l1 < l.
 	//! In order to restrict search depth set maxSearchLevel < maxLevel,
 	//! for full search depth set maxSearchLevel = maxLevel,
 	void searchZones(const QVector<SphericalCap>& convex,
-					 int **inside,int **border,int maxSearchLevel) const;
+					 QVector<int> *inside,QVector<int> *border,int maxSearchLevel) const;
 	
 	const Vec3f& getTriangleCorner(int lev, int index, int cornerNumber) const;
+	//! Compute the triangles of the levels in [firstLevel, maxLevel) below triangle(lev,index).
 	void initTriangle(int lev,int index,
 					  const Vec3f &c0,
 					  const Vec3f &c1,
-					  const Vec3f &c2);
+					  const Vec3f &c2,
+					  int firstLevel=0);
+	void clearSearchCache(void);
 	void visitTriangles(int lev,int index,
 						const Vec3f &c0,
 						const Vec3f &c1,
@@ -121,9 +134,9 @@ private:
 	                 const bool *corner0_inside,
 	                 const bool *corner1_inside,
 	                 const bool *corner2_inside,
-	                 int **inside,int **border,int maxSearchLevel) const;
+	                 QVector<int> *inside,QVector<int> *border,int maxSearchLevel) const;
 
-	const int maxLevel;
+	int maxLevel;
 	struct Triangle
 	{
 		Vec3f e0,e1,e2;   // Seitenmittelpunkte
@@ -133,9 +146,59 @@ private:
 	// 2+10*4^n corners
 	
 	//! A cached search result used to avoid doing twice the same search
-	mutable GeodesicSearchResult* cacheSearchResult;
-	mutable int lastMaxSearchlevel;
-	mutable QVector<SphericalCap> lastSearchRegion;
+	struct CachedSearch
+	{
+		QVector<SphericalCap> region;
+		int maxSearchLevel;
+		GeodesicSearchResult* result;
+	};
+	//! The cached searches, most recently used first
+	mutable QList<CachedSearch> searchCache;
+};
+
+//! @class GeodesicZoneBits
+//! Set of zones of one level of a StelGeodesicGrid, with one bit per zone.
+//! Unlike the search iterators, it can be split in ranges of words which are processed
+//! in parallel, e.g. with QtConcurrent.
+class GeodesicZoneBits
+{
+public:
+	GeodesicZoneBits(void) : nrOfZones(0) {}
+
+	//! Empty the set, and make it hold the zones in [0, nrOfZones).
+	void reset(int nrOfZones);
+	void insert(int zone) {words[zone>>6] |= Q_UINT64_C(1)<<(zone&63);}
+	//! Insert the zones in [first, first+count).
+	void insertRange(int first, int count);
+	bool contains(int zone) const {return (words.at(zone>>6)>>(zone&63))&1;}
+	//! The number of zones in the set.
+	int count(void) const;
+
+	int getNrOfZones(void) const {return nrOfZones;}
+	//! The number of 64 bit words of the set, zone z is in word z/64.
+	int getNrOfWords(void) const {return words.size();}
+
+	//! Call func(zone) for each zone of the set in the words [beginWord, endWord), in increasing order.
+	//! With the default arguments, all the zones are visited.
+	template <class Func> void visit(Func& func, int beginWord=0, int endWord=-1) const
+	{
+		if (endWord<0 || endWord>words.size())
+			endWord = words.size();
+		for (int w=beginWord;w<endWord;w++)
+		{
+			// Zero words are skipped: a set is usually small compared with its level
+			quint64 bits = words.at(w);
+			for (int zone=w<<6;bits;zone++,bits>>=1)
+			{
+				if (bits&1)
+					func(zone);
+			}
+		}
+	}
+
+private:
+	QVector<quint64> words;
+	int nrOfZones;
 };
 
 class GeodesicSearchResult
@@ -144,29 +207,43 @@ public:
 	GeodesicSearchResult(const StelGeodesicGrid &grid);
 	~GeodesicSearchResult(void);
 	void print(void) const;
+
+	//! The zones of a level which lie fully inside the searched region,
+	//! including the zones inside the region at the lower levels.
+	//! Same zones as GeodesicSearchInsideIterator, built at the first call after the search.
+	const GeodesicZoneBits& getInsideZones(int level) const;
+	//! The zones of a level which lie partly inside the searched region.
+	//! Same zones as GeodesicSearchBorderIterator, built at the first call after the search.
+	const GeodesicZoneBits& getBorderZones(int level) const;
+
 private:
 	friend class GeodesicSearchInsideIterator;
 	friend class GeodesicSearchBorderIterator;
 	friend class StelGeodesicGrid;
 	
 	void search(const QVector<SphericalCap>& convex, int maxSearchLevel);
+	int clampLevel(int level) const {return level<0 ? 0 : (level>levels-1 ? levels-1 : level);}
 	
 	const StelGeodesicGrid &grid;
-	int **const zones;
-	int **const inside;
-	int **const border;
+	const int levels;
+	//! The zone numbers of each level, their size is proportional to the searched region
+	QVector<QVector<int> > inside;
+	QVector<QVector<int> > border;
+	mutable QVector<GeodesicZoneBits> insideBits;
+	mutable QVector<GeodesicZoneBits> borderBits;
+	mutable QVector<bool> insideBitsValid;
+	mutable QVector<bool> borderBitsValid;
 };
 
 class GeodesicSearchBorderIterator
 {
 public:
 	GeodesicSearchBorderIterator(const GeodesicSearchResult &ar,int alevel)
-		: r(ar),level((alevel<0)?0:(alevel>ar.grid.getMaxLevel())
-			             ?ar.grid.getMaxLevel():alevel),
-			end(ar.zones[GeodesicSearchBorderIterator::level]+
-			    StelGeodesicGrid::nrOfZones(GeodesicSearchBorderIterator::level))
+		: r(ar),level(ar.clampLevel(alevel)),
+			end(ar.border.at(GeodesicSearchBorderIterator::level).constData()+
+			    ar.border.at(GeodesicSearchBorderIterator::level).size())
 	{reset();}
-	void reset(void) {index = r.border[level];}
+	void reset(void) {index = r.border.at(level).constData();}
 	int next(void) // returns -1 when finished
 	{if (index < end) {return *index++;} return -1;}
 private:
@@ -182,7 +259,7 @@ class GeodesicSearchInsideIterator
 public:
 	GeodesicSearchInsideIterator(const GeodesicSearchResult &ar,int alevel)
 		: 	r(ar), 
-			maxLevel((alevel<0)?0:(alevel>ar.grid.getMaxLevel())?ar.grid.getMaxLevel():alevel)
+			maxLevel(ar.clampLevel(alevel))
 	{reset();}
 	void reset(void);
 	int next(void); // returns -1 when finished
@@ -191,8 +268,8 @@ private:
 	const int maxLevel;
 	int level;
 	int maxCount;
-	int *indexP;
-	int *endP;
+	const int *indexP;
+	const int *endP;
 	int index;
 	int count;
 };
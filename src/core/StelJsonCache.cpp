@@ -0,0 +1,121 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include "StelJsonCache.hpp"
+#include "StelCompiledCache.hpp"
+#include "StelJsonParser.hpp"
+
+#include <QDir>
+#include <QFile>
+
+#include <stdexcept>
+
+const quint32 StelJsonCache::compiledMagic = 0x534a5343;
+const quint32 StelJsonCache::compiledVersion = 1;
+
+QVariantMap StelJsonCache::load(const QString& filePath, const QStringList& keys)
+{
+	QFile file(filePath);
+	if (!file.open(QIODevice::ReadOnly))
+		throw std::runtime_error(QString("cannot open %1: %2").arg(QDir::toNativeSeparators(filePath), file.errorString()).toStdString());
+	const qint64 size = file.size();
+	// Map the file to hash it, it is only copied if it must be parsed
+	uchar* mapped = size>0 ? file.map(0, size) : NULL;
+	const QByteArray data = mapped ? QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), size) : file.readAll();
+
+	StelCompiledCache cache(filePath, "json", compiledMagic, compiledVersion, StelCompiledCache::CheckContentHash);
+	cache.setSourceData(data);
+	QVariantMap result;
+	QDataStream* in = cache.beginRead();
+	if (in)
+	{
+		readMembers(*in, keys, result);
+		if (cache.endRead())
+		{
+			if (mapped)
+				file.unmap(mapped);
+			return result;
+		}
+		result.clear();
+	}
+
+	QVariantMap map;
+	try
+	{
+		map = StelJsonParser::parse(data).toMap();
+	}
+	catch (std::runtime_error&)
+	{
+		if (mapped)
+			file.unmap(mapped);
+		throw;
+	}
+	if (mapped)
+		file.unmap(mapped);
+	QDataStream* out = cache.beginWrite();
+	if (out)
+	{
+		writeMembers(*out, map);
+		cache.endWrite();
+	}
+
+	if (keys.isEmpty())
+		return map;
+	foreach (const QString& key, keys)
+	{
+		if (map.contains(key))
+			result.insert(key, map.value(key));
+	}
+	return result;
+}
+
+void StelJsonCache::readMembers(QDataStream& in, const QStringList& keys, QVariantMap& result)
+{
+	// Each member is a QVariant record preceded by its length, so that the others are skipped
+	quint32 count;
+	in >> count;
+	for (quint32 i=0; i<count && in.status()==QDataStream::Ok; ++i)
+	{
+		QString key;
+		quint32 length;
+		in >> key >> length;
+		if (keys.isEmpty() || keys.contains(key))
+		{
+			QVariant value;
+			in >> value;
+			result.insert(key, value);
+		}
+		else if (in.skipRawData(length)!=(int)length)
+			in.setStatus(QDataStream::ReadPastEnd);
+	}
+}
+
+void StelJsonCache::writeMembers(QDataStream& out, const QVariantMap& map)
+{
+	out << (quint32)map.size();
+	for (QVariantMap::const_iterator it=map.constBegin(); it!=map.constEnd(); ++it)
+	{
+		QByteArray record;
+		QDataStream recordOut(&record, QIODevice::WriteOnly);
+		recordOut.setVersion(out.version());
+		recordOut << it.value();
+		out << it.key() << (quint32)record.size();
+		out.writeRawData(record.constData(), record.size());
+	}
+}
@@ -0,0 +1,59 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _STELJSONCACHE_HPP_
+#define _STELJSONCACHE_HPP_
+
+#include <QDataStream>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+
+//! @class StelJsonCache
+//! Compiled copies of JSON catalogues, such as the catalogues of the Quasars or Novae plugins.
+//! Parsing a large JSON file with StelJsonParser takes a long time, so the members of its top-level
+//! object are written to a StelCompiledCache, each one as a separate QDataStream record. On the next
+//! loads, only the requested members are read, e.g. the "version" of a catalogue is read without its
+//! objects. The compiled file is used as long as the size and the SHA-1 hash of the JSON file are
+//! unchanged (the catalogues are replaced by downloads), otherwise the JSON file is parsed again and
+//! the compiled file is rewritten.
+class StelJsonCache
+{
+public:
+	//! Load the top-level object of a JSON file, through its compiled file if it is up to date.
+	//! @param filePath the JSON file.
+	//! @param keys the members of the object to load, or an empty list to load all of them.
+	//! @return the requested members which exist in the file.
+	//! @exception std::runtime_error if the file cannot be read or is not valid JSON.
+	static QVariantMap load(const QString& filePath, const QStringList& keys=QStringList());
+
+private:
+	friend class TestStelJsonCache;
+
+	//! Identifies the compiled files, and their format version.
+	static const quint32 compiledMagic;
+	static const quint32 compiledVersion;
+
+	//! Read the requested members from the records of the compiled file.
+	static void readMembers(QDataStream& in, const QStringList& keys, QVariantMap& result);
+	//! Write the members of map as records of the compiled file.
+	static void writeMembers(QDataStream& out, const QVariantMap& map);
+};
+
+#endif // _STELJSONCACHE_HPP_
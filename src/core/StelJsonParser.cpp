@@ -20,94 +20,255 @@
 #include <QDebug>
 #include <QBuffer>
 #include <QDateTime>
+#include <QVector>
 #include <stdexcept>
 #include <stdio.h>
 
 class StelJsonParserInstance
 {
 public:
+	//! Parse from a device, read through a buffer.
 	StelJsonParserInstance(QIODevice* ain)
 		: input(ain)
-		, nextChar()
-		, hasNextChar(false)
+		, cur(buffer)
+		, last(buffer)
+		, eof(false)
+	{
+	}
+	//! Parse from memory, read in place.
+	StelJsonParserInstance(const char* data, int size)
+		: input(NULL)
+		, cur(data)
+		, last(data+size)
+		, eof(false)
 	{
-		cur = buffer;
-		last = cur;
 	}
 	inline void skipJson();
 	inline bool tryReadChar(char c);
 	inline bool skipAndConsumeChar(char r);
-	QByteArray readString();
+	QString readString();
 	QVariant readOther();
+	//! Parse one value, passing its contents to handler.
+	void parse(StelJsonHandler& handler);
+	//! Parse one value into a tree.
 	QVariant parse();
 
 private:
 	QIODevice* input;
-	char nextChar;
-	bool hasNextChar;
+	const char* cur;
+	const char* last;
+	bool eof;
 
 #define BUFSIZESTATIC 65536
 	char buffer[BUFSIZESTATIC];
-	char* last;
-	char* cur;
 
-	inline bool getNextFromBuffer(char *c)
+	// Make sure that cur points to a character, reading the next block of the device if needed
+	inline bool fill()
 	{
-		if (cur==last)
+		if (cur!=last)
+			return true;
+		if (eof)
+			return false;
+		const qint64 n = input ? input->read(buffer, BUFSIZESTATIC) : 0;
+		if (n<=0)
 		{
-			if (cur==buffer-1) // End of file
-				return false;
-
-			last = buffer + input->read(buffer, BUFSIZESTATIC);
-			if (last==buffer)
-			{
-				cur = buffer-1;
-				last = cur;
-				return false;
-			}
-			cur = buffer;
+			// A read error is not the end of file
+			eof = n==0;
+			return false;
 		}
-		*c = *cur;
-		++cur;
+		cur = buffer;
+		last = buffer + n;
 		return true;
 	}
 
 	inline bool getChar(char* c)
 	{
-		if (hasNextChar)
-		{
-			hasNextChar=false;
-			*c = nextChar;
-			return true;
-		}
-		return getNextFromBuffer(c);
+		if (!fill())
+			return false;
+		*c = *cur;
+		++cur;
+		return true;
 	}
 
+	// Only the character just returned by getChar() can be put back, it is still before cur
 	inline void ungetChar(char c)
 	{
-		nextChar=c;
-		hasNextChar=true;
+		Q_UNUSED(c);
+		Q_ASSERT(cur[-1]==c);
+		--cur;
 	}
 
 	inline void skipLine()
 	{
-		if (hasNextChar && nextChar=='\n')
-		{
-			hasNextChar=false;
-			return;
-		}
-		hasNextChar=false;
 		char c;
-		while (getNextFromBuffer(&c) && c!='\n')
+		while (getChar(&c) && c!='\n')
 		{}
 	}
 
 	inline bool atEnd()
 	{
-		return cur==buffer-1;
+		return eof;
 	}
 };
 
+// Builds the tree returned by StelJsonParser::parse()
+class StelJsonTreeBuilder : public StelJsonHandler
+{
+public:
+	QVariant result;
+
+	virtual void beginObject()
+	{
+		stack.append(Container(true));
+	}
+	virtual void key(const QString& name)
+	{
+		stack.last().key = name;
+	}
+	virtual void endObject()
+	{
+		// The container is shared, not copied
+		const QVariant v(stack.last().map);
+		stack.removeLast();
+		add(v);
+	}
+	virtual void beginArray()
+	{
+		stack.append(Container(false));
+	}
+	virtual void endArray()
+	{
+		const QVariant v(stack.last().list);
+		stack.removeLast();
+		add(v);
+	}
+	virtual void value(const QVariant& v)
+	{
+		add(v);
+	}
+
+private:
+	struct Container
+	{
+		Container(bool m=false) : isMap(m) {}
+		bool isMap;
+		QVariantMap map;
+		QVariantList list;
+		QString key;
+	};
+	QVector<Container> stack;
+
+	void add(const QVariant& v)
+	{
+		if (stack.isEmpty())
+			result = v;
+		else if (stack.last().isMap)
+			stack.last().map.insert(stack.last().key, v);
+		else
+			stack.last().list.append(v);
+	}
+};
+
+// Values other than strings end at one of these characters
+static inline bool isValueEnd(char c)
+{
+	return c==' ' || c==',' || c=='\n' || c=='\r' || c==']' || c=='\t' || c=='}';
+}
+
+static inline bool isDigit(char c)
+{
+	return c>='0' && c<='9';
+}
+
+// Convert a number without the locale and without a copy, for the usual cases: integers of at most
+// 9 digits, and decimal numbers of at most 15 digits with a small exponent, for which the conversion of the
+// digits and the multiplication or division by an exact power of ten is exactly rounded (Clinger, 1990).
+// Return false for the other numbers, and for other values.
+static bool fastToNumber(const char* s, int n, QVariant* result)
+{
+	static const double powersOf10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+					    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+	int i = 0;
+	const bool negative = n>0 && s[0]=='-';
+	if (negative)
+		++i;
+	qint64 mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+	for (; i<n && isDigit(s[i]); ++i, ++digits)
+	{
+		if (digits==15)
+			return false;
+		mantissa = mantissa*10 + (s[i]-'0');
+	}
+	if (i==n)
+	{
+		if (digits==0 || digits>9)
+			return false;
+		*result = (int)(negative ? -mantissa : mantissa);
+		return true;
+	}
+	if (s[i]=='.')
+	{
+		for (++i; i<n && isDigit(s[i]); ++i, ++digits, --exponent)
+		{
+			if (digits==15)
+				return false;
+			mantissa = mantissa*10 + (s[i]-'0');
+		}
+	}
+	if (digits==0)
+		return false;
+	if (i<n && (s[i]=='e' || s[i]=='E'))
+	{
+		++i;
+		const bool negativeExp = i<n && s[i]=='-';
+		if (i<n && (s[i]=='-' || s[i]=='+'))
+			++i;
+		int e = 0, expDigits = 0;
+		for (; i<n && isDigit(s[i]) && expDigits<4; ++i, ++expDigits)
+			e = e*10 + (s[i]-'0');
+		if (expDigits==0)
+			return false;
+		exponent += negativeExp ? -e : e;
+	}
+	if (i!=n || exponent<-22 || exponent>22)
+		return false;
+	double d = (double)mantissa;
+	if (exponent<0)
+		d /= powersOf10[-exponent];
+	else
+		d *= powersOf10[exponent];
+	*result = negative ? -d : d;
+	return true;
+}
+
+static QVariant toValue(const char* s, int n)
+{
+	QVariant v;
+	if (fastToNumber(s, n, &v))
+		return v;
+	const QByteArray str(s, n);
+	bool ok;
+	const int i = str.toInt(&ok);
+	if (ok)
+		return i;
+	const double d = str.toDouble(&ok);
+	if (ok)
+		return d;
+	if (str=="true")
+		return QVariant(true);
+	if (str=="false")
+		return QVariant(false);
+	if (str=="null")
+		return QVariant();
+	QDateTime dt = QDateTime::fromString(str, Qt::ISODate);
+	if (dt.isValid())
+		return QVariant(dt);
+
+	throw std::runtime_error(qPrintable(QString("Invalid JSON value: \"")+str+"\""));
+}
+
 void StelJsonParserInstance::skipJson()
 {
 	// There is a weakness in this code -- it will cause any standalone '/' to be absorbed.
@@ -193,8 +354,22 @@ bool StelJsonParserInstance::skipAndConsumeChar(char r)
 }
 
 // Read a string without the initial "
-QByteArray StelJsonParserInstance::readString()
+QString StelJsonParserInstance::readString()
 {
+	// Most strings have no escape and end in the current block: convert them in place
+	if (fill())
+	{
+		const char* end = cur;
+		while (end!=last && *end!='"' && *end!='\\')
+			++end;
+		if (end!=last && *end=='"')
+		{
+			const QString str = QString::fromUtf8(cur, end-cur);
+			cur = end+1;
+			return str;
+		}
+	}
+
 	QByteArray name;
 	char c;
 	while (getChar(&c))
@@ -202,7 +377,7 @@ QByteArray StelJsonParserInstance::readString()
 		switch (c)
 		{
 			case '"':
-				return name;
+				return QString::fromUtf8(name.constData(), name.size());
 				break;
 			case '\\':
 			{
@@ -214,6 +389,7 @@ QByteArray StelJsonParserInstance::readString()
 				if (c=='r') c='\r';
 				if (c=='t') c='\t';
 				if (c=='u') {qWarning() << "don't support \\uxxxx char"; continue;}
+				name+=c;
 			}
 				break;
 			default:
@@ -228,54 +404,56 @@ QByteArray StelJsonParserInstance::readString()
 
 QVariant StelJsonParserInstance::readOther()
 {
+	// Most values end in the current block: convert them in place
 	QByteArray str;
+	if (fill())
+	{
+		const char* end = cur;
+		while (end!=last && !isValueEnd(*end))
+			++end;
+		if (end!=last || !input)
+		{
+			const char* begin = cur;
+			cur = end;
+			return toValue(begin, end-begin);
+		}
+		str.append(cur, end-cur);
+		cur = end;
+	}
+
 	char c;
 	while (getChar(&c))
 	{
-		if (c==' ' || c==',' || c=='\n' || c=='\r' || c==']' || c=='\t' || c=='}')
+		if (isValueEnd(c))
 		{
 			ungetChar(c);
 			break;
 		}
 		str+=c;
 	}
-	bool ok;
-	const int i = str.toInt(&ok);
-	if (ok)
-		return i;
-	const double d = str.toDouble(&ok);
-	if (ok)
-		return d;
-	if (str=="true")
-		return QVariant(true);
-	if (str=="false")
-		return QVariant(false);
-	if (str=="null")
-		return QVariant();
-	QDateTime dt = QDateTime::fromString(str, Qt::ISODate);
-	if (dt.isValid())
-		return QVariant(dt);
-
-	throw std::runtime_error(qPrintable(QString("Invalid JSON value: \"")+str+"\""));
+	return toValue(str.constData(), str.size());
 }
 
 // Parse the given input stream
-QVariant StelJsonParserInstance::parse()
+void StelJsonParserInstance::parse(StelJsonHandler& handler)
 {
 	skipJson();
 
 	char r;
 	if (!getChar(&r))
-		return QVariant();
+		return;
 
 	switch (r)
 	{
 		case '{':
 		{
 			// We've got an object (a tuple)
-			QVariantMap map;
+			handler.beginObject();
 			if (skipAndConsumeChar('}'))
-				return map;
+			{
+				handler.endObject();
+				return;
+			}
 			for (;;)
 			{
 				if (!skipAndConsumeChar('\"'))
@@ -284,30 +462,34 @@ QVariant StelJsonParserInstance::parse()
 					if (getChar(&cc))
 						throw std::runtime_error(qPrintable(QString("Expected '\"' at beginning of string, found: '%1' (ASCII %2)").arg(cc).arg((int)(cc))));
 				}
-				const QByteArray& ar = readString();
-				const QString& key = QString::fromUtf8(ar.constData(), ar.size());
+				const QString key = readString();
 				if (!skipAndConsumeChar(':'))
 					throw std::runtime_error(qPrintable(QString("Expected ':' after a member name: ")+key));
 
+				handler.key(key);
 				skipJson();
-				map.insert(key, parse());
+				parse(handler);
 				if (!skipAndConsumeChar(','))
 					break;
 			}
 			if (!skipAndConsumeChar('}'))
 				throw std::runtime_error("Expected '}' to close an object");
-			return map;
+			handler.endObject();
+			return;
 		}
 		case '[':
 		{
 			// We've got an array (a vector)
-			QVariantList list;
+			handler.beginArray();
 			if (skipAndConsumeChar(']'))
-				return list;
+			{
+				handler.endArray();
+				return;
+			}
 
 			for (;;)
 			{
-				list.append(parse());
+				parse(handler);
 				if (!skipAndConsumeChar(','))
 					break;
 			}
@@ -315,22 +497,31 @@ QVariant StelJsonParserInstance::parse()
 			if (!skipAndConsumeChar(']'))
 				throw std::runtime_error("Expected ']' to close an array");
 
-			return list;
+			handler.endArray();
+			return;
 		}
 		case '\"':
 		{
 			// We've got a string
-			const QByteArray& ar = readString();
-			return QString::fromUtf8(ar.constData(), ar.size());
+			handler.value(readString());
+			return;
 		}
 		default:
 		{
 			ungetChar(r);
-			return readOther();
+			handler.value(readOther());
+			return;
 		}
 	}
 }
 
+QVariant StelJsonParserInstance::parse()
+{
+	StelJsonTreeBuilder builder;
+	parse(builder);
+	return builder.result;
+}
+
 QHash<int, void (*)(const QVariant&, QIODevice*, int)> StelJsonParser::otherSerializer;
 
 // Serialize the passed QVariant as JSON into the output QIODevice
@@ -452,14 +643,22 @@ QVariant StelJsonParser::parse(QIODevice* input)
 	return parser.parse();
 }
 
-QVariant StelJsonParser::parse(const QByteArray& aar)
+QVariant StelJsonParser::parse(const QByteArray& input)
 {
-	QByteArray ar = aar;
-	QBuffer buf(&ar);
-	buf.open(QIODevice::ReadOnly);
-	QVariant v = StelJsonParser::parse(&buf);
-	buf.close();
-	return v;
+	StelJsonParserInstance parser(input.constData(), input.size());
+	return parser.parse();
+}
+
+void StelJsonParser::parse(QIODevice* input, StelJsonHandler& handler)
+{
+	StelJsonParserInstance parser(input);
+	parser.parse(handler);
+}
+
+void StelJsonParser::parse(const QByteArray& input, StelJsonHandler& handler)
+{
+	StelJsonParserInstance parser(input.constData(), input.size());
+	parser.parse(handler);
 }
 
 JsonListIterator::JsonListIterator(QIODevice* input)
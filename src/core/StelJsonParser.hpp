@@ -52,6 +52,26 @@ private:
 	class StelJsonParserInstance* parser;
 };
 
+//! @class StelJsonHandler
+//! Receives the contents of a JSON document from StelJsonParser::parse() as a sequence of events,
+//! without building a tree of QVariant, e.g. to create the objects of a catalogue while it is read.
+//! The values have the same types as in the tree returned by StelJsonParser::parse().
+class StelJsonHandler
+{
+public:
+	virtual ~StelJsonHandler() {}
+	//! The start of an object, followed by key() and the value of each member, then endObject().
+	virtual void beginObject() = 0;
+	//! The name of the next member of the current object.
+	virtual void key(const QString& name) = 0;
+	virtual void endObject() = 0;
+	//! The start of an array, followed by its values, then endArray().
+	virtual void beginArray() = 0;
+	virtual void endArray() = 0;
+	//! A string, number, boolean, date or null (invalid QVariant) value.
+	virtual void value(const QVariant& v) = 0;
+};
+
 //! @class StelJsonParser
 //! Qt-based simple JSON reader inspired by the one from <a href='http://zoolib.sourceforge.net/'>Zoolib</a>.
 //! JSON is JavaScript Object Notation. See http://www.json.org/
@@ -74,8 +94,15 @@ public:
 
 	//! Parse the given input stream.
 	static QVariant parse(QIODevice* input);
+	//! Parse the given input in memory. It is read in place, so it can be a QByteArray::fromRawData()
+	//! on a memory-mapped file.
 	static QVariant parse(const QByteArray& input);
 
+	//! Parse the given input stream, passing its contents to handler instead of building a tree.
+	//! @exception std::runtime_error if the input is not valid JSON, after the events before the error.
+	static void parse(QIODevice* input, StelJsonHandler& handler);
+	static void parse(const QByteArray& input, StelJsonHandler& handler);
+
 	//! Serialize the passed QVariant as JSON into the output QIODevice.
 	static void write(const QVariant& jsonObject, QIODevice* output, int indentLevel=0);
 
@@ -0,0 +1,53 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include "StelLineBatch.hpp"
+
+void StelLineBatch::begin()
+{
+	Q_ASSERT(!active);
+	active = true;
+}
+
+void StelLineBatch::end()
+{
+	Q_ASSERT(active);
+	active = false;
+}
+
+void StelLineBatch::addStrip(const QVector<Vec2f>& stripVertices, const QVector<Vec4f>& stripColors, const Vec4f& color)
+{
+	Q_ASSERT(stripVertices.size()>1);
+	Q_ASSERT(stripColors.isEmpty() || stripColors.size()==stripVertices.size());
+	// Store the strip as separate segments, so that the strips of the batch are not joined
+	const bool colored = !stripColors.isEmpty();
+	for (int i=1; i<stripVertices.size(); ++i)
+	{
+		vertices.append(stripVertices.at(i-1));
+		vertices.append(stripVertices.at(i));
+		colors.append(colored ? stripColors.at(i-1) : color);
+		colors.append(colored ? stripColors.at(i) : color);
+	}
+}
+
+void StelLineBatch::clear()
+{
+	vertices.resize(0);
+	colors.resize(0);
+}
@@ -0,0 +1,62 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _STELLINEBATCH_HPP_
+#define _STELLINEBATCH_HPP_
+
+#include "VecMath.hpp"
+
+#include <QVector>
+
+//! @class StelLineBatch
+//! Line strips collected as separate segments (GL_LINES pairs) in window coordinates, with the color
+//! of each vertex, so that the lines of many strips can be drawn in one call.
+//! StelPainter::beginLineBatch() makes the painters add their lines to such a batch.
+class StelLineBatch
+{
+public:
+	StelLineBatch() : active(false) {}
+
+	//! Start collecting the strips.
+	void begin();
+	//! Stop collecting. The collected segments are kept until clear().
+	void end();
+	//! Whether strips are being collected.
+	bool isActive() const {return active;}
+
+	//! Add a line strip of at least 2 vertices.
+	//! @param colors the color of each vertex, or an empty vector to use color for all of them.
+	void addStrip(const QVector<Vec2f>& vertices, const QVector<Vec4f>& colors, const Vec4f& color);
+
+	//! Remove the collected segments, keeping the memory for the next ones.
+	void clear();
+
+	bool isEmpty() const {return vertices.isEmpty();}
+	//! Vertices of the segments, 2 per segment.
+	const QVector<Vec2f>& getVertices() const {return vertices;}
+	//! Color of each vertex.
+	const QVector<Vec4f>& getColors() const {return colors;}
+
+private:
+	bool active;
+	QVector<Vec2f> vertices;
+	QVector<Vec4f> colors;
+};
+
+#endif // _STELLINEBATCH_HPP_
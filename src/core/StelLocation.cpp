@@ -17,7 +17,9 @@
  */
 
 #include "StelLocation.hpp"
+#ifndef UNIT_TEST
 #include "StelLocaleMgr.hpp"
+#endif
 #include "StelUtils.hpp"
 #include <QStringList>
 
@@ -78,7 +80,10 @@ StelLocation StelLocation::createFromLine(const QString& rawline)
 	const QStringList& splitline = rawline.split("\t");
 	loc.name    = splitline.at(0);
 	loc.state   = splitline.at(1);
+#ifndef UNIT_TEST
+	// NOTE: Hook for unit testing (testStelLocationIndex), without the locale manager
 	loc.country = StelLocaleMgr::countryCodeToString(splitline.at(2));
+#endif
 	if (loc.country.isEmpty())
 		loc.country = splitline.at(2);
 
@@ -135,6 +140,7 @@ StelLocation StelLocation::createFromLine(const QString& rawline)
 float StelLocation::distanceDegrees(const float long1, const float lat1, const float long2, const float lat2)
 {
 	const float DEGREES=M_PI/180.0f;
-	return std::acos( std::sin(lat1*DEGREES)*std::sin(lat2*DEGREES) +
-					  std::cos(lat1*DEGREES)*std::cos(lat2*DEGREES)*std::cos((long1-long2)*DEGREES) ) / DEGREES;
+	// The rounding errors must not give NaN for the same or opposite points
+	return std::acos( qBound(-1.0f, std::sin(lat1*DEGREES)*std::sin(lat2*DEGREES) +
+					  std::cos(lat1*DEGREES)*std::cos(lat2*DEGREES)*std::cos((long1-long2)*DEGREES), 1.0f) ) / DEGREES;
 }
@@ -0,0 +1,161 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include "StelLocationIndex.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Size of the cells of the spatial index [degree]
+static const float locationCellSize = 1.f;
+static const int locationCellRows = 180;
+static const int locationCellCols = 360;
+
+static inline int locationCellRow(float latitude)
+{
+	return qBound(0, (int)std::floor((latitude+90.f)/locationCellSize), locationCellRows-1);
+}
+
+// Wrap the columns before the first one and after the last one
+static inline int locationCellCol(int col)
+{
+	col %= locationCellCols;
+	return col<0 ? col+locationCellCols : col;
+}
+
+// Column of a longitude, before wrapping
+static inline int locationCellColUnwrapped(float longitude)
+{
+	return (int)std::floor((longitude+180.f)/locationCellSize);
+}
+
+void StelLocationIndex::build(const QMap<QString, StelLocation>& locations)
+{
+	locationCells.clear();
+	countryIndex.clear();
+	QVector<StelObjectNameIndex::Entry> names;
+	names.reserve(locations.size());
+	// The IDs of each cell and country are in the order of the map
+	for (QMap<QString, StelLocation>::const_iterator it=locations.constBegin(); it!=locations.constEnd(); ++it)
+	{
+		const StelLocation& loc = it.value();
+		IndexedLocation indexed;
+		indexed.id = it.key();
+		indexed.longitude = loc.longitude;
+		indexed.latitude = loc.latitude;
+		const int cell = locationCellRow(loc.latitude)*locationCellCols + locationCellCol(locationCellColUnwrapped(loc.longitude));
+		locationCells[loc.planetName][cell].append(indexed);
+		countryIndex[loc.country].append(it.key());
+		names.append(StelObjectNameIndex::Entry(it.key(), -(float)loc.population, names.size()));
+	}
+	nameIndex.setNames("locations", true, names);
+	// The queries then only read the indexes
+	nameIndex.buildTables();
+}
+
+QVector<QPair<float, QString> > StelLocationIndex::findNearby(const QString& planetName, float longitude, float latitude, float radiusDegrees) const
+{
+	QVector<QPair<float, QString> > result;
+	QHash<QString, QHash<int, QVector<IndexedLocation> > >::const_iterator planet = locationCells.constFind(planetName);
+	if (planet==locationCells.constEnd() || radiusDegrees<0.f)
+		return result;
+	const QHash<int, QVector<IndexedLocation> >& cells = planet.value();
+
+	// The cells of the latitude band of the circle, and of its longitude range if it does not contain a pole
+	const int rowMin = locationCellRow(latitude-radiusDegrees);
+	const int rowMax = locationCellRow(latitude+radiusDegrees);
+	int colMin = 0, colMax = locationCellCols-1;
+	if (std::fabs(latitude)+radiusDegrees<90.f)
+	{
+		const float dLon = std::asin(std::sin(radiusDegrees*M_PI/180.)/std::cos(latitude*M_PI/180.))*180./M_PI;
+		colMin = locationCellColUnwrapped(longitude-dLon);
+		colMax = qMin(locationCellColUnwrapped(longitude+dLon), colMin+locationCellCols-1);
+	}
+
+	QList<const QVector<IndexedLocation>*> candidates;
+	if ((rowMax-rowMin+1)*(colMax-colMin+1) < cells.size())
+	{
+		for (int row=rowMin; row<=rowMax; ++row)
+		{
+			for (int col=colMin; col<=colMax; ++col)
+			{
+				QHash<int, QVector<IndexedLocation> >::const_iterator cell = cells.constFind(row*locationCellCols + locationCellCol(col));
+				if (cell!=cells.constEnd())
+					candidates << &cell.value();
+			}
+		}
+	}
+	else
+	{
+		// Large circles cover more cells than the cells which have locations
+		for (QHash<int, QVector<IndexedLocation> >::const_iterator cell=cells.constBegin(); cell!=cells.constEnd(); ++cell)
+			candidates << &cell.value();
+	}
+
+	foreach (const QVector<IndexedLocation>* cell, candidates)
+	{
+		foreach (const IndexedLocation& loc, *cell)
+		{
+			const float distance = StelLocation::distanceDegrees(longitude, latitude, loc.longitude, loc.latitude);
+			if (distance<=radiusDegrees)
+				result.append(qMakePair(distance, loc.id));
+		}
+	}
+	return result;
+}
+
+QString StelLocationIndex::findNearest(const QString& planetName, float longitude, float latitude) const
+{
+	if (!locationCells.contains(planetName))
+		return QString();
+	// Grow the searched circle until it contains a location: the nearest location is in the first non empty one
+	for (float radius=locationCellSize; ; radius*=2.f)
+	{
+		const QVector<QPair<float, QString> > nearby = findNearby(planetName, longitude, latitude, qMin(radius, 180.f));
+		if (!nearby.isEmpty())
+			return std::min_element(nearby.constBegin(), nearby.constEnd())->second;
+		if (radius>=180.f)
+			return QString();
+	}
+}
+
+QStringList StelLocationIndex::findIDs(const QString& text, int maxNbItem) const
+{
+	return nameIndex.find(text, maxNbItem, StelObjectNameIndex::MatchSubstring, true);
+}
+
+void StelLocationIndex::readLocations(QDataStream& in, QMap<QString, StelLocation>& locations)
+{
+	quint32 count;
+	in >> count;
+	QString id;
+	StelLocation loc;
+	for (quint32 i=0; i<count && in.status()==QDataStream::Ok; ++i)
+	{
+		in >> id >> loc;
+		locations.insert(locations.constEnd(), id, loc);
+	}
+}
+
+void StelLocationIndex::writeLocations(QDataStream& out, const QMap<QString, StelLocation>& locations)
+{
+	out << (quint32)locations.size();
+	for (QMap<QString, StelLocation>::const_iterator it=locations.constBegin(); it!=locations.constEnd(); ++it)
+		out << it.key() << it.value();
+}
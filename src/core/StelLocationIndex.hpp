@@ -0,0 +1,79 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _STELLOCATIONINDEX_HPP_
+#define _STELLOCATIONINDEX_HPP_
+
+#include "StelLocation.hpp"
+#include "StelObjectNameIndex.hpp"
+
+#include <QDataStream>
+#include <QHash>
+#include <QMap>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+//! @class StelLocationIndex
+//! Indexes of the locations of the StelLocationMgr, so that its queries do not scan the whole list.
+//! - The IDs of the locations of each planet are kept in cells of 1x1 degree: a circle only visits
+//!   the cells it overlaps, and the nearest location is found by growing a circle.
+//! - The IDs of the locations of each country.
+//! - A StelObjectNameIndex of the IDs ranked by population, for the search of a part of the name.
+//! It also reads and writes the records of the compiled copy of a location file, see StelCompiledCache.
+class StelLocationIndex
+{
+public:
+	//! Rebuild the indexes from the locations, by ID.
+	void build(const QMap<QString, StelLocation>& locations);
+
+	//! IDs of the locations of a planet within radiusDegrees of the given coordinates, with their distance.
+	QVector<QPair<float, QString> > findNearby(const QString& planetName, float longitude, float latitude, float radiusDegrees) const;
+	//! ID of the location of a planet nearest to the given coordinates, or an empty string if the planet has no location.
+	QString findNearest(const QString& planetName, float longitude, float latitude) const;
+	//! IDs of the locations of a country, sorted.
+	QStringList findInCountry(const QString& country) const {return countryIndex.value(country);}
+	//! IDs which contain text, ignoring the case and the diacritics.
+	//! @return at most maxNbItem IDs, most populated first.
+	QStringList findIDs(const QString& text, int maxNbItem) const;
+
+	//! Read the locations from the records of a compiled location file.
+	//! The locations are stored in the order of their ID, so each one is appended to the map.
+	static void readLocations(QDataStream& in, QMap<QString, StelLocation>& locations);
+	//! Write the locations as records of a compiled location file.
+	static void writeLocations(QDataStream& out, const QMap<QString, StelLocation>& locations);
+
+private:
+	//! A location in a cell of the spatial index
+	struct IndexedLocation
+	{
+		QString id;
+		float longitude;
+		float latitude;
+	};
+	//! Cells of 1x1 degree of the locations of each planet, by latitude row and longitude column
+	QHash<QString, QHash<int, QVector<IndexedLocation> > > locationCells;
+	//! IDs of the locations of each country
+	QHash<QString, QStringList> countryIndex;
+	//! IDs of all locations, ranked by population
+	StelObjectNameIndex nameIndex;
+};
+
+#endif // _STELLOCATIONINDEX_HPP_
@@ -17,6 +17,7 @@
  */
 
 #include "StelApp.hpp"
+#include "StelCompiledCache.hpp"
 #include "StelCore.hpp"
 #include "StelFileMgr.hpp"
 #include "StelLocationMgr.hpp"
@@ -35,6 +36,10 @@
 #include <QUrlQuery>
 #include <QSettings>
 
+// Identifies the compiled location files, and their format version
+#define LOCDB_MAGIC 0x4c4f4344
+#define LOCDB_VERSION 1
+
 StelLocationMgr::StelLocationMgr()
 {
 	QSettings* conf = StelApp::getInstance().getSettings();
@@ -44,6 +49,7 @@ StelLocationMgr::StelLocationMgr()
 
 	locations = loadCitiesBin("data/base_locations.bin.gz");
 	locations.unite(loadCities("data/user_locations.txt", true));
+	updateIndex();
 	
 	// Init to Paris France because it's the center of the world.
 	lastResortLocation = locationForString(conf->value("init_location/last_location", "Paris, France").toString());
@@ -60,10 +66,13 @@ StelLocationMgr::StelLocationMgr(const LocationList &locations)
 
 void StelLocationMgr::setLocations(const LocationList &locations)
 {
+	lock.lockForWrite();
 	for(LocationList::const_iterator it = locations.constBegin();it!=locations.constEnd();++it)
 	{
 		this->locations.insert(it->getID(),*it);
 	}
+	updateIndex();
+	lock.unlock();
 
 	emit locationListChanged();
 }
@@ -88,6 +97,16 @@ LocationMap StelLocationMgr::loadCitiesBin(const QString& fileName)
 	if (cityDataPath.isEmpty())
 		return res;
 
+	StelCompiledCache cache(cityDataPath, "locations", LOCDB_MAGIC, LOCDB_VERSION);
+	QDataStream* cacheIn = cache.beginRead();
+	if (cacheIn)
+	{
+		StelLocationIndex::readLocations(*cacheIn, res);
+		if (cache.endRead())
+			return res;
+		res.clear();
+	}
+
 	QFile sourcefile(cityDataPath);
 	if (!sourcefile.open(QIODevice::ReadOnly))
 	{
@@ -100,15 +119,20 @@ LocationMap StelLocationMgr::loadCitiesBin(const QString& fileName)
 		QDataStream in(StelUtils::uncompress(sourcefile.readAll()));
 		in.setVersion(QDataStream::Qt_4_6);
 		in >> res;
-		return res;
 	}
 	else
 	{
 		QDataStream in(&sourcefile);
 		in.setVersion(QDataStream::Qt_4_6);
 		in >> res;
-		return res;
 	}
+	QDataStream* cacheOut = cache.beginWrite();
+	if (cacheOut)
+	{
+		StelLocationIndex::writeLocations(*cacheOut, res);
+		cache.endWrite();
+	}
+	return res;
 }
 
 LocationMap StelLocationMgr::loadCities(const QString& fileName, bool isUserLocation)
@@ -191,11 +215,15 @@ static float parseAngle(const QString& s, bool* ok)
 
 const StelLocation StelLocationMgr::locationForString(const QString& s) const
 {
+	lock.lockForRead();
 	QMap<QString, StelLocation>::const_iterator iter = locations.find(s);
 	if (iter!=locations.end())
 	{
-		return iter.value();
+		const StelLocation loc = iter.value();
+		lock.unlock();
+		return loc;
 	}
+	lock.unlock();
 	StelLocation ret;
 	// Maybe it is a coordinate set ? (e.g. GPS 25.107363,121.558807 )
 	QRegExp reg("(?:(.+)\\s+)?(.+),(.+)");
@@ -236,6 +264,7 @@ const StelLocation StelLocationMgr::locationFromCLI() const
 // Get whether a location can be permanently added to the list of user locations
 bool StelLocationMgr::canSaveUserLocation(const StelLocation& loc) const
 {
+	QReadLocker locker(&lock);
 	return loc.isValid() && locations.find(loc.getID())==locations.end();
 }
 
@@ -246,7 +275,10 @@ bool StelLocationMgr::saveUserLocation(const StelLocation& loc)
 		return false;
 
 	// Add in the program
+	lock.lockForWrite();
 	locations[loc.getID()]=loc;
+	updateIndex();
+	lock.unlock();
 
 	//emit before saving the list
 	emit locationListChanged();
@@ -288,6 +320,7 @@ bool StelLocationMgr::saveUserLocation(const StelLocation& loc)
 // If the location comes from the base read only list, it cannot be deleted
 bool StelLocationMgr::canDeleteUserLocation(const QString& id) const
 {
+	QReadLocker locker(&lock);
 	QMap<QString, StelLocation>::const_iterator iter=locations.find(id);
 
 	// If it's not known at all there is a problem
@@ -304,7 +337,10 @@ bool StelLocationMgr::deleteUserLocation(const QString& id)
 	if (!canDeleteUserLocation(id))
 		return false;
 
+	lock.lockForWrite();
 	locations.remove(id);
+	updateIndex();
+	lock.unlock();
 
 	//emit before saving the list
 	emit locationListChanged();
@@ -337,7 +373,8 @@ bool StelLocationMgr::deleteUserLocation(const QString& id)
 	QTextStream outstream(&sourcefile);
 	outstream.setCodec("UTF-8");
 
-	for (QMap<QString, StelLocation>::ConstIterator iter=locations.constBegin();iter!=locations.constEnd();++iter)
+	const LocationMap remaining = getAllMap();
+	for (QMap<QString, StelLocation>::ConstIterator iter=remaining.constBegin();iter!=remaining.constEnd();++iter)
 	{
 		if (iter.value().isUserLocation)
 		{
@@ -402,35 +439,49 @@ void StelLocationMgr::changeLocationFromNetworkLookup()
 	networkReply->deleteLater();
 }
 
-LocationMap StelLocationMgr::pickLocationsNearby(const QString planetName, const float longitude, const float latitude, const float radiusDegrees)
+void StelLocationMgr::updateIndex()
 {
-	QMap<QString, StelLocation> results;
-	QMapIterator<QString, StelLocation> iter(locations);
-	while (iter.hasNext())
-	{
-		iter.next();
-		const StelLocation *loc=&iter.value();
-		if ( (loc->planetName == planetName) &&
-				(StelLocation::distanceDegrees(longitude, latitude, loc->longitude, loc->latitude) <= radiusDegrees) )
-		{
-			results.insert(iter.key(), iter.value());
-		}
-	}
+	index.build(locations);
+}
+
+LocationMap StelLocationMgr::locationsFromIDs(QStringList ids) const
+{
+	LocationMap results;
+	ids.sort();
+	foreach (const QString& id, ids)
+		results.insert(results.constEnd(), id, locations.value(id));
 	return results;
 }
 
+LocationMap StelLocationMgr::pickLocationsNearby(const QString planetName, const float longitude, const float latitude, const float radiusDegrees)
+{
+	QReadLocker locker(&lock);
+	QStringList ids;
+	typedef QPair<float, QString> DistanceID;
+	foreach (const DistanceID& loc, index.findNearby(planetName, longitude, latitude, radiusDegrees))
+		ids << loc.second;
+	return locationsFromIDs(ids);
+}
+
 LocationMap StelLocationMgr::pickLocationsInCountry(const QString country)
 {
-	QMap<QString, StelLocation> results;
-	QMapIterator<QString, StelLocation> iter(locations);
-	while (iter.hasNext())
-	{
-		iter.next();
-		const StelLocation *loc=&iter.value();
-		if (loc->country == country)
-		{
-			results.insert(iter.key(), iter.value());
-		}
-	}
-	return results;
+	QReadLocker locker(&lock);
+	return locationsFromIDs(index.findInCountry(country));
+}
+
+StelLocation StelLocationMgr::pickNearestLocation(const QString& planetName, float longitude, float latitude) const
+{
+	QReadLocker locker(&lock);
+	const QString id = index.findNearest(planetName, longitude, latitude);
+	if (!id.isEmpty())
+		return locations.value(id);
+	StelLocation result;
+	result.role = '!';
+	return result;
+}
+
+QStringList StelLocationMgr::findLocationIDs(const QString& text, int maxNbItem) const
+{
+	QReadLocker locker(&lock);
+	return index.findIDs(text, maxNbItem);
 }
@@ -20,16 +20,24 @@
 #define _STELLOCATIONMGR_HPP_
 
 #include "StelLocation.hpp"
+#include "StelLocationIndex.hpp"
 #include <QString>
 #include <QObject>
 #include <QMetaType>
 #include <QMap>
+#include <QReadWriteLock>
 
 typedef QList<StelLocation> LocationList;
 typedef QMap<QString,StelLocation> LocationMap;
 
 //! @class StelLocationMgr
 //! Manage the list of available location.
+//! The locations are indexed by position, country and name, so that the queries do not scan the whole list.
+//! The base locations are loaded from a compiled copy of the location file (see StelCompiledCache): its records
+//! are read in ID order, without the uncompression and the ordered inserts of the original file. They are still
+//! all deserialised into the LocationMap, which the rest of the program uses.
+//! The queries can run in several threads: a lock guards the locations and the indexes, which are built
+//! when the locations change, so that a lookup only reads them.
 class StelLocationMgr : public QObject
 {
 	Q_OBJECT
@@ -45,10 +53,10 @@ public:
 	void setLocations(const LocationList& locations);
 
 	//! Return the list of all loaded locations
-	LocationList getAll() const {return locations.values();}
+	LocationList getAll() const {QReadLocker locker(&lock); return locations.values();}
 
 	//! Returns a map of all loaded locations. The key is the location ID, suitable for a list view.
-	LocationMap getAllMap() const { return locations; }
+	LocationMap getAllMap() const {QReadLocker locker(&lock); return locations;}
 
 	//! Return the StelLocation from a CLI
 	const StelLocation locationFromCLI() const;
@@ -81,6 +89,12 @@ public:
 	LocationMap pickLocationsNearby(const QString planetName, const float longitude, const float latitude, const float radiusDegrees);
 	//! Find list of locations in a particular country only.
 	LocationMap pickLocationsInCountry(const QString country);
+	//! Find the location nearest to the given coordinates.
+	//! @return the nearest location of the planet, or an invalid location if the planet has no location.
+	StelLocation pickNearestLocation(const QString& planetName, float longitude, float latitude) const;
+	//! Find the locations whose ID contains text, ignoring the case and the diacritics.
+	//! @return at most maxNbItem location IDs, most populated first.
+	QStringList findLocationIDs(const QString& text, int maxNbItem) const;
 
 public slots:
 	//! Return the StelLocation for a given string
@@ -102,8 +116,18 @@ private:
 	static LocationMap loadCities(const QString& fileName, bool isUserLocation);
 	static LocationMap loadCitiesBin(const QString& fileName);
 
+	//! Rebuild the indexes after a change of the list of locations, with the lock held for writing.
+	void updateIndex();
+	//! Map of the locations with the given IDs, with the lock held.
+	LocationMap locationsFromIDs(QStringList ids) const;
+
 	//! The list of all loaded locations
 	LocationMap locations;
+
+	//! Indexes of the locations by position, country and name
+	StelLocationIndex index;
+	//! Guards locations and index
+	mutable QReadWriteLock lock;
 	
 	StelLocation lastResortLocation;
 };
@@ -76,6 +76,8 @@ StelMovementMgr::StelMovementMgr(StelCore* acore)
 	isDragging = false;
 	mountMode = MountAltAzimuthal;  // default
 	upVectorMountFrame.set(0.,0.,1.);
+	lastViewDirectionJ2000.set(0.,0.,0.);
+	viewVelocityJ2000.set(0.,0.,0.);
 }
 
 StelMovementMgr::~StelMovementMgr()
@@ -638,6 +640,15 @@ void StelMovementMgr::lookZenith(void)
 // Increment/decrement smoothly the vision field and position
 void StelMovementMgr::updateMotion(double deltaTime)
 {
+	// The view also moves by mouse drags between two updates
+	if (deltaTime>0. && lastViewDirectionJ2000.lengthSquared()>0.)
+	{
+		const Vec3d velocity = (viewDirectionJ2000-lastViewDirectionJ2000)/deltaTime;
+		// Smoothed over a few frames, the mouse moves by steps
+		viewVelocityJ2000 = viewVelocityJ2000*0.5 + velocity*0.5;
+	}
+	lastViewDirectionJ2000 = viewDirectionJ2000;
+
 	updateVisionVector(deltaTime);
 
 	const StelProjectorP proj = core->getProjection(StelCore::FrameJ2000);
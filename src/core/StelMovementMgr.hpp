@@ -213,6 +213,9 @@ public slots:
 
 	//! Return the current viewing direction in equatorial J2000 frame.
 	Vec3d getViewDirectionJ2000() const {return viewDirectionJ2000;}
+	//! Return the rate of change of the viewing direction in equatorial J2000 frame, per second.
+	//! It is smoothed over the last frames, e.g. to predict which part of the sky will be visible.
+	Vec3d getViewVelocityJ2000() const {return viewVelocityJ2000;}
 	void setViewDirectionJ2000(const Vec3d& v);
 
 	//! Set the maximum field of View in degrees.
@@ -424,6 +427,9 @@ private:
 	Vec3d viewDirectionJ2000;
 	// Viewing direction in the mount reference frame.
 	Vec3d viewDirectionMountFrame;
+	// Viewing direction at the previous update, and its rate of change per second
+	Vec3d lastViewDirectionJ2000;
+	Vec3d viewVelocityJ2000;
 
 	// Up vector (in OpenGL terms) in the mount reference frame.
 	// This can usually be just 0/0/1, but must be set to something useful when viewDirectionMountFrame is parallel, i.e. looks into a pole.
@@ -28,6 +28,7 @@
 #include "RefractionExtinction.hpp"
 #include "StelLocation.hpp"
 #include "SolarSystem.hpp"
+#include "ConstellationMgr.hpp"
 #include "StelModuleMgr.hpp"
 #include "planetsephems/sidereal_time.h"
 
@@ -246,6 +247,14 @@ QString StelObject::getPositionInfoString(const StelCore *core, const InfoString
 			res += q_("Galactic longitude/latitude: %1/%2").arg(StelUtils::radToDmsStr(glong,true), StelUtils::radToDmsStr(glat,true)) + "<br>";
 	}
 
+	if (flags&Extra)
+	{
+		const ConstellationMgr* cmgr = GETSTELMODULE(ConstellationMgr);
+		const QString constellation = cmgr ? cmgr->getIAUConstellation(getJ2000EquatorialPos(core)) : QString();
+		if (!constellation.isEmpty())
+			res += q_("IAU Constellation: %1").arg(constellation) + "<br>";
+	}
+
 	if ((flags&Extra) && core->getCurrentPlanet()->getEnglishName()=="Earth")
 	{
 		double longitude=core->getCurrentLocation().longitude;
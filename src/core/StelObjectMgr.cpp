@@ -254,16 +254,34 @@ QStringList StelObjectMgr::listMatchingObjects(const QString& objPrefix, unsigne
 		return result;
 	}
 
-	// For all StelObjectmodules..
+	// Each source lists its best matches first: the name index for the modules which fill it,
+	// then each module for its designations or, if it does not fill the index, for its names
+	QList<QStringList> sources;
+	sources << nameIndex.find(objPrefix, maxNbItem, useStartOfWords ? StelObjectNameIndex::MatchWordStart : StelObjectNameIndex::MatchSubstring, inEnglish);
 	foreach (const StelObjectModule* m, objectsModule)
 	{
-		// Get matching object for this module
-		QStringList matchingObj = m->listMatchingObjects(objPrefix, maxNbItem, useStartOfWords, inEnglish);
-		result += matchingObj;
-		maxNbItem-=matchingObj.size();
+		QStringList matchingObj = nameIndex.hasNames(m->objectName())
+				? m->listMatchingDesignations(objPrefix, maxNbItem)
+				: m->listMatchingObjects(objPrefix, maxNbItem, useStartOfWords, inEnglish);
+		if (!matchingObj.isEmpty())
+			sources << matchingObj;
 	}
 
-	result.sort();
+	// Take the best remaining match of each source in turn, so that no source starves the others
+	for (int i=0; result.size()<(int)maxNbItem; ++i)
+	{
+		bool more = false;
+		foreach (const QStringList& matchingObj, sources)
+		{
+			if (i>=matchingObj.size())
+				continue;
+			more = true;
+			if (result.size()<(int)maxNbItem && !result.contains(matchingObj.at(i)))
+				result << matchingObj.at(i);
+		}
+		if (!more)
+			break;
+	}
 	return result;
 }
 
@@ -24,6 +24,7 @@
 #include "VecMath.hpp"
 #include "StelModule.hpp"
 #include "StelObject.hpp"
+#include "StelObjectNameIndex.hpp"
 
 #include <QList>
 #include <QString>
@@ -80,12 +81,17 @@ public:
 	bool findAndSelect(const QString &name, StelModule::StelModuleSelectAction action=StelModule::ReplaceSelection);
 
 	//! Find and return the list of at most maxNbItem objects auto-completing the passed object name.
+	//! The names of the modules which fill the name index are searched in the index, brightest objects first.
+	//! The matches of the index and of the other modules are taken in turn, so that each source gets its best matches listed.
 	//! @param objPrefix the case insensitive first letters of the searched object
 	//! @param maxNbItem the maximum number of returned object names.
-	//! @param useStartOfWords the autofill mode for returned objects names
+	//! @param useStartOfWords the autofill mode for returned objects names: the start of a word instead of any part of the names
 	//! @return a list of matching object names by order of relevance, or an empty list if nothing match
 	QStringList listMatchingObjects(const QString& objPrefix, unsigned int maxNbItem=5, bool useStartOfWords=false, bool inEnglish=true) const;
 
+	//! Get the index of the object names, which the StelObjectModules fill with their names.
+	StelObjectNameIndex& getNameIndex() {return nameIndex;}
+
 	QStringList listAllModuleObjects(const QString& moduleId, bool inEnglish) const;
 	QMap<QString, QString> objectModulesMap() const;
 
@@ -156,6 +162,9 @@ private:
 
 	// Weight of the distance factor when choosing the best object to select.
 	float distanceWeight;
+
+	// Names of the modules for listMatchingObjects()
+	StelObjectNameIndex nameIndex;
 };
 
 #endif // _SELECTIONMGR_HPP_
@@ -68,6 +68,13 @@ QStringList StelObjectModule::listMatchingObjects(const QString &objPrefix, int
 	return result;
 }
 
+QStringList StelObjectModule::listMatchingDesignations(const QString& objPrefix, int maxNbItem) const
+{
+	Q_UNUSED(objPrefix);
+	Q_UNUSED(maxNbItem);
+	return QStringList();
+}
+
 QStringList StelObjectModule::listAllObjectsByType(const QString &objType, bool inEnglish) const
 {
 	Q_UNUSED(objType);
@@ -66,6 +66,14 @@ public:
 	//! @return a list of matching object name by order of relevance, or an empty list if nothing matches
 	virtual QStringList listMatchingObjects(const QString& objPrefix, int maxNbItem=5, bool useStartOfWords=false, bool inEnglish=false) const;
 
+	//! Find the designations which match objPrefix but are not in the name index of the StelObjectMgr,
+	//! e.g. catalogue numbers typed in full. Called instead of listMatchingObjects() for the modules which set their names
+	//! in the index with their objectName() as source. The default implementation returns nothing.
+	//! @param objPrefix the searched text
+	//! @param maxNbItem the maximum number of returned object names
+	//! @return a list of matching designations
+	virtual QStringList listMatchingDesignations(const QString& objPrefix, int maxNbItem) const;
+
 	//! List all StelObjects.
 	//! @param inEnglish list names in English (true) or translated (false)
 	//! @return a list of matching object name by order of relevance, or an empty list if nothing matches
@@ -0,0 +1,360 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include "StelObjectNameIndex.hpp"
+
+#include <QSet>
+#include <QStringRef>
+
+#include <algorithm>
+#include <queue>
+
+// A name with its folded key, while the table is built
+struct NameItem
+{
+	QString name;
+	QString key;
+	float magnitude;
+	int group;
+};
+
+static bool brighterItem(const NameItem& a, const NameItem& b)
+{
+	if (a.magnitude!=b.magnitude)
+		return a.magnitude<b.magnitude;
+	return a.key<b.key;
+}
+
+// Orders the starts of a SuffixArray by the text which follows them
+struct SuffixLess
+{
+	SuffixLess(const QVector<QString>& k, const QVector<int>& r, const QVector<int>& o) : keys(k), rank(r), offset(o) {}
+	QStringRef suffix(int i) const {return keys.at(rank.at(i)).midRef(offset.at(i));}
+	bool operator()(int a, int b) const {return suffix(a).compare(suffix(b))<0;}
+	const QVector<QString>& keys;
+	const QVector<int>& rank;
+	const QVector<int>& offset;
+};
+
+// Range of a SuffixArray searched for the best ranks
+struct RangeCandidate
+{
+	int rank;
+	int pos;
+	int begin;
+	int end;
+	// The priority queue returns the smallest rank first
+	bool operator<(const RangeCandidate& other) const {return rank>other.rank;}
+};
+
+static inline bool isWordStart(const QString& key, int i)
+{
+	return key.at(i).isLetterOrNumber() && (i==0 || !key.at(i-1).isLetterOrNumber());
+}
+
+StelObjectNameIndex::StelObjectNameIndex()
+{
+}
+
+void StelObjectNameIndex::setNames(const QString& source, bool inEnglish, const QVector<Entry>& entries)
+{
+	Table& table = tables[inEnglish ? 1 : 0];
+	table.sources.insert(source, entries);
+	table.dirty = true;
+}
+
+void StelObjectNameIndex::removeNames(const QString& source)
+{
+	for (int i=0; i<2; ++i)
+	{
+		if (tables[i].sources.remove(source))
+			tables[i].dirty = true;
+	}
+}
+
+bool StelObjectNameIndex::hasNames(const QString& source) const
+{
+	return tables[0].sources.contains(source) || tables[1].sources.contains(source);
+}
+
+void StelObjectNameIndex::buildTables()
+{
+	for (int i=0; i<2; ++i)
+	{
+		if (tables[i].dirty)
+			build(tables[i]);
+	}
+}
+
+QString StelObjectNameIndex::fold(const QString& text)
+{
+	// The compatibility decomposition separates the diacritics from their letters
+	const QString decomposed = text.normalized(QString::NormalizationForm_KD);
+	QString result;
+	result.reserve(decomposed.size());
+	for (int i=0; i<decomposed.size(); ++i)
+	{
+		const QChar c = decomposed.at(i);
+		if (c.isMark())
+			continue;
+		if (c.isSpace())
+		{
+			int next = i+1;
+			while (next<decomposed.size() && decomposed.at(next).isSpace())
+				++next;
+			// Trim, and join designations like "NGC 224"
+			if (!result.isEmpty() && next<decomposed.size()
+			    && !(result.at(result.size()-1).isLetter() && decomposed.at(next).isDigit()))
+				result += QChar(' ');
+			i = next-1;
+			continue;
+		}
+		result += c.toUpper();
+	}
+	return result;
+}
+
+QStringList StelObjectNameIndex::find(const QString& text, int maxNbItem, MatchMode mode, bool inEnglish) const
+{
+	QStringList result;
+	const QString key = fold(text);
+	if (maxNbItem<=0 || key.isEmpty())
+		return result;
+
+	Table& table = tables[inEnglish ? 1 : 0];
+	if (table.dirty)
+		build(table);
+
+	if (mode==MatchSubstring)
+		findSubstring(table, key, maxNbItem, result);
+	else
+	{
+		const SuffixArray& array = mode==MatchPrefix ? table.prefixes : table.wordStarts;
+		int begin, end;
+		array.range(table.keys, key, begin, end);
+		findInRange(table, array, begin, end, maxNbItem, result);
+	}
+	return result;
+}
+
+void StelObjectNameIndex::build(Table& table)
+{
+	QVector<NameItem> items;
+	int groupBase = 0;
+	for (QMap<QString, QVector<Entry> >::const_iterator it=table.sources.constBegin(); it!=table.sources.constEnd(); ++it)
+	{
+		int groupCount = 0;
+		foreach (const Entry& e, it.value())
+		{
+			NameItem item;
+			item.name = e.name;
+			item.key = fold(e.searchName.isEmpty() ? e.name : e.searchName);
+			item.magnitude = e.magnitude;
+			item.group = groupBase + e.group;
+			groupCount = qMax(groupCount, e.group+1);
+			if (!item.key.isEmpty())
+				items.append(item);
+		}
+		groupBase += groupCount;
+	}
+	std::sort(items.begin(), items.end(), brighterItem);
+
+	const int n = items.size();
+	table.names.resize(n);
+	table.keys.resize(n);
+	table.groups.resize(n);
+	table.trigrams.clear();
+	for (int r=0; r<n; ++r)
+	{
+		const NameItem& item = items.at(r);
+		table.names[r] = item.name;
+		table.keys[r] = item.key;
+		table.groups[r] = item.group;
+		for (int pos=0; pos+3<=item.key.size(); ++pos)
+		{
+			QVector<int>& ranks = table.trigrams[trigram(item.key, pos)];
+			if (ranks.isEmpty() || ranks.last()!=r)
+				ranks.append(r);
+		}
+	}
+	table.prefixes.build(table.keys, false);
+	table.wordStarts.build(table.keys, true);
+	table.dirty = false;
+}
+
+void StelObjectNameIndex::findInRange(const Table& table, const SuffixArray& array, int begin, int end, int maxNbItem, QStringList& result)
+{
+	if (begin>=end)
+		return;
+	QSet<int> groups;
+	std::priority_queue<RangeCandidate> queue;
+	RangeCandidate c;
+	c.pos = array.minPos(begin, end);
+	c.rank = array.rank.at(c.pos);
+	c.begin = begin;
+	c.end = end;
+	queue.push(c);
+	while (!queue.empty() && result.size()<maxNbItem)
+	{
+		const RangeCandidate best = queue.top();
+		queue.pop();
+		// The same object can match by several names, or by several words of a name
+		const int group = table.groups.at(best.rank);
+		if (!groups.contains(group))
+		{
+			groups.insert(group);
+			result << table.names.at(best.rank);
+		}
+		// The next best ranks are on either side of this one
+		if (best.begin<best.pos)
+		{
+			c.begin = best.begin;
+			c.end = best.pos;
+			c.pos = array.minPos(c.begin, c.end);
+			c.rank = array.rank.at(c.pos);
+			queue.push(c);
+		}
+		if (best.pos+1<best.end)
+		{
+			c.begin = best.pos+1;
+			c.end = best.end;
+			c.pos = array.minPos(c.begin, c.end);
+			c.rank = array.rank.at(c.pos);
+			queue.push(c);
+		}
+	}
+}
+
+void StelObjectNameIndex::findSubstring(const Table& table, const QString& key, int maxNbItem, QStringList& result)
+{
+	QSet<int> groups;
+	const int n = table.keys.size();
+	const QVector<int>* candidates = NULL;
+	if (key.size()>=3)
+	{
+		// All matching names contain every trigram of the key: walk the shortest list
+		for (int pos=0; pos+3<=key.size(); ++pos)
+		{
+			QHash<quint64, QVector<int> >::const_iterator it = table.trigrams.constFind(trigram(key, pos));
+			if (it==table.trigrams.constEnd())
+				return;
+			if (!candidates || it.value().size()<candidates->size())
+				candidates = &it.value();
+		}
+	}
+	// Shorter texts are contained in many names, so the walk over all names stops early
+	const int count = candidates ? candidates->size() : n;
+	for (int i=0; i<count && result.size()<maxNbItem; ++i)
+	{
+		const int r = candidates ? candidates->at(i) : i;
+		if (!table.keys.at(r).contains(key))
+			continue;
+		const int group = table.groups.at(r);
+		if (!groups.contains(group))
+		{
+			groups.insert(group);
+			result << table.names.at(r);
+		}
+	}
+}
+
+quint64 StelObjectNameIndex::trigram(const QString& key, int pos)
+{
+	return ((quint64)key.at(pos).unicode()<<32) | ((quint64)key.at(pos+1).unicode()<<16) | (quint64)key.at(pos+2).unicode();
+}
+
+void StelObjectNameIndex::SuffixArray::build(const QVector<QString>& keys, bool wordStarts)
+{
+	rank.clear();
+	offset.clear();
+	for (int r=0; r<keys.size(); ++r)
+	{
+		const QString& key = keys.at(r);
+		for (int i=0; i<(wordStarts ? key.size() : 1); ++i)
+		{
+			if (wordStarts && !isWordStart(key, i))
+				continue;
+			rank.append(r);
+			offset.append(i);
+		}
+	}
+
+	// Sort the starts through a permutation, then apply it
+	QVector<int> order(rank.size());
+	for (int i=0; i<order.size(); ++i)
+		order[i] = i;
+	std::sort(order.begin(), order.end(), SuffixLess(keys, rank, offset));
+	QVector<int> sortedRank(order.size()), sortedOffset(order.size());
+	for (int i=0; i<order.size(); ++i)
+	{
+		sortedRank[i] = rank.at(order.at(i));
+		sortedOffset[i] = offset.at(order.at(i));
+	}
+	rank = sortedRank;
+	offset = sortedOffset;
+
+	leaves = 1;
+	while (leaves<rank.size())
+		leaves *= 2;
+	minTree.fill(-1, 2*leaves);
+	for (int i=0; i<rank.size(); ++i)
+		minTree[leaves+i] = i;
+	for (int i=leaves-1; i>0; --i)
+		minTree[i] = better(minTree.at(2*i), minTree.at(2*i+1));
+}
+
+void StelObjectNameIndex::SuffixArray::range(const QVector<QString>& keys, const QString& text, int& begin, int& end) const
+{
+	const SuffixLess less(keys, rank, offset);
+	// First start not before text
+	int lo = 0, hi = rank.size();
+	while (lo<hi)
+	{
+		const int mid = (lo+hi)/2;
+		if (less.suffix(mid).compare(text)<0)
+			lo = mid+1;
+		else
+			hi = mid;
+	}
+	begin = lo;
+	// First start after begin which is not followed by text
+	hi = rank.size();
+	while (lo<hi)
+	{
+		const int mid = (lo+hi)/2;
+		if (less.suffix(mid).startsWith(text))
+			lo = mid+1;
+		else
+			hi = mid;
+	}
+	end = lo;
+}
+
+int StelObjectNameIndex::SuffixArray::minPos(int begin, int end) const
+{
+	int result = -1;
+	for (int l=begin+leaves, r=end+leaves; l<r; l/=2, r/=2)
+	{
+		if (l&1)
+			result = better(result, minTree.at(l++));
+		if (r&1)
+			result = better(result, minTree.at(--r));
+	}
+	return result;
+}
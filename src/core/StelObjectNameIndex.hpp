@@ -0,0 +1,124 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _STELOBJECTNAMEINDEX_HPP_
+#define _STELOBJECTNAMEINDEX_HPP_
+
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+//! @class StelObjectNameIndex
+//! Index of the object names of all StelObjectModules, for the completion of the search dialog.
+//! Each module sets its names when it loads its catalogues and when the sky language changes.
+//! Names are compared after folding: upper case, without diacritics, and without the space between
+//! a letter and a digit, so that "M 31" and "m31" find the same object.
+//! The names are ranked by the magnitude of their object, and lookups return the brightest matches:
+//! - prefix and word start lookups search sorted arrays of the name (or word) starts, and take the
+//!   best ranks of the matching range from a segment tree, so they do not depend on the number of names;
+//! - substring lookups walk the names containing the rarest trigram of the searched text in rank order,
+//!   and stop after the requested number of matches.
+class StelObjectNameIndex
+{
+public:
+	enum MatchMode
+	{
+		MatchPrefix,	//!< The name starts with the text
+		MatchWordStart,	//!< A word of the name starts with the text
+		MatchSubstring	//!< The name contains the text
+	};
+
+	//! One name of an object.
+	struct Entry
+	{
+		Entry() : magnitude(99.f), group(0) {}
+		Entry(const QString& n, float mag, int g, const QString& alias=QString())
+			: name(n), searchName(alias), magnitude(mag), group(g) {}
+		QString name;		//!< The returned name
+		QString searchName;	//!< Text matched instead of name, if not empty
+		float magnitude;	//!< Rank of the name, brightest first
+		int group;		//!< Object of the name in its module: only the best name of an object is returned
+	};
+
+	StelObjectNameIndex();
+
+	//! Replace the names of a source (usually the name of a module) in one language.
+	void setNames(const QString& source, bool inEnglish, const QVector<Entry>& entries);
+	//! Remove the names of a source in both languages.
+	void removeNames(const QString& source);
+	//! Whether names were set for the source.
+	bool hasNames(const QString& source) const;
+	//! Build the tables changed since the last lookup now. The following lookups then only read
+	//! the index, so they can run in several threads while the names do not change.
+	void buildTables();
+
+	//! Find the names of the brightest objects matching text.
+	//! @return at most maxNbItem names, brightest first.
+	QStringList find(const QString& text, int maxNbItem, MatchMode mode, bool inEnglish) const;
+
+	//! Text as compared by the index.
+	static QString fold(const QString& text);
+
+private:
+	//! Starts of names or words sorted by the text which follows them.
+	struct SuffixArray
+	{
+		SuffixArray() : leaves(0) {}
+		QVector<int> rank;	// rank of the entry of each start
+		QVector<int> offset;	// position of the start in the key
+		QVector<int> minTree;	// segment tree of the position of the smallest rank
+		int leaves;
+		void build(const QVector<QString>& keys, bool wordStarts);
+		//! Range of the starts which are followed by text.
+		void range(const QVector<QString>& keys, const QString& text, int& begin, int& end) const;
+		//! Position of the smallest rank in [begin, end).
+		int minPos(int begin, int end) const;
+		//! The position of a and b with the smallest rank, a or b may be -1.
+		int better(int a, int b) const {return a<0 ? b : (b<0 || rank.at(a)<=rank.at(b) ? a : b);}
+	};
+
+	//! The names of one language, in rank order.
+	struct Table
+	{
+		Table() : dirty(true) {}
+		QMap<QString, QVector<Entry> > sources;
+		QVector<QString> names;
+		QVector<QString> keys;
+		QVector<int> groups;
+		SuffixArray prefixes;
+		SuffixArray wordStarts;
+		QHash<quint64, QVector<int> > trigrams;	// ranks of the keys containing each trigram
+		bool dirty;
+	};
+
+	//! Rebuild the ranks and indexes of a table after its sources changed.
+	static void build(Table& table);
+	//! The brightest entries with a start in [begin, end) of array.
+	static void findInRange(const Table& table, const SuffixArray& array, int begin, int end, int maxNbItem, QStringList& result);
+	//! The brightest entries containing key.
+	static void findSubstring(const Table& table, const QString& key, int maxNbItem, QStringList& result);
+	static quint64 trigram(const QString& key, int pos);
+
+	// Built at the first lookup after a change, so that the modules can set their names one after the other
+	mutable Table tables[2];	// translated, English
+};
+
+#endif // _STELOBJECTNAMEINDEX_HPP_
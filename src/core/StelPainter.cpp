@@ -54,6 +54,8 @@ StelPainter::BasicShaderVars StelPainter::basicShaderVars;
 StelPainter::TexturesShaderVars StelPainter::texturesShaderVars;
 StelPainter::BasicShaderVars StelPainter::colorShaderVars;
 StelPainter::TexturesColorShaderVars StelPainter::texturesColorShaderVars;
+QOpenGLShaderProgram* StelPainter::retainedShaderPrograms[4] = {NULL, NULL, NULL, NULL};
+StelPainter::RetainedShaderVars StelPainter::retainedShaderVars[4];
 
 StelPainter::GLState::GLState()
 {
@@ -673,6 +675,8 @@ inline void fIter(const StelProjectorP& prj, const Vec3d& p1, const Vec3d& p2, V
 // Used by the method below
 QVector<Vec2f> StelPainter::smallCircleVertexArray;
 QVector<Vec4f> StelPainter::smallCircleColorArray;
+StelLineBatch StelPainter::lineBatch;
+int StelPainter::drawCallCount = 0;
 
 void StelPainter::drawSmallCircleVertexArray()
 {
@@ -681,6 +685,14 @@ void StelPainter::drawSmallCircleVertexArray()
 
 	Q_ASSERT(smallCircleVertexArray.size()>1);
 
+	if (lineBatch.isActive())
+	{
+		lineBatch.addStrip(smallCircleVertexArray, smallCircleColorArray, currentColor);
+		smallCircleVertexArray.resize(0);
+		smallCircleColorArray.resize(0);
+		return;
+	}
+
 	enableClientStates(true, false, !smallCircleColorArray.isEmpty());
 	setVertexPointer(2, GL_FLOAT, smallCircleVertexArray.constData());
 	if (!smallCircleColorArray.isEmpty())
@@ -691,6 +703,26 @@ void StelPainter::drawSmallCircleVertexArray()
 	smallCircleColorArray.resize(0);
 }
 
+void StelPainter::beginLineBatch()
+{
+	lineBatch.begin();
+}
+
+void StelPainter::endLineBatch()
+{
+	lineBatch.end();
+	if (lineBatch.isEmpty())
+		return;
+
+	enableClientStates(true, false, true);
+	setVertexPointer(2, GL_FLOAT, lineBatch.getVertices().constData());
+	setColorPointer(4, GL_FLOAT, lineBatch.getColors().constData());
+	drawFromArray(Lines, lineBatch.getVertices().size(), 0, false);
+	enableClientStates(false);
+	// Keep the capacity for the next frame
+	lineBatch.clear();
+}
+
 static Vec3d pt1, pt2;
 void StelPainter::drawGreatCircleArc(const Vec3d& start, const Vec3d& stop, const SphericalCap* clippingCap,
 	void (*viewportEdgeIntersectCallback)(const Vec3d& screenPos, const Vec3d& direction, void* userData), void* userData)
@@ -1431,6 +1463,139 @@ void StelPainter::drawStelVertexArray(const StelVertexArray& arr, bool checkDisc
 	enableClientStates(false);
 }
 
+StelPainter::RetainedGeometry::RetainedGeometry(const StelVertexArray& va)
+	: vertexArray(va)
+	, vertexBuffer(QOpenGLBuffer::VertexBuffer)
+	, indexBuffer(QOpenGLBuffer::IndexBuffer)
+	, texCoordOffset(0)
+	, colorOffset(0)
+	, colorsChanged(false)
+{
+	const int n = va.vertex.size();
+	QVector<float> data;
+	data.reserve(n*(3 + (va.isTextured() ? 2 : 0) + (va.isColored() ? 3 : 0)));
+	foreach (const Vec3d& v, va.vertex)
+		data << (float)v[0] << (float)v[1] << (float)v[2];
+	texCoordOffset = data.size()*sizeof(float);
+	if (va.isTextured())
+	{
+		Q_ASSERT(va.texCoords.size()==n);
+		foreach (const Vec2f& t, va.texCoords)
+			data << t[0] << t[1];
+	}
+	colorOffset = data.size()*sizeof(float);
+	if (va.isColored())
+	{
+		Q_ASSERT(va.colors.size()==n);
+		foreach (const Vec3f& c, va.colors)
+			data << c[0] << c[1] << c[2];
+	}
+
+	// Without the buffers, the geometry is drawn from client memory
+	if (va.isIndexed())
+	{
+		if (!indexBuffer.create())
+		{
+			qWarning() << "Cannot create an index buffer for retained geometry";
+			return;
+		}
+		indexBuffer.bind();
+		indexBuffer.allocate(va.indices.constData(), va.indices.size()*sizeof(unsigned short));
+		indexBuffer.release();
+	}
+	if (!vertexBuffer.create())
+	{
+		qWarning() << "Cannot create a vertex buffer for retained geometry";
+		return;
+	}
+	vertexBuffer.setUsagePattern(va.isColored() ? QOpenGLBuffer::DynamicDraw : QOpenGLBuffer::StaticDraw);
+	vertexBuffer.bind();
+	vertexBuffer.allocate(data.constData(), data.size()*sizeof(float));
+	vertexBuffer.release();
+}
+
+void StelPainter::RetainedGeometry::setColors(const QVector<Vec3f>& colors)
+{
+	Q_ASSERT(vertexArray.isColored() && colors.size()==vertexArray.vertex.size());
+	if (colors==vertexArray.colors)
+		return;
+	vertexArray.colors = colors;
+	colorsChanged = true;
+}
+
+StelPainter::RetainedGeometryP StelPainter::createRetainedGeometry(const StelVertexArray& va)
+{
+	return RetainedGeometryP(new RetainedGeometry(va));
+}
+
+void StelPainter::drawRetainedGeometry(const RetainedGeometryP& geometry, bool checkDiscontinuity)
+{
+	const StelVertexArray& va = geometry->vertexArray;
+	const int variant = (va.isTextured() ? 1 : 0) | (va.isColored() ? 2 : 0);
+	const StelProjector::ShaderParameters params = prj->getShaderParameters();
+	QOpenGLShaderProgram* pr = retainedShaderPrograms[variant];
+	if (params.projection==StelProjector::ShaderProjectionNone || !geometry->vertexBuffer.isCreated() || !pr)
+	{
+		drawStelVertexArray(va, checkDiscontinuity);
+		return;
+	}
+	if (va.vertex.isEmpty())
+		return;
+
+	const RetainedShaderVars& vars = retainedShaderVars[variant];
+	const Mat4f& m = prj->getProjectionMatrix();
+	const QMatrix4x4 qMat(m[0], m[4], m[8], m[12], m[1], m[5], m[9], m[13], m[2], m[6], m[10], m[14], m[3], m[7], m[11], m[15]);
+	const Mat4d& mv = params.modelView;
+	const QMatrix4x4 qModelView(mv[0], mv[4], mv[8], mv[12], mv[1], mv[5], mv[9], mv[13], mv[2], mv[6], mv[10], mv[14], mv[3], mv[7], mv[11], mv[15]);
+
+	// The vertex shader computes StelProjector::shaderProject()
+	pr->bind();
+	pr->setUniformValue(vars.projectionMatrix, qMat);
+	pr->setUniformValue(vars.modelView, qModelView);
+	pr->setUniformValue(vars.viewport, params.viewport[0], params.viewport[1], params.viewport[2], params.viewport[3]);
+	pr->setUniformValue(vars.depth, params.depth[0], params.depth[1]);
+	pr->setUniformValue(vars.perspective, (GLint)(params.projection==StelProjector::ShaderProjectionPerspective));
+	if (!va.isColored())
+		pr->setUniformValue(vars.color, currentColor[0], currentColor[1], currentColor[2], currentColor[3]);
+
+	geometry->vertexBuffer.bind();
+	if (geometry->colorsChanged)
+	{
+		geometry->vertexBuffer.write(geometry->colorOffset, va.colors.constData(), va.colors.size()*sizeof(Vec3f));
+		geometry->colorsChanged = false;
+	}
+	pr->setAttributeBuffer(vars.vertex, GL_FLOAT, 0, 3);
+	pr->enableAttributeArray(vars.vertex);
+	if (va.isTextured())
+	{
+		pr->setAttributeBuffer(vars.texCoord, GL_FLOAT, geometry->texCoordOffset, 2);
+		pr->enableAttributeArray(vars.texCoord);
+	}
+	if (va.isColored())
+	{
+		pr->setAttributeBuffer(vars.vertexColor, GL_FLOAT, geometry->colorOffset, 3);
+		pr->enableAttributeArray(vars.vertexColor);
+	}
+
+	if (va.isIndexed())
+	{
+		geometry->indexBuffer.bind();
+		glDrawElements(va.primitiveType, va.indices.size(), GL_UNSIGNED_SHORT, NULL);
+		geometry->indexBuffer.release();
+	}
+	else
+		glDrawArrays(va.primitiveType, 0, va.vertex.size());
+	++drawCallCount;
+
+	pr->disableAttributeArray(vars.vertex);
+	if (va.isTextured())
+		pr->disableAttributeArray(vars.texCoord);
+	if (va.isColored())
+		pr->disableAttributeArray(vars.vertexColor);
+	geometry->vertexBuffer.release();
+	pr->release();
+}
+
 void StelPainter::drawSphericalTriangles(const StelVertexArray& va, bool textured, bool colored, const SphericalCap* clippingCap, bool doSubDivide, double maxSqDistortion)
 {
 	if (va.vertex.isEmpty())
@@ -1972,6 +2137,101 @@ void StelPainter::initGLShaders()
 	texturesColorShaderVars.vertex = texturesColorShaderProgram->attributeLocation("vertex");
 	texturesColorShaderVars.color = texturesColorShaderProgram->attributeLocation("color");
 	texturesColorShaderVars.texture = texturesColorShaderProgram->uniformLocation("tex");
+
+	// Retained geometry programs: the vertices are projected in the shader, as in StelProjector::project()
+	// for the perspective and orthographic projections, then into the window like the other programs.
+	const char *vshaderRetainedSrc =
+		"attribute highp vec3 vertex;\n"
+		"uniform highp mat4 modelView;\n"
+		"uniform mediump mat4 projectionMatrix;\n"
+		"uniform highp vec4 viewport;\n" // center x, center y, pixel per radian in x and y
+		"uniform highp vec2 depth;\n" // zNear, 1/(zNear-zFar)
+		"uniform bool perspective;\n"
+		"#ifdef TEXTURED\n"
+		"attribute mediump vec2 texCoord;\n"
+		"varying mediump vec2 texc;\n"
+		"#endif\n"
+		"#ifdef COLORED\n"
+		"attribute mediump vec4 vertexColor;\n"
+		"varying mediump vec4 fragcolor;\n"
+		"#endif\n"
+		"void main(void)\n"
+		"{\n"
+		"    highp vec3 v = (modelView*vec4(vertex, 1.)).xyz;\n"
+		"    highp float r = length(v);\n"
+		"    if (perspective && v.z >= 0.)\n"
+		"        gl_Position = vec4(0., 0., 2., 1.);\n" // behind the viewer: clipped, as the depth of the CPU
+		"    else\n"
+		"    {\n"
+		"        highp float d = perspective ? -v.z : r;\n"
+		"        gl_Position = projectionMatrix*vec4(viewport.x + viewport.z*v.x/d, viewport.y + viewport.w*v.y/d, (r-depth.x)*depth.y, 1.);\n"
+		"    }\n"
+		"#ifdef TEXTURED\n"
+		"    texc = texCoord;\n"
+		"#endif\n"
+		"#ifdef COLORED\n"
+		"    fragcolor = vertexColor;\n"
+		"#endif\n"
+		"}\n";
+	const char *fshaderRetainedSrc =
+		"#ifdef TEXTURED\n"
+		"varying mediump vec2 texc;\n"
+		"uniform sampler2D tex;\n"
+		"#endif\n"
+		"#ifdef COLORED\n"
+		"varying mediump vec4 fragcolor;\n"
+		"#else\n"
+		"uniform mediump vec4 color;\n"
+		"#endif\n"
+		"void main(void)\n"
+		"{\n"
+		"#ifdef COLORED\n"
+		"    mediump vec4 c = fragcolor;\n"
+		"#else\n"
+		"    mediump vec4 c = color;\n"
+		"#endif\n"
+		"#ifdef TEXTURED\n"
+		"    gl_FragColor = texture2D(tex, texc)*c;\n"
+		"#else\n"
+		"    gl_FragColor = c;\n"
+		"#endif\n"
+		"}\n";
+	for (int i=0; i<4; ++i)
+	{
+		QByteArray defines;
+		if (i&1)
+			defines += "#define TEXTURED\n";
+		if (i&2)
+			defines += "#define COLORED\n";
+		QOpenGLShader vshaderRetained(QOpenGLShader::Vertex);
+		vshaderRetained.compileSourceCode(defines + vshaderRetainedSrc);
+		if (!vshaderRetained.log().isEmpty()) { qWarning() << "StelPainter: Warnings while compiling vshaderRetained: " << vshaderRetained.log(); }
+		QOpenGLShader fshaderRetained(QOpenGLShader::Fragment);
+		fshaderRetained.compileSourceCode(defines + fshaderRetainedSrc);
+		if (!fshaderRetained.log().isEmpty()) { qWarning() << "StelPainter: Warnings while compiling fshaderRetained: " << fshaderRetained.log(); }
+
+		QOpenGLShaderProgram* pr = new QOpenGLShaderProgram(QOpenGLContext::currentContext());
+		pr->addShader(&vshaderRetained);
+		pr->addShader(&fshaderRetained);
+		if (!linkProg(pr, QString("retainedShaderProgram%1").arg(i)))
+		{
+			// The retained geometry is then drawn with the other programs
+			delete pr;
+			continue;
+		}
+		retainedShaderPrograms[i] = pr;
+		RetainedShaderVars& vars = retainedShaderVars[i];
+		vars.projectionMatrix = pr->uniformLocation("projectionMatrix");
+		vars.modelView = pr->uniformLocation("modelView");
+		vars.viewport = pr->uniformLocation("viewport");
+		vars.depth = pr->uniformLocation("depth");
+		vars.perspective = pr->uniformLocation("perspective");
+		vars.vertex = pr->attributeLocation("vertex");
+		vars.texCoord = pr->attributeLocation("texCoord");
+		vars.vertexColor = pr->attributeLocation("vertexColor");
+		vars.color = pr->uniformLocation("color");
+		vars.texture = pr->uniformLocation("tex");
+	}
 }
 
 
@@ -1985,6 +2245,11 @@ void StelPainter::deinitGLShaders()
 	texturesShaderProgram = NULL;
 	delete texturesColorShaderProgram;
 	texturesColorShaderProgram = NULL;
+	for (int i=0; i<4; ++i)
+	{
+		delete retainedShaderPrograms[i];
+		retainedShaderPrograms[i] = NULL;
+	}
 	texCache.clear();
 }
 
@@ -2087,6 +2352,7 @@ void StelPainter::drawFromArray(DrawingMode mode, int count, int offset, bool do
 		glDrawElements(mode, count, GL_UNSIGNED_SHORT, indices + offset);
 	else
 		glDrawArrays(mode, offset, count);
+	++drawCallCount;
 
 	if (pr==texturesColorShaderProgram)
 	{
@@ -25,9 +25,12 @@
 #include "StelSphereGeometry.hpp"
 #include "StelProjectorType.hpp"
 #include "StelProjector.hpp"
+#include "StelLineBatch.hpp"
 #include <QString>
 #include <QVarLengthArray>
 #include <QFontMetrics>
+#include <QOpenGLBuffer>
+#include <QSharedPointer>
 
 class QOpenGLShaderProgram;
 
@@ -122,6 +125,20 @@ public:
 	//! The algorithm take care of cutting the path if it crosses a viewport discontinutiy.
 	void drawPath(const QVector<Vec3d> &points, const QVector<Vec4f> &colors);
 
+	//! Start collecting the lines drawn by drawSmallCircleArc(), drawGreatCircleArc() and drawPath() instead of drawing them.
+	//! The tessellated lines are stored in window coordinates with the color of each vertex, so that the lines of
+	//! several painters and frames can be collected, e.g. all the grids of a module. The viewportEdgeIntersectCallback
+	//! of the arcs is still called while they are collected, so labels are drawn before the lines.
+	static void beginLineBatch();
+	//! Draw all the lines collected since beginLineBatch() in one call, with the current GL state, and stop collecting.
+	void endLineBatch();
+	//! Whether lines are currently being collected.
+	static bool isLineBatchActive() {return lineBatch.isActive();}
+
+	//! Number of draw calls issued by all painters since the start of the program.
+	//! Compare two values to count the draw calls of a part of the drawing.
+	static int getDrawCallCount() {return drawCallCount;}
+
 	//! Draw a simple circle, 2d viewport coordinates in pixel
 	void drawCircle(float x, float y, float r);
 
@@ -281,6 +298,37 @@ public:
 	//! @param checkDiscontinuity will check and suppress discontinuities if necessary.
 	void drawStelVertexArray(const StelVertexArray& arr, bool checkDiscontinuity=true);
 
+	//! @class RetainedGeometry
+	//! A StelVertexArray stored once in a GPU buffer, for geometry which does not change in its own frame.
+	//! With a perspective or orthographic projection and a linear model view transformation, the vertices
+	//! are projected by a vertex shader, so that nothing is projected or uploaded by the CPU when drawing.
+	//! With the other projections, or with refraction, the vertex array is drawn as by drawStelVertexArray().
+	//! Must be destroyed while the GL context is current.
+	class RetainedGeometry
+	{
+	public:
+		const StelVertexArray& getVertexArray() const {return vertexArray;}
+		//! Replace the vertex colors, e.g. for extinction. The size must be the number of vertices.
+		//! The colors are only written to the buffer if they changed.
+		void setColors(const QVector<Vec3f>& colors);
+	private:
+		friend class StelPainter;
+		RetainedGeometry(const StelVertexArray& va);
+		StelVertexArray vertexArray;  // for the CPU path
+		QOpenGLBuffer vertexBuffer;   // vertices, then texture coordinates, then colors
+		QOpenGLBuffer indexBuffer;
+		int texCoordOffset;           // in bytes
+		int colorOffset;              // in bytes
+		bool colorsChanged;           // the colors of the buffer must be rewritten
+	};
+	typedef QSharedPointer<RetainedGeometry> RetainedGeometryP;
+
+	//! Store the vertex array in GPU buffers. The GL context must be current.
+	static RetainedGeometryP createRetainedGeometry(const StelVertexArray& va);
+	//! Draw retained geometry with the current projector, color and texture.
+	//! @param checkDiscontinuity used when the geometry is projected on the CPU, as in drawStelVertexArray().
+	void drawRetainedGeometry(const RetainedGeometryP& geometry, bool checkDiscontinuity=true);
+
 	//! Link an opengl program and show a message in case of error or warnings.
 	//! @return true if the link was successful.
 	static bool linkProg(class QOpenGLShaderProgram* prog, const QString& name);
@@ -340,6 +388,11 @@ private:
 	static QVector<Vec4f> smallCircleColorArray;
 	void drawSmallCircleVertexArray();
 
+	// Lines collected between beginLineBatch() and endLineBatch()
+	static StelLineBatch lineBatch;
+	// Number of draw calls of all painters
+	static int drawCallCount;
+
 	//! The associated instance of projector
 	StelProjectorP prj;
 
@@ -384,6 +437,22 @@ private:
 	};
 	static TexturesColorShaderVars texturesColorShaderVars;
 
+	//! Programs of the retained geometry, indexed by 1 if textured + 2 if colored
+	static QOpenGLShaderProgram* retainedShaderPrograms[4];
+	struct RetainedShaderVars {
+		int projectionMatrix;
+		int modelView;
+		int viewport;
+		int depth;
+		int perspective;
+		int vertex;
+		int texCoord;
+		int vertexColor;
+		int color;
+		int texture;
+	};
+	static RetainedShaderVars retainedShaderVars[4];
+
 
 	//! The descriptor for the current opengl vertex array
 	ArrayDesc vertexArray;
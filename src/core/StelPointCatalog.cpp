@@ -0,0 +1,213 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include "StelPointCatalog.hpp"
+#include "StelGeodesicGrid.hpp"
+#include "StelProjector.hpp"
+#include "StelSphereGeometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// The level of the grid is the first one with at most this number of objects per zone on average
+static const int objectsPerZone = 16;
+// Level of the grid for the largest catalogues (81920 zones)
+static const int maxLevel = 6;
+// Margin of the caps searched on the grid, see appendSearchCaps()
+static const double searchMargin = 1e-6;
+
+// An object while the entries are sorted
+struct PointEntry
+{
+	int zone;
+	float mag;
+	int index;
+	bool operator<(const PointEntry& other) const
+	{
+		if (zone!=other.zone)
+			return zone<other.zone;
+		if (mag!=other.mag)
+			return mag<other.mag;
+		return index<other.index;
+	}
+};
+
+StelPointCatalog::StelPointCatalog() : level(0)
+{
+	zoneStart.fill(0, StelGeodesicGrid::nrOfZones(level)+1);
+}
+
+void StelPointCatalog::clear()
+{
+	level = 0;
+	positions.clear();
+	zoneStart.fill(0, StelGeodesicGrid::nrOfZones(level)+1);
+	entryIndex.clear();
+	entryPositions.clear();
+	entryMagnitudes.clear();
+}
+
+int StelPointCatalog::getLevelFor(int n)
+{
+	int l = 0;
+	while (l<maxLevel && StelGeodesicGrid::nrOfZones(l)*objectsPerZone<n)
+		++l;
+	return l;
+}
+
+void StelPointCatalog::setPositions(const StelGeodesicGrid* grid, const QVector<Vec3d>& pos, const QVector<float>& magnitudes)
+{
+	Q_ASSERT(magnitudes.isEmpty() || magnitudes.size()==pos.size());
+	const int n = pos.size();
+	level = getLevelFor(n);
+	Q_ASSERT(grid->getMaxLevel()>=level);
+
+	positions = pos;
+	QVector<PointEntry> entries(n);
+	for (int i=0; i<n; ++i)
+	{
+		positions[i].normalize();
+		const Vec3d& p = positions.at(i);
+		entries[i].zone = grid->getZoneNumberForPoint(Vec3f(p[0], p[1], p[2]), level);
+		entries[i].mag = magnitudes.isEmpty() ? 0.f : magnitudes.at(i);
+		entries[i].index = i;
+	}
+	std::sort(entries.begin(), entries.end());
+
+	const int nrOfZones = StelGeodesicGrid::nrOfZones(level);
+	zoneStart.fill(0, nrOfZones+1);
+	entryIndex.resize(n);
+	entryPositions.resize(n);
+	entryMagnitudes.resize(magnitudes.isEmpty() ? 0 : n);
+	for (int i=0; i<n; ++i)
+	{
+		const PointEntry& e = entries.at(i);
+		++zoneStart[e.zone+1];
+		entryIndex[i] = e.index;
+		entryPositions[i] = positions.at(e.index);
+		if (!magnitudes.isEmpty())
+			entryMagnitudes[i] = e.mag;
+	}
+	for (int z=0; z<nrOfZones; ++z)
+		zoneStart[z+1] += zoneStart.at(z);
+}
+
+QVector<int> StelPointCatalog::findAround(const StelGeodesicGrid* grid, const Vec3d& av, double limitFov) const
+{
+	QVector<int> result;
+	Vec3d v(av);
+	v.normalize();
+	QVector<SphericalCap> convex;
+	convex.append(SphericalCap(v, std::cos(limitFov*M_PI/180.)));
+	find(grid, convex, 99.f, result);
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+QVector<int> StelPointCatalog::findVisible(const StelGeodesicGrid* grid, const StelProjectorP& prj, const SphericalCap& visibleSkyArea, float maxMag) const
+{
+	QVector<int> result;
+	// Same viewport as for the stars (see StarMgr::draw())
+	QVector<SphericalCap> viewportCaps = prj->getViewportConvexPolygon()->getBoundingSphericalCaps();
+	viewportCaps.append(visibleSkyArea);
+	find(grid, viewportCaps, maxMag, result);
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+// The grid only finds the zones of a cap exactly when it is a half-space through the centre of the sphere
+// (see StelGeodesicGrid::searchZones()): a zone can intersect a smaller cap without any of its corners in it.
+// Such a cap is searched as the square around it, as in StarMgr::searchAround(), or as the hemisphere around
+// it if it is large. A larger cap can only give too many zones. The caps are enlarged by searchMargin against
+// the rounding of the corners of the zones, which are in float, and the objects found are tested exactly.
+static void appendSearchCaps(const SphericalCap& cap, QVector<SphericalCap>& searchCaps)
+{
+	Vec3d v(cap.n);
+	v.normalize();
+	if (cap.d<=0.)
+	{
+		searchCaps << SphericalCap(v, cap.d-searchMargin);
+		return;
+	}
+	if (cap.d<0.5)
+	{
+		searchCaps << SphericalCap(v, -searchMargin);
+		return;
+	}
+
+	// Any vectors h0 and h1 with h0*v=h1*v=h0*h1=0, then the corners of the square
+	Vec3d h0(0., 0., 0.);
+	h0[std::fabs(v[0])<std::fabs(v[1]) ? (std::fabs(v[0])<std::fabs(v[2]) ? 0 : 2) : (std::fabs(v[1])<std::fabs(v[2]) ? 1 : 2)] = 1.;
+	Vec3d h1 = h0^v;
+	h1.normalize();
+	h0 = h1^v;
+	h0.normalize();
+	// The middle of the sides of the square is on the cap
+	const double f = std::sqrt(2.)*std::tan(std::acos(cap.d));
+	h0 *= f;
+	h1 *= f;
+	const Vec3d e0 = v+h0, e1 = v+h1, e2 = v-h0, e3 = v-h1;
+	const Vec3d sides[4] = {e2^e3, e1^e2, e0^e1, e3^e0};
+	for (int i=0; i<4; ++i)
+	{
+		Vec3d n = sides[i];
+		n.normalize();
+		searchCaps << SphericalCap(n, -searchMargin);
+	}
+}
+
+void StelPointCatalog::find(const StelGeodesicGrid* grid, const QVector<SphericalCap>& convex, float maxMag, QVector<int>& result) const
+{
+	if (positions.isEmpty())
+		return;
+	QVector<SphericalCap> searchCaps;
+	foreach (const SphericalCap& cap, convex)
+		appendSearchCaps(cap, searchCaps);
+	const GeodesicSearchResult* searchResult = grid->search(searchCaps, level);
+	int zone;
+	for (GeodesicSearchInsideIterator it(*searchResult, level); (zone = it.next()) >= 0;)
+		findInZone(zone, convex, maxMag, result);
+	for (GeodesicSearchBorderIterator it(*searchResult, level); (zone = it.next()) >= 0;)
+		findInZone(zone, convex, maxMag, result);
+}
+
+void StelPointCatalog::findInZone(int zone, const QVector<SphericalCap>& convex, float maxMag, QVector<int>& result) const
+{
+	int end = zoneStart.at(zone+1);
+	if (!entryMagnitudes.isEmpty())
+	{
+		// The entries of a zone are sorted by magnitude
+		end = std::upper_bound(entryMagnitudes.constBegin()+zoneStart.at(zone), entryMagnitudes.constBegin()+end, maxMag) - entryMagnitudes.constBegin();
+	}
+	for (int i=zoneStart.at(zone); i<end; ++i)
+	{
+		const Vec3d& p = entryPositions.at(i);
+		bool contained = true;
+		foreach (const SphericalCap& cap, convex)
+		{
+			if (p*cap.n<cap.d)
+			{
+				contained = false;
+				break;
+			}
+		}
+		if (contained)
+			result.append(entryIndex.at(i));
+	}
+}
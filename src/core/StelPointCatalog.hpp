@@ -0,0 +1,118 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _STELPOINTCATALOG_HPP_
+#define _STELPOINTCATALOG_HPP_
+
+#include "StelCore.hpp"
+#include "StelProjectorType.hpp"
+#include "StelTextureTypes.hpp"
+#include "VecMath.hpp"
+
+#include <QVector>
+
+class SphericalCap;
+class StelGeodesicGrid;
+class StelPainter;
+
+//! @class StelPointCatalog
+//! Index of the positions of a catalogue of point objects, such as the quasars or the novae of the plugins.
+//! The modules keep their objects in their own list, and give the index of an object in that list to
+//! setPositions(). The positions are copied in contiguous arrays sorted by the zones of one level of
+//! the geodesic grid of StelCore, like the stars of StarMgr, so that the objects in the viewport
+//! (findVisible()) or around a direction (findAround()) are found by searching the grid, without a scan
+//! of the whole catalogue. The level is chosen so that there are a few objects per zone.
+//! When the magnitudes of the objects do not change, they can be given too: the objects of a zone are
+//! then sorted by magnitude, and the faint ones are skipped without being tested.
+//! The functions taking a StelCore use its geodesic grid, the others take the grid explicitly.
+class StelPointCatalog
+{
+public:
+	//! Markers of one texture drawn in a single call, instead of one call per object.
+	class MarkerBatch
+	{
+	public:
+		MarkerBatch(StelPainter* painter);
+		//! Add a marker of radius pixels on the projection of the J2000 position pos, if it is visible.
+		void add(const Vec3d& pos, float radius, const Vec3f& color);
+		//! Draw the markers with tex and additive blending, then empty the batch.
+		void draw(const StelTextureSP& tex);
+		bool isEmpty() const {return vertices.isEmpty();}
+	private:
+		StelPainter* painter;
+		float scale;	// device pixels per pixel times the global scaling ratio
+		QVector<Vec3f> vertices;
+		QVector<Vec2f> texCoords;
+		QVector<Vec3f> colors;
+	};
+
+	StelPointCatalog();
+
+	//! Index the positions of the objects of a catalogue.
+	//! @param positions the J2000 equatorial positions, the index of an object is its index in this vector.
+	//! @param magnitudes the magnitudes of the objects if they do not change, or an empty vector.
+	void setPositions(const StelCore* core, const QVector<Vec3d>& positions, const QVector<float>& magnitudes=QVector<float>())
+	{
+		setPositions(core->getGeodesicGrid(getLevelFor(positions.size())), positions, magnitudes);
+	}
+	//! Index the positions of the objects of a catalogue on a grid of at least getLevelFor(positions.size()) levels.
+	void setPositions(const StelGeodesicGrid* grid, const QVector<Vec3d>& positions, const QVector<float>& magnitudes=QVector<float>());
+	void clear();
+
+	//! The level of the geodesic grid of the index of n objects.
+	static int getLevelFor(int n);
+
+	int size() const {return positions.size();}
+	const Vec3d& getPosition(int i) const {return positions.at(i);}
+	//! The level of the geodesic grid of the index.
+	int getLevel() const {return level;}
+
+	//! Find the objects within limitFov degrees of a direction.
+	//! @return the indices of the objects, in increasing order.
+	QVector<int> findAround(const StelCore* core, const Vec3d& v, double limitFov) const
+	{
+		return findAround(core->getGeodesicGrid(level), v, limitFov);
+	}
+	QVector<int> findAround(const StelGeodesicGrid* grid, const Vec3d& v, double limitFov) const;
+
+	//! Find the objects in the viewport of a J2000 projector, above the landscape if it hides the ground.
+	//! @param maxMag the objects fainter than this are skipped, if their magnitudes were set.
+	//! @return the indices of the objects, in increasing order so that they are drawn in catalogue order.
+	QVector<int> findVisible(const StelCore* core, const StelProjectorP& prj, float maxMag=99.f) const
+	{
+		return findVisible(core->getGeodesicGrid(level), prj, core->getVisibleSkyArea(), maxMag);
+	}
+	//! @param visibleSkyArea the part of the sky above the landscape, see StelCore::getVisibleSkyArea().
+	QVector<int> findVisible(const StelGeodesicGrid* grid, const StelProjectorP& prj, const SphericalCap& visibleSkyArea, float maxMag=99.f) const;
+
+private:
+	//! Append the objects of the zones found for convex to result.
+	void find(const StelGeodesicGrid* grid, const QVector<SphericalCap>& convex, float maxMag, QVector<int>& result) const;
+	//! Append the objects of a zone inside convex.
+	void findInZone(int zone, const QVector<SphericalCap>& convex, float maxMag, QVector<int>& result) const;
+
+	int level;
+	QVector<Vec3d> positions;		// in catalogue order
+	QVector<int> zoneStart;			// first entry of each zone, and the number of entries at the end
+	QVector<int> entryIndex;		// index of the object of each entry, sorted by zone then magnitude
+	QVector<Vec3d> entryPositions;
+	QVector<float> entryMagnitudes;		// empty if the magnitudes were not set
+};
+
+#endif // _STELPOINTCATALOG_HPP_
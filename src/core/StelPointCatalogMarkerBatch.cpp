@@ -0,0 +1,60 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include "StelPointCatalog.hpp"
+#include "StelApp.hpp"
+#include "StelPainter.hpp"
+#include "StelProjector.hpp"
+#include "StelTexture.hpp"
+
+StelPointCatalog::MarkerBatch::MarkerBatch(StelPainter* apainter) : painter(apainter)
+{
+	// Same scale as StelPainter::drawSprite2dMode()
+	scale = painter->getProjector()->getDevicePixelsPerPixel()*StelApp::getInstance().getGlobalScalingRatio();
+}
+
+void StelPointCatalog::MarkerBatch::add(const Vec3d& pos, float radius, const Vec3f& color)
+{
+	Vec3d win;
+	if (!painter->getProjector()->project(pos, win))
+		return;
+	const float x = win[0], y = win[1], r = radius*scale;
+	vertices << Vec3f(x-r, y-r, 0.f) << Vec3f(x+r, y-r, 0.f) << Vec3f(x+r, y+r, 0.f)
+		 << Vec3f(x-r, y-r, 0.f) << Vec3f(x+r, y+r, 0.f) << Vec3f(x-r, y+r, 0.f);
+	texCoords << Vec2f(0.f, 0.f) << Vec2f(1.f, 0.f) << Vec2f(1.f, 1.f)
+		  << Vec2f(0.f, 0.f) << Vec2f(1.f, 1.f) << Vec2f(0.f, 1.f);
+	for (int i=0; i<6; ++i)
+		colors << color;
+}
+
+void StelPointCatalog::MarkerBatch::draw(const StelTextureSP& tex)
+{
+	if (vertices.isEmpty())
+		return;
+	tex->bind();
+	painter->enableTexture2d(true);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_ONE, GL_ONE);
+	painter->setArrays(vertices.constData(), texCoords.constData(), colors.constData());
+	painter->drawFromArray(StelPainter::Triangles, vertices.size(), 0, false);
+	painter->enableClientStates(false);
+	vertices.clear();
+	texCoords.clear();
+	colors.clear();
+}
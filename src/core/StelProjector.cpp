@@ -25,6 +25,23 @@
 
 #include <QDebug>
 #include <QString>
+#include <limits>
+
+// Number of vectors projected together by the array versions of project() and projectCheck().
+// The intermediate results of a block stay in the L1 cache.
+static const int projectBlockSize = 256;
+
+void StelProjector::ModelViewTranform::forwardBatch(int n, const float* x, const float* y, const float* z, float* outX, float* outY, float* outZ) const
+{
+	for (int i=0; i<n; ++i)
+	{
+		Vec3f v(x[i], y[i], z[i]);
+		forward(v);
+		outX[i] = v[0];
+		outY[i] = v[1];
+		outZ[i] = v[2];
+	}
+}
 
 StelProjector::Mat4dTransform::Mat4dTransform(const Mat4d& m)
     : transfoMat(m),
@@ -67,6 +84,21 @@ void StelProjector::Mat4dTransform::backward(Vec3f& v) const
 	v[2] = transfoMatf.r[8]*x + transfoMatf.r[9]*y + transfoMatf.r[10]*z;
 }
 
+void StelProjector::Mat4dTransform::forwardBatch(int n, const float* x, const float* y, const float* z, float* outX, float* outY, float* outZ) const
+{
+	const float* m = transfoMatf.r;
+	for (int i=0; i<n; ++i)
+	{
+		// Same as Vec3f::transfo4d(). The output may be the input arrays.
+		const float vx = x[i];
+		const float vy = y[i];
+		const float vz = z[i];
+		outX[i] = m[0]*vx + m[4]*vy + m[8]*vz + m[12];
+		outY[i] = m[1]*vx + m[5]*vy + m[9]*vz + m[13];
+		outZ[i] = m[2]*vx + m[6]*vy + m[10]*vz + m[14];
+	}
+}
+
 void StelProjector::Mat4dTransform::combine(const Mat4d& m)
 {
 	Mat4f mf(m[0],  m[1] ,  m[2],  m[3],
@@ -322,15 +354,95 @@ void StelProjector::project(int n, const Vec3d* in, Vec3f* out)
 
 void StelProjector::project(int n, const Vec3f* in, Vec3f* out)
 {
-	for (int i = 0; i < n; ++i, ++out)
+	float x[projectBlockSize], y[projectBlockSize], z[projectBlockSize];
+	quint8 valid[projectBlockSize];
+	for (int begin=0; begin<n; begin+=projectBlockSize)
 	{
-		*out=in[i];
-		modelViewTransform->forward(*out);
-		forward(*out);
-		out->set(viewportCenter[0] + flipHorz * pixelPerRad * (*out)[0],
-			viewportCenter[1] + flipVert * pixelPerRad * (*out)[1],
-			((*out)[2] - zNear) * oneOverZNearMinusZFar);
+		const int count = qMin(projectBlockSize, n-begin);
+		for (int i=0; i<count; ++i)
+		{
+			x[i] = in[begin+i][0];
+			y[i] = in[begin+i][1];
+			z[i] = in[begin+i][2];
+		}
+		modelViewTransform->forwardBatch(count, x, y, z, x, y, z);
+		forwardBatch(count, x, y, z, valid);
+		for (int i=0; i<count; ++i)
+			out[begin+i].set(viewportCenter[0] + flipHorz * pixelPerRad * x[i],
+					 viewportCenter[1] + flipVert * pixelPerRad * y[i],
+					 (z[i] - zNear) * oneOverZNearMinusZFar);
+	}
+}
+
+int StelProjector::projectCheck(int n, const float* x, const float* y, const float* z, float* winX, float* winY, float* winZ, quint8* visible) const
+{
+	const float xMin = viewportXywh[0];
+	const float yMin = viewportXywh[1];
+	const float xMax = viewportXywh[0] + viewportXywh[2];
+	const float yMax = viewportXywh[1] + viewportXywh[3];
+	const float sx = flipHorz * pixelPerRad;
+	const float sy = flipVert * pixelPerRad;
+	int nbVisible = 0;
+	for (int begin=0; begin<n; begin+=projectBlockSize)
+	{
+		const int count = qMin(projectBlockSize, n-begin);
+		float* wx = winX + begin;
+		float* wy = winY + begin;
+		float* wz = winZ + begin;
+		quint8* vis = visible + begin;
+		modelViewTransform->forwardBatch(count, x+begin, y+begin, z+begin, wx, wy, wz);
+		forwardBatch(count, wx, wy, wz, vis);
+		// Same as projectInPlace() and checkInViewport()
+		for (int i=0; i<count; ++i)
+		{
+			wx[i] = viewportCenter[0] + sx * wx[i];
+			wy[i] = viewportCenter[1] + sy * wy[i];
+			wz[i] = (wz[i] - zNear) * oneOverZNearMinusZFar;
+			vis[i] = vis[i] && wy[i]>=yMin && wx[i]>=xMin && wy[i]<=yMax && wx[i]<=xMax;
+			nbVisible += vis[i];
+		}
+	}
+	return nbVisible;
+}
+
+void StelProjector::forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const
+{
+	for (int i=0; i<n; ++i)
+	{
+		Vec3f v(x[i], y[i], z[i]);
+		valid[i] = forward(v);
+		x[i] = v[0];
+		y[i] = v[1];
+		z[i] = v[2];
+	}
+}
+
+StelProjector::ShaderParameters StelProjector::getShaderParameters() const
+{
+	ShaderParameters params;
+	params.projection = modelViewTransform->isLinear() ? getShaderProjection() : ShaderProjectionNone;
+	params.modelView = modelViewTransform->getApproximateLinearTransfo();
+	// widthStretch is applied by forward()
+	params.viewport.set(viewportCenter[0], viewportCenter[1], flipHorz*pixelPerRad*widthStretch, flipVert*pixelPerRad);
+	params.depth.set(zNear, oneOverZNearMinusZFar);
+	return params;
+}
+
+bool StelProjector::shaderProject(const ShaderParameters& params, const Vec3d& v, Vec3f& win)
+{
+	const Vec3d mv = params.modelView*v;
+	const Vec3f p(mv[0], mv[1], mv[2]);
+	const float r = p.length();
+	if (params.projection==ShaderProjectionPerspective && p[2]>=0.f)
+	{
+		// Behind the viewer the shader emits a position outside of the clipping volume,
+		// as the CPU sets the depth of these points far beyond zFar
+		win.set(0.f, 0.f, std::numeric_limits<float>::max());
+		return false;
 	}
+	const float d = params.projection==ShaderProjectionPerspective ? -p[2] : r;
+	win.set(params.viewport[0] + params.viewport[2]*p[0]/d, params.viewport[1] + params.viewport[3]*p[1]/d, (r-params.depth[0])*params.depth[1]);
+	return true;
 }
 
 bool StelProjector::projectInPlace(Vec3d& vd) const
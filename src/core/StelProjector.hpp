@@ -39,6 +39,8 @@ class StelProjector
 public:
 	friend class StelPainter;
 	friend class StelCore;
+	friend class TestStelProjector;
+	friend class TestStelPointCatalog;
 
 	class ModelViewTranform;
 	//! @typedef ModelViewTranformP
@@ -57,10 +59,16 @@ public:
 		virtual void forward(Vec3f&) const =0;
 		virtual void backward(Vec3f&) const =0;
 
+		//! Apply forward() to n points given as structure of arrays. The output arrays may be the input arrays.
+		//! The default implementation calls forward() for each point.
+		virtual void forwardBatch(int n, const float* x, const float* y, const float* z, float* outX, float* outY, float* outZ) const;
+
 		virtual void combine(const Mat4d&)=0;
 		virtual ModelViewTranformP clone() const=0;
 
 		virtual Mat4d getApproximateLinearTransfo() const=0;
+		//! Whether the transformation is exactly getApproximateLinearTransfo(), so that it can be applied by a shader.
+		virtual bool isLinear() const {return false;}
 	};
 
 	class Mat4dTransform: public ModelViewTranform
@@ -71,8 +79,10 @@ public:
         void backward(Vec3d& v) const;
         void forward(Vec3f& v) const;
         void backward(Vec3f& v) const;
+        void forwardBatch(int n, const float* x, const float* y, const float* z, float* outX, float* outY, float* outZ) const;
         void combine(const Mat4d& m);
         Mat4d getApproximateLinearTransfo() const;
+        bool isLinear() const {return true;}
         ModelViewTranformP clone() const;
 
 	private:
@@ -122,6 +132,17 @@ public:
 		bool flipHorz, flipVert;         //! Whether to flip in horizontal or vertical directions
 		float devicePixelsPerPixel;      //! The number of device pixel per "Device Independent Pixels" (value is usually 1, but 2 for mac retina screens)
 		float widthStretch;              //! A factor to adapt to special installation setups, e.g. multi-projector with edge blending. Allow to stretch/squeeze projected content. Larger than 1 means the image is stretched wider.
+
+		bool operator==(const StelProjectorParams& other) const
+		{
+			return viewportXywh==other.viewportXywh && fov==other.fov && gravityLabels==other.gravityLabels
+				&& defaultAngleForGravityText==other.defaultAngleForGravityText && maskType==other.maskType
+				&& zNear==other.zNear && zFar==other.zFar && viewportCenter==other.viewportCenter
+				&& viewportCenterOffset==other.viewportCenterOffset && viewportFovDiameter==other.viewportFovDiameter
+				&& flipHorz==other.flipHorz && flipVert==other.flipVert
+				&& devicePixelsPerPixel==other.devicePixelsPerPixel && widthStretch==other.widthStretch;
+		}
+		bool operator!=(const StelProjectorParams& other) const {return !(*this==other);}
 	};
 
 	//! Destructor
@@ -233,6 +254,15 @@ public:
 
 	virtual void project(int n, const Vec3f* in, Vec3f* out);
 
+	//! Project n direction vectors from the current frame into the viewport, like projectCheck() for each vector.
+	//! The vectors are given as structure of arrays and are processed in blocks: the model view transformation and
+	//! the projection are each applied to a whole block, with loops the compiler can vectorise, instead of two
+	//! virtual calls per vector.
+	//! @param winX, winY, winZ receive the projected vectors, as computed by projectInPlace().
+	//! @param visible receives 1 where projectCheck() would return true, 0 elsewhere.
+	//! @return the number of visible vectors.
+	int projectCheck(int n, const float* x, const float* y, const float* z, float* winX, float* winY, float* winZ, quint8* visible) const;
+
 	//! Project the vector v from the current frame into the viewport.
 	//! @param vd the vector in the current frame.
 	//! @return true if the projected coordinate is valid.
@@ -276,6 +306,29 @@ public:
 	//! Get the current projection matrix.
 	Mat4f getProjectionMatrix() const;
 
+	//! Projections which StelPainter can evaluate in a vertex shader.
+	enum ShaderProjection
+	{
+		ShaderProjectionNone,		//!< Only projected on the CPU
+		ShaderProjectionPerspective,	//!< x/|z|, y/|z|
+		ShaderProjectionOrthographic	//!< x/r, y/r
+	};
+	//! The uniforms of the retained geometry shader of StelPainter.
+	struct ShaderParameters
+	{
+		ShaderProjection projection;	//!< ShaderProjectionNone if the shader does not apply
+		Mat4d modelView;		//!< the linear model view transformation
+		Vec4f viewport;			//!< viewport center, then the pixels per unit of x and y
+		Vec2f depth;			//!< zNear and 1/(zNear-zFar)
+	};
+	//! Get the parameters of the retained geometry shader. The shader only applies to the perspective and
+	//! orthographic projections with a linear model view transformation, i.e. without refraction.
+	ShaderParameters getShaderParameters() const;
+	//! Project v as the retained geometry shader does, into the viewport as projectInPlace().
+	//! The same computations as the GLSL code of StelPainter, to compare them with project().
+	//! @return false if the shader clips the point, i.e. behind the viewer in the perspective projection.
+	static bool shaderProject(const ShaderParameters& params, const Vec3d& v, Vec3f& win);
+
 	///////////////////////////////////////////////////////////////////////////
 	//! Get a string description of a StelProjectorMaskType.
 	static const QString maskTypeToString(StelProjectorMaskType type);
@@ -314,6 +367,13 @@ protected:
 	//! Initialize the bounding cap.
 	virtual void computeBoundingCap();
 
+	//! The forward() function of the projection as evaluated by the retained geometry shader of StelPainter.
+	virtual ShaderProjection getShaderProjection() const {return ShaderProjectionNone;}
+
+	//! Apply forward() to n points given as structure of arrays, in place. valid receives the results of forward().
+	//! The projections override this with a loop over their forward() kernel.
+	virtual void forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const;
+
 	ModelViewTranformP modelViewTransform;	// Operator to apply (if not NULL) before the modelview projection step
 
 	float flipHorz,flipVert;            // Whether to flip in horizontal or vertical directions
@@ -22,6 +22,23 @@
 
 #include <limits>
 
+// Apply the forward kernel of a projection to arrays of coordinates.
+// Each projection has its kernel as a static inline function, used by both forward() and
+// forwardBatch() so that they give the same results. The kernel is a template argument here,
+// so it is inlined into the loop.
+template<bool (*kernel)(float*, float)>
+static void forwardArrays(int n, float* x, float* y, float* z, quint8* valid, const float widthStretch)
+{
+	for (int i=0; i<n; ++i)
+	{
+		float v[3] = {x[i], y[i], z[i]};
+		valid[i] = kernel(v, widthStretch);
+		x[i] = v[0];
+		y[i] = v[1];
+		z[i] = v[2];
+	}
+}
+
 QString StelProjectorPerspective::getNameI18() const
 {
 	return q_("Perspective");
@@ -32,7 +49,7 @@ QString StelProjectorPerspective::getDescriptionI18() const
 	return q_("Perspective projection maps the horizon and other great circles like equator, ecliptic, hour lines, etc. into straight lines. The mathematical name for this projection method is <i>gnomonic projection</i>.");
 }
 
-bool StelProjectorPerspective::forward(Vec3f &v) const
+static inline bool perspectiveForward(float* v, const float widthStretch)
 {
 	const float r = std::sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
 	if (v[2] < 0) {
@@ -53,6 +70,16 @@ bool StelProjectorPerspective::forward(Vec3f &v) const
 	return false;
 }
 
+bool StelProjectorPerspective::forward(Vec3f &v) const
+{
+	return perspectiveForward(v, widthStretch);
+}
+
+void StelProjectorPerspective::forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const
+{
+	forwardArrays<perspectiveForward>(n, x, y, z, valid, widthStretch);
+}
+
 bool StelProjectorPerspective::backward(Vec3d &v) const
 {
 	v[0] /= widthStretch;
@@ -92,7 +119,7 @@ QString StelProjectorEqualArea::getDescriptionI18() const
 	return q_("The full name of this projection method is <i>Lambert azimuthal equal-area projection</i>. It preserves the area but not the angle.");
 }
 
-bool StelProjectorEqualArea::forward(Vec3f &v) const
+static inline bool equalAreaForward(float* v, const float widthStretch)
 {
 	const float r = std::sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
 	const float f = std::sqrt(2.f/(r*(r-v[2])));
@@ -102,6 +129,16 @@ bool StelProjectorEqualArea::forward(Vec3f &v) const
 	return true;
 }
 
+bool StelProjectorEqualArea::forward(Vec3f &v) const
+{
+	return equalAreaForward(v, widthStretch);
+}
+
+void StelProjectorEqualArea::forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const
+{
+	forwardArrays<equalAreaForward>(n, x, y, z, valid, widthStretch);
+}
+
 bool StelProjectorEqualArea::backward(Vec3d &v) const
 {
 	v[0] /= widthStretch;
@@ -150,7 +187,7 @@ QString StelProjectorStereographic::getDescriptionI18() const
 	return q_("Stereographic projection is known since antiquity and was originally known as the planisphere projection. It preserves the angles at which curves cross each other but it does not preserve area.");
 }
 
-bool StelProjectorStereographic::forward(Vec3f &v) const
+static inline bool stereographicForward(float* v, const float widthStretch)
 {
 	const float r = std::sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
 	const float h = 0.5f*(r-v[2]);
@@ -167,6 +204,16 @@ bool StelProjectorStereographic::forward(Vec3f &v) const
 	return true;
 }
 
+bool StelProjectorStereographic::forward(Vec3f &v) const
+{
+	return stereographicForward(v, widthStretch);
+}
+
+void StelProjectorStereographic::forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const
+{
+	forwardArrays<stereographicForward>(n, x, y, z, valid, widthStretch);
+}
+
 bool StelProjectorStereographic::backward(Vec3d &v) const
 {
 	v[0] /= widthStretch;
@@ -205,7 +252,7 @@ QString StelProjectorFisheye::getDescriptionI18() const
 	return q_("In fish-eye projection, or <i>azimuthal equidistant projection</i>, straight lines become curves when they appear a large angular distance from the centre of the field of view (like the distortions seen with very wide angle camera lenses).");
 }
 
-bool StelProjectorFisheye::forward(Vec3f &v) const
+static inline bool fisheyeForward(float* v, const float widthStretch)
 {
 	const float rq1 = v[0]*v[0] + v[1]*v[1];
 	if (rq1 > 0.f) {
@@ -228,6 +275,16 @@ bool StelProjectorFisheye::forward(Vec3f &v) const
 	return false;
 }
 
+bool StelProjectorFisheye::forward(Vec3f &v) const
+{
+	return fisheyeForward(v, widthStretch);
+}
+
+void StelProjectorFisheye::forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const
+{
+	forwardArrays<fisheyeForward>(n, x, y, z, valid, widthStretch);
+}
+
 bool StelProjectorFisheye::backward(Vec3d &v) const
 {
 	v[0] /= widthStretch;
@@ -266,7 +323,7 @@ QString StelProjectorHammer::getDescriptionI18() const
 	return q_("The Hammer projection is an equal-area map projection, described by Ernst Hammer in 1892 and directly inspired by the Aitoff projection.");
 }
 
-bool StelProjectorHammer::forward(Vec3f &v) const
+static inline bool hammerForward(float* v, const float widthStretch)
 {
 	// Hammer Aitoff
 	const float r = std::sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
@@ -279,6 +336,16 @@ bool StelProjectorHammer::forward(Vec3f &v) const
 	return true;
 }
 
+bool StelProjectorHammer::forward(Vec3f &v) const
+{
+	return hammerForward(v, widthStretch);
+}
+
+void StelProjectorHammer::forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const
+{
+	forwardArrays<hammerForward>(n, x, y, z, valid, widthStretch);
+}
+
 bool StelProjectorHammer::backward(Vec3d &v) const
 {
 	v[0] /= widthStretch;
@@ -321,7 +388,7 @@ QString StelProjectorCylinder::getDescriptionI18() const
 	return q_("The full name of this projection mode is <i>cylindrical equidistant projection</i>. With this projection all parallels are equally spaced.");
 }
 
-bool StelProjectorCylinder::forward(Vec3f &v) const
+static inline bool cylinderForward(float* v, const float widthStretch)
 {
 	const float r = std::sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
 	const bool rval = (-r < v[1] && v[1] < r);
@@ -333,6 +400,16 @@ bool StelProjectorCylinder::forward(Vec3f &v) const
 	return rval;
 }
 
+bool StelProjectorCylinder::forward(Vec3f &v) const
+{
+	return cylinderForward(v, widthStretch);
+}
+
+void StelProjectorCylinder::forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const
+{
+	forwardArrays<cylinderForward>(n, x, y, z, valid, widthStretch);
+}
+
 bool StelProjectorCylinder::backward(Vec3d &v) const
 {
 	v[0] /= widthStretch;
@@ -370,7 +447,7 @@ QString StelProjectorMercator::getDescriptionI18() const
 	return q_("The Mercator projection is one of the most used world map projections. It preserves direction and shapes but distorts size, in an increasing degree away from the equator.");
 }
 
-bool StelProjectorMercator::forward(Vec3f &v) const
+static inline bool mercatorForward(float* v, const float widthStretch)
 {
 	const float r = std::sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
 	const bool rval = (-r < v[1] && v[1] < r);
@@ -381,6 +458,16 @@ bool StelProjectorMercator::forward(Vec3f &v) const
 	return rval;
 }
 
+bool StelProjectorMercator::forward(Vec3f &v) const
+{
+	return mercatorForward(v, widthStretch);
+}
+
+void StelProjectorMercator::forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const
+{
+	forwardArrays<mercatorForward>(n, x, y, z, valid, widthStretch);
+}
+
 
 bool StelProjectorMercator::backward(Vec3d &v) const
 {
@@ -423,7 +510,7 @@ QString StelProjectorOrthographic::getDescriptionI18() const
 	return q_("Orthographic projection is related to perspective projection, but the point of perspective is set to an infinite distance.");
 }
 
-bool StelProjectorOrthographic::forward(Vec3f &v) const
+static inline bool orthographicForward(float* v, const float widthStretch)
 {
 	const float r = std::sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
 	const float h = 1.f/r;
@@ -434,6 +521,16 @@ bool StelProjectorOrthographic::forward(Vec3f &v) const
 	return rval;
 }
 
+bool StelProjectorOrthographic::forward(Vec3f &v) const
+{
+	return orthographicForward(v, widthStretch);
+}
+
+void StelProjectorOrthographic::forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const
+{
+	forwardArrays<orthographicForward>(n, x, y, z, valid, widthStretch);
+}
+
 bool StelProjectorOrthographic::backward(Vec3d &v) const
 {
 	v[0] /= widthStretch;
@@ -475,7 +572,7 @@ QString StelProjectorSinusoidal::getDescriptionI18() const
 	return q_("The sinusoidal projection is a <i>pseudocylindrical equal-area map projection</i>, sometimes called the Sanson–Flamsteed or the Mercator equal-area projection.");
 }
 
-bool StelProjectorSinusoidal::forward(Vec3f &v) const
+static inline bool sinusoidalForward(float* v, const float widthStretch)
 {
 	const float r = std::sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
 	const bool rval = (-r < v[1] && v[1] < r);
@@ -487,6 +584,16 @@ bool StelProjectorSinusoidal::forward(Vec3f &v) const
 	return rval;
 }
 
+bool StelProjectorSinusoidal::forward(Vec3f &v) const
+{
+	return sinusoidalForward(v, widthStretch);
+}
+
+void StelProjectorSinusoidal::forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const
+{
+	forwardArrays<sinusoidalForward>(n, x, y, z, valid, widthStretch);
+}
+
 bool StelProjectorSinusoidal::backward(Vec3d &v) const
 {
 	v[0] /= widthStretch;
@@ -517,7 +624,7 @@ QString StelProjectorMiller::getDescriptionI18() const
 	return q_("The Miller cylindrical projection is a modified Mercator projection, proposed by Osborn Maitland Miller (1897–1979) in 1942. The poles are no longer mapped to infinity.");
 }
 
-bool StelProjectorMiller::forward(Vec3f &v) const
+static inline bool millerForward(float* v, const float widthStretch)
 {
 	const float r = std::sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
 	const bool rval = (-r < v[1] && v[1] < r);
@@ -529,6 +636,16 @@ bool StelProjectorMiller::forward(Vec3f &v) const
 	return rval;
 }
 
+bool StelProjectorMiller::forward(Vec3f &v) const
+{
+	return millerForward(v, widthStretch);
+}
+
+void StelProjectorMiller::forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const
+{
+	forwardArrays<millerForward>(n, x, y, z, valid, widthStretch);
+}
+
 bool StelProjectorMiller::backward(Vec3d &v) const
 {
 	v[0] /= widthStretch;
@@ -35,6 +35,8 @@ public:
 	float viewScalingFactorToFov(float vsf) const;
 	float deltaZoom(float fov) const;
 protected:
+	virtual ShaderProjection getShaderProjection() const {return ShaderProjectionPerspective;}
+	virtual void forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const;
 	virtual bool hasDiscontinuity() const {return false;}
 	virtual bool intersectViewportDiscontinuityInternal(const Vec3d&, const Vec3d&) const {return false;}
 	virtual bool intersectViewportDiscontinuityInternal(const Vec3d&, double) const {return false;}
@@ -53,6 +55,7 @@ public:
 	float viewScalingFactorToFov(float vsf) const;
 	float deltaZoom(float fov) const;
 protected:
+	virtual void forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const;
 	virtual bool hasDiscontinuity() const {return false;}
 	virtual bool intersectViewportDiscontinuityInternal(const Vec3d&, const Vec3d&) const {return false;}
 	virtual bool intersectViewportDiscontinuityInternal(const Vec3d&, double) const {return false;}
@@ -86,6 +89,7 @@ public:
 	float viewScalingFactorToFov(float vsf) const;
 	float deltaZoom(float fov) const;
 protected:
+	virtual void forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const;
 	virtual bool hasDiscontinuity() const {return false;}
 	virtual bool intersectViewportDiscontinuityInternal(const Vec3d&, const Vec3d&) const {return false;}
 	virtual bool intersectViewportDiscontinuityInternal(const Vec3d&, double) const {return false;}
@@ -104,6 +108,7 @@ public:
 	float viewScalingFactorToFov(float vsf) const;
 	float deltaZoom(float fov) const;
 protected:
+	virtual void forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const;
 	virtual bool hasDiscontinuity() const {return false;}
 	virtual bool intersectViewportDiscontinuityInternal(const Vec3d&, const Vec3d&) const {return false;}
 	virtual bool intersectViewportDiscontinuityInternal(const Vec3d&, double) const {return false;}
@@ -136,6 +141,7 @@ public:
 	float viewScalingFactorToFov(float vsf) const;
 	float deltaZoom(float fov) const;
 protected:
+	virtual void forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const;
 	virtual bool hasDiscontinuity() const {return true;}
 	virtual bool intersectViewportDiscontinuityInternal(const Vec3d& p1, const Vec3d& p2) const {return p1[0]*p2[0]<0 && !(p1[2]<0 && p2[2]<0);}
 	virtual bool intersectViewportDiscontinuityInternal(const Vec3d& capN, double capD) const
@@ -161,6 +167,7 @@ public:
 	float viewScalingFactorToFov(float vsf) const;
 	float deltaZoom(float fov) const;
 protected:
+	virtual void forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const;
 	virtual bool hasDiscontinuity() const {return true;}
 	virtual bool intersectViewportDiscontinuityInternal(const Vec3d& p1, const Vec3d& p2) const
 	{
@@ -189,6 +196,7 @@ public:
 	float viewScalingFactorToFov(float vsf) const;
 	float deltaZoom(float fov) const;
 protected:
+	virtual void forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const;
 	virtual bool hasDiscontinuity() const {return true;}
 	virtual bool intersectViewportDiscontinuityInternal(const Vec3d& p1, const Vec3d& p2) const
 	{
@@ -217,6 +225,8 @@ public:
 	float viewScalingFactorToFov(float vsf) const;
 	float deltaZoom(float fov) const;
 protected:
+	virtual ShaderProjection getShaderProjection() const {return ShaderProjectionOrthographic;}
+	virtual void forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const;
 	virtual bool hasDiscontinuity() const {return false;}
 	virtual bool intersectViewportDiscontinuityInternal(const Vec3d&, const Vec3d&) const {return false;}
 	virtual bool intersectViewportDiscontinuityInternal(const Vec3d&, double) const {return false;}
@@ -230,6 +240,8 @@ public:
 	virtual QString getDescriptionI18() const;
 	bool forward(Vec3f &win) const;
 	bool backward(Vec3d &v) const;
+protected:
+	virtual void forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const;
 };
 
 class StelProjectorMiller : public StelProjectorMercator
@@ -241,6 +253,8 @@ public:
 	virtual float getMaxFov() const {return 175.f * 4.f/3.f;} // or 180?
 	bool forward(Vec3f &win) const;
 	bool backward(Vec3d &v) const;
+protected:
+	virtual void forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const;
 };
 
 class StelProjector2d : public StelProjector
@@ -430,6 +430,12 @@ bool StelSkyDrawer::drawPointSource(StelPainter* sPainter, const Vec3f& v, const
 	if (!(checkInScreen ? sPainter->getProjector()->projectCheck(v, win) : sPainter->getProjector()->project(v, win)))
 		return false;
 
+	drawProjectedPointSource(sPainter, win, rcMag, color, twinkleFactor);
+	return true;
+}
+
+void StelSkyDrawer::drawProjectedPointSource(StelPainter* sPainter, const Vec3f& win, const RCMag& rcMag, const Vec3f& color, float twinkleFactor)
+{
 	const float radius = rcMag.radius;
 	// Random coef for star twinkling. twinkleFactor can introduce height-dependent twinkling.
 	const float tw = (flagStarTwinkle && (flagHasAtmosphere || flagForcedTwinkle)) ? (1.f-twinkleFactor*twinkleAmount*qrand()/RAND_MAX)*rcMag.luminance : rcMag.luminance;
@@ -470,7 +476,6 @@ bool StelSkyDrawer::drawPointSource(StelPainter* sPainter, const Vec3f& v, const
 		// Flush the buffer (draw all buffered stars)
 		postDrawPointSource(sPainter);
 	}
-	return true;
 }
 
 // Draw's the Sun's corona during a solar eclipse on Earth.
@@ -104,6 +104,12 @@ public:
 
 	bool drawPointSource(StelPainter* sPainter, const Vec3f& v, const RCMag &rcMag, const Vec3f& bcolor, bool checkInScreen=false, float twinkleFactor=1.0f);
 
+	//! Draw a point source halo at a position already projected in window coordinates.
+	//! Used to draw the stars culled and projected beforehand by StarMgr. The radius of rcMag must be positive.
+	//! @param win the window coordinates of the source
+	//! @param color the source color, as given by indexToColor()
+	void drawProjectedPointSource(StelPainter* sPainter, const Vec3f& win, const RCMag &rcMag, const Vec3f& color, float twinkleFactor=1.0f);
+
 	void drawSunCorona(StelPainter* painter, const Vec3f& v, float radius, const Vec3f& color, const float alpha);
 
 	//! Terminate drawing of a 3D model, draw the halo
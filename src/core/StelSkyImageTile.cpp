@@ -27,10 +27,19 @@
 #include "StelCore.hpp"
 #include "StelSkyDrawer.hpp"
 #include "StelPainter.hpp"
+#include "StelMovementMgr.hpp"
 
 #include <QDebug>
 
 #include <stdio.h>
+#include <cmath>
+
+// How far ahead the view is predicted for prefetching, in seconds
+static const double prefetchDelay = 0.5;
+// The view is predicted when it moves by more than this fraction of the field of view during prefetchDelay
+static const double prefetchMinMove = 0.1;
+// The tiles which are not visible yet are loaded after the visible ones of the same level
+static const double prefetchPriorityFactor = 0.25;
 
 StelSkyImageTile::StelSkyImageTile()
 {
@@ -44,6 +53,7 @@ void StelSkyImageTile::initCtor()
 	alphaBlend = false;
 	noTexture = false;
 	texFader = NULL;
+	skyArea = 0.;
 }
 
 // Constructor
@@ -80,8 +90,21 @@ void StelSkyImageTile::draw(StelCore* core, StelPainter& sPainter, float)
 	const StelProjectorP prj = core->getProjection(StelCore::FrameJ2000);
 
 	const float limitLuminance = core->getSkyDrawer()->getLimitLuminance();
+	const SphericalRegionP viewPortPoly = prj->getViewportConvexPolygon(0, 0);
+
+	// Load the tiles where the view is moving before they become visible
+	const StelMovementMgr* mvmgr = core->getMovementMgr();
+	const Vec3d velocity = mvmgr->getViewVelocityJ2000();
+	SphericalRegionP prefetchPoly;
+	if (velocity.length()*prefetchDelay > prefetchMinMove*mvmgr->getCurrentFov()*M_PI/180.)
+	{
+		Vec3d ahead = mvmgr->getViewDirectionJ2000() + velocity*prefetchDelay;
+		ahead.normalize();
+		prefetchPoly = SphericalRegionP(new SphericalCap(ahead, std::cos(qMin(M_PI, mvmgr->getCurrentFov()*M_PI/180.))));
+	}
+
 	QMultiMap<double, StelSkyImageTile*> result;
-	getTilesToDraw(result, core, prj->getViewportConvexPolygon(0, 0), limitLuminance, true);
+	getTilesToDraw(result, core, viewPortPoly, prefetchPoly, viewPortPoly->getArea(), limitLuminance, 1., true);
 
 	int numToBeLoaded=0;
 	foreach (StelSkyImageTile* t, result)
@@ -103,7 +126,8 @@ void StelSkyImageTile::draw(StelCore* core, StelPainter& sPainter, float)
 }
 
 // Return the list of tiles which should be drawn.
-void StelSkyImageTile::getTilesToDraw(QMultiMap<double, StelSkyImageTile*>& result, StelCore* core, const SphericalRegionP& viewPortPoly, float limitLuminance, bool recheckIntersect)
+void StelSkyImageTile::getTilesToDraw(QMultiMap<double, StelSkyImageTile*>& result, StelCore* core, const SphericalRegionP& viewPortPoly,
+				      const SphericalRegionP& prefetchPoly, double viewPortArea, float limitLuminance, double parentPriority, bool recheckIntersect)
 {
 
 #ifndef NDEBUG
@@ -130,6 +154,8 @@ void StelSkyImageTile::getTilesToDraw(QMultiMap<double, StelSkyImageTile*>& resu
 	if (downloading)
 	{
 		//qDebug() << "Downloading " << contructorUrl;
+		// The polygons are not known yet, those of the parent are the best guess
+		requestDownload(parentPriority);
 		return;
 	}
 
@@ -169,38 +195,67 @@ void StelSkyImageTile::getTilesToDraw(QMultiMap<double, StelSkyImageTile*>& resu
 		}
 	}
 	// The tile is outside screen
+	bool prefetch = false;
 	if (fullInScreen==false && intersectScreen==false)
 	{
-		// Schedule a deletion
-		scheduleChildsDeletion();
-		return;
+		foreach (const SphericalRegionP& poly, skyConvexPolygons)
+		{
+			if (!prefetchPoly.isNull() && prefetchPoly->intersects(poly))
+				prefetch = true;
+		}
+		if (!prefetch)
+		{
+			// Schedule a deletion
+			scheduleChildsDeletion();
+			return;
+		}
 	}
 
 	// The tile is in screen, and it is a precondition that its resolution is higher than the limit
 	// make sure that it's not going to be deleted
 	cancelDeletion();
 
+	const double degPerPixel = 1./core->getProjection(StelCore::FrameJ2000)->getPixelPerRadAtCenter()*180./M_PI;
+	double priority = getLoadingPriority(degPerPixel, viewPortArea, fullInScreen);
+	if (prefetch)
+		priority *= prefetchPriorityFactor;
+
 	if (noTexture==false)
 	{
+		StelTileLoader& loader = getTileLoader();
 		if (!tex)
 		{
-			// The tile has an associated texture, but it is not yet loaded: load it now
-			StelTextureMgr& texMgr=StelApp::getInstance().getTextureManager();
-			tex = texMgr.createTextureThread(absoluteImageURI, StelTexture::StelTextureParams(true));
-			if (!tex)
+			// The tile has an associated texture, but it is not yet loaded: load it when it gets a loading slot
+			if (loader.request(this, priority))
 			{
-				qWarning() << "WARNING : Can't create tile: " << absoluteImageURI;
-				errorOccured = true;
-				return;
+				StelTextureMgr& texMgr=StelApp::getInstance().getTextureManager();
+				tex = texMgr.createTextureThread(absoluteImageURI, StelTexture::StelTextureParams(true), false);
+				if (!tex)
+				{
+					qWarning() << "WARNING : Can't create tile: " << absoluteImageURI;
+					loader.release(this);
+					errorOccured = true;
+					return;
+				}
 			}
 		}
+		else if (loader.hasSlot(this))
+		{
+			// The loading progresses when the texture is bound, and the prefetched tiles are not drawn
+			if (!tex->canBind())
+				tex->bind();
+			if (tex->canBind() || !tex->getErrorMessage().isEmpty())
+				loader.release(this);
+			else
+				loader.request(this, priority);
+		}
 
 		// The tile is in screen and has a texture: every test passed :) The tile will be displayed
-		result.insert(minResolution, this);
+		if (tex && !prefetch)
+			result.insert(minResolution, this);
 	}
 
 	// Check if we reach the resolution limit
-	const double degPerPixel = 1./core->getProjection(StelCore::FrameJ2000)->getPixelPerRadAtCenter()*180./M_PI;
 	if (degPerPixel < minResolution)
 	{
 		if (subTiles.isEmpty() && !subTilesUrls.isEmpty())
@@ -222,7 +277,7 @@ void StelSkyImageTile::getTilesToDraw(QMultiMap<double, StelSkyImageTile*>& resu
 		// Try to add the subtiles
 		foreach (MultiLevelJsonBase* tile, subTiles)
 		{
-			qobject_cast<StelSkyImageTile*>(tile)->getTilesToDraw(result, core, viewPortPoly, limitLuminance, !fullInScreen);
+			qobject_cast<StelSkyImageTile*>(tile)->getTilesToDraw(result, core, viewPortPoly, prefetchPoly, viewPortArea, limitLuminance, priority, !fullInScreen);
 		}
 	}
 	else
@@ -232,6 +287,28 @@ void StelSkyImageTile::getTilesToDraw(QMultiMap<double, StelSkyImageTile*>& resu
 	}
 }
 
+// The tiles much coarser than the screen resolution fill the holes of the screen: they are loaded first,
+// then the tiles covering the largest part of the screen.
+double StelSkyImageTile::getLoadingPriority(double degPerPixel, double viewPortArea, bool fullInScreen) const
+{
+	double need = 1.;
+	if (minResolution>0 && degPerPixel>0)
+		need += qMax(0., std::log(minResolution/degPerPixel)/std::log(2.));
+	double coverage = (viewPortArea>0 && !skyConvexPolygons.isEmpty()) ? qMin(1., skyArea/viewPortArea) : 1.;
+	// About half of a tile on the edge of the screen is visible
+	if (!fullInScreen)
+		coverage *= 0.5;
+	return need*(0.1+coverage);
+}
+
+void StelSkyImageTile::cancelLoading()
+{
+	// A texture which is still loading is abandoned, the loaded ones are kept until the tile is deleted
+	if (tex && !tex->canBind())
+		tex.clear();
+	MultiLevelJsonBase::cancelLoading();
+}
+
 // Draw the image on the screen.
 // Assume GL_TEXTURE_2D is enabled
 bool StelSkyImageTile::drawTile(StelCore* core, StelPainter& sPainter)
@@ -433,11 +510,18 @@ void StelSkyImageTile::loadFromQVariantMap(const QVariantMap& map)
 			skyConvexPolygons.append(SphericalRegionP(pol));
 		}
 	}
+	skyArea = 0.;
+	foreach (const SphericalRegionP& poly, skyConvexPolygons)
+		skyArea += poly->getArea();
 
 	if (map.contains("imageUrl"))
 	{
 		QString imageUrl = map.value("imageUrl").toString();
-		if (baseUrl.startsWith("http://"))
+		if (baseUrl.startsWith("file://"))
+		{
+			absoluteImageURI = QUrl(baseUrl+imageUrl).toLocalFile();
+		}
+		else if (isRemoteUrl(baseUrl))
 		{
 			absoluteImageURI = baseUrl+imageUrl;
 		}
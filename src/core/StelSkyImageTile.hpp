@@ -106,6 +106,9 @@ protected:
 	//! Load the tile from a valid QVariantMap.
 	virtual void loadFromQVariantMap(const QVariantMap& map);
 
+	//! Abandon the texture if it is still loading.
+	virtual void cancelLoading();
+
 	//! The credits of the server where this data come from
 	ServerCredits serverCredits;
 
@@ -127,6 +130,9 @@ protected:
 	//! list of all the polygons.
 	QList<SphericalRegionP> skyConvexPolygons;
 
+	//! The area of the polygons in steradian
+	double skyArea;
+
 	//! The texture of the tile
 	StelTextureSP tex;
 
@@ -137,9 +143,16 @@ private:
 	//! init the StelSkyImageTile
 	void initCtor();
 
-	//! Return the list of tiles which should be drawn.
+	//! Return the list of tiles which should be drawn, and request the loading of the tiles which are needed.
 	//! @param result a map containing resolution, pointer to the tiles
-	void getTilesToDraw(QMultiMap<double, StelSkyImageTile*>& result, StelCore* core, const SphericalRegionP& viewPortPoly, float limitLuminance, bool recheckIntersect=true);
+	//! @param prefetchPoly the region expected to be visible soon, its tiles are loaded but not drawn. May be null.
+	//! @param viewPortArea the area of viewPortPoly in steradian.
+	//! @param parentPriority the loading priority of the parent tile.
+	void getTilesToDraw(QMultiMap<double, StelSkyImageTile*>& result, StelCore* core, const SphericalRegionP& viewPortPoly,
+			    const SphericalRegionP& prefetchPoly, double viewPortArea, float limitLuminance, double parentPriority, bool recheckIntersect=true);
+
+	//! Return the priority of the loading of this tile, see StelTileLoader.
+	double getLoadingPriority(double degPerPixel, double viewPortArea, bool fullInScreen) const;
 
 	//! Draw the image on the screen.
 	//! @return true if the tile was actually displayed
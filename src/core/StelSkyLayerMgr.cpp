@@ -156,7 +156,11 @@ void StelSkyLayerMgr::removeSkyLayer(StelSkyLayerP l)
 void StelSkyLayerMgr::draw(StelCore* core)
 {
 	if (!flagShow)
+	{
+		// Cancel the loading of the tiles
+		MultiLevelJsonBase::updateTileLoading();
 		return;
+	}
 
 	StelPainter sPainter(core->getProjection(StelCore::FrameJ2000));
 	glBlendFunc(GL_ONE, GL_ONE);
@@ -178,6 +182,8 @@ void StelSkyLayerMgr::draw(StelCore* core)
 			s->layer->draw(core, sPainter, 1.);
 		}
 	}
+	// The tiles which were not requested while drawing stop loading
+	MultiLevelJsonBase::updateTileLoading();
 }
 
 void noDelete(StelSkyLayer*) {;}
@@ -24,6 +24,7 @@
 #include "StelPainter.hpp"
 #include "StelCore.hpp"
 
+#include <cmath>
 #include <stdexcept>
 #include <stdio.h>
 #include <QDebug>
@@ -58,7 +59,7 @@ void StelSkyPolygon::draw(StelCore* core, StelPainter& sPainter, float)
 	const StelProjectorP prj = core->getProjection(StelCore::FrameJ2000);
 
 	QMultiMap<double, StelSkyPolygon*> result;
-	getTilesToDraw(result, core, prj->getViewportConvexPolygon(0, 0), true);
+	getTilesToDraw(result, core, prj->getViewportConvexPolygon(0, 0), 1., true);
 
 	// Draw in the good order
 	sPainter.enableTexture2d(false);
@@ -74,7 +75,7 @@ void StelSkyPolygon::draw(StelCore* core, StelPainter& sPainter, float)
 }
 
 // Return the list of tiles which should be drawn.
-void StelSkyPolygon::getTilesToDraw(QMultiMap<double, StelSkyPolygon*>& result, StelCore* core, const SphericalRegionP& viewPortPoly, bool recheckIntersect)
+void StelSkyPolygon::getTilesToDraw(QMultiMap<double, StelSkyPolygon*>& result, StelCore* core, const SphericalRegionP& viewPortPoly, double parentPriority, bool recheckIntersect)
 {
 	// An error occured during loading
 	if (errorOccured)
@@ -82,7 +83,11 @@ void StelSkyPolygon::getTilesToDraw(QMultiMap<double, StelSkyPolygon*>& result,
 
 	// The JSON file is currently being downloaded
 	if (downloading)
+	{
+		// The download only starts when the tile gets a loading slot
+		requestDownload(parentPriority);
 		return;
+	}
 
 	// Check that we are in the screen
 	bool fullInScreen = true;
@@ -130,6 +135,8 @@ void StelSkyPolygon::getTilesToDraw(QMultiMap<double, StelSkyPolygon*>& result,
 	const double degPerPixel = 1./core->getProjection(StelCore::FrameJ2000)->getPixelPerRadAtCenter()*180./M_PI;
 	if (degPerPixel < minResolution)
 	{
+		// As for the image tiles, the sub tiles of a tile much coarser than the screen resolution come first
+		const double priority = 1.+std::log(minResolution/degPerPixel)/std::log(2.);
 		if (subTiles.isEmpty() && !subTilesUrls.isEmpty())
 		{
 			// Load the sub tiles because we reached the maximum resolution and they are not yet loaded
@@ -149,7 +156,7 @@ void StelSkyPolygon::getTilesToDraw(QMultiMap<double, StelSkyPolygon*>& result,
 		// Try to add the subtiles
 		foreach (MultiLevelJsonBase* tile, subTiles)
 		{
-			qobject_cast<StelSkyPolygon*>(tile)->getTilesToDraw(result, core, viewPortPoly, !fullInScreen);
+			qobject_cast<StelSkyPolygon*>(tile)->getTilesToDraw(result, core, viewPortPoly, priority, !fullInScreen);
 		}
 	}
 	else
@@ -83,7 +83,8 @@ private:
 
 	//! Return the list of tiles which should be drawn.
 	//! @param result a map containing resolution, pointer to the tiles
-	void getTilesToDraw(QMultiMap<double, StelSkyPolygon*>& result, StelCore* core, const SphericalRegionP& viewPortPoly, bool recheckIntersect=true);
+	//! @param parentPriority the loading priority of the parent tile, used while the description of this tile is not known.
+	void getTilesToDraw(QMultiMap<double, StelSkyPolygon*>& result, StelCore* core, const SphericalRegionP& viewPortPoly, double parentPriority, bool recheckIntersect=true);
 
 	//! Draw the polygon on the screen.
 	//! @return true if the tile was actually displayed
@@ -20,6 +20,8 @@
 #include "StelSphericalIndex.hpp"
 #include <QVector>
 
+#include <queue>
+
 StelSphericalIndex::StelSphericalIndex(int maxObjPerNode, int maxLevel) : maxObjectsPerNode(maxObjPerNode)
 {
 	rootNode = new RootNode(maxObjectsPerNode, maxLevel);
@@ -37,3 +39,78 @@ void StelSphericalIndex::insert(StelRegionObjectP regObj)
 }
 
 
+
+QVector<StelRegionObjectP> StelSphericalIndex::findPointsInCap(const SphericalCap& cap) const
+{
+	QVector<StelRegionObjectP> result;
+	findPointsInCap(*rootNode, cap, false, result);
+	return result;
+}
+
+void StelSphericalIndex::findPointsInCap(const Node& node, const SphericalCap& cap, bool inside, QVector<StelRegionObjectP>& result)
+{
+	foreach (const NodeElem& el, node.elements)
+	{
+		if (inside || el.point*cap.n>=cap.d)
+			result.append(el.obj);
+	}
+	foreach (const Node& child, node.children)
+	{
+		// The tests with the bounding cap are much cheaper than the tests with the triangle
+		if (inside || cap.contains(child.boundingCap))
+			findPointsInCap(child, cap, true, result);
+		else if (cap.intersects(child.boundingCap))
+			findPointsInCap(child, cap, false, result);
+	}
+}
+
+// Angle between two directions, precise for the small angles unlike acos
+static inline double angleBetween(const Vec3d& a, const Vec3d& b)
+{
+	return std::atan2((a^b).length(), a*b);
+}
+
+QVector<StelRegionObjectP> StelSphericalIndex::findNearestPoints(const Vec3d& v, int k, double maxAngle) const
+{
+	QVector<StelRegionObjectP> result;
+	if (k<=0)
+		return result;
+
+	// Best first search: a node is only opened when no element can be nearer than its triangle
+	std::priority_queue<NearestCandidate> queue;
+	NearestCandidate c;
+	c.angle = 0.;
+	c.node = rootNode;
+	c.elem = NULL;
+	queue.push(c);
+	while (!queue.empty() && result.size()<k)
+	{
+		const NearestCandidate best = queue.top();
+		queue.pop();
+		if (best.angle>maxAngle)
+			break;
+		if (best.elem)
+		{
+			result.append(best.elem->obj);
+			continue;
+		}
+		c.node = NULL;
+		for (QVector<NodeElem>::ConstIterator el=best.node->elements.constBegin(); el!=best.node->elements.constEnd(); ++el)
+		{
+			c.angle = angleBetween(v, el->point);
+			c.elem = &(*el);
+			if (c.angle<=maxAngle)
+				queue.push(c);
+		}
+		c.elem = NULL;
+		for (QVector<Node>::ConstIterator child=best.node->children.constBegin(); child!=best.node->children.constEnd(); ++child)
+		{
+			const double radius = std::acos(qBound(-1., child->boundingCap.d, 1.));
+			c.angle = qMax(0., angleBetween(v, child->boundingCap.n) - radius);
+			c.node = &(*child);
+			if (c.angle<=maxAngle)
+				queue.push(c);
+		}
+	}
+	return result;
+}
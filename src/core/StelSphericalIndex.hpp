@@ -22,8 +22,13 @@
 
 #include "StelRegionObject.hpp"
 
+#include <QVector>
+
 //! @class StelSphericalIndex
 //! Container allowing to store and query SphericalRegion.
+//! The regions are stored in a hierarchical triangular mesh. Besides the region queries, the points
+//! of the objects (StelRegionObject::getPointInRegion()) can be searched in a cone, or by their distance
+//! to a direction, which only visits the triangles near the searched direction.
 class StelSphericalIndex
 {
 public:
@@ -63,6 +68,17 @@ public:
 		rootNode->processAll(func);
 	}
 
+	//! Find the objects with their point in a cap (cone search).
+	//! Faster than processIntersectingPointInRegions() with a cap, as the triangles are tested with their bounding caps.
+	QVector<StelRegionObjectP> findPointsInCap(const SphericalCap& cap) const;
+
+	//! Find the objects with their point nearest to a direction.
+	//! @param v the direction, it does not need to be normalized.
+	//! @param k the maximum number of returned objects.
+	//! @param maxAngle the maximum angular distance of the returned points, in radian.
+	//! @return at most k objects, nearest first.
+	QVector<StelRegionObjectP> findNearestPoints(const Vec3d& v, int k, double maxAngle=M_PI) const;
+
 	//! Remove all the elements in the container.
 	void clear()
 	{
@@ -92,9 +108,10 @@ private:
 	struct NodeElem
 	{
 		NodeElem() {;}
-		NodeElem(StelRegionObjectP aobj) : obj(aobj), cap(obj->getRegion()->getBoundingCap()) {;}
+		NodeElem(StelRegionObjectP aobj) : obj(aobj), cap(obj->getRegion()->getBoundingCap()), point(obj->getPointInRegion()) {;}
 		StelRegionObjectP obj;
 		SphericalCap cap;
+		Vec3d point;
 	};
 
 	//! @class Node
@@ -106,6 +123,8 @@ private:
 		QVector<NodeElem> elements;
 		QVector<Node> children;
 		SphericalConvexPolygon triangle;
+		//! Bounding cap of the triangle, for the point queries.
+		SphericalCap boundingCap;
 		//! Split each triangles in to 4 subtriangles.
 		virtual void split()
 		{
@@ -134,6 +153,8 @@ private:
 			Q_ASSERT(children[2].triangle.checkValid());
 			children[3].triangle = SphericalConvexPolygon(e2,e0,e1);
 			Q_ASSERT(children[3].triangle.checkValid());
+			for (int i=0;i<4;++i)
+				children[i].boundingCap = children[i].triangle.getBoundingCap();
 		}
 
 		//! Suppress everything
@@ -174,6 +195,7 @@ private:
 				{
 					node.triangle = SphericalConvexPolygon(vertice[verticeIndice[i][0]], vertice[verticeIndice[i][1]], vertice[verticeIndice[i][2]]);
 					Q_ASSERT(node.triangle.checkValid());
+					node.boundingCap = node.triangle.getBoundingCap();
 					children.append(node);
 				}
 			}
@@ -333,6 +355,20 @@ private:
 	//! The maximum allowed number of object per node.
 	int maxObjectsPerNode;
 
+	//! Append the objects of node and its children with their point in cap to result.
+	//! @param inside if true, the node is known to be in cap.
+	static void findPointsInCap(const Node& node, const SphericalCap& cap, bool inside, QVector<StelRegionObjectP>& result);
+
+	//! A node to visit or an element, ordered by the smallest possible angle to the searched direction.
+	struct NearestCandidate
+	{
+		double angle;
+		const Node* node;
+		const NodeElem* elem;
+		//! The priority queue returns the smallest angle first.
+		bool operator<(const NearestCandidate& other) const {return angle>other.angle;}
+	};
+
 	RootNode* rootNode;
 };
 
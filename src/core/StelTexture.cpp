@@ -37,34 +37,44 @@
 
 #include <cstdlib>
 
-StelTexture::StelTexture() : networkReply(NULL), loader(NULL), errorOccured(false), alphaChannel(false), id(0), avgLuminance(-1.f)
+StelTexture::StelTexture() : networkReply(NULL), loader(NULL), errorOccured(false), alphaChannel(false), id(0), avgLuminance(-1.f),
+	textureMgr(NULL), gpuBytes(0), lastBoundFrame(0)
 {
 	width = -1;
 	height = -1;
 }
 
 StelTexture::~StelTexture()
+{
+	glUnload();
+	if (textureMgr != NULL)
+		textureMgr->textureDeleted(this);
+	if (networkReply != NULL)
+	{
+		networkReply->abort();
+		networkReply->deleteLater();
+	}
+	if (loader != NULL) {
+		delete loader;
+		loader = NULL;
+	}
+}
+
+void StelTexture::glUnload()
 {
 	if (id != 0)
 	{
 		if (glIsTexture(id)==GL_FALSE)
 		{
-			qDebug() << "WARNING: in StelTexture::~StelTexture() tried to delete invalid texture with ID=" << id << "Current GL ERROR status is" << glGetError() << "(" << getGLErrorText(glGetError()) << ")";
+			qDebug() << "WARNING: in StelTexture::glUnload() tried to delete invalid texture with ID=" << id << "Current GL ERROR status is" << glGetError() << "(" << getGLErrorText(glGetError()) << ")";
 		}
 		else
 		{
 			glDeleteTextures(1, &id);
 		}
 		id = 0;
-	}
-	if (networkReply != NULL)
-	{
-		networkReply->abort();
-		networkReply->deleteLater();
-	}
-	if (loader != NULL) {
-		delete loader;
-		loader = NULL;
+		if (textureMgr != NULL)
+			textureMgr->textureUnloaded(this);
 	}
 }
 
@@ -109,6 +119,8 @@ StelTexture::GLData StelTexture::loadFromData(const QByteArray& data)
 
 bool StelTexture::bind(int slot)
 {
+	if (textureMgr != NULL)
+		lastBoundFrame = textureMgr->frame;
 	if (id != 0)
 	{
 		// The texture is already fully loaded, just bind and return true;
@@ -317,6 +329,17 @@ bool StelTexture::glLoad(const GLData& data)
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, loadParams.filterMipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR_MIPMAP_NEAREST);
 		glGenerateMipmap(GL_TEXTURE_2D);
 	}
+	const int bpp = data.format == GL_LUMINANCE_ALPHA ? 2 :
+			data.format == GL_LUMINANCE ? 1 :
+			data.format == GL_RGBA ? 4 :
+			3;
+	gpuBytes = (qint64)width * height * bpp;
+	// The mipmaps add a third of the base level
+	if (loadParams.generateMipmaps)
+		gpuBytes += gpuBytes/3;
+	if (textureMgr != NULL)
+		textureMgr->textureLoaded(this);
+
 	// Report success of texture loading
 	emit(loadingProcessFinished(false));
 	return true;
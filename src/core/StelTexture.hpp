@@ -65,7 +65,7 @@ public:
 	virtual ~StelTexture();
 
 	//! Bind the texture so that it can be used for openGL drawing (calls glBindTexture).
-	//! If the texture is lazyly loaded, this starts the loading and return false immediately.
+	//! If the texture is lazyly loaded, or was unloaded by the StelTextureMgr memory budget, this starts the loading and return false immediately.
 	//! @return true if the binding successfully occured, false if the texture is not yet loaded.
 	
 	bool bind(int slot=0);
@@ -136,6 +136,8 @@ private:
 	bool glLoad(const QImage& image);
 	//! Same as glLoad(QImage), but with an image already in OpenGl format
 	bool glLoad(const GLData& data);
+	//! Remove the texture from the openGL memory, the next bind() loads it again.
+	void glUnload();
 
 	StelTextureParams loadParams;
 
@@ -166,6 +168,15 @@ private:
 
 	GLsizei width;	//! Texture image width
 	GLsizei height;	//! Texture image height
+
+	//! The manager sharing this texture, NULL after its deletion
+	StelTextureMgr* textureMgr;
+	//! The key under which the manager shares this texture
+	QString cacheKey;
+	//! Size of the texture in the openGL memory in bytes, including the mipmaps
+	qint64 gpuBytes;
+	//! Number of the last frame where the texture was bound
+	int lastBoundFrame;
 };
 
 
@@ -32,9 +32,34 @@
 #include <cstdlib>
 #include <QOpenGLContext>
 
+#include <algorithm>
+
+
+StelTextureMgr::StelTextureMgr()
+	: memory(0)
+	, memoryBudget(0)
+	, hits(0)
+	, misses(0)
+	, evictions(0)
+	, frame(0)
+{
+}
+
+StelTextureMgr::~StelTextureMgr()
+{
+	// Some textures are deleted after the manager
+	foreach (const QWeakPointer<StelTexture>& weak, textures)
+	{
+		StelTextureSP tex = weak.toStrongRef();
+		if (tex)
+			tex->textureMgr = NULL;
+	}
+}
 
 void StelTextureMgr::init()
 {
+	QSettings* conf = StelApp::getInstance().getSettings();
+	setMemoryBudget(conf->value("video/texture_memory_budget", 0).toLongLong()*1024*1024);
 }
 
 StelTextureSP StelTextureMgr::createTexture(const QString& afilename, const StelTexture::StelTextureParams& params)
@@ -42,14 +67,20 @@ StelTextureSP StelTextureMgr::createTexture(const QString& afilename, const Stel
 	if (afilename.isEmpty())
 		return StelTextureSP();
 
-	StelTextureSP tex = StelTextureSP(new StelTexture());
-	tex->fullPath = afilename;
+	const QString key = cacheKey(afilename, params);
+	StelTextureSP cached = findCached(key);
+	// A texture created by createTextureThread() may still be loading
+	if (cached && cached->canBind())
+	{
+		++hits;
+		return cached;
+	}
 
-	QImage image(tex->fullPath);
+	QImage image(afilename);
 	if (image.isNull())
 		return StelTextureSP();
 
-	tex->loadParams = params;
+	StelTextureSP tex = createCached(key, afilename, params);
 	if (tex->glLoad(image))
 		return tex;
 	else
@@ -65,12 +96,101 @@ StelTextureSP StelTextureMgr::createTextureThread(const QString& url, const Stel
 	if (url.isEmpty())
 		return StelTextureSP();
 
-	StelTextureSP tex = StelTextureSP(new StelTexture());
-	tex->loadParams = params;
-	tex->fullPath = url;
+	const QString key = cacheKey(url, params);
+	StelTextureSP tex = findCached(key);
+	if (tex && !tex->errorOccured)
+		++hits;
+	else
+		tex = createCached(key, url, params);
 	if (!lazyLoading)
 	{
 		tex->bind();
 	}
 	return tex;
 }
+
+StelTextureMgr::Statistics StelTextureMgr::getStatistics() const
+{
+	Statistics stats;
+	stats.hits = hits;
+	stats.misses = misses;
+	stats.evictions = evictions;
+	stats.textures = textures.size();
+	stats.loadedTextures = loadedTextures.size();
+	stats.memory = memory;
+	stats.memoryBudget = memoryBudget;
+	return stats;
+}
+
+bool StelTextureMgr::boundBefore(const StelTexture* a, const StelTexture* b)
+{
+	return a->lastBoundFrame<b->lastBoundFrame;
+}
+
+void StelTextureMgr::update()
+{
+	if (memoryBudget>0 && memory>memoryBudget)
+	{
+		QList<StelTexture*> candidates;
+		foreach (StelTexture* tex, loadedTextures)
+		{
+			if (tex->lastBoundFrame<frame)
+				candidates << tex;
+		}
+		std::sort(candidates.begin(), candidates.end(), boundBefore);
+		foreach (StelTexture* tex, candidates)
+		{
+			if (memory<=memoryBudget)
+				break;
+			tex->glUnload();
+			++evictions;
+		}
+	}
+	++frame;
+}
+
+QString StelTextureMgr::cacheKey(const QString& path, const StelTexture::StelTextureParams& params)
+{
+	return QString("%1|%2|%3|%4|%5").arg(params.generateMipmaps).arg(params.filterMipmaps).arg(params.filtering).arg(params.wrapMode).arg(path);
+}
+
+StelTextureSP StelTextureMgr::findCached(const QString& key) const
+{
+	return textures.value(key).toStrongRef();
+}
+
+StelTextureSP StelTextureMgr::createCached(const QString& key, const QString& path, const StelTexture::StelTextureParams& params)
+{
+	StelTextureSP tex = StelTextureSP(new StelTexture());
+	tex->loadParams = params;
+	tex->fullPath = path;
+	tex->textureMgr = this;
+	tex->cacheKey = key;
+	tex->lastBoundFrame = frame;
+	// Replaces a texture which failed, or which is still loading for createTexture()
+	textures.insert(key, tex);
+	++misses;
+	return tex;
+}
+
+void StelTextureMgr::textureLoaded(StelTexture* tex)
+{
+	loadedTextures.insert(tex);
+	memory += tex->gpuBytes;
+	tex->lastBoundFrame = frame;
+}
+
+void StelTextureMgr::textureUnloaded(StelTexture* tex)
+{
+	if (loadedTextures.remove(tex))
+		memory -= tex->gpuBytes;
+}
+
+void StelTextureMgr::textureDeleted(StelTexture* tex)
+{
+	textureUnloaded(tex);
+	// The key may already be used by a texture which replaced this one
+	QHash<QString, QWeakPointer<StelTexture> >::iterator it = textures.find(tex->cacheKey);
+	if (it!=textures.end() && it.value().isNull())
+		textures.erase(it);
+}
@@ -21,7 +21,10 @@
 #define _STELTEXTUREMGR_HPP_
 
 #include "StelTexture.hpp"
+#include <QHash>
 #include <QObject>
+#include <QSet>
+#include <QWeakPointer>
 
 class QNetworkReply;
 class QThread;
@@ -30,9 +33,27 @@ class QThread;
 //! @class StelTextureMgr
 //! Manage textures loading.
 //! It provides method for loading images in a separate thread.
+//! Textures are shared: creating a texture for a file and parameters which are already used returns the same instance.
+//! The memory used by the loaded textures can be limited by a budget (see setMemoryBudget()): above it,
+//! the least recently bound textures are unloaded at the end of the frame, and loaded again at their next bind().
 class StelTextureMgr : QObject
 {
 public:
+	//! Usage of the texture cache since the start of the program.
+	struct Statistics
+	{
+		int hits;		//!< Number of textures created which were already loaded or loading
+		int misses;		//!< Number of textures created from their file
+		int evictions;		//!< Number of textures unloaded to respect the memory budget
+		int textures;		//!< Number of textures in use
+		int loadedTextures;	//!< Number of textures in the graphic memory
+		qint64 memory;		//!< Graphic memory used by the loaded textures in bytes, including their mipmaps
+		qint64 memoryBudget;	//!< See setMemoryBudget()
+	};
+
+	StelTextureMgr();
+	~StelTextureMgr();
+
 	//! Initialize some variable from the openGL context.
 	//! Must be called after the creation of the GLContext.
 	void init();
@@ -50,9 +71,49 @@ public:
 	//! @param lazyLoading define whether the texture should be actually loaded only when needed, i.e. when bind() is called the first time.
 	StelTextureSP createTextureThread(const QString& url, const StelTexture::StelTextureParams& params=StelTexture::StelTextureParams(), bool lazyLoading=true);
 
+	//! Set the graphic memory which the loaded textures should not exceed.
+	//! The textures bound in the current frame are never unloaded, so the budget may be exceeded for a while.
+	//! @param bytes the budget in bytes, or 0 for no limit. The default is the video/texture_memory_budget
+	//!    setting in MiB, or no limit.
+	void setMemoryBudget(qint64 bytes) {memoryBudget = bytes<0 ? 0 : bytes;}
+	qint64 getMemoryBudget() const {return memoryBudget;}
+
+	//! Return the usage of the texture cache.
+	Statistics getStatistics() const;
+
+	//! Unload the least recently bound textures if the memory budget is exceeded.
+	//! Must be called once per frame, after drawing.
+	void update();
+
 private:
 	friend class StelTexture;
 	friend class ImageLoader;
+
+	//! The key of the shared textures
+	static QString cacheKey(const QString& path, const StelTexture::StelTextureParams& params);
+	//! Return the shared texture for key, or a null pointer.
+	StelTextureSP findCached(const QString& key) const;
+	//! Create a texture shared under key.
+	StelTextureSP createCached(const QString& key, const QString& path, const StelTexture::StelTextureParams& params);
+	//! Order of the textures to unload
+	static bool boundBefore(const StelTexture* a, const StelTexture* b);
+
+	//! Called by the textures when they are loaded in or removed from the graphic memory, and when they are deleted
+	void textureLoaded(StelTexture* tex);
+	void textureUnloaded(StelTexture* tex);
+	void textureDeleted(StelTexture* tex);
+
+	//! The textures in use, by cacheKey(). They are not kept alive by the cache.
+	QHash<QString, QWeakPointer<StelTexture> > textures;
+	//! The textures which are in the graphic memory
+	QSet<StelTexture*> loadedTextures;
+	qint64 memory;
+	qint64 memoryBudget;
+	int hits;
+	int misses;
+	int evictions;
+	//! Number of the current frame, for the least recently bound textures
+	int frame;
 };
 
 
@@ -0,0 +1,89 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include "StelTileLoader.hpp"
+
+#include <QMultiMap>
+
+StelTileLoader::StelTileLoader(int n) : maxLoads(n<1 ? 1 : n)
+{
+}
+
+bool StelTileLoader::request(const QObject* tile, double priority)
+{
+	QHash<const QObject*, bool>::iterator it = loading.find(tile);
+	if (it!=loading.end())
+	{
+		it.value() = true;
+		return true;
+	}
+	// Requested twice in a frame (e.g. also for prefetching): keep the highest priority
+	QHash<const QObject*, double>::iterator p = pending.find(tile);
+	if (p==pending.end())
+		pending.insert(tile, priority);
+	else if (priority>p.value())
+		p.value() = priority;
+	return false;
+}
+
+void StelTileLoader::release(const QObject* tile)
+{
+	loading.remove(tile);
+	pending.remove(tile);
+	held.remove(tile);
+}
+
+void StelTileLoader::hold(const QObject* tile)
+{
+	if (loading.contains(tile))
+		held.insert(tile);
+}
+
+QList<const QObject*> StelTileLoader::update()
+{
+	QList<const QObject*> cancelled;
+	for (QHash<const QObject*, bool>::iterator it=loading.begin(); it!=loading.end();)
+	{
+		if (it.value() || held.contains(it.key()))
+		{
+			it.value() = false;
+			++it;
+		}
+		else
+		{
+			cancelled << it.key();
+			it = loading.erase(it);
+		}
+	}
+
+	// The best requests are at the end of the map
+	QMultiMap<double, const QObject*> byPriority;
+	for (QHash<const QObject*, double>::const_iterator it=pending.constBegin(); it!=pending.constEnd(); ++it)
+		byPriority.insert(it.value(), it.key());
+	QMultiMap<double, const QObject*>::const_iterator best = byPriority.constEnd();
+	while (loading.size()<maxLoads && best!=byPriority.constBegin())
+	{
+		--best;
+		// Counts as renewed, so that the tile gets its slot at its request in the next frame
+		loading.insert(best.value(), true);
+	}
+	// The other requests must be renewed in the next frame
+	pending.clear();
+	return cancelled;
+}
@@ -0,0 +1,82 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _STELTILELOADER_HPP_
+#define _STELTILELOADER_HPP_
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+
+class QObject;
+
+//! @class StelTileLoader
+//! Schedules the loading of the tiles of the multi-resolution sky layers (see MultiLevelJsonBase).
+//! A tile requests a loading slot in each frame while it needs to load, with a priority computed from
+//! the part of the screen it covers and from how much its resolution is needed. At the end of the frame,
+//! update() cancels the requests which were not renewed, i.e. the tiles which left the view, and gives
+//! the free slots to the pending requests with the highest priority.
+//! This bounds the number of concurrent downloads and decoding threads, and fills the largest holes
+//! of the screen first. A loading which cannot be cancelled, such as a decoding thread, holds its slot
+//! until it ends.
+class StelTileLoader
+{
+public:
+	//! @param maxLoads the maximum number of tiles loading at the same time.
+	StelTileLoader(int maxLoads=6);
+
+	void setMaxLoads(int n) {maxLoads = n<1 ? 1 : n;}
+	int getMaxLoads() const {return maxLoads;}
+
+	//! Request to load a tile, or to keep loading it. Must be called in each frame while the tile needs to load.
+	//! @param tile the tile, it must release() its request before its deletion.
+	//! @param priority the tiles with the highest priority get a slot first.
+	//! @return true if the tile has a slot and can load.
+	bool request(const QObject* tile, double priority);
+
+	//! Release the slot or the pending request of a tile, when it is loaded, failed or deleted.
+	void release(const QObject* tile);
+
+	//! Keep the slot of a tile until its release(), even if it is not requested any more.
+	//! For the loadings which cannot be cancelled: the slot is not given to another tile while they run.
+	//! Does nothing if the tile has no slot.
+	void hold(const QObject* tile);
+
+	//! Return whether the tile has a loading slot.
+	bool hasSlot(const QObject* tile) const {return loading.contains(tile);}
+
+	//! Cancel the requests which were not renewed since the last call, then give the free slots
+	//! to the pending requests with the highest priority. Must be called once per frame.
+	//! @return the tiles whose slot was cancelled, they must stop loading.
+	QList<const QObject*> update();
+
+	int getNbPending() const {return pending.size();}
+	int getNbLoading() const {return loading.size();}
+
+private:
+	//! The requests of the current frame waiting for a slot, with their priority
+	QHash<const QObject*, double> pending;
+	//! The tiles with a slot, and whether they renewed their request in the current frame
+	QHash<const QObject*, bool> loading;
+	//! The tiles which keep their slot until they release it
+	QSet<const QObject*> held;
+	int maxLoads;
+};
+
+#endif // _STELTILELOADER_HPP_
@@ -25,16 +25,99 @@
 #include "StelCore.hpp"
 #include "StelPainter.hpp"
 #include "StelFileMgr.hpp"
+#include "StelModuleMgr.hpp"
+#include "SolarSystem.hpp"
 
 #include <QDebug>
 #include <QSettings>
 #include <QOpenGLShaderProgram>
+#include <QtConcurrent>
+
+#include <algorithm>
 
 inline bool myisnan(double value)
 {
 	return value != value;
 }
 
+// Number of grid points computed by one thread at once
+static const int gridChunkSize = 512;
+// Below this number of grid points, computing them in the calling thread is faster than waking the thread pool.
+static const int minParallelGridPoints = 2048;
+// The grid is not recomputed until the sun or the moon moved by this angle [rad], about 4 arcseconds.
+static const float maxSunMoonMove = 2e-5f;
+// Nor until the moon phase changed by this angle [rad]. The moon magnitude then changes by about 0.00015.
+static const float maxMoonPhaseChange = 1e-4f;
+
+// Computes the positions and luminances of a range of the grid. Used with QtConcurrent::blockingMap().
+struct Atmosphere::ChunkComputer
+{
+	typedef void result_type;
+	ChunkComputer(const Atmosphere* atmosphere, const StelProjector* prj, const float* sunPos, const float* moonPos)
+		: atmosphere(atmosphere), prj(prj), sunPos(sunPos), moonPos(moonPos) {}
+	void operator()(GridChunk& c) const
+	{
+		float cosDistMoon[gridChunkSize];
+		float cosDistSun[gridChunkSize];
+		float cosDistZenith[gridChunkSize];
+		float lum[gridChunkSize];
+		const int n = c.end-c.begin;
+		Q_ASSERT(n<=gridChunkSize);
+
+		Vec3d point(1., 0., 0.);
+		for (int j=0; j<n; ++j)
+		{
+			const Vec2f &v(atmosphere->posGrid[c.begin+j]);
+			prj->unProject(v[0],v[1],point);
+
+			Q_ASSERT(fabs(point.lengthSquared()-1.0) < 1e-10);
+
+			// Use mirroring for sun only
+			if (point[2]<=0)
+			{
+				point[2] = -point[2];
+				// The sky below the ground is the symmetric of the one above :
+				// it looks nice and gives proper values for brightness estimation
+				cosDistMoon[j] = moonPos[0]*point[0]+moonPos[1]*point[1]-moonPos[2]*point[2];
+			}
+			else
+				cosDistMoon[j] = moonPos[0]*point[0]+moonPos[1]*point[1]+moonPos[2]*point[2];
+			cosDistSun[j] = sunPos[0]*point[0]+sunPos[1]*point[1]+sunPos[2]*point[2];
+			cosDistZenith[j] = point[2];
+			atmosphere->colorGrid[c.begin+j].set(point[0], point[1], point[2], 0.f);
+		}
+
+		// Use the Skybright.cpp 's models for brightness which gives better results.
+		if (atmosphere->gridInputs.flagPlanets)
+			atmosphere->skyb.getLuminances(n, cosDistMoon, cosDistSun, cosDistZenith, lum);
+		else
+			std::fill(lum, lum+n, 0.f);
+
+		c.sumLum = 0.f;
+		for (int j=0; j<n; ++j)
+		{
+			float lumi = lum[j] * atmosphere->eclipseFactor;
+			// Add star background luminance
+			lumi += 0.0001f;
+			// Add the light pollution luminance AFTER the scaling to avoid scaling it because it is the cause
+			// of the scaling itself
+			lumi += atmosphere->lightPollutionLuminance;
+
+			// Store for later statistics
+			c.sumLum += lumi;
+
+			// Now need to compute the xy part of the color component
+			// This is done in the openGL shader
+			// Store the back projected position + luminance in the input color to the shader
+			atmosphere->colorGrid[c.begin+j][3] = lumi;
+		}
+	}
+	const Atmosphere* atmosphere;
+	const StelProjector* prj;
+	const float* sunPos;
+	const float* moonPos;
+};
+
 Atmosphere::Atmosphere(void)
 	: viewport(0,0,0,0)
 	, skyResolutionY(44)
@@ -44,6 +127,8 @@ Atmosphere::Atmosphere(void)
 	, indicesBuffer(QOpenGLBuffer::IndexBuffer)
 	, colorGrid(NULL)
 	, colorGridBuffer(QOpenGLBuffer::VertexBuffer)
+	, gridValid(false)
+	, gridAverageLuminance(0.f)
 	, averageLuminance(0.f)
 	, overrideAverageLuminance(false)
 	, eclipseFactor(1.f)
@@ -180,6 +265,17 @@ void Atmosphere::computeColor(double JD, Vec3d _sunPos, Vec3d moonPos, float moo
 		colorGridBuffer.bind();
 		colorGridBuffer.allocate(colorGrid, (1+skyResolutionX)*(1+skyResolutionY)*4*4);
 		colorGridBuffer.release();
+
+		gridChunks.clear();
+		for (int begin=0; begin<(1+skyResolutionX)*(1+skyResolutionY); begin+=gridChunkSize)
+		{
+			GridChunk c;
+			c.begin = begin;
+			c.end = qMin(begin+gridChunkSize, (1+skyResolutionX)*(1+skyResolutionY));
+			c.sumLum = 0.f;
+			gridChunks << c;
+		}
+		gridValid = false;
 	}
 
 	if (myisnan(_sunPos.length()))
@@ -243,72 +339,81 @@ void Atmosphere::computeColor(double JD, Vec3d _sunPos, Vec3d moonPos, float moo
 
 	sky.setParamsv(sunPos, 5.f);
 
-	skyb.setLocation(latitude * M_PI/180., altitude, temperature, relativeHumidity);
-	skyb.setSunMoon(moon_pos[2], sunPos[2]);
-
 	// Calculate the date from the julian day.
 	int year, month, day;
 	StelUtils::getDateFromJulianDay(JD, &year, &month, &day);
-	skyb.setDate(year, month, moonPhase);
 
-	// Variables used to compute the average sky luminance
-	float sum_lum = 0.f;
-
-	Vec3d point(1., 0., 0.);
-	float lumi;
-
-	// Compute the sky color for every point above the ground
-	for (int i=0; i<(1+skyResolutionX)*(1+skyResolutionY); ++i)
+	// Skip the computation while the sky and the view did not change
+	GridInputs inputs;
+	inputs.sunPos.set(sunPos[0], sunPos[1], sunPos[2]);
+	inputs.moonPos.set(moon_pos[0], moon_pos[1], moon_pos[2]);
+	inputs.moonPhase = moonPhase;
+	inputs.year = year;
+	inputs.month = month;
+	inputs.latitude = latitude;
+	inputs.altitude = altitude;
+	inputs.temperature = temperature;
+	inputs.relativeHumidity = relativeHumidity;
+	inputs.eclipseFactor = eclipseFactor;
+	inputs.lightPollutionLuminance = lightPollutionLuminance;
+	inputs.flagPlanets = GETSTELMODULE(SolarSystem)->getFlagPlanets();
+	const Vec4i& vp = prj->getViewport();
+	prj->unProject(vp[0], vp[1], inputs.viewProbes[0]);
+	prj->unProject(vp[0]+vp[2], vp[1], inputs.viewProbes[1]);
+	prj->unProject(vp[0], vp[1]+vp[3], inputs.viewProbes[2]);
+	prj->unProject(vp[0]+vp[2], vp[1]+vp[3], inputs.viewProbes[3]);
+	prj->unProject(vp[0]+0.5*vp[2], vp[1]+0.5*vp[3], inputs.viewProbes[4]);
+	if (gridValid && isGridUpToDate(gridInputs, inputs))
 	{
-		const Vec2f &v(posGrid[i]);
-		prj->unProject(v[0],v[1],point);
+		if (!overrideAverageLuminance)
+			averageLuminance = gridAverageLuminance;
+		return;
+	}
+	gridInputs = inputs;
 
-		Q_ASSERT(fabs(point.lengthSquared()-1.0) < 1e-10);
+	skyb.setLocation(latitude * M_PI/180., altitude, temperature, relativeHumidity);
+	skyb.setSunMoon(moon_pos[2], sunPos[2]);
+	skyb.setDate(year, month, moonPhase);
 
-		// Use mirroring for sun only
-		if (point[2]<=0)
-		{
-			point[2] = -point[2];
-			// The sky below the ground is the symmetric of the one above :
-			// it looks nice and gives proper values for brightness estimation
-			// Use the Skybright.cpp 's models for brightness which gives better results.
-			lumi = skyb.getLuminance(moon_pos[0]*point[0]+moon_pos[1]*point[1]-
-					moon_pos[2]*point[2], sunPos[0]*point[0]+sunPos[1]*point[1]+
-					sunPos[2]*point[2], point[2]);
-		}
-		else
-		{
-			// Use the Skybright.cpp 's models for brightness which gives better results.
-			lumi = skyb.getLuminance(moon_pos[0]*point[0]+moon_pos[1]*point[1]+
-					moon_pos[2]*point[2], sunPos[0]*point[0]+sunPos[1]*point[1]+
-					sunPos[2]*point[2], point[2]);
-		}
-		lumi *= eclipseFactor;
-		// Add star background luminance
-		lumi += 0.0001f;
-		// Multiply by the input scale of the ToneConverter (is not done automatically by the xyYtoRGB method called later)
-		//lumi*=eye->getInputScale();
-
-		// Add the light pollution luminance AFTER the scaling to avoid scaling it because it is the cause
-		// of the scaling itself
-		lumi += lightPollutionLuminance;
-
-		// Store for later statistics
-		sum_lum+=lumi;
-
-		// Now need to compute the xy part of the color component
-		// This is done in the openGL shader
-		// Store the back projected position + luminance in the input color to the shader
-		colorGrid[i].set(point[0], point[1], point[2], lumi);
-	}
+	// Compute the sky color for every point of the grid, the points below the ground mirroring those above
+	const ChunkComputer computer(this, prj.data(), sunPos, moon_pos);
+	if ((1+skyResolutionX)*(1+skyResolutionY)<minParallelGridPoints)
+		std::for_each(gridChunks.begin(), gridChunks.end(), computer);
+	else
+		QtConcurrent::blockingMap(gridChunks, computer);
+
+	// Variables used to compute the average sky luminance
+	float sum_lum = 0.f;
+	foreach (const GridChunk& c, gridChunks)
+		sum_lum += c.sumLum;
 	
 	colorGridBuffer.bind();
 	colorGridBuffer.write(0, colorGrid, (1+skyResolutionX)*(1+skyResolutionY)*4*4);
 	colorGridBuffer.release();
 	
 	// Update average luminance
+	gridAverageLuminance = sum_lum/((1+skyResolutionX)*(1+skyResolutionY));
+	gridValid = true;
 	if (!overrideAverageLuminance)
-		averageLuminance = sum_lum/((1+skyResolutionX)*(1+skyResolutionY));
+		averageLuminance = gridAverageLuminance;
+}
+
+bool Atmosphere::isGridUpToDate(const GridInputs& last, const GridInputs& current)
+{
+	for (int i=0; i<5; ++i)
+	{
+		if (last.viewProbes[i]!=current.viewProbes[i])
+			return false;
+	}
+	return (last.sunPos-current.sunPos).lengthSquared() < maxSunMoonMove*maxSunMoonMove
+		&& (last.moonPos-current.moonPos).lengthSquared() < maxSunMoonMove*maxSunMoonMove
+		&& std::fabs(last.moonPhase-current.moonPhase) < maxMoonPhaseChange
+		&& last.year==current.year && last.month==current.month
+		&& last.latitude==current.latitude && last.altitude==current.altitude
+		&& last.temperature==current.temperature && last.relativeHumidity==current.relativeHumidity
+		&& last.eclipseFactor==current.eclipseFactor
+		&& last.lightPollutionLuminance==current.lightPollutionLuminance
+		&& last.flagPlanets==current.flagPlanets;
 }
 
 // override computable luminance. This is for special operations only, e.g. for scripting of brightness-balanced image export.
@@ -28,6 +28,7 @@
 #include "StelFader.hpp"
 
 #include <QOpenGLBuffer>
+#include <QVector>
 
 class StelProjector;
 class StelToneReproducer;
@@ -80,6 +81,30 @@ public:
 	float getLightPollutionLuminance() const { return lightPollutionLuminance; }
 
 private:
+	//! A range of the grid computed by one thread.
+	struct GridChunk
+	{
+		int begin;
+		int end;
+		float sumLum;	// sum of the luminances of the range
+	};
+	struct ChunkComputer;
+
+	//! The inputs of the grid luminances. The grid is only recomputed when they change.
+	struct GridInputs
+	{
+		Vec3f sunPos, moonPos;	// normalized
+		float moonPhase;
+		int year, month;
+		float latitude, altitude, temperature, relativeHumidity;
+		float eclipseFactor;
+		float lightPollutionLuminance;
+		bool flagPlanets;
+		Vec3d viewProbes[5];	// unprojected corners and center of the viewport
+	};
+	//! Whether the grid computed for last can be used for current.
+	static bool isGridUpToDate(const GridInputs& last, const GridInputs& current);
+
 	Vec4i viewport;
 	Skylight sky;
 	Skybright skyb;
@@ -90,6 +115,10 @@ private:
 	QOpenGLBuffer indicesBuffer;
 	Vec4f* colorGrid;
 	QOpenGLBuffer colorGridBuffer;
+	QVector<GridChunk> gridChunks;
+	GridInputs gridInputs;	// of the current colorGrid
+	bool gridValid;		// colorGrid is computed for gridInputs
+	float gridAverageLuminance;
 
 	//! The average luminance of the atmosphere in cd/m2
 	float averageLuminance;
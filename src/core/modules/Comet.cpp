@@ -278,6 +278,15 @@ void Comet::setSemiMajorAxis(const double value)
 	semiMajorAxis = value;
 }
 
+Vec3d Comet::computeEclipticPosAt(const double dateJDE) const
+{
+	// The CometOrbit is in fact available in userDataPtr!
+	// Don't update the velocity vector, it is used for the tails of the currently displayed comet.
+	Vec3d pos;
+	static_cast<CometOrbit*>(userDataPtr)->positionAtTimevInVSOP87Coordinates(dateJDE, pos, false);
+	return pos;
+}
+
 double Comet::getSiderealPeriod() const
 {
 	double period;
@@ -289,18 +298,18 @@ double Comet::getSiderealPeriod() const
 	return period;
 }
 
-float Comet::getVMagnitude(const StelCore* core) const
+float Comet::computeVMagnitude(const StelCore* core, const Vec3d& observerHelioPos, const Vec3d& planetHelioPos, const Vec3d& parentHelioPos, double JDE) const
 {
 	//If the two parameter system is not used,
 	//use the default radius/albedo mechanism
 	if (slopeParameter < 0)
 	{
-		return Planet::getVMagnitude(core);
+		return Planet::computeVMagnitude(core, observerHelioPos, planetHelioPos, parentHelioPos, JDE);
 	}
 
 	//Calculate distances
-	const Vec3d& observerHeliocentricPosition = core->getObserverHeliocentricEclipticPos();
-	const Vec3d& cometHeliocentricPosition = getHeliocentricEclipticPos();
+	const Vec3d& observerHeliocentricPosition = observerHelioPos;
+	const Vec3d& cometHeliocentricPosition = planetHelioPos;
 	const double cometSunDistance = cometHeliocentricPosition.length();
 	const double observerCometDistance = (observerHeliocentricPosition - cometHeliocentricPosition).length();
 
@@ -76,7 +76,9 @@ public:
 	//was not designed to handle different types of objects.
 	//virtual QString getType() const {return "Comet";}
 	//! \todo Find better sources for the g,k system
-	virtual float getVMagnitude(const StelCore* core) const;
+	virtual float computeVMagnitude(const StelCore* core, const Vec3d& observerHelioPos, const Vec3d& planetHelioPos, const Vec3d& parentHelioPos, double JDE) const;
+	//! Evaluates the CometOrbit without updating its velocity vector (which is used for the tails).
+	virtual Vec3d computeEclipticPosAt(const double dateJDE) const;
 	//! sets the nameI18 property with the appropriate translation.
 	//! Function overriden to handle the problem with name conflicts.
 	virtual void translateName(const StelTranslator& trans);
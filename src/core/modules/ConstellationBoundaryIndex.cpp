@@ -0,0 +1,260 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include "ConstellationBoundaryIndex.hpp"
+#include "StelCore.hpp"
+#include "StelUtils.hpp"
+#include "planetsephems/precession.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QTextStream>
+
+#include <algorithm>
+
+// JDE of the equinox B1875.0
+static const double jdeB1875 = 2405889.258550475;
+// The points of an arc of constant declination differ by less than this after the precession [rad]
+static const double parallelTolerance = 1e-4;
+// Ends of arcs closer than this in right ascension are the same strip boundary [rad]
+static const double stripTolerance = 3e-5;
+
+// An arc of constant declination of the boundaries, from ra1 to ra2 > ra1
+struct BoundaryArc
+{
+	double dec;
+	double ra1, ra2;
+	int c1, c2;
+	bool crosses(double ra) const {return (ra1<=ra && ra<=ra2) || (ra1<=ra+2.*M_PI && ra+2.*M_PI<=ra2);}
+};
+
+static bool northOf(const BoundaryArc& a, const BoundaryArc& b)
+{
+	return a.dec>b.dec;
+}
+
+// The abbreviations of the boundary file are in upper case
+static QString iauAbbreviation(const QString& name)
+{
+	static const char* const mixedCase[] = {"CMa", "CMi", "CrA", "CrB", "CVn", "LMi", "PsA", "TrA", "UMa", "UMi"};
+	for (unsigned int i=0; i<sizeof(mixedCase)/sizeof(mixedCase[0]); ++i)
+	{
+		if (name.compare(mixedCase[i], Qt::CaseInsensitive)==0)
+			return mixedCase[i];
+	}
+	return name.left(1).toUpper() + name.mid(1).toLower();
+}
+
+ConstellationBoundaryIndex::ConstellationBoundaryIndex() : northPole(-1)
+{
+	// Same precession as the Earth, without nutation (see Planet::computeRotLocalToParent())
+	double eps_A, chi_A, omega_A, psi_A;
+	getPrecessionAnglesVondrak(jdeB1875, &eps_A, &chi_A, &omega_A, &psi_A);
+	const Mat4d matB1875ToVsop87 = Mat4d::zrotation(-psi_A) * Mat4d::xrotation(-omega_A) * Mat4d::zrotation(chi_A);
+	matJ2000ToB1875 = matB1875ToVsop87.transpose() * StelCore::matJ2000ToVsop87;
+}
+
+bool ConstellationBoundaryIndex::load(const QString& boundaryFile)
+{
+	abbreviations.clear();
+	stripStarts.clear();
+	strips.clear();
+	northPole = -1;
+
+	QFile dataFile(boundaryFile);
+	if (!dataFile.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		qWarning() << "Boundary file " << QDir::toNativeSeparators(boundaryFile) << " not found";
+		return false;
+	}
+
+	// Only the arcs of constant declination cross the strips, the arcs of constant right ascension are their limits
+	QVector<BoundaryArc> arcs;
+	QHash<QString, int> ids;
+	QTextStream istr(&dataFile);
+	QVector<double> ra, dec;
+	while (!istr.atEnd())
+	{
+		unsigned num = 0;
+		istr >> num;
+		if (num==0)
+			continue; // empty line
+
+		ra.resize(num);
+		dec.resize(num);
+		double decMin = M_PI, decMax = -M_PI;
+		for (unsigned j=0; j<num; ++j)
+		{
+			double RA, DE;
+			istr >> RA >> DE;
+			Vec3d XYZ;
+			StelUtils::spheToRect(RA*M_PI/12., DE*M_PI/180., XYZ);
+			StelUtils::rectToSphe(&ra[j], &dec[j], matJ2000ToB1875.multiplyWithoutTranslation(XYZ));
+			if (ra[j]<0.)
+				ra[j] += 2.*M_PI;
+			decMin = qMin(decMin, dec[j]);
+			decMax = qMax(decMax, dec[j]);
+		}
+
+		unsigned numc = 0;
+		istr >> numc;
+		QVector<int> cons;
+		for (unsigned j=0; j<numc; ++j)
+		{
+			QString consname;
+			istr >> consname;
+			if (consname == "SER1" || consname == "SER2") consname = "SER";
+			if (!ids.contains(consname))
+			{
+				ids.insert(consname, abbreviations.size());
+				abbreviations << iauAbbreviation(consname);
+			}
+			cons << ids.value(consname);
+		}
+		if (cons.size()!=2 || decMax-decMin>parallelTolerance)
+			continue;
+
+		for (unsigned j=0; j+1<num; ++j)
+		{
+			BoundaryArc arc;
+			arc.dec = 0.5*(dec[j]+dec[j+1]);
+			arc.ra1 = qMin(ra[j], ra[j+1]);
+			arc.ra2 = qMax(ra[j], ra[j+1]);
+			if (arc.ra2-arc.ra1>M_PI)
+			{
+				// The arc crosses 0h
+				const double start = arc.ra2;
+				arc.ra2 = arc.ra1 + 2.*M_PI;
+				arc.ra1 = start;
+			}
+			arc.c1 = cons.at(0);
+			arc.c2 = cons.at(1);
+			arcs << arc;
+		}
+	}
+	dataFile.close();
+	if (arcs.isEmpty())
+	{
+		qWarning() << "No constellation boundary in" << QDir::toNativeSeparators(boundaryFile);
+		return false;
+	}
+
+	// The strips start at the ends of the arcs
+	QVector<double> ends;
+	foreach (const BoundaryArc& arc, arcs)
+		ends << arc.ra1 << (arc.ra2>=2.*M_PI ? arc.ra2-2.*M_PI : arc.ra2);
+	std::sort(ends.begin(), ends.end());
+	foreach (double end, ends)
+	{
+		if (stripStarts.isEmpty() || end-stripStarts.last()>stripTolerance)
+			stripStarts << end;
+	}
+
+	// The arcs crossing the middle of each strip, from north to south
+	QVector<QVector<BoundaryArc> > stripArcs(stripStarts.size());
+	for (int i=0; i<stripStarts.size(); ++i)
+	{
+		const double next = i+1<stripStarts.size() ? stripStarts.at(i+1) : stripStarts.first()+2.*M_PI;
+		double middle = 0.5*(stripStarts.at(i)+next);
+		if (middle>=2.*M_PI)
+			middle -= 2.*M_PI;
+		foreach (const BoundaryArc& arc, arcs)
+		{
+			if (arc.crosses(middle))
+				stripArcs[i] << arc;
+		}
+		std::sort(stripArcs[i].begin(), stripArcs[i].end(), northOf);
+	}
+
+	// The constellation of the north pole is on the first arc south of the pole in every strip
+	QVector<int> poleCandidates;
+	if (!stripArcs.first().isEmpty())
+		poleCandidates << stripArcs.first().first().c1 << stripArcs.first().first().c2;
+	foreach (const QVector<BoundaryArc>& strip, stripArcs)
+	{
+		for (int k=poleCandidates.size()-1; k>=0; --k)
+		{
+			if (strip.isEmpty() || (strip.first().c1!=poleCandidates.at(k) && strip.first().c2!=poleCandidates.at(k)))
+				poleCandidates.remove(k);
+		}
+	}
+	if (poleCandidates.size()!=1)
+	{
+		qWarning() << "Constellation boundaries in" << QDir::toNativeSeparators(boundaryFile) << "are not closed around the north pole";
+		stripStarts.clear();
+		return false;
+	}
+	northPole = poleCandidates.first();
+
+	// Walk each strip from the pole: each arc leads from one of its constellations to the other one
+	strips.resize(stripStarts.size());
+	int inconsistencies = 0;
+	for (int i=0; i<stripArcs.size(); ++i)
+	{
+		int current = northPole;
+		foreach (const BoundaryArc& arc, stripArcs.at(i))
+		{
+			if (current==arc.c1)
+				current = arc.c2;
+			else if (current==arc.c2)
+				current = arc.c1;
+			else
+				++inconsistencies;
+			Crossing crossing;
+			crossing.dec = arc.dec;
+			crossing.south = current;
+			strips[i] << crossing;
+		}
+	}
+	if (inconsistencies>0)
+		qWarning() << "Constellation boundaries in" << QDir::toNativeSeparators(boundaryFile) << "have" << inconsistencies << "inconsistent arcs";
+	return true;
+}
+
+int ConstellationBoundaryIndex::find(const Vec3d& j2000Pos) const
+{
+	if (strips.isEmpty())
+		return -1;
+	double ra, dec;
+	StelUtils::rectToSphe(&ra, &dec, matJ2000ToB1875.multiplyWithoutTranslation(j2000Pos));
+	if (ra<0.)
+		ra += 2.*M_PI;
+	// Before the first strip start is the end of the last strip
+	int i = std::upper_bound(stripStarts.constBegin(), stripStarts.constEnd(), ra) - stripStarts.constBegin() - 1;
+	if (i<0)
+		i = strips.size()-1;
+	int result = northPole;
+	foreach (const Crossing& crossing, strips.at(i))
+	{
+		if (crossing.dec<=dec)
+			break;
+		result = crossing.south;
+	}
+	return result;
+}
+
+QVector<int> ConstellationBoundaryIndex::find(const QVector<Vec3d>& j2000Pos) const
+{
+	QVector<int> result(j2000Pos.size());
+	for (int i=0; i<j2000Pos.size(); ++i)
+		result[i] = find(j2000Pos.at(i));
+	return result;
+}
@@ -0,0 +1,77 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _CONSTELLATIONBOUNDARYINDEX_HPP_
+#define _CONSTELLATIONBOUNDARYINDEX_HPP_
+
+#include "VecMath.hpp"
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+//! @class ConstellationBoundaryIndex
+//! Finds the IAU constellation which contains a direction.
+//! The IAU boundaries are arcs of constant right ascension or declination for the equinox B1875.0
+//! (Delporte, 1930). The boundary file gives them for J2000.0: they are precessed back to B1875.0,
+//! and the sky is cut in strips of right ascension at the ends of the arcs of constant declination.
+//! In each strip, the arcs crossing it are sorted from north to south, each with the constellation
+//! south of it, as in the table of Roman (1987, PASP 99, 695). A lookup finds the strip by binary search,
+//! then the first arc north of the direction.
+class ConstellationBoundaryIndex
+{
+public:
+	ConstellationBoundaryIndex();
+
+	//! Build the index from a file in the format of constellations_boundaries.dat.
+	//! @return false if the file cannot be read or does not describe closed boundaries.
+	bool load(const QString& boundaryFile);
+
+	//! Whether boundaries were loaded.
+	bool isLoaded() const {return !strips.isEmpty();}
+
+	//! Find the constellation containing a direction.
+	//! @param j2000Pos a direction in the J2000 equatorial frame, it does not need to be normalized.
+	//! @return the index of the constellation in getAbbreviations(), or -1 if no boundaries were loaded.
+	int find(const Vec3d& j2000Pos) const;
+
+	//! Find the constellations containing many directions, e.g. to tag a catalogue when it is loaded.
+	//! @param j2000Pos directions in the J2000 equatorial frame.
+	//! @return the index of the constellation of each direction in getAbbreviations().
+	QVector<int> find(const QVector<Vec3d>& j2000Pos) const;
+
+	//! The IAU abbreviations of the constellations, e.g. "UMa".
+	const QStringList& getAbbreviations() const {return abbreviations;}
+
+private:
+	//! An arc of constant declination crossing a strip
+	struct Crossing
+	{
+		double dec;
+		int south;	// constellation south of the arc
+	};
+
+	Mat4d matJ2000ToB1875;
+	QStringList abbreviations;
+	QVector<double> stripStarts;		// B1875.0 right ascension of the start of each strip, in [0, 2pi)
+	QVector<QVector<Crossing> > strips;	// crossings of each strip, from north to south
+	int northPole;				// constellation of the north pole
+};
+
+#endif // _CONSTELLATIONBOUNDARYINDEX_HPP_
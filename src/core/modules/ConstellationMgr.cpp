@@ -132,6 +132,11 @@ void ConstellationMgr::init()
 	setBoundariesColor(StelUtils::strToVec3f(conf->value("color/const_boundary_color", "0.8,0.3,0.3").toString()));
 	setLabelsColor(StelUtils::strToVec3f(conf->value("color/const_names_color", defaultColor).toString()));
 
+	// The IAU constellation of a position does not depend on the sky culture
+	const QString iauBoundaryFile = StelFileMgr::findFile("data/constellations_boundaries.dat");
+	if (!iauBoundaryFile.isEmpty())
+		iauBoundaries.load(iauBoundaryFile);
+
 	StelObjectMgr *objectManager = GETSTELMODULE(StelObjectMgr);
 	objectManager->registerStelObjectMgr(this);
 	connect(objectManager, SIGNAL(selectedObjectChanged(StelModule::StelModuleSelectAction)), 
@@ -1316,6 +1321,21 @@ bool ConstellationMgr::loadBoundaries(const QString& boundaryFile)
 	return true;
 }
 
+QString ConstellationMgr::getIAUConstellation(const Vec3d& j2000Pos) const
+{
+	const int c = iauBoundaries.find(j2000Pos);
+	return c<0 ? QString() : iauBoundaries.getAbbreviations().at(c);
+}
+
+QStringList ConstellationMgr::getIAUConstellations(const QVector<Vec3d>& j2000Pos) const
+{
+	QStringList result;
+	result.reserve(j2000Pos.size());
+	foreach (int c, iauBoundaries.find(j2000Pos))
+		result << (c<0 ? QString() : iauBoundaries.getAbbreviations().at(c));
+	return result;
+}
+
 void ConstellationMgr::drawBoundaries(StelPainter& sPainter) const
 {
 	sPainter.enableTexture2d(false);
@@ -24,6 +24,7 @@
 #include "StelObjectType.hpp"
 #include "StelObjectModule.hpp"
 #include "StelProjectorType.hpp"
+#include "ConstellationBoundaryIndex.hpp"
 
 #include <vector>
 #include <QString>
@@ -217,6 +218,15 @@ public slots:
 	//! Get whether only one selected constellation is displayed
 	bool getFlagConstellationPick(void) const;
 
+	//! Get the IAU constellation which contains a direction, whatever the sky culture.
+	//! @param j2000Pos a direction in the J2000 equatorial frame.
+	//! @return the IAU abbreviation of the constellation, e.g. "UMa", or an empty string if the IAU boundaries are not available.
+	QString getIAUConstellation(const Vec3d& j2000Pos) const;
+	//! Get the IAU constellations of many directions, e.g. to tag the objects of a catalogue when it is loaded.
+	//! @param j2000Pos directions in the J2000 equatorial frame.
+	//! @return the IAU abbreviation of the constellation of each direction.
+	QStringList getIAUConstellations(const QVector<Vec3d>& j2000Pos) const;
+
 	//! Define line color
 	//! @param color The color of lines
 	//! @code
@@ -371,6 +381,8 @@ private:
 	bool isolateSelected; // true to pick individual constellations.
 	bool constellationPickEnabled;
 	std::vector<std::vector<Vec3f> *> allBoundarySegments;
+	//! The IAU boundaries, for the constellation of a position
+	ConstellationBoundaryIndex iauBoundaries;
 
 	QString lastLoadedSkyCulture;	// Store the last loaded sky culture directory name
 
@@ -840,6 +840,7 @@ void SkyLine::draw(StelCore *core) const
 }
 
 GridLinesMgr::GridLinesMgr()
+	: flagLineBatch(true)
 {
 	setObjectName("GridLinesMgr");
 	equGrid = new SkyGrid(StelCore::FrameEquinoxEqu);
@@ -923,6 +924,7 @@ void GridLinesMgr::init()
 	setFlagPrimeVerticalLine(conf->value("viewing/flag_prime_vertical_line").toBool());
 	setFlagColureLines(conf->value("viewing/flag_colure_lines").toBool());
 	setFlagCircumpolarCircles(conf->value("viewing/flag_circumpolar_circles").toBool());
+	setFlagLineBatch(conf->value("viewing/flag_grid_line_batch", true).toBool());
 
 	// Load colors from config file
 	QString defaultColor = conf->value("color/default_color").toString();
@@ -997,6 +999,11 @@ void GridLinesMgr::update(double deltaTime)
 
 void GridLinesMgr::draw(StelCore* core)
 {
+	// Collect the lines of all grids and lines, and draw them in one call at the end.
+	// The labels are drawn while the lines are collected.
+	if (flagLineBatch)
+		StelPainter::beginLineBatch();
+
 	galacticGrid->draw(core);
 	eclJ2000Grid->draw(core);
 	// While ecliptic of J2000 may be helpful to get a feeling of the Z=0 plane of VSOP87,
@@ -1026,6 +1033,24 @@ void GridLinesMgr::draw(StelCore* core)
 	primeVerticalLine->draw(core);
 	circumpolarCircleN->draw(core);
 	circumpolarCircleS->draw(core);
+	if (!flagLineBatch)
+		return;
+
+	// The lines are in window coordinates
+	StelPainter sPainter(core->getProjection2d());
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal transparency mode
+	// OpenGL ES 2.0 doesn't have GL_LINE_SMOOTH
+	#ifdef GL_LINE_SMOOTH
+	if (QOpenGLContext::currentContext()->format().renderableType()==QSurfaceFormat::OpenGL)
+		glEnable(GL_LINE_SMOOTH);
+	#endif
+	sPainter.endLineBatch();
+	#ifdef GL_LINE_SMOOTH
+	if (QOpenGLContext::currentContext()->format().renderableType()==QSurfaceFormat::OpenGL)
+		glDisable(GL_LINE_SMOOTH);
+	#endif
+	glDisable(GL_BLEND);
 }
 
 void GridLinesMgr::updateLineLabels()
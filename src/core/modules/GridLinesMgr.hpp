@@ -487,6 +487,11 @@ public slots:
 	//! @endcode
 	void setColorCircumpolarCircles(const Vec3f& newColor);
 
+	//! Set whether the lines of all grids and great circles are drawn in one call, or each arc in its own call.
+	void setFlagLineBatch(const bool batch) {flagLineBatch=batch;}
+	//! Get whether the lines of all grids and great circles are drawn in one call.
+	bool getFlagLineBatch(void) const {return flagLineBatch;}
+
 
 signals:
 	void azimuthalGridDisplayedChanged(const bool) const;
@@ -553,6 +558,7 @@ private:
 	SkyLine * colureLine_2;		// Second Colure line (6/18h)
 	SkyLine * circumpolarCircleN;	// Northern circumpolar circle
 	SkyLine * circumpolarCircleS;	// Southern circumpolar circle
+	bool flagLineBatch;		// Draw all the lines in one call
 };
 
 #endif // _GRIDLINESMGR_HPP_
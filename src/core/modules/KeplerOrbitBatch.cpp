@@ -0,0 +1,293 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include "KeplerOrbitBatch.hpp"
+#include "Orbit.hpp"
+#include "StelUtils.hpp"
+
+#include <cmath>
+#include <QtConcurrent>
+
+// Number of orbits solved by one thread in one go
+static const int chunkSize = 1024;
+// Below this number of orbits, the batch is computed in the calling thread
+static const int minParallelOrbits = 4*chunkSize;
+
+// Same as sign() in Orbit.cpp
+static inline double signOf(const double x)
+{
+	return x<0. ? -1. : (x>0. ? 1. : 0.);
+}
+
+// Eccentric anomaly for mean anomaly M, with the same iterations as EllipticalOrbit::eccentricAnomaly().
+// The loops have a fixed count, so the compiler can unroll them and the solution of all orbits
+// of a group takes the same path.
+template<int method> static inline double eccentricAnomaly(const double e, const double M);
+
+template<> inline double eccentricAnomaly<0>(const double e, const double M)
+{
+	double E = M;
+	for (int k=0; k<5; ++k)
+		E = M + e*sin(E);
+	return E;
+}
+
+template<> inline double eccentricAnomaly<1>(const double e, const double M)
+{
+	double E = M;
+	for (int k=0; k<6; ++k)
+		E = E + (M + e*sin(E) - E) / (1 - e*cos(E));
+	return E;
+}
+
+template<> inline double eccentricAnomaly<2>(const double e, const double M)
+{
+	double E = M + 0.85*e*signOf(sin(M));
+	for (int k=0; k<8; ++k)
+	{
+		const double s = e*sin(E);
+		const double c = e*cos(E);
+		const double f = E - s - M;
+		const double f1 = 1 - c;
+		const double f2 = s;
+		E += -5*f / (f1 + signOf(f1)*std::sqrt(fabs(16*f1*f1 - 20*f*f2)));
+	}
+	return E;
+}
+
+template<int method> static void solveRange(const double* M0, const double* n, const double* epoch,
+					     const double* e, const double* a, const double* b,
+					     const double* r00, const double* r01, const double* r10,
+					     const double* r11, const double* r20, const double* r21,
+					     const int begin, const int end, const double commonJDE, const double* t,
+					     double* x, double* y, double* z)
+{
+	for (int i=begin; i<end; ++i)
+	{
+		const double JDE = t ? t[i] : commonJDE;
+		const double E = eccentricAnomaly<method>(e[i], M0[i] + (JDE-epoch[i])*n[i]);
+		// position in the orbit plane, x towards pericenter
+		const double px = a[i]*(cos(E) - e[i]);
+		const double py = b[i]*sin(E);
+		x[i] = r00[i]*px + r01[i]*py;
+		y[i] = r10[i]*px + r11[i]*py;
+		z[i] = r20[i]*px + r21[i]*py;
+	}
+}
+
+struct KeplerOrbitBatch::ChunkSolver
+{
+	ChunkSolver(KeplerOrbitBatch* batch, bool lightTimePass) : batch(batch), lightTimePass(lightTimePass) {}
+	void operator()(const Chunk& c) const
+	{
+		Group& g = batch->groups[c.method];
+		if (lightTimePass)
+		{
+			// Same correction as in SolarSystem::computePositions(). The Sun is the parent, so the results are heliocentric.
+			double* t1 = g.t1.data();
+			for (int i=c.begin; i<c.end; ++i)
+				t1[i] = batch->commonJDE - (Vec3d(g.x0.at(i), g.y0.at(i), g.z0.at(i))-batch->observerPos).length() * (AU / (SPEED_OF_LIGHT * 86400));
+			solve(c.method, g, c.begin, c.end, batch->commonJDE, t1, g.x1.data(), g.y1.data(), g.z1.data());
+		}
+		else
+			solve(c.method, g, c.begin, c.end, batch->commonJDE, NULL, g.x0.data(), g.y0.data(), g.z0.data());
+	}
+	KeplerOrbitBatch* batch;
+	bool lightTimePass;
+};
+
+KeplerOrbitBatch::KeplerOrbitBatch()
+	: commonJDE(0.)
+	, commonComputed(false)
+	, lightTimeComputed(false)
+{
+}
+
+KeplerOrbitBatch::~KeplerOrbitBatch()
+{
+	clear();
+}
+
+bool KeplerOrbitBatch::add(EllipticalOrbit* orbit)
+{
+	const double e = orbit->eccentricity;
+	if (e<0. || e>=1.)
+		return false;
+
+	const Method method = e<0.2 ? FixedPoint : (e<0.9 ? Newton : LaguerreConway);
+	Group& g = groups[method];
+
+	// Rotation from the orbit plane to the parent's equator (as in EllipticalOrbit::positionAtE()),
+	// followed by the rotation to VSOP87. Only the first two columns are needed, the orbit is in the XY plane.
+	const Mat4d R = Mat4d::zrotation(orbit->ascendingNode) * Mat4d::xrotation(orbit->inclination) * Mat4d::zrotation(orbit->argOfPeriapsis);
+	const double* rot = orbit->rotateToVsop87;
+	double c[3][2];
+	for (int row=0; row<3; ++row)
+	{
+		c[row][0] = rot[row*3]*R.r[0] + rot[row*3+1]*R.r[1] + rot[row*3+2]*R.r[2];
+		c[row][1] = rot[row*3]*R.r[4] + rot[row*3+1]*R.r[5] + rot[row*3+2]*R.r[6];
+	}
+
+	const double a = orbit->pericenterDistance / (1.0 - e);
+	g.meanAnomalyAtEpoch.append(orbit->meanAnomalyAtEpoch);
+	g.meanMotion.append(2.0 * M_PI / orbit->period);
+	g.epoch.append(orbit->epoch);
+	g.e.append(e);
+	g.a.append(a);
+	g.b.append(a * std::sqrt(1 - e * e));
+	g.r00.append(c[0][0]);
+	g.r01.append(c[0][1]);
+	g.r10.append(c[1][0]);
+	g.r11.append(c[1][1]);
+	g.r20.append(c[2][0]);
+	g.r21.append(c[2][1]);
+	const int slot = g.e.size();
+	g.x0.resize(slot);
+	g.y0.resize(slot);
+	g.z0.resize(slot);
+	g.t1.resize(slot);
+	g.x1.resize(slot);
+	g.y1.resize(slot);
+	g.z1.resize(slot);
+
+	orbits.append(orbit);
+	orbitMethod.append(method);
+	orbitSlot.append(slot-1);
+	chunks.clear();
+	// The new orbit has no results yet
+	commonComputed = false;
+	lightTimeComputed = false;
+	return true;
+}
+
+void KeplerOrbitBatch::clear()
+{
+	orbits.clear();
+	orbitMethod.clear();
+	orbitSlot.clear();
+	for (int m=0; m<MethodCount; ++m)
+		groups[m] = Group();
+	chunks.clear();
+	commonComputed = false;
+	lightTimeComputed = false;
+}
+
+void KeplerOrbitBatch::compute(double JDE)
+{
+	commonJDE = JDE;
+	lightTimeComputed = false;
+	run(false);
+	commonComputed = true;
+}
+
+void KeplerOrbitBatch::computeWithLightTime(double JDE, const Vec3d& observerPos)
+{
+	commonJDE = JDE;
+	lightTimeComputed = false;
+	run(false);
+	commonComputed = true;
+	this->observerPos = observerPos;
+	run(true);
+	lightTimeComputed = true;
+}
+
+bool KeplerOrbitBatch::getPosition(int index, Pass pass, double* v) const
+{
+	if (index<0 || index>=orbits.size())
+		return false;
+	const Group& g = groups[orbitMethod[index]];
+	const int i = orbitSlot[index];
+	if (pass==CommonPass && commonComputed)
+	{
+		v[0] = g.x0[i];
+		v[1] = g.y0[i];
+		v[2] = g.z0[i];
+		return true;
+	}
+	if (pass==LightTimePass && lightTimeComputed)
+	{
+		v[0] = g.x1[i];
+		v[1] = g.y1[i];
+		v[2] = g.z1[i];
+		return true;
+	}
+	return false;
+}
+
+void KeplerOrbitBatch::solve(Method method, Group& g, int begin, int end, double commonJDE, const double* t, double* x, double* y, double* z)
+{
+	Q_ASSERT(begin>=0 && end<=g.e.size());
+	switch (method)
+	{
+		case FixedPoint:
+			solveRange<0>(g.meanAnomalyAtEpoch.constData(), g.meanMotion.constData(), g.epoch.constData(),
+				      g.e.constData(), g.a.constData(), g.b.constData(),
+				      g.r00.constData(), g.r01.constData(), g.r10.constData(),
+				      g.r11.constData(), g.r20.constData(), g.r21.constData(),
+				      begin, end, commonJDE, t, x, y, z);
+			break;
+		case Newton:
+			solveRange<1>(g.meanAnomalyAtEpoch.constData(), g.meanMotion.constData(), g.epoch.constData(),
+				      g.e.constData(), g.a.constData(), g.b.constData(),
+				      g.r00.constData(), g.r01.constData(), g.r10.constData(),
+				      g.r11.constData(), g.r20.constData(), g.r21.constData(),
+				      begin, end, commonJDE, t, x, y, z);
+			break;
+		case LaguerreConway:
+			solveRange<2>(g.meanAnomalyAtEpoch.constData(), g.meanMotion.constData(), g.epoch.constData(),
+				      g.e.constData(), g.a.constData(), g.b.constData(),
+				      g.r00.constData(), g.r01.constData(), g.r10.constData(),
+				      g.r11.constData(), g.r20.constData(), g.r21.constData(),
+				      begin, end, commonJDE, t, x, y, z);
+			break;
+		default:
+			Q_ASSERT(0);
+	}
+}
+
+void KeplerOrbitBatch::run(bool lightTimePass)
+{
+	if (orbits.isEmpty())
+		return;
+
+	if (chunks.isEmpty())
+	{
+		for (int m=0; m<MethodCount; ++m)
+		{
+			const int count = groups[m].e.size();
+			for (int begin=0; begin<count; begin+=chunkSize)
+			{
+				Chunk c;
+				c.method = (Method)m;
+				c.begin = begin;
+				c.end = qMin(begin+chunkSize, count);
+				chunks.append(c);
+			}
+		}
+	}
+
+	const ChunkSolver solver(this, lightTimePass);
+	if (orbits.size()<minParallelOrbits)
+	{
+		foreach (const Chunk& c, chunks)
+			solver(c);
+	}
+	else
+		QtConcurrent::blockingMap(chunks, solver);
+}
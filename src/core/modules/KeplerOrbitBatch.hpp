@@ -0,0 +1,124 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _KEPLERORBITBATCH_HPP_
+#define _KEPLERORBITBATCH_HPP_
+
+#include "VecMath.hpp"
+
+#include <QVector>
+
+class EllipticalOrbit;
+
+//! @class KeplerOrbitBatch
+//! Evaluates many heliocentric elliptical orbits in one pass.
+//! The orbital elements are stored as structure of arrays, grouped by the method used
+//! by EllipticalOrbit::eccentricAnomaly(), so that each group is solved in a branch-free loop
+//! with the same fixed number of iterations as the per-object code. The rotations into VSOP87
+//! coordinates are combined into one matrix per orbit when it is added.
+//! The results are read by the index of the orbit and the pass which computed them, not by their date:
+//! SolarSystem gives them to the Planets computed for the date of the pass.
+//! @note compute() must not run concurrently with getPosition().
+class KeplerOrbitBatch
+{
+public:
+	KeplerOrbitBatch();
+	~KeplerOrbitBatch();
+
+	//! The results of a computation.
+	enum Pass
+	{
+		CommonPass,	//!< the positions for the date of compute() or computeWithLightTime()
+		LightTimePass	//!< the positions for the dates corrected for the light time by computeWithLightTime()
+	};
+
+	//! Add an orbit around the Sun. The orbit must outlive the batch or be removed by clear().
+	//! @return false if the orbit is not elliptical. It then keeps using the per-object path.
+	//! Otherwise its index in the batch is size()-1.
+	bool add(EllipticalOrbit* orbit);
+	//! Remove all orbits from the batch.
+	void clear();
+	//! Number of orbits in the batch.
+	int size() const {return orbits.size();}
+
+	//! Compute the positions of all orbits for JDE.
+	void compute(double JDE);
+	//! Compute the positions of all orbits for JDE and, in a second pass, for JDE corrected
+	//! for the light travel time to an observer at observerPos (heliocentric ecliptic, AU).
+	//! The corrected dates are the same as those computed by SolarSystem::computePositions().
+	void computeWithLightTime(double JDE, const Vec3d& observerPos);
+
+	//! Get the position of orbit number index in VSOP87 coordinates computed by a pass of the last computation.
+	//! @return false if the pass was not computed, e.g. the light time corrected pass after compute().
+	bool getPosition(int index, Pass pass, double* v) const;
+
+private:
+	KeplerOrbitBatch(const KeplerOrbitBatch&);
+	const KeplerOrbitBatch &operator=(const KeplerOrbitBatch&);
+
+	//! Method for solving Kepler's equation, as chosen by EllipticalOrbit::eccentricAnomaly()
+	enum Method
+	{
+		FixedPoint,	//!< e<0.2: 5 iterations of E=M+e*sin(E)
+		Newton,		//!< e<0.9: 6 Newton iterations
+		LaguerreConway,	//!< e<1: 8 Laguerre-Conway iterations
+		MethodCount
+	};
+
+	//! Elements and results of all orbits using the same method.
+	struct Group
+	{
+		// Elements
+		QVector<double> meanAnomalyAtEpoch, meanMotion, epoch;
+		QVector<double> e, a, b;            // eccentricity, semi-major and semi-minor axis
+		QVector<double> r00, r01, r10, r11, r20, r21; // rotation from the orbit plane into VSOP87
+		// Result of the pass for the common date
+		QVector<double> x0, y0, z0;
+		// Dates and result of the light time corrected pass
+		QVector<double> t1, x1, y1, z1;
+	};
+
+	//! A range of one group computed by one thread.
+	struct Chunk
+	{
+		Method method;
+		int begin;
+		int end;
+	};
+
+	struct ChunkSolver;
+
+	//! Solve the orbits of group method in [begin, end) for the dates t (or commonJDE if t is NULL), writing to x, y, z.
+	static void solve(Method method, Group& g, int begin, int end, double commonJDE, const double* t, double* x, double* y, double* z);
+	//! Run the common date pass or the light time corrected pass over all chunks.
+	void run(bool lightTimePass);
+
+	QVector<EllipticalOrbit*> orbits;
+	QVector<int> orbitMethod;  // group of each orbit
+	QVector<int> orbitSlot;    // index in the group of each orbit
+	Group groups[MethodCount];
+	QVector<Chunk> chunks;
+
+	double commonJDE;       // date of the x0, y0, z0 results, and origin of the light time correction
+	bool commonComputed;    // x0, y0, z0 are valid
+	bool lightTimeComputed; // t1, x1, y1, z1 are valid
+	Vec3d observerPos;      // for the light time corrected pass
+};
+
+#endif // _KEPLERORBITBATCH_HPP_
@@ -89,9 +89,9 @@ void MilkyWay::draw(StelCore* core)
 	if (!getFlagShow())
 		return;
 
-	StelProjector::ModelViewTranformP transfo = core->getJ2000ModelViewTransform();
-
-	const StelProjectorP prj = core->getProjection(transfo); // GZ: Maybe this can now be simplified?
+	// Without refraction, the retained geometry is projected by the GPU in the perspective and
+	// orthographic projections. Refraction is not visible on the diffuse Milky Way.
+	const StelProjectorP prj = core->getProjection(StelCore::FrameJ2000, StelCore::RefractionOff);
 	StelToneReproducer* eye = core->getToneReproducer();
 	StelSkyDrawer *drawer=core->getSkyDrawer();
 
@@ -161,10 +161,14 @@ void MilkyWay::draw(StelCore* core)
 		vertexArray->colors.fill(Vec3f(c[0], c[1], c[2]));
 
 	StelPainter sPainter(prj);
+	if (geometry.isNull())
+		geometry = StelPainter::createRetainedGeometry(*vertexArray);
+	else
+		geometry->setColors(vertexArray->colors); // only uploaded when they changed
 	glEnable(GL_CULL_FACE);
 	sPainter.enableTexture2d(true);
 	glDisable(GL_BLEND);
 	tex->bind();
-	sPainter.drawStelVertexArray(*vertexArray);
+	sPainter.drawRetainedGeometry(geometry);
 	glDisable(GL_CULL_FACE);
 }
@@ -23,6 +23,7 @@
 #include "StelModule.hpp"
 #include "VecMath.hpp"
 #include "StelTextureTypes.hpp"
+#include "StelPainter.hpp"
 
 //! @class MilkyWay 
 //! Manages the displaying of the Milky Way.
@@ -89,6 +90,8 @@ private:
 	class LinearFader* fader;
 
 	struct StelVertexArray* vertexArray;
+	//! The vertex array in GPU buffers, created at the first draw
+	StelPainter::RetainedGeometryP geometry;
 };
 
 #endif // _MILKYWAY_HPP_
@@ -580,23 +580,11 @@ void NebulaMgr::loadNebulaSet(const QString& setName)
 // Look for a nebulae by XYZ coords
 NebulaP NebulaMgr::search(const Vec3d& apos)
 {
-	Vec3d pos = apos;
-	pos.normalize();
-	NebulaP plusProche;
-	float anglePlusProche=0.0f;
-	foreach (const NebulaP& n, dsoArray)
-	{
-		if (n->XYZ*pos>anglePlusProche)
-		{
-			anglePlusProche=n->XYZ*pos;
-			plusProche=n;
-		}
-	}
-	if (anglePlusProche>0.999f)
-	{
-		return plusProche;
-	}
-	else return NebulaP();
+	// The nearest nebula, if it is within acos(0.999) of the position
+	const QVector<StelRegionObjectP> nearest = nebGrid.findNearestPoints(apos, 1, acos(0.999));
+	if (nearest.isEmpty())
+		return NebulaP();
+	return qSharedPointerCast<Nebula>(nearest.first());
 }
 
 
@@ -609,16 +597,8 @@ QList<StelObjectP> NebulaMgr::searchAround(const Vec3d& av, double limitFov, con
 	Vec3d v(av);
 	v.normalize();
 	double cosLimFov = cos(limitFov * M_PI/180.);
-	Vec3d equPos;
-	foreach (const NebulaP& n, dsoArray)
-	{
-		equPos = n->XYZ;
-		equPos.normalize();
-		if (equPos*v>=cosLimFov)
-		{
-			result.push_back(qSharedPointerCast<StelObject>(n));
-		}
-	}
+	foreach (const StelRegionObjectP& n, nebGrid.findPointsInCap(SphericalCap(v, cosLimFov)))
+		result.push_back(qSharedPointerCast<StelObject>(n));
 	return result;
 }
 
@@ -1192,6 +1172,62 @@ void NebulaMgr::updateI18n()
 	const StelTranslator& trans = StelApp::getInstance().getLocaleMgr().getSkyTranslator();
 	foreach (NebulaP n, dsoArray)
 		n->translateName(trans);
+	updateNameIndex();
+}
+
+void NebulaMgr::updateNameIndex() const
+{
+	QVector<StelObjectNameIndex::Entry> english, translated;
+	for (int i=0; i<dsoArray.size(); ++i)
+	{
+		const NebulaP& n = dsoArray.at(i);
+		const float mag = qMin(n->vMag, n->bMag);
+		// The index ignores the space between a catalogue and a number, so "M31" finds "M 31"
+		QStringList designations;
+		if (n->M_nb>0)
+			designations << QString("M %1").arg(n->M_nb);
+		if (n->NGC_nb>0)
+			designations << QString("NGC %1").arg(n->NGC_nb);
+		if (n->IC_nb>0)
+			designations << QString("IC %1").arg(n->IC_nb);
+		if (n->C_nb>0)
+			designations << QString("C %1").arg(n->C_nb);
+		if (n->B_nb>0)
+			designations << QString("B %1").arg(n->B_nb);
+		if (n->Sh2_nb>0)
+			designations << QString("SH 2-%1").arg(n->Sh2_nb);
+		if (n->VdB_nb>0)
+			designations << QString("VdB %1").arg(n->VdB_nb);
+		if (n->RCW_nb>0)
+			designations << QString("RCW %1").arg(n->RCW_nb);
+		if (n->LDN_nb>0)
+			designations << QString("LDN %1").arg(n->LDN_nb);
+		if (n->LBN_nb>0)
+			designations << QString("LBN %1").arg(n->LBN_nb);
+		if (n->Cr_nb>0)
+			designations << QString("Cr %1").arg(n->Cr_nb);
+		if (n->Mel_nb>0)
+			designations << QString("Mel %1").arg(n->Mel_nb);
+		if (n->PGC_nb>0)
+			designations << QString("PGC %1").arg(n->PGC_nb);
+		if (n->UGC_nb>0)
+			designations << QString("UGC %1").arg(n->UGC_nb);
+		if (!n->Ced_nb.trimmed().isEmpty())
+			designations << QString("Ced %1").arg(n->Ced_nb.trimmed());
+		foreach (const QString& designation, designations)
+		{
+			english << StelObjectNameIndex::Entry(designation, mag, i);
+			translated << StelObjectNameIndex::Entry(designation, mag, i);
+		}
+		if (!n->englishName.isEmpty())
+			english << StelObjectNameIndex::Entry(n->englishName, mag, i);
+		if (!n->nameI18.isEmpty())
+			translated << StelObjectNameIndex::Entry(n->nameI18, mag, i);
+	}
+
+	StelObjectNameIndex& index = StelApp::getInstance().getStelObjectMgr().getNameIndex();
+	index.setNames(objectName(), true, english);
+	index.setNames(objectName(), false, translated);
 }
 
 
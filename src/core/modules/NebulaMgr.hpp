@@ -563,6 +563,9 @@ private slots:
 
 private:
 
+	//! Set the names and catalogue designations of the nebulae in the name index of the StelObjectMgr.
+	void updateNameIndex() const;
+
 	//! Search for a nebula object by name. e.g. M83, NGC 1123, IC 1234.
 	NebulaP search(const QString& name);
 
@@ -516,6 +516,13 @@ double EllipticalOrbit::getPeriod() const
 }
 
 
+double EllipticalOrbit::getParentGM() const
+{
+	const double a = pericenterDistance / (1.0 - eccentricity);
+	return 4.0*M_PI*M_PI*a*a*a/(period*period);
+}
+
+
 double EllipticalOrbit::getBoundingRadius() const
 {
 	// TODO: watch out for unbounded parabolic and hyperbolic orbits
@@ -24,6 +24,8 @@ class Orbit
 public:
     Orbit(void) {}
     virtual ~Orbit(void) {}
+    //! Gravitational parameter GM of the parent body [AU^3/day^2], as given by the elements, or 0 if they do not give it.
+    virtual double getParentGM() const {return 0.;}
 private:
     Orbit(const Orbit&);
     const Orbit &operator=(const Orbit&);
@@ -57,6 +59,8 @@ public:
 	Vec3d positionAtTime(const double JDE) const;
 	double getPeriod() const;
 	double getBoundingRadius() const;
+	//! From the semi-major axis and the period, with Kepler's third law.
+	virtual double getParentGM() const;
 	virtual void sample(double, double, int, OrbitSampleProc&) const;
 
 private:
@@ -73,6 +77,8 @@ private:
 	double period;
 	double epoch;
 	double rotateToVsop87[9];
+
+	friend class KeplerOrbitBatch;
 };
 
 
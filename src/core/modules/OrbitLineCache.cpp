@@ -0,0 +1,282 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include "OrbitLineCache.hpp"
+
+#include <cmath>
+#include <limits>
+
+// Number of samples of one cached window
+static const int windowSamples = 30;
+// A segment is split in two while its midpoint is further than this fraction of its length from the chord
+static const double refineTolerance = 0.02;
+// Segments are only refined next to a turn of more than 9 degrees, about the same curvature as refineTolerance
+static const double cosMaxTurn = 0.9877;
+// A segment is split in at most 2^maxRefineDepth parts
+static const int maxRefineDepth = 4;
+// GM of the Sun, same as in Orbit.cpp. The mass of the body is ignored.
+static const double gaussGravConst = 0.01720209895*0.01720209895;
+// Step of the finite difference for the velocity of fitted osculating orbits [days], short enough for the inner moons
+static const double velocityStep = 0.001;
+// Angle travelled along the osculating orbit in the step of the finite differences of its positions
+static const double osculatingStepAngle = 0.01;
+// Number of cached osculating elements, for the epochs of the recent dates
+static const int maxEllipses = 64;
+
+// Index of the window containing sample number index, rounded towards minus infinity
+static inline qint64 windowIndex(const qint64 index)
+{
+	return index>=0 ? index/windowSamples : -((-index-1)/windowSamples)-1;
+}
+
+OrbitLineCache::OrbitLineCache(int maxPoints)
+	: windows(maxPoints)
+	, ellipses(maxEllipses)
+	, step(0.)
+	, osculating(false)
+	, epochIndex(std::numeric_limits<qint64>::min())
+{
+	ellipse.valid = false;
+}
+
+double OrbitLineCache::Sampler::getParentGM() const
+{
+	return gaussGravConst;
+}
+
+qint64 OrbitLineCache::sampleIndex(double JDE, double step)
+{
+	return (qint64)std::floor(JDE/step);
+}
+
+void OrbitLineCache::clear()
+{
+	windows.clear();
+	ellipses.clear();
+	epochIndex = std::numeric_limits<qint64>::min();
+	ellipse.valid = false;
+}
+
+int OrbitLineCache::getLine(const Sampler& sampler, double JDE, double step, int segments, bool close, bool osculating, QVector<Vec3d>& points)
+{
+	points.clear();
+	if (step<=0. || segments<2)
+		return 0;
+
+	if (step!=this->step || osculating!=this->osculating)
+	{
+		clear();
+		this->step = step;
+		this->osculating = osculating;
+	}
+
+	const qint64 current = sampleIndex(JDE, step);
+	if (osculating && current!=epochIndex)
+	{
+		// The elements change with the epoch, so do all points. They are evaluated
+		// from the elements, which are only computed once for each epoch.
+		windows.clear();
+		setEllipse(sampler, current);
+	}
+
+	const qint64 first = current - segments/2;
+	const qint64 last = first + segments - 1;
+	int currentPoint = 0;
+	points.reserve(segments+1);
+	for (qint64 w=windowIndex(first); w<=windowIndex(last); ++w)
+	{
+		Window* win = windows.object(w);
+		const bool cached = win!=NULL;
+		if (!cached)
+			win = computeWindow(sampler, w);
+
+		const qint64 base = w*windowSamples;
+		const int from = (int)(qMax(first, base) - base);
+		const int to = (int)(qMin(last, base+windowSamples-1) - base);
+		for (int s=from; s<=to; ++s)
+		{
+			if (base+s==current)
+				currentPoint = points.size();
+			const int begin = win->sampleIndex.at(s);
+			// The refinement after the last sample is only needed to close the line
+			const int end = (base+s==last && !close) ? begin+1 : win->sampleIndex.at(s+1);
+			for (int i=begin; i<end; ++i)
+				points.append(win->points.at(i));
+		}
+
+		// Inserted after use, as the cache deletes a window which exceeds its size
+		if (!cached)
+			windows.insert(w, win, win->points.size());
+	}
+	if (close)
+		points.append(points.first());
+	return currentPoint;
+}
+
+Vec3d OrbitLineCache::positionAt(const Sampler& sampler, double JDE) const
+{
+	if (!osculating)
+		return sampler.positionAt(JDE);
+	if (!ellipse.valid)
+	{
+		Vec3d pos;
+		if (sampler.osculatingPositionAt(epochIndex*step, JDE, pos))
+			return pos;
+		return sampler.positionAt(JDE);
+	}
+
+	const double e = ellipse.e;
+	const double M = ellipse.meanAnomaly + (JDE-ellipse.epoch)*ellipse.meanMotion;
+	double E = M;
+	for (int k=0; k<10; ++k)
+	{
+		const double dE = (M + e*std::sin(E) - E) / (1 - e*std::cos(E));
+		E += dE;
+		if (std::fabs(dE)<1e-12)
+			break;
+	}
+	return ellipse.p*(ellipse.a*(std::cos(E)-e)) + ellipse.q*(ellipse.a*std::sqrt(1-e*e)*std::sin(E));
+}
+
+void OrbitLineCache::setEllipse(const Sampler& sampler, qint64 index)
+{
+	epochIndex = index;
+	const Ellipse* cached = ellipses.object(index);
+	if (cached)
+	{
+		ellipse = *cached;
+		return;
+	}
+	if (!computeOsculatingEllipse(sampler, index*step, ellipse))
+		computeEllipse(sampler, index*step, ellipse);
+	ellipses.insert(index, new Ellipse(ellipse));
+}
+
+void OrbitLineCache::computeEllipse(const Sampler& sampler, double epoch, Ellipse& ellipse)
+{
+	const Vec3d r = sampler.positionAt(epoch);
+	const Vec3d v = (sampler.positionAt(epoch+velocityStep) - sampler.positionAt(epoch-velocityStep)) * (0.5/velocityStep);
+	fitEllipse(r, v, sampler.getParentGM(), epoch, ellipse);
+}
+
+bool OrbitLineCache::computeOsculatingEllipse(const Sampler& sampler, double epoch, Ellipse& ellipse)
+{
+	Vec3d r;
+	if (!sampler.osculatingPositionAt(epoch, epoch, r))
+		return false;
+	// The osculating function only gives positions: the velocity and the acceleration, hence the GM
+	// of the osculating orbit, are taken from 4 more positions, by finite differences of the 4th order.
+	// The step is a small angle along the orbit, estimated from the parent GM.
+	const double rl = r.length();
+	const double h = osculatingStepAngle/std::sqrt(sampler.getParentGM()/(rl*rl*rl));
+	if (!(h>0. && h<std::numeric_limits<double>::max()))
+	{
+		// No parent GM: the points are taken from the osculating function
+		ellipse.valid = false;
+		return true;
+	}
+	Vec3d rp1, rm1, rp2, rm2;
+	sampler.osculatingPositionAt(epoch, epoch+h, rp1);
+	sampler.osculatingPositionAt(epoch, epoch-h, rm1);
+	sampler.osculatingPositionAt(epoch, epoch+2.*h, rp2);
+	sampler.osculatingPositionAt(epoch, epoch-2.*h, rm2);
+	const Vec3d v = (rm2 - rp2 + (rp1 - rm1)*8.) * (1./(12.*h));
+	const Vec3d acc = (rp1 + rm1)*16. - rp2 - rm2 - r*30.;
+	// The acceleration is -GM*r/|r|^3
+	double gm = -acc.dot(r)*rl/(12.*h*h);
+	if (!(gm>0.))
+		gm = sampler.getParentGM();
+	fitEllipse(r, v, gm, epoch, ellipse);
+	return true;
+}
+
+void OrbitLineCache::fitEllipse(const Vec3d& r, const Vec3d& v, double gm, double epoch, Ellipse& ellipse)
+{
+	ellipse.valid = false;
+	const double rl = r.length();
+	const Vec3d h = r^v;
+	const double a = 1./(2./rl - v.dot(v)/gm);
+	if (!(a>0.) || h.length()<=0.)
+		return; // not an ellipse: use the sampler
+
+	const Vec3d eVec = (v^h)*(1./gm) - r*(1./rl);
+	const double e = eVec.length();
+	if (!(e<1.))
+		return;
+	// Any direction in the orbit plane will do as pericenter of a circular orbit
+	ellipse.p = e>1e-9 ? eVec*(1./e) : r*(1./rl);
+	ellipse.q = h^ellipse.p;
+	ellipse.q.normalize();
+
+	const double E0 = std::atan2(r.dot(ellipse.q)/(a*std::sqrt(1-e*e)), r.dot(ellipse.p)/a + e);
+	ellipse.epoch = epoch;
+	ellipse.a = a;
+	ellipse.e = e;
+	ellipse.meanAnomaly = E0 - e*std::sin(E0);
+	ellipse.meanMotion = std::sqrt(gm/(a*a*a));
+	ellipse.valid = true;
+}
+
+// Whether the line P, Q, R turns by more than the angle at which segments are refined.
+// Written so that undefined positions are not refined.
+static inline bool turnsSharply(const Vec3d& P, const Vec3d& Q, const Vec3d& R)
+{
+	const Vec3d d1 = Q-P;
+	const Vec3d d2 = R-Q;
+	return d1.dot(d2) < cosMaxTurn*d1.length()*d2.length();
+}
+
+OrbitLineCache::Window* OrbitLineCache::computeWindow(const Sampler& sampler, qint64 index) const
+{
+	const qint64 base = index*windowSamples;
+	// The samples from one before the window to two after it, for the directions of the neighbouring segments
+	Vec3d S[windowSamples+3];
+	for (int s=0; s<windowSamples+3; ++s)
+		S[s] = positionAt(sampler, (base+s-1)*step);
+
+	Window* win = new Window;
+	win->points.reserve(windowSamples);
+	win->sampleIndex.reserve(windowSamples+1);
+	for (int s=0; s<windowSamples; ++s)
+	{
+		const Vec3d& A = S[s+1];
+		const Vec3d& B = S[s+2];
+		win->sampleIndex.append(win->points.size());
+		win->points.append(A);
+		// Only the segments next to a sharp turn are checked, which saves evaluating their midpoints
+		if (turnsSharply(S[s], A, B) || turnsSharply(A, B, S[s+3]))
+			refine(sampler, A, (base+s)*step, B, (base+s+1)*step, 0, win->points);
+	}
+	win->sampleIndex.append(win->points.size());
+	return win;
+}
+
+void OrbitLineCache::refine(const Sampler& sampler, const Vec3d& A, double tA, const Vec3d& B, double tB, int depth, QVector<Vec3d>& points) const
+{
+	if (depth>=maxRefineDepth)
+		return;
+	const double tM = 0.5*(tA+tB);
+	const Vec3d M = positionAt(sampler, tM);
+	// Written so that undefined positions are not refined
+	if (!((M-(A+B)*0.5).length() > refineTolerance*(B-A).length()))
+		return;
+	refine(sampler, A, tA, M, tM, depth+1, points);
+	points.append(M);
+	refine(sampler, M, tM, B, tB, depth+1, points);
+}
@@ -0,0 +1,121 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _ORBITLINECACHE_HPP_
+#define _ORBITLINECACHE_HPP_
+
+#include "VecMath.hpp"
+
+#include <QCache>
+#include <QVector>
+
+//! @class OrbitLineCache
+//! Cached geometry of the orbit line of one body.
+//! The orbit is sampled at fixed dates k*step, so that the samples do not depend on the current date
+//! or on the time rate. The samples are stored in windows of consecutive dates, which are kept
+//! in a cache after a time jump and reused when the date comes back to them.
+//! Where the line turns sharply between two samples (e.g. a comet near perihelion), the segment is
+//! subdivided until the line is smooth.
+//! For bodies with an osculating orbit, the line is the osculating orbit at the sample date at or before
+//! the current date, given by the osculating function of the body. Without such a function, it is the
+//! Keplerian ellipse of the position and velocity of the body around its parent. In both cases the elements
+//! are computed once per sample date and cached, and the points are evaluated from them.
+class OrbitLineCache
+{
+public:
+	//! Computes the positions of the body, relative to its parent.
+	class Sampler
+	{
+	public:
+		virtual ~Sampler() {}
+		virtual Vec3d positionAt(double JDE) const = 0;
+		//! Position at JDE on the osculating orbit at epoch, as the OsculatingFunctType of Planet.
+		//! @return false if the body has no osculating function, the default. The osculating orbit is
+		//! then fitted to positionAt() with getParentGM().
+		virtual bool osculatingPositionAt(double epoch, double JDE, Vec3d& pos) const
+		{
+			Q_UNUSED(epoch); Q_UNUSED(JDE); Q_UNUSED(pos);
+			return false;
+		}
+		//! Gravitational parameter of the parent body [AU^3/day^2]. The default is the one of the Sun.
+		virtual double getParentGM() const;
+	};
+
+	//! @param maxPoints the number of cached points after which the least recently used windows are removed.
+	OrbitLineCache(int maxPoints);
+
+	//! Index of the sample date at or before JDE.
+	static qint64 sampleIndex(double JDE, double step);
+
+	//! Get the orbit line around JDE, in the coordinates of the sampler.
+	//! The line starts segments/2 samples before JDE and has segments samples, plus the points added by
+	//! the refinement of the segments.
+	//! @param close if true, the last point is the first one, for closed orbits.
+	//! @param osculating if true, the line is the osculating ellipse instead of the positions of the sampler.
+	//! @param points receives the points.
+	//! @return the index in points of the sample at or before JDE.
+	int getLine(const Sampler& sampler, double JDE, double step, int segments, bool close, bool osculating, QVector<Vec3d>& points);
+
+	//! Remove all cached points.
+	void clear();
+
+private:
+	//! Samples windowSamples*index to windowSamples*(index+1)-1, with the refinement of the segments after each sample.
+	struct Window
+	{
+		QVector<Vec3d> points;
+		QVector<int> sampleIndex; // index in points of each sample
+	};
+
+	//! Elements of an osculating orbit, as the position on the ellipse in the orbit plane
+	struct Ellipse
+	{
+		double epoch;
+		double a, e;          // semi-major axis and eccentricity
+		double meanAnomaly;   // at epoch
+		double meanMotion;
+		Vec3d p, q;           // unit vectors towards pericenter and 90 degrees further
+		bool valid;
+	};
+
+	//! Position at JDE, from the sampler or on the osculating orbit.
+	Vec3d positionAt(const Sampler& sampler, double JDE) const;
+	//! Set the elements of the osculating orbit at the sample of index from the cache, or compute them.
+	void setEllipse(const Sampler& sampler, qint64 index);
+	//! Fit the elements of the osculating orbit at epoch to the positions given by sampler.
+	static void computeEllipse(const Sampler& sampler, double epoch, Ellipse& ellipse);
+	//! Get the elements of the orbit given by the osculating function of sampler at epoch.
+	//! @return false if the sampler has no osculating function.
+	static bool computeOsculatingEllipse(const Sampler& sampler, double epoch, Ellipse& ellipse);
+	//! Set the elements of the ellipse of position r and velocity v at epoch, if the orbit is an ellipse.
+	static void fitEllipse(const Vec3d& r, const Vec3d& v, double gm, double epoch, Ellipse& ellipse);
+	//! Compute the samples of window index.
+	Window* computeWindow(const Sampler& sampler, qint64 index) const;
+	//! Append the points between A at tA and B at tB to points, if the line between them is not straight enough.
+	void refine(const Sampler& sampler, const Vec3d& A, double tA, const Vec3d& B, double tB, int depth, QVector<Vec3d>& points) const;
+
+	QCache<qint64, Window> windows;
+	QCache<qint64, Ellipse> ellipses; // osculating elements by sample index of their epoch
+	double step;            // of the cached windows
+	bool osculating;        // of the cached windows
+	qint64 epochIndex;      // sample index of the osculating elements of the cached windows
+	Ellipse ellipse;        // osculating elements of the cached windows
+};
+
+#endif // _ORBITLINECACHE_HPP_
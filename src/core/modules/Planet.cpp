@@ -25,6 +25,7 @@
 #include "SolarSystem.hpp"
 #include "LandscapeMgr.hpp"
 #include "Planet.hpp"
+#include "Orbit.hpp"
 #include "planetsephems/precession.h"
 #include "StelObserver.hpp"
 #include "StelProjector.hpp"
@@ -85,7 +86,8 @@ Planet::Planet(const QString& englishName,
 	       bool hasAtmosphere,
 	       bool hasHalo,
 	       const QString& pTypeStr)
-	: englishName(englishName),
+	: orbitCache(3*ORBIT_SEGMENTS),
+	  englishName(englishName),
 	  flagLighting(flagLighting),
 	  radius(radius),
 	  oneMinusOblateness(1.0-oblateness),
@@ -97,6 +99,8 @@ Planet::Planet(const QString& englishName,
 	  lastJDE(J2000),
 	  coordFunc(coordFunc),
 	  userDataPtr(auserDataPtr),
+	  orbitPtr(NULL),
+	  orbitBatchIndex(-1),
 	  osculatingFunc(osculatingFunc),
 	  parent(NULL),
 	  hidden(hidden),
@@ -107,6 +111,7 @@ Planet::Planet(const QString& englishName,
 	normalMapName = anormalMapName;
 	lastOrbitJDE =0;
 	deltaJDE = StelCore::JD_SECOND;
+	orbitPosIndex = 0;
 	orbitCached = 0;
 	closeOrbit = acloseOrbit;
 	deltaOrbitJDE = 0;
@@ -448,15 +453,43 @@ Vec3d Planet::getJ2000EquatorialPos(const StelCore *core) const
 
 // Compute the position in the parent Planet coordinate system
 // Actually call the provided function to compute the ecliptical position
-void Planet::computePositionWithoutOrbits(const double dateJDE)
+void Planet::computePositionWithoutOrbits(const double dateJDE, const Vec3d* knownPos)
 {
 	if (fabs(lastJDE-dateJDE)>deltaJDE)
 	{
-		coordFunc(dateJDE, eclipticPos, userDataPtr);
+		if (knownPos)
+			eclipticPos = *knownPos;
+		else
+			coordFunc(dateJDE, eclipticPos, userDataPtr);
 		lastJDE = dateJDE;
 	}
 }
 
+Vec3d Planet::computeEclipticPosAt(const double dateJDE) const
+{
+	// the transitional ArtificialPlanet of SpaceShipObserver has no position function
+	if (!coordFunc)
+		return eclipticPos;
+	Vec3d pos;
+	coordFunc(dateJDE, pos, userDataPtr);
+	return pos;
+}
+
+Vec3d Planet::computeHeliocentricEclipticPosAt(const double dateJDE) const
+{
+	Vec3d pos = computeEclipticPosAt(dateJDE);
+	const Planet* pp = parent.data();
+	if (pp)
+	{
+		while (pp->parent.data())
+		{
+			pos += pp->computeEclipticPosAt(dateJDE);
+			pp = pp->parent.data();
+		}
+	}
+	return pos;
+}
+
 // return value in radians!
 // For Earth, this is epsilon_A, the angle between earth's rotational axis and mean ecliptic of date.
 // Details: e.g. Hilton etal, Report on Precession and the Ecliptic, Cel.Mech.Dyn.Astr.94:351-67 (2006), Fig1.
@@ -530,131 +563,75 @@ void Planet::computePosition(const double dateJDE)
 	// getHeliocentricPos() would return incorrect values.
 	if (parent)
 		parent->computePositionWithoutOrbits(dateJDE);
+	computeOwnPosition(dateJDE);
+}
 
-	if (orbitFader.getInterstate()>0.000001 && deltaOrbitJDE > 0 && (fabs(lastOrbitJDE-dateJDE)>deltaOrbitJDE || !orbitCached))
+// Samples the orbit line with the position functions of a Planet
+class PlanetOrbitSampler : public OrbitLineCache::Sampler
+{
+public:
+	PlanetOrbitSampler(posFuncType coordFunc, OsculatingFunctType* osculatingFunc, void* userDataPtr, const Orbit* orbit)
+		: coordFunc(coordFunc), osculatingFunc(osculatingFunc), userDataPtr(userDataPtr), orbit(orbit) {}
+	virtual Vec3d positionAt(double JDE) const
 	{
-		StelCore *core=StelApp::getInstance().getCore();
-
-		double calc_date;
-		// int delta_points = (int)(0.5 + (date - lastOrbitJD)/date_increment);
-		int delta_points;
-
-		if( dateJDE > lastOrbitJDE )
-		{
-			delta_points = (int)(0.5 + (dateJDE - lastOrbitJDE)/deltaOrbitJDE);
-		}
-		else
-		{
-			delta_points = (int)(-0.5 + (dateJDE - lastOrbitJDE)/deltaOrbitJDE);
-		}
-		double new_date = lastOrbitJDE + delta_points*deltaOrbitJDE;
-
-		// qDebug( "Updating orbit coordinates for %s (delta %f) (%d points)\n", getEnglishName().toUtf8().data(), deltaOrbitJDE, delta_points);
-
-		if( delta_points > 0 && delta_points < ORBIT_SEGMENTS && orbitCached)
-		{
-
-			for( int d=0; d<ORBIT_SEGMENTS; d++ )
-			{
-				if(d + delta_points >= ORBIT_SEGMENTS-1 )
-				{
-					// calculate new points
-					calc_date = new_date + (d-ORBIT_SEGMENTS/2)*deltaOrbitJDE;
-
-					// date increments between points will not be completely constant though
-					computeTransMatrix(calc_date-core->computeDeltaT(calc_date)/86400.0, calc_date);
-					if (osculatingFunc)
-					{
-						(*osculatingFunc)(dateJDE,calc_date,eclipticPos);
-					}
-					else
-					{
-						coordFunc(calc_date, eclipticPos, userDataPtr);
-					}
-					orbitP[d] = eclipticPos;
-					orbit[d] = getHeliocentricEclipticPos();
-				}
-				else
-				{
-					orbitP[d] = orbitP[d+delta_points];
-					orbit[d] = getHeliocentricPos(orbitP[d]);
-				}
-			}
-
-			lastOrbitJDE = new_date;
-		}
-		else if( delta_points < 0 && abs(delta_points) < ORBIT_SEGMENTS  && orbitCached)
-		{
-
-			for( int d=ORBIT_SEGMENTS-1; d>=0; d-- )
-			{
-				if(d + delta_points < 0 )
-				{
-					// calculate new points
-					calc_date = new_date + (d-ORBIT_SEGMENTS/2)*deltaOrbitJDE;
-
-					computeTransMatrix(calc_date-core->computeDeltaT(calc_date)/86400.0, calc_date);
-					if (osculatingFunc) {
-						(*osculatingFunc)(dateJDE,calc_date,eclipticPos);
-					}
-					else
-					{
-						coordFunc(calc_date, eclipticPos, userDataPtr);
-					}
-					orbitP[d] = eclipticPos;
-					orbit[d] = getHeliocentricEclipticPos();
-				}
-				else
-				{
-					orbitP[d] = orbitP[d+delta_points];
-					orbit[d] = getHeliocentricPos(orbitP[d]);
-				}
-			}
-
-			lastOrbitJDE = new_date;
-
-		}
-		else if( delta_points || !orbitCached)
-		{
-
-			// update all points (less efficient)
-			for( int d=0; d<ORBIT_SEGMENTS; d++ )
-			{
-				calc_date = dateJDE + (d-ORBIT_SEGMENTS/2)*deltaOrbitJDE;
-				computeTransMatrix(calc_date-core->computeDeltaT(calc_date)/86400.0, calc_date);
-				if (osculatingFunc)
-				{
-					(*osculatingFunc)(dateJDE,calc_date,eclipticPos);
-				}
-				else
-				{
-					coordFunc(calc_date, eclipticPos, userDataPtr);
-				}
-				orbitP[d] = eclipticPos;
-				orbit[d] = getHeliocentricEclipticPos();
-			}
-
-			lastOrbitJDE = dateJDE;
-			if (!osculatingFunc) orbitCached = 1;
-		}
+		Vec3d pos;
+		coordFunc(JDE, pos, userDataPtr);
+		return pos;
+	}
+	virtual bool osculatingPositionAt(double epoch, double JDE, Vec3d& pos) const
+	{
+		if (!osculatingFunc)
+			return false;
+		(*osculatingFunc)(epoch, JDE, pos);
+		return true;
+	}
+	virtual double getParentGM() const
+	{
+		const double gm = orbit ? orbit->getParentGM() : 0.;
+		return gm>0. ? gm : OrbitLineCache::Sampler::getParentGM();
+	}
+private:
+	posFuncType coordFunc;
+	OsculatingFunctType* osculatingFunc;
+	void* userDataPtr;
+	const Orbit* orbit;
+};
 
+void Planet::computeOwnPosition(const double dateJDE, const Vec3d* knownPos)
+{
+	const bool withOrbit = orbitFader.getInterstate()>0.000001 && deltaOrbitJDE > 0;
+	if (withOrbit && (!orbitCached || OrbitLineCache::sampleIndex(dateJDE, deltaOrbitJDE)!=OrbitLineCache::sampleIndex(lastOrbitJDE, deltaOrbitJDE)))
+	{
+		// The samples are taken at fixed dates and kept in the cache, so after a time jump
+		// or a change of time rate only the samples for new dates are computed.
+		// Osculating orbits are drawn with the osculating function, at the sample date.
+		const PlanetOrbitSampler sampler(coordFunc, osculatingFunc, userDataPtr, orbitPtr);
+		orbitPosIndex = orbitCache.getLine(sampler, dateJDE, deltaOrbitJDE, ORBIT_SEGMENTS, closeOrbit, osculatingFunc!=NULL, orbitP);
+		lastOrbitJDE = dateJDE;
+		orbitCached = 1;
 
 		// calculate actual Planet position
-		coordFunc(dateJDE, eclipticPos, userDataPtr);
-
+		if (knownPos)
+			eclipticPos = *knownPos;
+		else
+			coordFunc(dateJDE, eclipticPos, userDataPtr);
+		orbit.resize(orbitP.size());
+		for (int d=0; d<orbitP.size(); d++)
+			orbit[d]=getHeliocentricPos(orbitP[d]);
 		lastJDE = dateJDE;
-
 	}
 	else if (fabs(lastJDE-dateJDE)>deltaJDE)
 	{
 		// calculate actual Planet position
-		coordFunc(dateJDE, eclipticPos, userDataPtr);
-		if (orbitFader.getInterstate()>0.000001)
-			for( int d=0; d<ORBIT_SEGMENTS; d++ )
+		if (knownPos)
+			eclipticPos = *knownPos;
+		else
+			coordFunc(dateJDE, eclipticPos, userDataPtr);
+		if (withOrbit)
+			for (int d=0; d<orbitP.size(); d++)
 				orbit[d]=getHeliocentricPos(orbitP[d]);
 		lastJDE = dateJDE;
 	}
-
 }
 
 // Compute the transformation matrix from the local Planet coordinate system to the parent Planet coordinate system.
@@ -669,35 +646,50 @@ void Planet::computeTransMatrix(double JD, double JDE)
 	// not solar equator...
 
 	if (parent)
+		rotLocalToParent = computeRotLocalToParent(JDE);
+}
+
+Mat4d Planet::computeRotLocalToParent(const double dateJDE) const
+{
+	// We can inject a proper precession plus even nutation matrix in this stage, if available.
+	if (englishName=="Earth")
 	{
-		// We can inject a proper precession plus even nutation matrix in this stage, if available.
-		if (englishName=="Earth")
+		// rotLocalToParent = Mat4d::zrotation(re.ascendingNode - re.precessionRate*(jd-re.epoch)) * Mat4d::xrotation(-getRotObliquity(jd));
+		// We follow Capitaine's (2003) formulation P=Rz(Chi_A)*Rx(-omega_A)*Rz(-psi_A)*Rx(eps_o).
+		// ADS: 2011A&A...534A..22V = A&A 534, A22 (2011): Vondrak, Capitane, Wallace: New Precession Expressions, valid for long time intervals:
+		// See also Hilton et al., Report on Precession and the Ecliptic. Cel.Mech.Dyn.Astr. 94:351-367 (2006), eqn (6) and (21).
+		double eps_A, chi_A, omega_A, psi_A;
+		getPrecessionAnglesVondrak(dateJDE, &eps_A, &chi_A, &omega_A, &psi_A);
+		// Canonical precession rotations: Nodal rotation psi_A,
+		// then rotation by omega_A, the angle between EclPoleJ2000 and EarthPoleOfDate.
+		// The final rotation by chi_A rotates the equinox (zero degree).
+		// To achieve ecliptical coords of date, you just have now to add a rotX by epsilon_A (obliquity of date).
+
+		Mat4d rot = Mat4d::zrotation(-psi_A) * Mat4d::xrotation(-omega_A) * Mat4d::zrotation(chi_A);
+		// Plus nutation IAU-2000B:
+		if (StelApp::getInstance().getCore()->getUseNutation())
 		{
-			// rotLocalToParent = Mat4d::zrotation(re.ascendingNode - re.precessionRate*(jd-re.epoch)) * Mat4d::xrotation(-getRotObliquity(jd));
-			// We follow Capitaine's (2003) formulation P=Rz(Chi_A)*Rx(-omega_A)*Rz(-psi_A)*Rx(eps_o).
-			// ADS: 2011A&A...534A..22V = A&A 534, A22 (2011): Vondrak, Capitane, Wallace: New Precession Expressions, valid for long time intervals:
-			// See also Hilton et al., Report on Precession and the Ecliptic. Cel.Mech.Dyn.Astr. 94:351-367 (2006), eqn (6) and (21).
-			double eps_A, chi_A, omega_A, psi_A;
-			getPrecessionAnglesVondrak(JDE, &eps_A, &chi_A, &omega_A, &psi_A);
-			// Canonical precession rotations: Nodal rotation psi_A,
-			// then rotation by omega_A, the angle between EclPoleJ2000 and EarthPoleOfDate.
-			// The final rotation by chi_A rotates the equinox (zero degree).
-			// To achieve ecliptical coords of date, you just have now to add a rotX by epsilon_A (obliquity of date).
-
-			rotLocalToParent= Mat4d::zrotation(-psi_A) * Mat4d::xrotation(-omega_A) * Mat4d::zrotation(chi_A);
-			// Plus nutation IAU-2000B:
-			if (StelApp::getInstance().getCore()->getUseNutation())
-			{
-				double deltaEps, deltaPsi;
-				getNutationAngles(JDE, &deltaPsi, &deltaEps);
-				//qDebug() << "deltaEps, arcsec" << deltaEps*180./M_PI*3600. << "deltaPsi" << deltaPsi*180./M_PI*3600.;
-				Mat4d nut2000B=Mat4d::xrotation(eps_A) * Mat4d::zrotation(deltaPsi)* Mat4d::xrotation(-eps_A-deltaEps);
-				rotLocalToParent=rotLocalToParent*nut2000B;
-			}
+			double deltaEps, deltaPsi;
+			getNutationAngles(dateJDE, &deltaPsi, &deltaEps);
+			//qDebug() << "deltaEps, arcsec" << deltaEps*180./M_PI*3600. << "deltaPsi" << deltaPsi*180./M_PI*3600.;
+			Mat4d nut2000B=Mat4d::xrotation(eps_A) * Mat4d::zrotation(deltaPsi)* Mat4d::xrotation(-eps_A-deltaEps);
+			rot=rot*nut2000B;
 		}
-		else
-			rotLocalToParent = Mat4d::zrotation(re.ascendingNode - re.precessionRate*(JDE-re.epoch)) * Mat4d::xrotation(re.obliquity);
+		return rot;
 	}
+	else
+		return Mat4d::zrotation(re.ascendingNode - re.precessionRate*(dateJDE-re.epoch)) * Mat4d::xrotation(re.obliquity);
+}
+
+Mat4d Planet::computeRotEquatorialToVsop87(const double dateJDE) const
+{
+	Mat4d rval = parent ? computeRotLocalToParent(dateJDE) : rotLocalToParent;
+	if (parent)
+	{
+		for (const Planet* p=parent.data();p->parent;p=p->parent.data())
+			rval = p->computeRotLocalToParent(dateJDE) * rval;
+	}
+	return rval;
 }
 
 Mat4d Planet::getRotEquatorialToVsop87(void) const
@@ -905,10 +897,20 @@ float Planet::getVMagnitude(const StelCore* core) const
 		return 4.83 + 5.*(std::log10(distParsec)-1.) - 2.5*(std::log10(shadowFactor));
 	}
 
+	return computeVMagnitude(core, core->getObserverHeliocentricEclipticPos(), getHeliocentricEclipticPos(), parent->getHeliocentricEclipticPos(), core->getJDE());
+}
+
+float Planet::computeVMagnitude(const StelCore* core, const Vec3d& observerHelioPos, const Vec3d& planetHelioPos, const Vec3d& parentHelioPos, double JDE) const
+{
+	if (parent == 0)
+	{
+		// Sun, see getVMagnitude(), but without eclipses
+		const double distParsec = std::sqrt(observerHelioPos.lengthSquared())*AU/PARSEC;
+		return 4.83 + 5.*(std::log10(distParsec)-1.);
+	}
+
 	// Compute the angular phase
-	const Vec3d& observerHelioPos = core->getObserverHeliocentricEclipticPos();
 	const double observerRq = observerHelioPos.lengthSquared();
-	const Vec3d& planetHelioPos = getHeliocentricEclipticPos();
 	const double planetRq = planetHelioPos.lengthSquared();
 	const double observerPlanetRq = (observerHelioPos - planetHelioPos).lengthSquared();
 	const double cos_chi = (observerPlanetRq + planetRq - observerRq)/(2.0*std::sqrt(observerPlanetRq*planetRq));
@@ -918,7 +920,7 @@ float Planet::getVMagnitude(const StelCore* core) const
 	// Check if the satellite is inside the inner shadow of the parent planet:
 	if (parent->parent != 0)
 	{
-		const Vec3d& parentHeliopos = parent->getHeliocentricEclipticPos();
+		const Vec3d& parentHeliopos = parentHelioPos;
 		const double parent_Rq = parentHeliopos.lengthSquared();
 		const double pos_times_parent_pos = planetHelioPos * parentHeliopos;
 		if (pos_times_parent_pos > parent_Rq)
@@ -990,12 +992,10 @@ float Planet::getVMagnitude(const StelCore* core) const
 				{
 					// add rings computation
 					// implemented from Meeus, Astr.Alg.1992
-					const double jde=core->getJDE();
-					const double T=(jde-2451545.0)/36525.0;
+					const double T=(JDE-2451545.0)/36525.0;
 					const double i=((0.000004*T-0.012998)*T+28.075216)*M_PI/180.0;
 					const double Omega=((0.000412*T+1.394681)*T+169.508470)*M_PI/180.0;
-					static SolarSystem *ssystem=GETSTELMODULE(SolarSystem);
-					const Vec3d saturnEarth=getHeliocentricEclipticPos() - ssystem->getEarth()->getHeliocentricEclipticPos();
+					const Vec3d saturnEarth=planetHelioPos - observerHelioPos;
 					double lambda=atan2(saturnEarth[1], saturnEarth[0]);
 					double beta=atan2(saturnEarth[2], std::sqrt(saturnEarth[0]*saturnEarth[0]+saturnEarth[1]*saturnEarth[1]));
 					const double sinx=sin(i)*cos(beta)*sin(lambda-Omega)-cos(i)*sin(beta);
@@ -1029,12 +1029,10 @@ float Planet::getVMagnitude(const StelCore* core) const
 				{
 					// add rings computation
 					// implemented from Meeus, Astr.Alg.1992
-					const double jde=core->getJDE();
-					const double T=(jde-2451545.0)/36525.0;
+					const double T=(JDE-2451545.0)/36525.0;
 					const double i=((0.000004*T-0.012998)*T+28.075216)*M_PI/180.0;
 					const double Omega=((0.000412*T+1.394681)*T+169.508470)*M_PI/180.0;
-					SolarSystem *ssystem=GETSTELMODULE(SolarSystem);
-					const Vec3d saturnEarth=getHeliocentricEclipticPos() - ssystem->getEarth()->getHeliocentricEclipticPos();
+					const Vec3d saturnEarth=planetHelioPos - observerHelioPos;
 					double lambda=atan2(saturnEarth[1], saturnEarth[0]);
 					double beta=atan2(saturnEarth[2], std::sqrt(saturnEarth[0]*saturnEarth[0]+saturnEarth[1]*saturnEarth[1]));
 					const double sinB=sin(i)*cos(beta)*sin(lambda-Omega)-cos(i)*sin(beta);
@@ -1067,12 +1065,10 @@ float Planet::getVMagnitude(const StelCore* core) const
 				{
 					// add rings computation
 					// implemented from Meeus, Astr.Alg.1992
-					const double jde=core->getJDE();
-					const double T=(jde-2451545.0)/36525.0;
+					const double T=(JDE-2451545.0)/36525.0;
 					const double i=((0.000004*T-0.012998)*T+28.075216)*M_PI/180.0;
 					const double Omega=((0.000412*T+1.394681)*T+169.508470)*M_PI/180.0;
-					static SolarSystem *ssystem=GETSTELMODULE(SolarSystem);
-					const Vec3d saturnEarth=getHeliocentricEclipticPos() - ssystem->getEarth()->getHeliocentricEclipticPos();
+					const Vec3d saturnEarth=planetHelioPos - observerHelioPos;
 					double lambda=atan2(saturnEarth[1], saturnEarth[0]);
 					double beta=atan2(saturnEarth[2], std::sqrt(saturnEarth[0]*saturnEarth[0]+saturnEarth[1]*saturnEarth[1]));
 					const double sinB=sin(i)*cos(beta)*sin(lambda-Omega)-cos(i)*sin(beta);
@@ -1989,17 +1985,16 @@ void Planet::drawOrbit(const StelCore* core)
 	Vec3d onscreen;
 	// special case - use current Planet position as center vertex so that draws
 	// on its orbit all the time (since segmented rather than smooth curve)
-	Vec3d savePos = orbit[ORBIT_SEGMENTS/2];
-	orbit[ORBIT_SEGMENTS/2]=getHeliocentricEclipticPos();
-	orbit[ORBIT_SEGMENTS]=orbit[0];
-	int nbIter = closeOrbit ? ORBIT_SEGMENTS : ORBIT_SEGMENTS-1;
+	const Vec3d pos = getHeliocentricEclipticPos();
 	QVarLengthArray<float, 1024> vertexArray;
 
 	sPainter.enableClientStates(true, false, false);
 
-	for (int n=0; n<=nbIter; ++n)
+	for (int n=0; n<orbit.size(); ++n)
 	{
-		if (prj->project(orbit[n],onscreen) && (vertexArray.size()==0 || !prj->intersectViewportDiscontinuity(orbit[n-1], orbit[n])))
+		const Vec3d& point = n==orbitPosIndex ? pos : orbit.at(n);
+		const Vec3d& previous = n-1==orbitPosIndex ? pos : orbit.at(qMax(n-1, 0));
+		if (prj->project(point,onscreen) && (vertexArray.size()==0 || !prj->intersectViewportDiscontinuity(previous, point)))
 		{
 			vertexArray.append(onscreen[0]);
 			vertexArray.append(onscreen[1]);
@@ -2011,7 +2006,6 @@ void Planet::drawOrbit(const StelCore* core)
 			vertexArray.clear();
 		}
 	}
-	orbit[ORBIT_SEGMENTS/2]=savePos;
 	if (!vertexArray.isEmpty())
 	{
 		sPainter.setVertexPointer(2, GL_FLOAT, vertexArray.constData());
@@ -26,8 +26,10 @@
 #include "StelFader.hpp"
 #include "StelTextureTypes.hpp"
 #include "StelProjectorType.hpp"
+#include "OrbitLineCache.hpp"
 
 #include <QString>
+#include <QVector>
 
 // The callback type for the external position computation function
 // The last variable is the userData pointer.
@@ -39,6 +41,7 @@ typedef void (OsculatingFunctType)(double jde0,double jde,double xyz[3]);
 #define J2000 2451545.0
 #define ORBIT_SEGMENTS 360
 
+class Orbit;
 class StelFont;
 class StelPainter;
 class StelTranslator;
@@ -148,6 +151,14 @@ public:
 	virtual double getSatellitesFov(const StelCore* core) const;
 	virtual double getParentSatellitesFov(const StelCore* core) const;
 	virtual float getVMagnitude(const StelCore* core) const;
+	//! Compute the visual magnitude for explicitly given positions instead of those cached in the Planet objects.
+	//! @param core only used for the magnitude algorithm and the name of the observer's planet.
+	//! @param observerHelioPos heliocentric ecliptic position of the observer [AU]
+	//! @param planetHelioPos heliocentric ecliptic position of this body [AU]
+	//! @param parentHelioPos heliocentric ecliptic position of the parent body [AU], used for eclipses of moons.
+	//! @param JDE date for the time dependent terms (Saturn's rings)
+	//! @note for the Sun, the dimming during solar eclipses is not included here.
+	virtual float computeVMagnitude(const StelCore* core, const Vec3d& observerHelioPos, const Vec3d& planetHelioPos, const Vec3d& parentHelioPos, double JDE) const;
 	virtual float getSelectPriority(const StelCore* core) const;
 	virtual Vec3f getInfoColor(void) const;
 	virtual QString getType(void) const {return "Planet";}
@@ -202,13 +213,31 @@ public:
 	const RotationElements &getRotationElements(void) const {return re;}
 
 	// Compute the position in the parent Planet coordinate system
-	void computePositionWithoutOrbits(const double dateJDE);
+	//! @param knownPos the position at dateJDE if it was already computed, e.g. by a KeplerOrbitBatch, or NULL.
+	void computePositionWithoutOrbits(const double dateJDE, const Vec3d* knownPos=NULL);
 	void computePosition(const double dateJDE);
+	//! Same as computePosition(), but assumes the parent position has already been computed for this frame.
+	//! Only the state of this Planet is changed, so this may be called for several Planets in parallel
+	//! as long as their position functions are reentrant (see EphemWrapper::Context).
+	//! @param knownPos the position at dateJDE if it was already computed, e.g. by a KeplerOrbitBatch, or NULL.
+	//! The orbit line is still sampled with the position function.
+	void computeOwnPosition(const double dateJDE, const Vec3d* knownPos=NULL);
 
 	// Compute the transformation matrix from the local Planet coordinate to the parent Planet coordinate.
 	// This requires both flavours of JD in cases involving Earth.
 	void computeTransMatrix(double JD, double JDE);
 
+	//! Compute the position in the parent Planet coordinate system for dateJDE.
+	//! Unlike computePosition(), this does not change the cached position, orbit or any other state of this object.
+	virtual Vec3d computeEclipticPosAt(const double dateJDE) const;
+	//! Compute the heliocentric ecliptic position for dateJDE, evaluating all parents for the same date.
+	//! This does not change the cached state of this Planet or its parents.
+	Vec3d computeHeliocentricEclipticPosAt(const double dateJDE) const;
+	//! Compute the axis orientation w.r.t. the parent Planet for dateJDE (the matrix which computeTransMatrix() stores).
+	Mat4d computeRotLocalToParent(const double dateJDE) const;
+	//! Compute the rotation from planet-based equatorial coordinates to VSOP87 for dateJDE without changing any state.
+	Mat4d computeRotEquatorialToVsop87(const double dateJDE) const;
+
 	// Get the phase angle (rad) for an observer at pos obsPos in heliocentric coordinates (in AU)
 	double getPhaseAngle(const Vec3d& obsPos) const;
 	// Get the elongation angle (rad) for an observer at pos obsPos in heliocentric coordinates (in AU)
@@ -243,6 +272,14 @@ public:
 
 	void setRings(Ring* r) {rings = r;}
 
+	//! Set the Keplerian orbit of the body, for the bodies whose positions are computed from orbital elements.
+	void setOrbit(Orbit* o) {orbitPtr = o;}
+	//! The Keplerian orbit of the body, or NULL if its positions come from a theory.
+	Orbit* getOrbit(void) const {return orbitPtr;}
+	//! Set the index of the orbit in the KeplerOrbitBatch of SolarSystem, or -1 if it is not in it.
+	void setOrbitBatchIndex(int index) {orbitBatchIndex = index;}
+	int getOrbitBatchIndex(void) const {return orbitBatchIndex;}
+
 	void setSphereScale(float s) {sphereScale = s;}
 	float getSphereScale(void) const {return sphereScale;}
 
@@ -277,8 +314,10 @@ public:
 	LinearFader orbitFader;
 	// draw orbital path of Planet
 	void drawOrbit(const StelCore*);
-	Vec3d orbit[ORBIT_SEGMENTS+1];   // store heliocentric coordinates for drawing the orbit
-	Vec3d orbitP[ORBIT_SEGMENTS+1];  // store local coordinate for orbit
+	QVector<Vec3d> orbit;            // store heliocentric coordinates for drawing the orbit
+	QVector<Vec3d> orbitP;           // store local coordinate for orbit
+	int orbitPosIndex;               // index of the point of orbit nearest to the planet position
+	OrbitLineCache orbitCache;       // orbit line samples, kept across time jumps
 	double lastOrbitJDE;
 	double deltaJDE;                 // time difference between positional updates.
 	double deltaOrbitJDE;
@@ -344,6 +383,8 @@ protected:
 	// The callback for the calculation of the equatorial rect heliocentric position at time JDE.
 	posFuncType coordFunc;
 	void* userDataPtr;               // this is always used with an Orbit object.
+	Orbit* orbitPtr;                 // the Orbit of userDataPtr, or NULL
+	int orbitBatchIndex;             // index of orbitPtr in the KeplerOrbitBatch of SolarSystem, or -1
 
 	OsculatingFunctType *const osculatingFunc;
 	QSharedPointer<Planet> parent;           // Planet parent i.e. sun for earth
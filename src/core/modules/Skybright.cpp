@@ -101,7 +101,17 @@ float Skybright::getLuminance( float cosDistMoon,
 	// Details: https://bugs.launchpad.net/stellarium/+bug/1499699
 	if (!GETSTELMODULE(SolarSystem)->getFlagPlanets())
 		return 0.f;
+	return computeLuminance(cosDistMoon, cosDistSun, cosDistZenith);
+}
 
+void Skybright::getLuminances(int n, const float* cosDistMoon, const float* cosDistSun, const float* cosDistZenith, float* luminance) const
+{
+	for (int i=0; i<n; ++i)
+		luminance[i] = computeLuminance(cosDistMoon[i], cosDistSun[i], cosDistZenith[i]);
+}
+
+inline float Skybright::computeLuminance(float cosDistMoon, const float cosDistSun, const float cosDistZenith) const
+{
 	// Air mass
 	const float bKX = stelpow10f(-0.4f * K * (1.f / (cosDistZenith + 0.025f*StelUtils::fastExp(-11.f*cosDistZenith))));
 
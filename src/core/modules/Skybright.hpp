@@ -68,7 +68,15 @@ public:
 	//! @param cosDistZenith cos(angular distance between zenith and the position)
 	float getLuminance(float cosDistMoon, const float cosDistSun, const float cosDistZenith) const;
 
+	//! Compute the luminance at n positions given as arrays of the same cosines as getLuminance().
+	//! Unlike getLuminance(), this does not check whether the planets are displayed: it is meant to be
+	//! called from worker threads, where the module manager must not be used, so the caller checks it.
+	void getLuminances(int n, const float* cosDistMoon, const float* cosDistSun, const float* cosDistZenith, float* luminance) const;
+
 private:
+	//! getLuminance() without the check of the display of the planets.
+	inline float computeLuminance(float cosDistMoon, const float cosDistSun, const float cosDistZenith) const;
+
 	float airMassMoon;  // Air mass for the Moon
 	float airMassSun;   // Air mass for the Sun
 	float magMoon;      // Moon magnitude
@@ -23,6 +23,8 @@
 #include "StelTexture.hpp"
 #include "EphemWrapper.hpp"
 #include "Orbit.hpp"
+#include "KeplerOrbitBatch.hpp"
+#include "SolarSystemDatabase.hpp"
 
 #include "StelProjector.hpp"
 #include "StelApp.hpp"
@@ -33,7 +35,6 @@
 #include "StelSkyCultureMgr.hpp"
 #include "StelFileMgr.hpp"
 #include "StelModuleMgr.hpp"
-#include "StelIniParser.hpp"
 #include "Planet.hpp"
 #include "MinorPlanet.hpp"
 #include "Comet.hpp"
@@ -58,6 +59,7 @@
 #include <QMultiMap>
 #include <QMapIterator>
 #include <QDebug>
+#include <QtConcurrent>
 #include <QDir>
 
 SolarSystem::SolarSystem()
@@ -77,6 +79,8 @@ SolarSystem::SolarSystem()
 	, ephemerisDatesDisplayed(false)
 	, allTrails(NULL)
 	, conf(StelApp::getInstance().getSettings())
+	, keplerOrbits(new KeplerOrbitBatch())
+	, keplerOrbitsJDE(0.)
 {
 	planetNameFont.setPixelSize(StelApp::getInstance().getBaseFontSize());
 	setObjectName("SolarSystem");
@@ -92,6 +96,8 @@ SolarSystem::~SolarSystem()
 {
 	// release selected:
 	selected.clear();
+	delete keplerOrbits;
+	keplerOrbits = NULL;
 	foreach (Orbit* orb, orbits)
 	{
 		delete orb;
@@ -390,6 +396,9 @@ void SolarSystem::loadPlanets()
 				p.clear();
 			}
 			systemPlanets.clear();
+			dependentPlanets.clear();
+			independentPlanets.clear();
+			keplerOrbits->clear();
 			//Memory leak? What's the proper way of cleaning shared pointers?
 
 			//If the file is in the user data directory, rename it:
@@ -412,12 +421,15 @@ void SolarSystem::loadPlanets()
 	foreach (const PlanetP& planet, systemPlanets)
 		if(planet->parent != sun || !planet->satellites.isEmpty())
 			shadowPlanetCount++;
+
+	updatePositionSchedule();
 }
 
 bool SolarSystem::loadPlanets(const QString& filePath)
 {
-	QSettings pd(filePath, StelIniFormat);
-	if (pd.status() != QSettings::NoError)
+	// Read through the compiled cache, parsing a large ssystem.ini with QSettings takes long.
+	SolarSystemDatabase pd;
+	if (!pd.load(filePath))
 	{
 		qWarning() << "ERROR while parsing" << QDir::toNativeSeparators(filePath);
 		return false;
@@ -458,12 +470,12 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 	// Stage 1 (as described above).
 	QMap<QString, QString> secNameMap;
 	QMap<QString, QString> parentMap;
-	QStringList sections = pd.childGroups();
+	const QStringList& sections = pd.sectionNames();
 	for (int i=0; i<sections.size(); ++i)
 	{
 		const QString secname = sections.at(i);
-		const QString englishName = pd.value(secname+"/name").toString();
-		const QString strParent = pd.value(secname+"/parent").toString();
+		const QString englishName = pd.section(secname).value("name").toString();
+		const QString strParent = pd.section(secname).value("parent").toString();
 		secNameMap[englishName] = secname;
 		if (strParent!="none" && !strParent.isEmpty() && !englishName.isEmpty())
 			parentMap[englishName] = strParent;
@@ -473,7 +485,7 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 	QMultiMap<int, QString> depLevelMap;
 	for (int i=0; i<sections.size(); ++i)
 	{
-		const QString englishName = pd.value(sections.at(i)+"/name").toString();
+		const QString englishName = pd.section(sections.at(i)).value("name").toString();
 
 		// follow dependencies, incrementing level when we have one
 		// till we run out.
@@ -500,24 +512,22 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 	// Stage 3 (as described above).
 	int readOk=0;
 	int totalPlanets=0;
+	// Already created bodies by english name, for looking up the parents
+	QHash<QString, PlanetP> planetsByName;
+	foreach (const PlanetP& p, systemPlanets)
+		planetsByName.insert(p->getEnglishName(), p);
 	for (int i = 0;i<orderedSections.size();++i)
 	{
 		totalPlanets++;
 		const QString secname = orderedSections.at(i);
-		const QString englishName = pd.value(secname+"/name").toString().simplified();
-		const QString strParent = pd.value(secname+"/parent").toString();
+		const SolarSystemDatabase::Section& sec = pd.section(secname);
+		const QString englishName = sec.value("name").toString().simplified();
+		const QString strParent = sec.value("parent").toString();
 		PlanetP parent;
 		if (strParent!="none")
 		{
 			// Look in the other planets the one named with strParent
-			foreach (const PlanetP& p, systemPlanets)
-			{
-				if (p->getEnglishName()==strParent)
-				{
-					parent = p;
-					break;
-				}
-			}
+			parent = planetsByName.value(strParent);
 			if (parent.isNull())
 			{
 				qWarning() << "ERROR : can't find parent solar system body for " << englishName;
@@ -526,22 +536,24 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 			}
 		}
 
-		const QString funcName = pd.value(secname+"/coord_func").toString();
+		const QString funcName = sec.value("coord_func").toString();
 		posFuncType posfunc=NULL;
 		void* userDataPtr=NULL;
+		Orbit* orbitPtr=NULL;
+		int orbitBatchIndex=-1;
 		OsculatingFunctType *osculatingFunc = 0;
-		bool closeOrbit = pd.value(secname+"/closeOrbit", true).toBool();
+		bool closeOrbit = sec.value("closeOrbit", true).toBool();
 
 		if (funcName=="ell_orbit")
 		{
 			// Read the orbital elements
-			const double epoch = pd.value(secname+"/orbit_Epoch",J2000).toDouble();
-			const double eccentricity = pd.value(secname+"/orbit_Eccentricity").toDouble();
+			const double epoch = sec.value("orbit_Epoch",J2000).toDouble();
+			const double eccentricity = sec.value("orbit_Eccentricity").toDouble();
 			if (eccentricity >= 1.0) closeOrbit = false;
-			double pericenterDistance = pd.value(secname+"/orbit_PericenterDistance",-1e100).toDouble();
+			double pericenterDistance = sec.value("orbit_PericenterDistance",-1e100).toDouble();
 			double semi_major_axis;
 			if (pericenterDistance <= 0.0) {
-				semi_major_axis = pd.value(secname+"/orbit_SemiMajorAxis",-1e100).toDouble();
+				semi_major_axis = sec.value("orbit_SemiMajorAxis",-1e100).toDouble();
 				if (semi_major_axis <= -1e100) {
 					qDebug() << "ERROR: " << englishName
 						<< ": you must provide orbit_PericenterDistance or orbit_SemiMajorAxis";
@@ -558,10 +570,10 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 								? 0.0 // parabolic orbits have no semi_major_axis
 								: pericenterDistance / (1.0-eccentricity);
 			}
-			double meanMotion = pd.value(secname+"/orbit_MeanMotion",-1e100).toDouble();
+			double meanMotion = sec.value("orbit_MeanMotion",-1e100).toDouble();
 			double period;
 			if (meanMotion <= -1e100) {
-				period = pd.value(secname+"/orbit_Period",-1e100).toDouble();
+				period = sec.value("orbit_Period",-1e100).toDouble();
 				if (period <= -1e100) {
 					meanMotion = (eccentricity == 1.0)
 								? 0.01720209895 * (1.5/pericenterDistance) * std::sqrt(0.5/pericenterDistance)
@@ -575,21 +587,21 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 			} else {
 				period = 2.0*M_PI/meanMotion;
 			}
-			const double inclination = pd.value(secname+"/orbit_Inclination").toDouble()*(M_PI/180.0);
-			const double ascending_node = pd.value(secname+"/orbit_AscendingNode").toDouble()*(M_PI/180.0);
-			double arg_of_pericenter = pd.value(secname+"/orbit_ArgOfPericenter",-1e100).toDouble();
+			const double inclination = sec.value("orbit_Inclination").toDouble()*(M_PI/180.0);
+			const double ascending_node = sec.value("orbit_AscendingNode").toDouble()*(M_PI/180.0);
+			double arg_of_pericenter = sec.value("orbit_ArgOfPericenter",-1e100).toDouble();
 			double long_of_pericenter;
 			if (arg_of_pericenter <= -1e100) {
-				long_of_pericenter = pd.value(secname+"/orbit_LongOfPericenter").toDouble()*(M_PI/180.0);
+				long_of_pericenter = sec.value("orbit_LongOfPericenter").toDouble()*(M_PI/180.0);
 				arg_of_pericenter = long_of_pericenter - ascending_node;
 			} else {
 				arg_of_pericenter *= (M_PI/180.0);
 				long_of_pericenter = arg_of_pericenter + ascending_node;
 			}
-			double mean_anomaly = pd.value(secname+"/orbit_MeanAnomaly",-1e100).toDouble();
+			double mean_anomaly = sec.value("orbit_MeanAnomaly",-1e100).toDouble();
 			double mean_longitude;
 			if (mean_anomaly <= -1e100) {
-				mean_longitude = pd.value(secname+"/orbit_MeanLongitude").toDouble()*(M_PI/180.0);
+				mean_longitude = sec.value("orbit_MeanLongitude").toDouble()*(M_PI/180.0);
 				mean_anomaly = mean_longitude - long_of_pericenter;
 			} else {
 				mean_anomaly *= (M_PI/180.0);
@@ -631,8 +643,12 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 								   parent_rot_asc_node,
 								   parent_rot_j2000_longitude);
 			orbits.push_back(orb);
+			// Heliocentric orbits are solved together in computePositions()
+			if (!parent->getParent() && keplerOrbits->add(orb))
+				orbitBatchIndex = keplerOrbits->size()-1;
 
 			userDataPtr = orb;
+			orbitPtr = orb;
 			posfunc = &ellipticalOrbitPosFunc;
 		}
 		else if (funcName=="comet_orbit")
@@ -643,12 +659,12 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 			// orbit_Period: given in days
 			// orbit_TimeAtPericenter,orbit_Epoch: JD
 			// orbit_MeanAnomaly,orbit_Inclination,orbit_ArgOfPericenter,orbit_AscendingNode: given in degrees
-			const double eccentricity = pd.value(secname+"/orbit_Eccentricity",0.0).toDouble();
+			const double eccentricity = sec.value("orbit_Eccentricity",0.0).toDouble();
 			if (eccentricity >= 1.0) closeOrbit = false;
-			double pericenterDistance = pd.value(secname+"/orbit_PericenterDistance",-1e100).toDouble();
+			double pericenterDistance = sec.value("orbit_PericenterDistance",-1e100).toDouble();
 			double semi_major_axis;
 			if (pericenterDistance <= 0.0) {
-				semi_major_axis = pd.value(secname+"/orbit_SemiMajorAxis",-1e100).toDouble();
+				semi_major_axis = sec.value("orbit_SemiMajorAxis",-1e100).toDouble();
 				if (semi_major_axis <= -1e100) {
 					qWarning() << "ERROR: " << englishName
 						<< ": you must provide orbit_PericenterDistance or orbit_SemiMajorAxis";
@@ -663,9 +679,9 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 								? 0.0 // parabolic orbits have no semi_major_axis
 								: pericenterDistance / (1.0-eccentricity);
 			}
-			double meanMotion = pd.value(secname+"/orbit_MeanMotion",-1e100).toDouble();
+			double meanMotion = sec.value("orbit_MeanMotion",-1e100).toDouble();
 			if (meanMotion <= -1e100) {
-				const double period = pd.value(secname+"/orbit_Period",-1e100).toDouble();
+				const double period = sec.value("orbit_Period",-1e100).toDouble();
 				if (period <= -1e100) {
 					if (parent->getParent()) {
 						qWarning() << "ERROR: " << englishName
@@ -689,10 +705,10 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 			} else {
 				meanMotion *= (M_PI/180.0);
 			}
-			double time_at_pericenter = pd.value(secname+"/orbit_TimeAtPericenter",-1e100).toDouble();
+			double time_at_pericenter = sec.value("orbit_TimeAtPericenter",-1e100).toDouble();
 			if (time_at_pericenter <= -1e100) {
-				const double epoch = pd.value(secname+"/orbit_Epoch",-1e100).toDouble();
-				double mean_anomaly = pd.value(secname+"/orbit_MeanAnomaly",-1e100).toDouble();
+				const double epoch = sec.value("orbit_Epoch",-1e100).toDouble();
+				double mean_anomaly = sec.value("orbit_MeanAnomaly",-1e100).toDouble();
 				if (epoch <= -1e100 || mean_anomaly <= -1e100) {
 					qWarning() << "ERROR: " << englishName
 						<< ": when you do not provide orbit_TimeAtPericenter, you must provide both "
@@ -704,10 +720,10 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 					time_at_pericenter = epoch - mean_anomaly / meanMotion;
 				}
 			}
-			const double orbitGoodDays=pd.value(secname+"/orbit_good", 1000).toDouble();
-			const double inclination = pd.value(secname+"/orbit_Inclination").toDouble()*(M_PI/180.0);
-			const double arg_of_pericenter = pd.value(secname+"/orbit_ArgOfPericenter").toDouble()*(M_PI/180.0);
-			const double ascending_node = pd.value(secname+"/orbit_AscendingNode").toDouble()*(M_PI/180.0);
+			const double orbitGoodDays=sec.value("orbit_good", 1000).toDouble();
+			const double inclination = sec.value("orbit_Inclination").toDouble()*(M_PI/180.0);
+			const double arg_of_pericenter = sec.value("orbit_ArgOfPericenter").toDouble()*(M_PI/180.0);
+			const double ascending_node = sec.value("orbit_AscendingNode").toDouble()*(M_PI/180.0);
 			const double parentRotObliquity = parent->getParent() ? parent->getRotObliquity(2451545.0) : 0.0;
 			const double parent_rot_asc_node = parent->getParent() ? parent->getRotAscendingnode() : 0.0;
 			double parent_rot_j2000_longitude = 0.0;
@@ -738,6 +754,7 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 							 parent_rot_j2000_longitude);
 			orbits.push_back(orb);
 			userDataPtr = orb;
+			orbitPtr = orb;
 			posfunc = &cometOrbitPosFunc;
 		}
 
@@ -855,7 +872,7 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 		}
 
 		// Create the Solar System body and add it to the list
-		QString type = pd.value(secname+"/type").toString();		
+		QString type = sec.value("type").toString();		
 		PlanetP p;
 		// New class objects, named "plutino", "cubewano", "dwarf planet", "SDO", "OCO", has properties
 		// similar to asteroids and we should calculate their positions like for asteroids. Dwarf planets
@@ -863,38 +880,38 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 		if ((type == "asteroid" || type == "dwarf planet" || type == "cubewano" || type == "plutino" || type == "scattered disc object" || type == "Oort cloud object") && !englishName.contains("Pluto"))
 		{
 			p = PlanetP(new MinorPlanet(englishName,
-						    pd.value(secname+"/lighting").toBool(),
-						    pd.value(secname+"/radius").toDouble()/AU,
-						    pd.value(secname+"/oblateness", 0.0).toDouble(),
-						    StelUtils::strToVec3f(pd.value(secname+"/color").toString()),
-						    pd.value(secname+"/albedo").toFloat(),
-						    pd.value(secname+"/tex_map").toString(),
+						    sec.value("lighting").toBool(),
+						    sec.value("radius").toDouble()/AU,
+						    sec.value("oblateness", 0.0).toDouble(),
+						    StelUtils::strToVec3f(sec.value("color").toString()),
+						    sec.value("albedo").toFloat(),
+						    sec.value("tex_map").toString(),
 						    posfunc,
 						    userDataPtr,
 						    osculatingFunc,
 						    closeOrbit,
-						    pd.value(secname+"/hidden", 0).toBool(),						    
+						    sec.value("hidden", 0).toBool(),						    
 						    type));
 
 			QSharedPointer<MinorPlanet> mp =  p.dynamicCast<MinorPlanet>();
 
 			//Number
-			int minorPlanetNumber = pd.value(secname+"/minor_planet_number", 0).toInt();
+			int minorPlanetNumber = sec.value("minor_planet_number", 0).toInt();
 			if (minorPlanetNumber)
 			{
 				mp->setMinorPlanetNumber(minorPlanetNumber);
 			}
 
 			//Provisional designation
-			QString provisionalDesignation = pd.value(secname+"/provisional_designation").toString();
+			QString provisionalDesignation = sec.value("provisional_designation").toString();
 			if (!provisionalDesignation.isEmpty())
 			{
 				mp->setProvisionalDesignation(provisionalDesignation);
 			}
 
 			//H-G magnitude system
-			double magnitude = pd.value(secname+"/absolute_magnitude", -99).toDouble();
-			double slope = pd.value(secname+"/slope_parameter", 0.15).toDouble();
+			double magnitude = sec.value("absolute_magnitude", -99).toDouble();
+			double slope = sec.value("slope_parameter", 0.15).toDouble();
 			if (magnitude > -99)
 			{
 				if (slope >= 0 && slope <= 1)
@@ -907,34 +924,34 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 				}
 			}
 
-			mp->setSemiMajorAxis(pd.value(secname+"/orbit_SemiMajorAxis", 0).toDouble());
+			mp->setSemiMajorAxis(sec.value("orbit_SemiMajorAxis", 0).toDouble());
 
 		}
 		else if (type == "comet")
 		{
 			p = PlanetP(new Comet(englishName,
-			               pd.value(secname+"/lighting").toBool(),
-			               pd.value(secname+"/radius").toDouble()/AU,
-			               pd.value(secname+"/oblateness", 0.0).toDouble(),
-			               StelUtils::strToVec3f(pd.value(secname+"/color").toString()),
-			               pd.value(secname+"/albedo").toFloat(),
-			               pd.value(secname+"/tex_map").toString(),
+			               sec.value("lighting").toBool(),
+			               sec.value("radius").toDouble()/AU,
+			               sec.value("oblateness", 0.0).toDouble(),
+			               StelUtils::strToVec3f(sec.value("color").toString()),
+			               sec.value("albedo").toFloat(),
+			               sec.value("tex_map").toString(),
 			               posfunc,
 			               userDataPtr,
 			               osculatingFunc,
 			               closeOrbit,
-						   pd.value(secname+"/hidden", 0).toBool(),
+						   sec.value("hidden", 0).toBool(),
 						   type,
-						   pd.value(secname+"/dust_widthfactor", 1.5f).toFloat(),
-						   pd.value(secname+"/dust_lengthfactor", 0.4f).toFloat(),
-						   pd.value(secname+"/dust_brightnessfactor", 1.5f).toFloat()
+						   sec.value("dust_widthfactor", 1.5f).toFloat(),
+						   sec.value("dust_lengthfactor", 0.4f).toFloat(),
+						   sec.value("dust_brightnessfactor", 1.5f).toFloat()
 						  ));
 
 			QSharedPointer<Comet> mp =  p.dynamicCast<Comet>();
 
 			//g,k magnitude system
-			double magnitude = pd.value(secname+"/absolute_magnitude", -99).toDouble();
-			double slope = pd.value(secname+"/slope_parameter", 4.0).toDouble();
+			double magnitude = sec.value("absolute_magnitude", -99).toDouble();
+			double slope = sec.value("slope_parameter", 4.0).toDouble();
 			if (magnitude > -99)
 			{
 				if (slope >= 0 && slope <= 20)
@@ -947,8 +964,8 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 				}
 			}
 
-			const double eccentricity = pd.value(secname+"/orbit_Eccentricity",0.0).toDouble();
-			const double pericenterDistance = pd.value(secname+"/orbit_PericenterDistance",-1e100).toDouble();
+			const double eccentricity = sec.value("orbit_Eccentricity",0.0).toDouble();
+			const double pericenterDistance = sec.value("orbit_PericenterDistance",-1e100).toDouble();
 			if (eccentricity<1 && pericenterDistance>0)
 			{
 				mp->setSemiMajorAxis(pericenterDistance / (1.0-eccentricity));
@@ -961,24 +978,27 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 			// Details: https://bugs.launchpad.net/stellarium/+bug/1335609
 			QString normalMapName = englishName.toLower().append("_normals.png");
 			p = PlanetP(new Planet(englishName,
-					       pd.value(secname+"/lighting").toBool(),
-					       pd.value(secname+"/radius").toDouble()/AU,
-					       pd.value(secname+"/oblateness", 0.0).toDouble(),
-					       StelUtils::strToVec3f(pd.value(secname+"/color").toString()),
-					       pd.value(secname+"/albedo").toFloat(),
-					       pd.value(secname+"/tex_map").toString(),
-					       pd.value(secname+"/normals_map", normalMapName).toString(),
+					       sec.value("lighting").toBool(),
+					       sec.value("radius").toDouble()/AU,
+					       sec.value("oblateness", 0.0).toDouble(),
+					       StelUtils::strToVec3f(sec.value("color").toString()),
+					       sec.value("albedo").toFloat(),
+					       sec.value("tex_map").toString(),
+					       sec.value("normals_map", normalMapName).toString(),
 					       posfunc,
 					       userDataPtr,
 					       osculatingFunc,
 					       closeOrbit,
-					       pd.value(secname+"/hidden", 0).toBool(),
-					       pd.value(secname+"/atmosphere", false).toBool(),
-					       pd.value(secname+"/halo", 0).toBool(),
+					       sec.value("hidden", 0).toBool(),
+					       sec.value("atmosphere", false).toBool(),
+					       sec.value("halo", 0).toBool(),
 					       type));
 		}
 
 
+		p->setOrbit(orbitPtr);
+		p->setOrbitBatchIndex(orbitBatchIndex);
+
 		if (!parent.isNull())
 		{
 			parent->satellites.append(p);
@@ -988,14 +1008,14 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 		if (secname=="sun") sun = p;
 		if (secname=="moon") moon = p;
 
-		double rotObliquity = pd.value(secname+"/rot_obliquity",0.).toDouble()*(M_PI/180.0);
-		double rotAscNode = pd.value(secname+"/rot_equator_ascending_node",0.).toDouble()*(M_PI/180.0);
+		double rotObliquity = sec.value("rot_obliquity",0.).toDouble()*(M_PI/180.0);
+		double rotAscNode = sec.value("rot_equator_ascending_node",0.).toDouble()*(M_PI/180.0);
 
 		// Use more common planet North pole data if available
 		// NB: N pole as defined by IAU (NOT right hand rotation rule)
 		// NB: J2000 epoch
-		double J2000NPoleRA = pd.value(secname+"/rot_pole_ra", 0.).toDouble()*M_PI/180.;
-		double J2000NPoleDE = pd.value(secname+"/rot_pole_de", 0.).toDouble()*M_PI/180.;
+		double J2000NPoleRA = sec.value("rot_pole_ra", 0.).toDouble()*M_PI/180.;
+		double J2000NPoleDE = sec.value("rot_pole_de", 0.).toDouble()*M_PI/180.;
 
 		if(J2000NPoleRA || J2000NPoleDE)
 		{
@@ -1015,23 +1035,25 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 		}
 
 		p->setRotationElements(
-			pd.value(secname+"/rot_periode", pd.value(secname+"/orbit_Period", 24.).toDouble()).toDouble()/24.,
-			pd.value(secname+"/rot_rotation_offset",0.).toDouble(),
-			pd.value(secname+"/rot_epoch", J2000).toDouble(),
+			sec.value("rot_periode", sec.value("orbit_Period", 24.).toDouble()).toDouble()/24.,
+			sec.value("rot_rotation_offset",0.).toDouble(),
+			sec.value("rot_epoch", J2000).toDouble(),
 			rotObliquity,
 			rotAscNode,
-			pd.value(secname+"/rot_precession_rate",0.).toDouble()*M_PI/(180*36525),
-			pd.value(secname+"/orbit_visualization_period",0.).toDouble());
+			sec.value("rot_precession_rate",0.).toDouble()*M_PI/(180*36525),
+			sec.value("orbit_visualization_period",0.).toDouble());
 
 
-		if (pd.value(secname+"/rings", 0).toBool()) {
-			const double rMin = pd.value(secname+"/ring_inner_size").toDouble()/AU;
-			const double rMax = pd.value(secname+"/ring_outer_size").toDouble()/AU;
-			Ring *r = new Ring(rMin,rMax,pd.value(secname+"/tex_ring").toString());
+		if (sec.value("rings", 0).toBool()) {
+			const double rMin = sec.value("ring_inner_size").toDouble()/AU;
+			const double rMax = sec.value("ring_outer_size").toDouble()/AU;
+			Ring *r = new Ring(rMin,rMax,sec.value("tex_ring").toString());
 			p->setRings(r);
 		}
 
 		systemPlanets.push_back(p);
+		if (!planetsByName.contains(p->getEnglishName()))
+			planetsByName.insert(p->getEnglishName(), p);
 		readOk++;
 	}
 
@@ -1052,29 +1074,125 @@ bool SolarSystem::loadPlanets(const QString& filePath)
 	return true;
 }
 
+// Light travel time [days] from planet p to an observer at observerPos (heliocentric ecliptic).
+static inline double lightTimeCorrection(const Planet* p, const Vec3d& observerPos)
+{
+	return (p->getHeliocentricEclipticPos()-observerPos).length() * (AU / (SPEED_OF_LIGHT * 86400));
+}
+
+// The position of p computed by a pass of the Kepler orbit batch, or NULL if it is not in the batch
+// or the batch was not computed for this date.
+static inline const Vec3d* batchPosition(const KeplerOrbitBatch* batch, const Planet* p, KeplerOrbitBatch::Pass pass, Vec3d& pos)
+{
+	return batch && batch->getPosition(p->getOrbitBatchIndex(), pass, pos) ? &pos : NULL;
+}
+
+// Below this number of independent bodies, computing them in the calling thread is faster than waking the thread pool.
+static const int minParallelPlanets = 64;
+
+// Computes the position of an independent body. Used with QtConcurrent::blockingMap().
+struct ComputePlanetPosition
+{
+	typedef void result_type;
+	ComputePlanetPosition(double dateJDE, const Vec3d& observerPos, bool lightTravelTime, const KeplerOrbitBatch* batch)
+		: dateJDE(dateJDE), observerPos(observerPos), lightTravelTime(lightTravelTime), batch(batch) {}
+	void operator()(Planet* p) const
+	{
+		Vec3d pos;
+		if (lightTravelTime)
+		{
+			p->computePositionWithoutOrbits(dateJDE, batchPosition(batch, p, KeplerOrbitBatch::CommonPass, pos));
+			p->computeOwnPosition(dateJDE-lightTimeCorrection(p, observerPos), batchPosition(batch, p, KeplerOrbitBatch::LightTimePass, pos));
+		}
+		else
+			p->computeOwnPosition(dateJDE, batchPosition(batch, p, KeplerOrbitBatch::CommonPass, pos));
+	}
+	double dateJDE;
+	Vec3d observerPos;
+	bool lightTravelTime;
+	const KeplerOrbitBatch* batch;
+};
+
+// Computes the transformation matrix of an independent body. Used with QtConcurrent::blockingMap().
+struct ComputePlanetTransMatrix
+{
+	typedef void result_type;
+	ComputePlanetTransMatrix(double dateJD, double dateJDE, const Vec3d& observerPos, bool lightTravelTime)
+		: dateJD(dateJD), dateJDE(dateJDE), observerPos(observerPos), lightTravelTime(lightTravelTime) {}
+	void operator()(Planet* p) const
+	{
+		const double correction = lightTravelTime ? lightTimeCorrection(p, observerPos) : 0.;
+		p->computeTransMatrix(dateJD-correction, dateJDE-correction);
+	}
+	double dateJD;
+	double dateJDE;
+	Vec3d observerPos;
+	bool lightTravelTime;
+};
+
+// Split the bodies into those which have to be computed in dependency order and those which can be computed in parallel.
+// Bodies which orbit the Sun and have no satellites only depend on the Sun, which is computed first.
+// Moons stay in the serial list, they depend on their parents and their theories (L1, TASS17...) are not reentrant.
+void SolarSystem::updatePositionSchedule()
+{
+	dependentPlanets.clear();
+	independentPlanets.clear();
+	// loadPlanets() only accepts parents defined before their satellites,
+	// so the order of systemPlanets after loading is Sun, planets, moons.
+	foreach (const PlanetP& p, systemPlanets)
+	{
+		if (p->parent == sun && p->satellites.isEmpty())
+			independentPlanets.append(p.data());
+		else
+			dependentPlanets.append(p.data());
+	}
+}
+
 // Compute the position for every elements of the solar system.
-// The order is not important since the position is computed relatively to the mother body
+// Parents are computed before their satellites, then the independent bodies are computed in parallel.
+// Each body only changes its own state, so the result does not depend on the scheduling.
 void SolarSystem::computePositions(double dateJDE, const Vec3d& observerPos)
 {
+	// Solve all heliocentric elliptical orbits in one pass, the planets then take the results of the passes.
+	// Minor bodies are only recomputed after about a second (Planet::deltaJDE), so don't solve them more often.
+	// In the other frames, the planets which need a new position compute it with their position function.
+	const KeplerOrbitBatch* batch = NULL;
+	if (keplerOrbits->size()>0 && fabs(dateJDE-keplerOrbitsJDE)>=StelCore::JD_SECOND)
+	{
+		if (flagLightTravelTime)
+			keplerOrbits->computeWithLightTime(dateJDE, observerPos);
+		else
+			keplerOrbits->compute(dateJDE);
+		keplerOrbitsJDE = dateJDE;
+		batch = keplerOrbits;
+	}
+
+	Vec3d pos;
 	if (flagLightTravelTime)
 	{
-		foreach (PlanetP p, systemPlanets)
+		foreach (Planet* p, dependentPlanets)
 		{
-			p->computePositionWithoutOrbits(dateJDE);
+			p->computePositionWithoutOrbits(dateJDE, batchPosition(batch, p, KeplerOrbitBatch::CommonPass, pos));
 		}
-		foreach (PlanetP p, systemPlanets)
+		foreach (Planet* p, dependentPlanets)
 		{
-			const double light_speed_correction = (p->getHeliocentricEclipticPos()-observerPos).length() * (AU / (SPEED_OF_LIGHT * 86400));
-			p->computePosition(dateJDE-light_speed_correction);
+			p->computeOwnPosition(dateJDE-lightTimeCorrection(p, observerPos), batchPosition(batch, p, KeplerOrbitBatch::LightTimePass, pos));
 		}
 	}
 	else
 	{
-		foreach (PlanetP p, systemPlanets)
+		foreach (Planet* p, dependentPlanets)
 		{
-			p->computePosition(dateJDE);
+			p->computeOwnPosition(dateJDE, batchPosition(batch, p, KeplerOrbitBatch::CommonPass, pos));
 		}
 	}
+
+	const ComputePlanetPosition computePosition(dateJDE, observerPos, flagLightTravelTime, batch);
+	if (independentPlanets.size()<minParallelPlanets)
+		std::for_each(independentPlanets.begin(), independentPlanets.end(), computePosition);
+	else
+		QtConcurrent::blockingMap(independentPlanets, computePosition);
+
 	computeTransMatrices(dateJDE, observerPos);
 }
 
@@ -1086,19 +1204,25 @@ void SolarSystem::computeTransMatrices(double dateJDE, const Vec3d& observerPos)
 
 	if (flagLightTravelTime)
 	{
-		foreach (PlanetP p, systemPlanets)
+		foreach (Planet* p, dependentPlanets)
 		{
-			const double light_speed_correction = (p->getHeliocentricEclipticPos()-observerPos).length() * (AU / (SPEED_OF_LIGHT * 86400));
+			const double light_speed_correction = lightTimeCorrection(p, observerPos);
 			p->computeTransMatrix(dateJD-light_speed_correction, dateJDE-light_speed_correction);
 		}
 	}
 	else
 	{
-		foreach (PlanetP p, systemPlanets)
+		foreach (Planet* p, dependentPlanets)
 		{
 			p->computeTransMatrix(dateJD, dateJDE);
 		}
 	}
+
+	const ComputePlanetTransMatrix computeTransMatrix(dateJD, dateJDE, observerPos, flagLightTravelTime);
+	if (independentPlanets.size()<minParallelPlanets)
+		std::for_each(independentPlanets.begin(), independentPlanets.end(), computeTransMatrix);
+	else
+		QtConcurrent::blockingMap(independentPlanets, computeTransMatrix);
 }
 
 // And sort them from the furthest to the closest to the observer
@@ -1739,6 +1863,7 @@ void SolarSystem::reloadPlanets()
 	}
 	// Unload all Solar System objects
 	selected.clear();//Release the selected one
+	keplerOrbits->clear();
 	foreach (Orbit* orb, orbits)
 	{
 		delete orb;
@@ -1760,6 +1885,8 @@ void SolarSystem::reloadPlanets()
 		p.clear();
 	}
 	systemPlanets.clear();
+	dependentPlanets.clear();
+	independentPlanets.clear();
 	// Memory leak? What's the proper way of cleaning shared pointers?
 
 	// Also delete Comet textures (loaded in loadPlanets()
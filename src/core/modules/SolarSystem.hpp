@@ -31,6 +31,7 @@
 #include "StelGui.hpp"
 
 #include <QFont>
+#include <QVector>
 
 class Orbit;
 class StelTranslator;
@@ -489,6 +490,9 @@ private:
 	//! observerPos is needed for light travel time computation.
 	void computeTransMatrices(double dateJDE, const Vec3d& observerPos = Vec3d(0.));
 
+	//! Rebuild dependentPlanets and independentPlanets from systemPlanets.
+	void updatePositionSchedule();
+
 	//! Draw a nice animated pointer around the object.
 	void drawPointer(const StelCore* core);
 
@@ -533,6 +537,10 @@ private:
 
 	//! List of all the bodies of the solar system.
 	QList<PlanetP> systemPlanets;
+	//! Bodies which have to be computed in dependency order (Sun, planets with satellites, moons).
+	QVector<Planet*> dependentPlanets;
+	//! Bodies which only depend on the Sun and are computed in parallel.
+	QVector<Planet*> independentPlanets;
 
 	// Master settings
 	bool flagOrbits;
@@ -561,6 +569,10 @@ private:
 	QHash<QString, QString> planetNativeNamesMap;
 
 	QList<Orbit*> orbits;           // Pointers on created elliptical orbits
+	//! The heliocentric elliptical orbits of orbits, solved together.
+	class KeplerOrbitBatch* keplerOrbits;
+	//! Date of the last computation of keplerOrbits.
+	double keplerOrbitsJDE;
 };
 
 
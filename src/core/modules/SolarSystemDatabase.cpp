@@ -0,0 +1,127 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include "SolarSystemDatabase.hpp"
+#include "StelCompiledCache.hpp"
+#include "StelIniParser.hpp"
+
+#include <QBuffer>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+
+// Identifies the compiled files, and their format version
+#define SSDB_MAGIC 0x53534442
+#define SSDB_VERSION 1
+
+bool SolarSystemDatabase::load(const QString& filePath)
+{
+	names.clear();
+	sections.clear();
+
+	// The ini file is only read if the compiled copy is out of date
+	StelCompiledCache cache(filePath, "solarsystem", SSDB_MAGIC, SSDB_VERSION);
+	QDataStream* in = cache.beginRead();
+	if (in)
+	{
+		readSections(*in);
+		if (cache.endRead())
+			return true;
+		names.clear();
+		sections.clear();
+	}
+
+	QFile file(filePath);
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		qWarning() << "ERROR while opening" << QDir::toNativeSeparators(filePath) << file.errorString();
+		return false;
+	}
+	parseIni(file.readAll());
+	file.close();
+	QDataStream* out = cache.beginWrite();
+	if (out)
+	{
+		writeSections(*out);
+		cache.endWrite();
+	}
+	return true;
+}
+
+const SolarSystemDatabase::Section& SolarSystemDatabase::section(const QString& name) const
+{
+	QHash<QString, Section>::const_iterator it = sections.constFind(name);
+	return it==sections.constEnd() ? emptySection : *it;
+}
+
+void SolarSystemDatabase::parseIni(const QByteArray& data)
+{
+	QByteArray copy(data);
+	QBuffer buffer(&copy);
+	buffer.open(QIODevice::ReadOnly);
+	QSettings::SettingsMap map;
+	readStelIniFile(buffer, map);
+
+	// The keys of one section are contiguous in the sorted map
+	for (QSettings::SettingsMap::const_iterator it=map.constBegin(); it!=map.constEnd(); ++it)
+	{
+		const int slash = it.key().indexOf('/');
+		if (slash<=0)
+			continue;
+		const QString name = it.key().left(slash);
+		if (names.isEmpty() || names.last()!=name)
+			names << name;
+		sections[name].values.insert(it.key().mid(slash+1), it.value().toString());
+	}
+	// Same order as QSettings::childGroups()
+	names.sort();
+}
+
+void SolarSystemDatabase::readSections(QDataStream& in)
+{
+	quint32 count;
+	in >> count;
+	for (quint32 i=0; i<count && in.status()==QDataStream::Ok; ++i)
+	{
+		QString name;
+		quint32 keyCount;
+		in >> name >> keyCount;
+		Section& sec = sections[name];
+		sec.values.reserve(keyCount);
+		for (quint32 k=0; k<keyCount && in.status()==QDataStream::Ok; ++k)
+		{
+			QString key, value;
+			in >> key >> value;
+			sec.values.insert(key, value);
+		}
+		names << name;
+	}
+}
+
+void SolarSystemDatabase::writeSections(QDataStream& out) const
+{
+	out << (quint32)names.size();
+	foreach (const QString& name, names)
+	{
+		const Section& sec = section(name);
+		out << name << (quint32)sec.values.size();
+		for (QHash<QString, QString>::const_iterator it=sec.values.constBegin(); it!=sec.values.constEnd(); ++it)
+			out << it.key() << it.value();
+	}
+}
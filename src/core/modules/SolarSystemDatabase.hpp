@@ -0,0 +1,75 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _SOLARSYSTEMDATABASE_HPP_
+#define _SOLARSYSTEMDATABASE_HPP_
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+//! @class SolarSystemDatabase
+//! Parsed contents of a solar system configuration file (ssystem.ini).
+//! Parsing a large file with QSettings takes a long time, so the parsed sections are written
+//! to a StelCompiledCache. On the next start, the compiled file is read instead of the ini file,
+//! which is not read at all, as long as its size and modification time are unchanged (the
+//! SolarSystemEditor plugin rewrites the file when it changes the bodies).
+class SolarSystemDatabase
+{
+public:
+	//! The keys of one section (one body) of the file.
+	class Section
+	{
+	public:
+		//! Same as QSettings::value("section/key", defaultValue).
+		QVariant value(const QString& key, const QVariant& defaultValue = QVariant()) const
+		{
+			QHash<QString, QString>::const_iterator it = values.constFind(key);
+			return it==values.constEnd() ? defaultValue : QVariant(*it);
+		}
+		QHash<QString, QString> values;
+	};
+
+	//! Load filePath, through the compiled cache if it is up to date.
+	//! If it is not, the ini file is parsed and the cache is rewritten.
+	//! @return false if the file could not be read.
+	bool load(const QString& filePath);
+
+	//! The section names, like QSettings::childGroups().
+	const QStringList& sectionNames() const {return names;}
+	//! Get a section by name. Returns an empty section for unknown names.
+	const Section& section(const QString& name) const;
+
+private:
+	//! Parse the ini file contents with the StelIniFormat parser.
+	void parseIni(const QByteArray& data);
+	//! Read the sections from the records of the compiled file.
+	void readSections(QDataStream& in);
+	//! Write the sections as records of the compiled file.
+	void writeSections(QDataStream& out) const;
+
+	QStringList names;
+	QHash<QString, Section> sections;
+	Section emptySection;
+};
+
+#endif // _SOLARSYSTEMDATABASE_HPP_
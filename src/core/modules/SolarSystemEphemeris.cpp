@@ -0,0 +1,108 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include "SolarSystemEphemeris.hpp"
+#include "SolarSystem.hpp"
+#include "StelApp.hpp"
+#include "StelCore.hpp"
+#include "StelModuleMgr.hpp"
+#include "StelUtils.hpp"
+
+SolarSystemEphemeris::SolarSystemEphemeris(const StelCore* core)
+	: core(core)
+	, observer(core->getCurrentLocation())
+	, flagTopocentric(core->getUseTopocentricCoordinates())
+	, flagLightTravelTime(GETSTELMODULE(SolarSystem)->getFlagLightTravelTime())
+{
+}
+
+SolarSystemEphemeris::SolarSystemEphemeris(const StelCore* core, const StelLocation& location, bool topocentric)
+	: core(core)
+	, observer(location)
+	, flagTopocentric(topocentric)
+	, flagLightTravelTime(GETSTELMODULE(SolarSystem)->getFlagLightTravelTime())
+{
+}
+
+Vec3d SolarSystemEphemeris::getObserverHeliocentricEclipticPos(double JD, double JDE) const
+{
+	const PlanetP& home = observer.getHomePlanet();
+	Vec3d pos = home->computeHeliocentricEclipticPosAt(JDE);
+	if (flagTopocentric)
+	{
+		// Same as the translation in StelCore::updateTransformMatrices(), but with the axis orientation for JDE.
+		const Mat4d altAzToVsop87 = home->computeRotEquatorialToVsop87(JDE) * observer.getRotAltAzToEquatorial(JD, JDE);
+		pos += altAzToVsop87.multiplyWithoutTranslation(Vec3d(0., 0., observer.getDistanceFromCenter()));
+	}
+	return pos;
+}
+
+Vec3d SolarSystemEphemeris::computeBodyPos(const PlanetP& body, const Vec3d& obsPos, double JDE, double* bodyJDE) const
+{
+	Vec3d pos = body->computeHeliocentricEclipticPosAt(JDE);
+	*bodyJDE = JDE;
+	if (flagLightTravelTime)
+	{
+		// Same correction as in SolarSystem::computePositions()
+		const double light_speed_correction = (pos-obsPos).length() * (AU / (SPEED_OF_LIGHT * 86400));
+		*bodyJDE = JDE - light_speed_correction;
+		pos = body->computeHeliocentricEclipticPosAt(*bodyJDE);
+	}
+	return pos;
+}
+
+SolarSystemEphemeris::Entry SolarSystemEphemeris::compute(const PlanetP& body, double JD) const
+{
+	Entry e;
+	e.JD = JD;
+	e.JDE = JD + core->computeDeltaT(JD)/86400.0;
+	e.observerPos = getObserverHeliocentricEclipticPos(e.JD, e.JDE);
+
+	double bodyJDE;
+	e.heliocentricPos = computeBodyPos(body, e.observerPos, e.JDE, &bodyJDE);
+	e.j2000Pos = StelCore::matVsop87ToJ2000.multiplyWithoutTranslation(e.heliocentricPos - e.observerPos);
+	e.distance = e.j2000Pos.length();
+
+	const PlanetP& parent = body->getParent();
+	const Vec3d parentPos = parent ? parent->computeHeliocentricEclipticPosAt(bodyJDE) : Vec3d(0.);
+	e.vMagnitude = body->computeVMagnitude(core, e.observerPos, e.heliocentricPos, parentPos, e.JDE);
+	return e;
+}
+
+QVector<SolarSystemEphemeris::Entry> SolarSystemEphemeris::compute(const PlanetP& body, double startJD, double stopJD, double step) const
+{
+	QVector<Entry> result;
+	if (step<=0. || stopJD<startJD)
+		return result;
+
+	const int elements = (int)((stopJD - startJD)/step);
+	result.reserve(elements);
+	for (int i=0; i<elements; i++)
+		result.append(compute(body, startJD + i*step));
+	return result;
+}
+
+Vec3d SolarSystemEphemeris::getJ2000EquatorialPos(const PlanetP& body, double JD) const
+{
+	const double JDE = JD + core->computeDeltaT(JD)/86400.0;
+	const Vec3d obsPos = getObserverHeliocentricEclipticPos(JD, JDE);
+	double bodyJDE;
+	const Vec3d pos = computeBodyPos(body, obsPos, JDE, &bodyJDE);
+	return StelCore::matVsop87ToJ2000.multiplyWithoutTranslation(pos - obsPos);
+}
@@ -0,0 +1,88 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _SOLARSYSTEMEPHEMERIS_HPP_
+#define _SOLARSYSTEMEPHEMERIS_HPP_
+
+#include "Planet.hpp"
+#include "StelObserver.hpp"
+#include "StelLocation.hpp"
+#include "VecMath.hpp"
+
+#include <QVector>
+
+class StelCore;
+
+//! @class SolarSystemEphemeris
+//! Computes positions and magnitudes of solar system bodies for arbitrary dates.
+//! Unlike StelCore::setJD() followed by StelCore::update(), this does not change the
+//! state of StelCore or of any Planet: only the requested body, its parents and the
+//! observer's planet are evaluated, through Planet::computeHeliocentricEclipticPosAt().
+//! This makes it suitable for ephemeris tables and searches for conjunctions etc.
+class SolarSystemEphemeris
+{
+public:
+	//! One sample of an ephemeris.
+	struct Entry
+	{
+		double JD;             //!< JD(UT) of the sample
+		double JDE;            //!< JD(TT) of the sample
+		Vec3d heliocentricPos; //!< Heliocentric ecliptic position of the body, corrected for light time if enabled [AU]
+		Vec3d observerPos;     //!< Heliocentric ecliptic position of the observer [AU]
+		Vec3d j2000Pos;        //!< Observer-centric equatorial J2000 position [AU], like StelObject::getJ2000EquatorialPos()
+		double distance;       //!< Distance between observer and body [AU]
+		float vMagnitude;      //!< Visual magnitude (without extinction)
+	};
+
+	//! Create an ephemeris for the current location of core, using the current settings
+	//! for topocentric coordinates and light travel time.
+	//! @param core is only used for DeltaT and settings, its time is never changed.
+	SolarSystemEphemeris(const StelCore* core);
+	//! Create an ephemeris for an observer at the given location.
+	//! @param core is only used for DeltaT and settings, its time is never changed.
+	//! @param location the observer location. If its planet is unknown, Earth is used.
+	//! @param topocentric if true, the observer is on the surface of its planet, else in its center.
+	SolarSystemEphemeris(const StelCore* core, const StelLocation& location, bool topocentric);
+
+	//! Set whether the positions of the bodies are corrected for light travel time.
+	void setFlagLightTravelTime(bool b) {flagLightTravelTime=b;}
+	bool getFlagLightTravelTime() const {return flagLightTravelTime;}
+
+	//! Get the heliocentric ecliptic position of the observer for the given dates.
+	Vec3d getObserverHeliocentricEclipticPos(double JD, double JDE) const;
+
+	//! Compute the position and magnitude of body for a single date.
+	//! @param JD Julian day (UT)
+	Entry compute(const PlanetP& body, double JD) const;
+	//! Compute the positions and magnitudes of body from startJD to stopJD (exclusive) in steps of step days.
+	QVector<Entry> compute(const PlanetP& body, double startJD, double stopJD, double step) const;
+	//! Get the observer-centric equatorial J2000 position of body at JD(UT) without computing the magnitude.
+	Vec3d getJ2000EquatorialPos(const PlanetP& body, double JD) const;
+
+private:
+	//! Compute the (light time corrected) heliocentric position of body as seen from obsPos at JDE.
+	Vec3d computeBodyPos(const PlanetP& body, const Vec3d& obsPos, double JDE, double* bodyJDE) const;
+
+	const StelCore* core;
+	StelObserver observer;
+	bool flagTopocentric;
+	bool flagLightTravelTime;
+};
+
+#endif // _SOLARSYSTEMEPHEMERIS_HPP_
@@ -56,6 +56,8 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QCryptographicHash>
+#include <QtConcurrent>
+#include <QVarLengthArray>
 
 #include <errno.h>
 
@@ -163,6 +165,9 @@ StarMgr::~StarMgr(void)
 	foreach(ZoneArray* z, gridLevels)
 		delete z;
 	gridLevels.clear();
+	foreach(StarCullBuffer* b, cullBuffers)
+		delete b;
+	cullBuffers.clear();
 	if (hipIndex)
 		delete[] hipIndex;
 }
@@ -981,6 +986,51 @@ int StarMgr::getMaxSearchLevel() const
 
 
 // Draw all the stars
+// Below this number of zones in a level, culling them in the calling thread is faster than waking the thread pool.
+static const int minParallelZones = 8;
+
+// A zone to cull.
+struct StarZone
+{
+	StarZone() : zone(-1), isInside(false) {}
+	StarZone(int zone, bool isInside) : zone(zone), isInside(isInside) {}
+	int zone;
+	bool isInside;
+};
+Q_DECLARE_TYPEINFO(StarZone, Q_PRIMITIVE_TYPE);
+
+// A range of the zones of a level culled by one thread, into its buffer.
+struct StarCullTask
+{
+	int begin;
+	int end;
+	StarCullBuffer* buffer;
+};
+
+// Culls and projects the stars of a range of zones of a level. Used with QtConcurrent::blockingMap().
+struct CullStarZones
+{
+	typedef void result_type;
+	CullStarZones(const ZoneArray* z, const StarZone* zones, const StelProjector* prj, const RCMag* rcmag_table, int limitMagIndex,
+		      const StelCore* core, int maxMagStarName, const QVector<SphericalCap>& viewportCaps)
+		: z(z), zones(zones), prj(prj), rcmag_table(rcmag_table), limitMagIndex(limitMagIndex), core(core),
+		  maxMagStarName(maxMagStarName), viewportCaps(viewportCaps) {}
+	void operator()(const StarCullTask& task) const
+	{
+		task.buffer->stars.clear();
+		for (int i=task.begin; i<task.end; ++i)
+			z->cullZone(prj, zones[i].zone, zones[i].isInside, rcmag_table, limitMagIndex, core, maxMagStarName, viewportCaps, *task.buffer);
+	}
+	const ZoneArray* z;
+	const StarZone* zones;
+	const StelProjector* prj;
+	const RCMag* rcmag_table;
+	int limitMagIndex;
+	const StelCore* core;
+	int maxMagStarName;
+	const QVector<SphericalCap>& viewportCaps;
+};
+
 void StarMgr::draw(StelCore* core)
 {
 	const StelProjectorP prj = core->getProjection(StelCore::FrameJ2000);
@@ -1005,6 +1055,9 @@ void StarMgr::draw(StelCore* core)
 
 	// Prepare a table for storing precomputed RCMag for all ZoneArrays
 	RCMag rcmag_table[RCMAG_TABLE_SIZE];
+	// Zones of the current level, and their split between the threads
+	QVarLengthArray<StarZone, 1024> zones;
+	QVarLengthArray<StarCullTask, 64> tasks;
 	
 	// Draw all the stars of all the selected zones
 	foreach(const ZoneArray* z, gridLevels)
@@ -1047,10 +1100,48 @@ void StarMgr::draw(StelCore* core)
 		}
 		int zone;
 		
+		// First pass: cull and project the stars of each zone, in parallel. Each thread culls a
+		// contiguous range of zones into its own buffer, which keeps its memory for the next frames.
+		zones.clear();
 		for (GeodesicSearchInsideIterator it1(*geodesic_search_result,z->level);(zone = it1.next()) >= 0;)
-			z->draw(&sPainter, zone, true, rcmag_table, limitMagIndex, core, maxMagStarName, names_brightness, viewportCaps);
+			zones.append(StarZone(zone, true));
 		for (GeodesicSearchBorderIterator it1(*geodesic_search_result,z->level);(zone = it1.next()) >= 0;)
-			z->draw(&sPainter, zone, false, rcmag_table, limitMagIndex, core, maxMagStarName,names_brightness, viewportCaps);
+			zones.append(StarZone(zone, false));
+
+		const int nbTasks = zones.size()<minParallelZones ? 1 : qMin(zones.size(), QThreadPool::globalInstance()->maxThreadCount());
+		while (cullBuffers.size()<nbTasks)
+			cullBuffers.append(new StarCullBuffer());
+		tasks.resize(nbTasks);
+		for (int t=0; t<nbTasks; ++t)
+		{
+			tasks[t].begin = zones.size()*t/nbTasks;
+			tasks[t].end = zones.size()*(t+1)/nbTasks;
+			tasks[t].buffer = cullBuffers.at(t);
+		}
+
+		const CullStarZones cull(z, zones.constData(), prj.data(), rcmag_table, limitMagIndex, core, maxMagStarName, viewportCaps);
+		if (nbTasks==1)
+			cull(tasks[0]);
+		else
+			QtConcurrent::blockingMap(tasks.begin(), tasks.end(), cull);
+
+		// Second pass: draw the zones in the order of the iterators, so that the stars twinkle and
+		// the labels are drawn exactly as when the zones are drawn one after the other
+		for (int t=0; t<nbTasks; ++t)
+		{
+			const std::vector<CulledStar>& stars = tasks[t].buffer->stars;
+			for (std::vector<CulledStar>::const_iterator s=stars.begin(); s!=stars.end(); ++s)
+			{
+				skyDrawer->drawProjectedPointSource(&sPainter, s->win, s->rcmag, StelSkyDrawer::indexToColor(s->bV), s->twinkleFactor);
+				if (s->label)
+				{
+					const float offset = s->rcmag.radius*0.7f;
+					const Vec3f colorr = StelSkyDrawer::indexToColor(s->bV)*0.75f;
+					sPainter.setColor(colorr[0], colorr[1], colorr[2],names_brightness);
+					sPainter.drawText(Vec3d(s->pos[0], s->pos[1], s->pos[2]), s->label->getNameI18n(), 0, offset, offset, false);
+				}
+			}
+		}
 	}
 	exit_loop:
 
@@ -1150,6 +1241,48 @@ void StarMgr::updateI18n()
 		commonNamesMapI18n[i] = t;
 		commonNamesIndexI18n[t.toUpper()] = i;
 	}
+	updateNameIndex();
+}
+
+float StarMgr::getHipMagnitude(int hip) const
+{
+	if (0 < hip && hip <= NR_OF_HIP && hipIndex[hip].s)
+	{
+		const SpecialZoneArray<Star1>* a = hipIndex[hip].a;
+		return 0.001f*a->mag_min + hipIndex[hip].s->getMag()*(0.001f*a->mag_range)/a->mag_steps;
+	}
+	return 99.f;
+}
+
+void StarMgr::updateNameIndex() const
+{
+	// The names which do not depend on the language
+	QVector<StelObjectNameIndex::Entry> designations;
+	for (QHash<int,QString>::ConstIterator it(sciNamesMapI18n.constBegin()); it!=sciNamesMapI18n.constEnd(); ++it)
+	{
+		const QString& name = it.value();
+		// "alpha1 Cen" is also found as "alpha Cen"
+		const bool greekIndex = name.size()>1 && name.at(0).unicode()>=0x0370 && name.at(0).unicode()<=0x03FF && name.at(1).isDigit();
+		designations << StelObjectNameIndex::Entry(name, getHipMagnitude(it.key()), it.key());
+		if (greekIndex)
+			designations << StelObjectNameIndex::Entry(name, getHipMagnitude(it.key()), it.key(), name.left(1) + name.mid(2));
+	}
+	for (QHash<int,QString>::ConstIterator it(sciAdditionalNamesMapI18n.constBegin()); it!=sciAdditionalNamesMapI18n.constEnd(); ++it)
+		designations << StelObjectNameIndex::Entry(it.value(), getHipMagnitude(it.key()), it.key());
+	for (QHash<int,varstar>::ConstIterator it(varStarsMapI18n.constBegin()); it!=varStarsMapI18n.constEnd(); ++it)
+		designations << StelObjectNameIndex::Entry(it.value().designation, getHipMagnitude(it.key()), it.key());
+	for (QHash<int,wds>::ConstIterator it(wdsStarsMapI18n.constBegin()); it!=wdsStarsMapI18n.constEnd(); ++it)
+		designations << StelObjectNameIndex::Entry(getWdsName(it.key()), getHipMagnitude(it.key()), it.key());
+
+	QVector<StelObjectNameIndex::Entry> english(designations), translated(designations);
+	for (QHash<int,QString>::ConstIterator it(commonNamesMap.constBegin()); it!=commonNamesMap.constEnd(); ++it)
+		english << StelObjectNameIndex::Entry(it.value(), getHipMagnitude(it.key()), it.key());
+	for (QHash<int,QString>::ConstIterator it(commonNamesMapI18n.constBegin()); it!=commonNamesMapI18n.constEnd(); ++it)
+		translated << StelObjectNameIndex::Entry(it.value(), getHipMagnitude(it.key()), it.key());
+
+	StelObjectNameIndex& index = StelApp::getInstance().getStelObjectMgr().getNameIndex();
+	index.setNames(objectName(), true, english);
+	index.setNames(objectName(), false, translated);
 }
 
 // Search the star by HP number
@@ -1392,6 +1525,39 @@ QStringList StarMgr::listMatchingObjects(const QString& objPrefix, int maxNbItem
 			break;
 	}
 
+	// Add exact Hp, SAO and HD catalogue numbers
+	const QStringList designations = listMatchingDesignations(objPrefix, maxNbItem);
+	result << designations;
+	maxNbItem -= designations.size();
+
+	// Add exact WDS catalogue numbers
+	QRegExp wdsRx("^(WDS)\\s*(\\S+)\\s*$");
+	wdsRx.setCaseSensitivity(Qt::CaseInsensitive);
+	if (wdsRx.exactMatch(objw))
+	{
+		for (QMap<QString,int>::const_iterator wds(wdsStarsIndexI18n.lowerBound(objw)); wds!=wdsStarsIndexI18n.end(); ++wds)
+		{
+			if (wds.key().startsWith(objw))
+			{
+				if (maxNbItem==0)
+					break;
+				result << getWdsName(wds.value());
+				--maxNbItem;
+			}
+			else
+				break;
+		}
+	}
+
+	result.sort();
+	return result;
+}
+
+QStringList StarMgr::listMatchingDesignations(const QString& objPrefix, int maxNbItem) const
+{
+	QStringList result;
+	QString objw = objPrefix.toUpper();
+
 	// Add exact Hp catalogue numbers
 	QRegExp hpRx("^(HIP|HP)\\s*(\\d+)\\s*$");
 	hpRx.setCaseSensitivity(Qt::CaseInsensitive);
@@ -1448,26 +1614,6 @@ QStringList StarMgr::listMatchingObjects(const QString& objPrefix, int maxNbItem
 		}
 	}
 
-	// Add exact WDS catalogue numbers
-	QRegExp wdsRx("^(WDS)\\s*(\\S+)\\s*$");
-	wdsRx.setCaseSensitivity(Qt::CaseInsensitive);
-	if (wdsRx.exactMatch(objw))
-	{
-		for (QMap<QString,int>::const_iterator wds(wdsStarsIndexI18n.lowerBound(objw)); wds!=wdsStarsIndexI18n.end(); ++wds)
-		{
-			if (wds.key().startsWith(objw))
-			{
-				if (maxNbItem==0)
-					break;
-				result << getWdsName(wds.value());
-				--maxNbItem;
-			}
-			else
-				break;
-		}
-	}
-
-	result.sort();
 	return result;
 }
 
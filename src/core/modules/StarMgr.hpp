@@ -36,6 +36,7 @@ class QSettings;
 
 class ZoneArray;
 struct HipIndexStruct;
+struct StarCullBuffer;
 
 static const int RCMAG_TABLE_SIZE = 4096;
 
@@ -146,6 +147,8 @@ public:
 	//! @param useStartOfWords the autofill mode for returned objects names
 	//! @return a list of matching object name by order of relevance, or an empty list if nothing match
 	virtual QStringList listMatchingObjects(const QString& objPrefix, int maxNbItem=5, bool useStartOfWords=false, bool inEnglish=false) const;
+	//! Find the exact HIP, SAO and HD numbers, the names are in the name index of the StelObjectMgr.
+	virtual QStringList listMatchingDesignations(const QString& objPrefix, int maxNbItem) const;
 	//! @note Loading stars with the common names only.
 	virtual QStringList listAllObjects(bool inEnglish) const;	
 	virtual QStringList listAllObjectsByType(const QString& objType, bool inEnglish) const;
@@ -335,6 +338,11 @@ private:
 
 	void setCheckFlag(const QString& catalogId, bool b);
 
+	//! Set the common, scientific, variable and double star names in the name index of the StelObjectMgr.
+	void updateNameIndex() const;
+	//! Magnitude of a Hipparcos star, for the ranking of its names.
+	float getHipMagnitude(int hip) const;
+
 	void copyDefaultConfigFile();
 
 	//! Loads common names for stars from a file.
@@ -382,6 +390,8 @@ private:
 	
 	// A ZoneArray per grid level
 	QVector<ZoneArray*> gridLevels;
+	// Working memory of the culling of the zones in draw(), one per thread, kept from frame to frame
+	QVector<StarCullBuffer*> cullBuffers;
 	static void initTriangleFunc(int lev, int index,
 								 const Vec3f &c0,
 								 const Vec3f &c1,
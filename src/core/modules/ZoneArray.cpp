@@ -459,20 +459,27 @@ SpecialZoneArray<Star>::~SpecialZoneArray(void)
 	nr_of_stars = 0;
 }
 
+// Only Star1 have names. Their lookup is left to the thread drawing the labels, as it is not thread-safe.
+static inline const Star1* labelStar(const Star1* s) {return s;}
+template<class Star> static inline const Star1* labelStar(const Star*) {return NULL;}
+
 template<class Star>
-void SpecialZoneArray<Star>::draw(StelPainter* sPainter, int index, bool isInsideViewport, const RCMag* rcmag_table,
-				  int limitMagIndex, StelCore* core, int maxMagStarName, float names_brightness,
-				  const QVector<SphericalCap> &boundingCaps) const
+void SpecialZoneArray<Star>::cullZone(const StelProjector* prj, int index, bool isInsideViewport, const RCMag* rcmag_table,
+				      int limitMagIndex, const StelCore* core, int maxMagStarName,
+				      const QVector<SphericalCap> &boundingCaps, StarCullBuffer& buffer) const
 {
-	StelSkyDrawer* drawer = core->getSkyDrawer();
+	const StelSkyDrawer* drawer = core->getSkyDrawer();
 	Vec3f vf;
 	static const double d2000 = 2451545.0;
 	const float movementFactor = (M_PI/180)*(0.0001/3600) * ((core->getJDE()-d2000)/365.25) / star_position_scale;
 
 	// GZ, added for extinction
-	const Extinction& extinction=core->getSkyDrawer()->getExtinction();
+	const Extinction& extinction=drawer->getExtinction();
 	const bool withExtinction=drawer->getFlagHasAtmosphere() && extinction.getExtinctionCoefficient()>=0.01f;
 	const float k = 0.001f*mag_range/mag_steps; // from StarMgr.cpp line 654
+	// The altitude only needs the z component of the altAz position, which is the dot product with the zenith
+	const Vec3d zenithd = core->altAzToJ2000(Vec3d(0.,0.,1.), StelCore::RefractionOff);
+	const Vec3f zenith(zenithd[0], zenithd[1], zenithd[2]);
 	
 	// Allow artificial cutoff:
 	// find the (integer) mag at which is just bright enough to be drawn.
@@ -488,6 +495,11 @@ void SpecialZoneArray<Star>::draw(StelPainter* sPainter, int index, bool isInsid
 	// Go through all stars, which are sorted by magnitude (bright stars first)
 	const SpecialZoneData<Star>* zoneToDraw = getZones() + index;
 	const Star* lastStar = zoneToDraw->getStars() + zoneToDraw->size;
+	buffer.candidates.clear();
+	buffer.x.clear();
+	buffer.y.clear();
+	buffer.z.clear();
+	CulledStar culled;
 	for (const Star* s=zoneToDraw->getStars();s<lastStar;++s)
 	{
 		// Artifical cutoff per magnitude
@@ -524,25 +536,49 @@ void SpecialZoneArray<Star>::draw(StelPainter* sPainter, int index, bool isInsid
 		float twinkleFactor=1.0f; // allow height-dependent twinkle.
 		if (withExtinction)
 		{
-			Vec3f altAz(vf);
-			altAz.normalize();
-			core->j2000ToAltAzInPlaceNoRefraction(&altAz);
+			// vf is already normalized in border zones
+			const float sinAlt = isInsideViewport ? zenith.dot(vf)/vf.length() : zenith.dot(vf);
 			float extMagShift=0.0f;
-			extinction.forward(altAz, &extMagShift);
+			extinction.forwardTabulated(sinAlt, &extMagShift);
 			extinctedMagIndex = s->getMag() + (int)(extMagShift/k);
 			if (extinctedMagIndex >= cutoffMagStep) // i.e., if extincted it is dimmer than cutoff, so remove
 				continue;
 			tmpRcmag = &rcmag_table[extinctedMagIndex];
-			twinkleFactor=qMin(1.0f, 1.0f-0.9f*altAz[2]); // suppress twinkling in higher altitudes. Keep 0.1 twinkle amount in zenith.
-		}
-	
-		if (drawer->drawPointSource(sPainter, vf, *tmpRcmag, s->getBVIndex(), !isInsideViewport, twinkleFactor) && s->hasName() && extinctedMagIndex < maxMagStarName && s->hasComponentID()<=1)
-		{
-			const float offset = tmpRcmag->radius*0.7f;
-			const Vec3f colorr = StelSkyDrawer::indexToColor(s->getBVIndex())*0.75f;
-			sPainter->setColor(colorr[0], colorr[1], colorr[2],names_brightness);
-			sPainter->drawText(Vec3d(vf[0], vf[1], vf[2]), s->getNameI18n(), 0, offset, offset, false);
+			twinkleFactor=qMin(1.0f, 1.0f-0.9f*sinAlt); // suppress twinkling in higher altitudes. Keep 0.1 twinkle amount in zenith.
 		}
+
+		// Same test as StelSkyDrawer::drawPointSource()
+		if (tmpRcmag->radius<=0.f)
+			continue;
+
+		culled.pos = vf;
+		culled.rcmag = *tmpRcmag;
+		culled.twinkleFactor = twinkleFactor;
+		culled.bV = s->getBVIndex();
+		culled.label = (s->hasName() && extinctedMagIndex < maxMagStarName && s->hasComponentID()<=1) ? labelStar(s) : NULL;
+		buffer.candidates.push_back(culled);
+		buffer.x.push_back(vf[0]);
+		buffer.y.push_back(vf[1]);
+		buffer.z.push_back(vf[2]);
+	}
+
+	// Project all candidates at once and keep those in the viewport. The zones inside the viewport are
+	// checked too: this only drops the stars whose center lies on the very edge of the viewport.
+	const int n = (int)buffer.candidates.size();
+	if (n==0)
+		return;
+	buffer.winX.resize(n);
+	buffer.winY.resize(n);
+	buffer.winZ.resize(n);
+	buffer.visible.resize(n);
+	prj->projectCheck(n, &buffer.x[0], &buffer.y[0], &buffer.z[0], &buffer.winX[0], &buffer.winY[0], &buffer.winZ[0], &buffer.visible[0]);
+	for (int i=0; i<n; ++i)
+	{
+		if (!buffer.visible[i])
+			continue;
+		CulledStar& c = buffer.candidates[i];
+		c.win.set(buffer.winX[i], buffer.winY[i], buffer.winZ[i]);
+		buffer.stars.push_back(c);
 	}
 }
 
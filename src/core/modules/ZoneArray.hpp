@@ -34,11 +34,14 @@
 #include <QFile>
 #include <QDebug>
 
+#include <vector>
+
 #ifdef __OpenBSD__
 #include <unistd.h>
 #endif
 
 class StelPainter;
+class StelProjector;
 
 // Patch by Rainer Canavan for compilation on irix with mipspro compiler part 1
 #ifndef MAP_NORESERVE
@@ -68,6 +71,33 @@ struct HipIndexStruct
 	const Star1 *s;
 };
 
+//! @struct CulledStar
+//! A star which passed the culling of its zone, ready to be drawn.
+struct CulledStar
+{
+	Vec3f pos;           // J2000 position, for the label
+	Vec3f win;           // window coordinates
+	RCMag rcmag;         // radius and luminance after extinction
+	float twinkleFactor;
+	unsigned char bV;
+	const Star1* label;  // the star whose name is drawn, or NULL
+};
+
+//! @struct StarCullBuffer
+//! Working memory of ZoneArray::cullZone(). A thread keeps its buffer for all the zones and frames it culls:
+//! the vectors keep their capacity when they are cleared, so they stop allocating once they are large enough.
+struct StarCullBuffer
+{
+	// Stars of the zone which passed the magnitude and viewport tests, waiting for the projection
+	std::vector<CulledStar> candidates;
+	std::vector<float> x, y, z;
+	// Projection of the candidates by StelProjector::projectCheck()
+	std::vector<float> winX, winY, winZ;
+	std::vector<quint8> visible;
+	//! The stars to draw, appended by cullZone() in drawing order.
+	std::vector<CulledStar> stars;
+};
+
 //! @class ZoneArray
 //! Manages all ZoneData structures of a given StelGeodesicGrid level. An
 //! instance of this class is never created directly; the named constructor
@@ -99,10 +129,10 @@ public:
 							  QList<StelObjectP > &result) = 0;
 
 	//! Pure virtual method. See subclass implementation.
-	virtual void draw(StelPainter* sPainter, int index,bool is_inside,
-					  const RCMag* rcmag_table, int limitMagIndex, StelCore* core,
-					  int maxMagStarName, float names_brightness,
-					  const QVector<SphericalCap>& boundingCaps) const = 0;
+	virtual void cullZone(const StelProjector* prj, int index, bool isInsideViewport,
+						  const RCMag* rcmag_table, int limitMagIndex, const StelCore* core,
+						  int maxMagStarName, const QVector<SphericalCap>& boundingCaps,
+						  StarCullBuffer& buffer) const = 0;
 
 	//! Get whether or not the catalog was successfully loaded.
 	//! @return @c true if at least one zone was loaded, otherwise @c false
@@ -170,19 +200,20 @@ protected:
 		return static_cast<SpecialZoneData<Star>*>(zones);
 	}
 
-	//! Draw stars and their names onto the viewport.
-	//! @param sPainter the painter to use 
-	//! @param index zone index to draw
+	//! Select the stars of a zone which are visible in the viewport and project them.
+	//! Only reads the catalog and the state of the core, so that several zones can be culled in parallel.
+	//! @param prj the projector to use
+	//! @param index zone index to cull
 	//! @param isInsideViewport whether the zone is inside the current viewport
 	//! @param rcmag_table table of magnitudes
 	//! @param limitMagIndex index from rcmag_table at which stars are not visible anymore
 	//! @param core core to use for drawing
 	//! @param maxMagStarName magnitude limit of stars that display labels
-	//! @param names_brightness brightness of labels
-	virtual void draw(StelPainter* sPainter, int index, bool isInsideViewport,
-			  const RCMag *rcmag_table, int limitMagIndex, StelCore* core,
-			  int maxMagStarName, float names_brightness,
-			  const QVector<SphericalCap>& boundingCaps) const;
+	//! @param buffer working memory, whose stars receive the stars to draw, in drawing order
+	virtual void cullZone(const StelProjector* prj, int index, bool isInsideViewport,
+			      const RCMag *rcmag_table, int limitMagIndex, const StelCore* core,
+			      int maxMagStarName, const QVector<SphericalCap>& boundingCaps,
+			      StarCullBuffer& buffer) const;
 
 	virtual void scaleAxis();
 	virtual void searchAround(const StelCore* core, int index,const Vec3d &v,double cosLimFov,
@@ -31,6 +31,8 @@ Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
 #include "de430.hpp"
 #include "pluto.h"
 
+#include <QThreadStorage>
+
 #define EPHEM_MERCURY_ID  0
 #define EPHEM_VENUS_ID    1
 #define EPHEM_EMB_ID    2
@@ -68,6 +70,56 @@ void EphemWrapper::init_de431(const char* filepath)
 	InitDE431(filepath);
 }
 
+EphemWrapper::Context::Context()
+	: de430(NULL)
+	, de431(NULL)
+	, de430Opened(false)
+	, de431Opened(false)
+{
+	InitVsop87Context(&vsop87);
+	InitElp82bContext(&elp82b);
+}
+
+EphemWrapper::Context::~Context()
+{
+	CloseDE430Handle(de430);
+	CloseDE431Handle(de431);
+}
+
+void* EphemWrapper::Context::getDe430Handle()
+{
+	if (!de430Opened)
+	{
+		de430 = OpenDE430Handle();
+		de430Opened = true;
+	}
+	return de430;
+}
+
+void* EphemWrapper::Context::getDe431Handle()
+{
+	if (!de431Opened)
+	{
+		de431 = OpenDE431Handle();
+		de431Opened = true;
+	}
+	return de431;
+}
+
+EphemWrapper::Context* EphemWrapper::getThreadContext()
+{
+	static QThreadStorage<EphemWrapper::Context*> threadContexts;
+	if (!threadContexts.hasLocalData())
+		threadContexts.setLocalData(new EphemWrapper::Context());
+	return threadContexts.localData();
+}
+
+// Returns the context passed by the caller or the one of the calling thread.
+static inline EphemWrapper::Context* contextFor(void* ctx)
+{
+	return ctx ? static_cast<EphemWrapper::Context*>(ctx) : EphemWrapper::getThreadContext();
+}
+
 bool jd_fits_de431(const double jd)
 {
 	//Correct limits found via jpl_get_double(). Limits hardcoded to avoid calls each time.
@@ -95,7 +147,7 @@ bool use_de431(const double jd)
 }
 
 // planet_id is ONLY one of the #defined values 0..8 above.
-void get_planet_helio_coordsv(const double jd, double xyz[3], const int planet_id)
+void get_planet_helio_coordsv(const double jd, double xyz[3], const int planet_id, EphemWrapper::Context* ctx)
 {
 	bool deOk=false;
 	if(!std::isfinite(jd))
@@ -106,15 +158,15 @@ void get_planet_helio_coordsv(const double jd, double xyz[3], const int planet_i
 
 	if(use_de430(jd))
 	{
-		deOk=GetDe430Coor(jd, planet_id + 1, xyz);
+		deOk=GetDe430CoorFromHandle(ctx->getDe430Handle(), jd, planet_id + 1, xyz);
 	}
 	else if(use_de431(jd))
 	{
-		deOk=GetDe431Coor(jd, planet_id + 1, xyz);
+		deOk=GetDe431CoorFromHandle(ctx->getDe431Handle(), jd, planet_id + 1, xyz);
 	}
 	if (!deOk) //VSOP87 as fallback
 	{
-		GetVsop87Coor(jd, planet_id, xyz);
+		GetVsop87CoorCtx(&ctx->vsop87, jd, planet_id, xyz);
 	}
 }
 
@@ -122,6 +174,7 @@ void get_planet_helio_coordsv(const double jd, double xyz[3], const int planet_i
 // For ephemerides like DE4xx, JDE0 is irrelevant.
 void get_planet_helio_osculating_coordsv(double jd0, double jd, double xyz[3], int planet_id)
 {
+	EphemWrapper::Context* ctx = EphemWrapper::getThreadContext();
 	bool deOk=false;
 	if(!(std::isfinite(jd) && std::isfinite(jd0)))
 	{
@@ -131,15 +184,15 @@ void get_planet_helio_osculating_coordsv(double jd0, double jd, double xyz[3], i
 
 	if(use_de430(jd))
 	{
-		deOk=GetDe430Coor(jd, planet_id + 1, xyz);
+		deOk=GetDe430CoorFromHandle(ctx->getDe430Handle(), jd, planet_id + 1, xyz);
 	}
 	else if(use_de431(jd))
 	{
-		deOk=GetDe431Coor(jd, planet_id + 1, xyz);
+		deOk=GetDe431CoorFromHandle(ctx->getDe431Handle(), jd, planet_id + 1, xyz);
 	}
 	if (!deOk) //VSOP87 as fallback
 	{
-		GetVsop87OsculatingCoor(jd0, jd, planet_id, xyz);
+		GetVsop87OsculatingCoorCtx(&ctx->vsop87, jd0, jd, planet_id, xyz);
 	}
 }
 
@@ -148,9 +201,9 @@ void get_planet_helio_osculating_coordsv(double jd0, double jd, double xyz[3], i
  * for given Julian Day. Values are in AU.
  * params : Julian day, rect coords */
 
-void get_pluto_helio_coordsv(double jd,double xyz[3], void* unused)
+void get_pluto_helio_coordsv(double jd,double xyz[3], void* context)
 {
-	Q_UNUSED(unused);
+	EphemWrapper::Context* ctx = contextFor(context);
 	bool deOk=false;
 	if(!std::isfinite(jd))
 	{
@@ -160,11 +213,11 @@ void get_pluto_helio_coordsv(double jd,double xyz[3], void* unused)
 
 	if(use_de430(jd))
 	{
-		deOk=GetDe430Coor(jd, EPHEM_JPL_PLUTO_ID, xyz);
+		deOk=GetDe430CoorFromHandle(ctx->getDe430Handle(), jd, EPHEM_JPL_PLUTO_ID, xyz);
 	}
 	else if(use_de431(jd))
 	{
-		deOk=GetDe431Coor(jd, EPHEM_JPL_PLUTO_ID, xyz);
+		deOk=GetDe431CoorFromHandle(ctx->getDe431Handle(), jd, EPHEM_JPL_PLUTO_ID, xyz);
 	}
 	if (!deOk) // fallback to previous solution
 	{
@@ -180,20 +233,18 @@ void get_sun_helio_coordsv(double jd,double xyz[3], void* unused)
 	xyz[0]=0.; xyz[1]=0.; xyz[2]=0.;
 }
 
-void get_mercury_helio_coordsv(double jd,double xyz[3], void* unused)
+void get_mercury_helio_coordsv(double jd,double xyz[3], void* context)
 {
-	Q_UNUSED(unused);
-  	get_planet_helio_coordsv(jd, xyz, EPHEM_MERCURY_ID);
+	get_planet_helio_coordsv(jd, xyz, EPHEM_MERCURY_ID, contextFor(context));
 }
-void get_venus_helio_coordsv(double jd,double xyz[3], void* unused)
+void get_venus_helio_coordsv(double jd,double xyz[3], void* context)
 {
-	Q_UNUSED(unused);
-  	get_planet_helio_coordsv(jd, xyz, EPHEM_VENUS_ID);
+	get_planet_helio_coordsv(jd, xyz, EPHEM_VENUS_ID, contextFor(context));
 }
 
-void get_earth_helio_coordsv(const double jd,double xyz[3], void* unused) 
+void get_earth_helio_coordsv(const double jd,double xyz[3], void* context) 
 {
-	Q_UNUSED(unused);
+	EphemWrapper::Context* ctx = contextFor(context);
 	bool deOk=false;
 	if(!std::isfinite(jd))
 	{
@@ -203,17 +254,17 @@ void get_earth_helio_coordsv(const double jd,double xyz[3], void* unused)
 
 	if(use_de430(jd))
 	{
-		deOk=GetDe430Coor(jd, EPHEM_JPL_EARTH_ID, xyz);
+		deOk=GetDe430CoorFromHandle(ctx->getDe430Handle(), jd, EPHEM_JPL_EARTH_ID, xyz);
 	}
 	else if(use_de431(jd))
 	{
-		deOk=GetDe431Coor(jd, EPHEM_JPL_EARTH_ID, xyz);
+		deOk=GetDe431CoorFromHandle(ctx->getDe431Handle(), jd, EPHEM_JPL_EARTH_ID, xyz);
 	}
 	if (!deOk) //VSOP87 as fallback
 	{
 		double moon[3];
-		GetVsop87Coor(jd,EPHEM_EMB_ID,xyz);
-		GetElp82bCoor(jd,moon);
+		GetVsop87CoorCtx(&ctx->vsop87,jd,EPHEM_EMB_ID,xyz);
+		GetElp82bCoorCtx(&ctx->elp82b,jd,moon);
 		/* Earth != EMB:
 	0.0121505677733761 = mu_m/(1+mu_m),
 	mu_m = mass(moon)/mass(earth) = 0.01230002 */
@@ -223,34 +274,29 @@ void get_earth_helio_coordsv(const double jd,double xyz[3], void* unused)
 	}
 }
 
-void get_mars_helio_coordsv(double jd,double xyz[3], void* unused)
+void get_mars_helio_coordsv(double jd,double xyz[3], void* context)
 {
-	Q_UNUSED(unused);
-	get_planet_helio_coordsv(jd, xyz, EPHEM_MARS_ID);
+	get_planet_helio_coordsv(jd, xyz, EPHEM_MARS_ID, contextFor(context));
 }
 
-void get_jupiter_helio_coordsv(double jd,double xyz[3], void* unused)
+void get_jupiter_helio_coordsv(double jd,double xyz[3], void* context)
 {
-	Q_UNUSED(unused);
-	get_planet_helio_coordsv(jd, xyz, EPHEM_JUPITER_ID);
+	get_planet_helio_coordsv(jd, xyz, EPHEM_JUPITER_ID, contextFor(context));
 }
 
-void get_saturn_helio_coordsv(double jd,double xyz[3], void* unused)
+void get_saturn_helio_coordsv(double jd,double xyz[3], void* context)
 {
-	Q_UNUSED(unused);
-	get_planet_helio_coordsv(jd, xyz, EPHEM_SATURN_ID);
+	get_planet_helio_coordsv(jd, xyz, EPHEM_SATURN_ID, contextFor(context));
 }
 
-void get_uranus_helio_coordsv(double jd,double xyz[3], void* unused)
+void get_uranus_helio_coordsv(double jd,double xyz[3], void* context)
 {
-	Q_UNUSED(unused);
-	get_planet_helio_coordsv(jd, xyz, EPHEM_URANUS_ID);
+	get_planet_helio_coordsv(jd, xyz, EPHEM_URANUS_ID, contextFor(context));
 }
 
-void get_neptune_helio_coordsv(double jd,double xyz[3], void* unused)
+void get_neptune_helio_coordsv(double jd,double xyz[3], void* context)
 {
-	Q_UNUSED(unused);
-	get_planet_helio_coordsv(jd, xyz, EPHEM_NEPTUNE_ID);
+	get_planet_helio_coordsv(jd, xyz, EPHEM_NEPTUNE_ID, contextFor(context));
 }
 
 void get_mercury_helio_osculating_coords(double jd0,double jd,double xyz[3])
@@ -300,16 +346,16 @@ void get_neptune_helio_osculating_coords(double jd0,double jd,double xyz[3])
  * Michelle Chapront-Touze and Jean Chapront of the Bureau des Longitudes,
  * Paris. ELP 2000-82B theory
  * param jd Julian day, rect pos */
-void get_lunar_parent_coordsv(double jde,double xyz[3], void* unused)
+void get_lunar_parent_coordsv(double jde,double xyz[3], void* context)
 {
-	Q_UNUSED(unused);
+	EphemWrapper::Context* ctx = contextFor(context);
 	bool deOk=false;
 	if(use_de430(jde))
-		deOk=GetDe430Coor(jde, EPHEM_JPL_MOON_ID, xyz, EPHEM_JPL_EARTH_ID);
+		deOk=GetDe430CoorFromHandle(ctx->getDe430Handle(), jde, EPHEM_JPL_MOON_ID, xyz, EPHEM_JPL_EARTH_ID);
 	else if(use_de431(jde))
-		deOk=GetDe431Coor(jde, EPHEM_JPL_MOON_ID, xyz, EPHEM_JPL_EARTH_ID);
+		deOk=GetDe431CoorFromHandle(ctx->getDe431Handle(), jde, EPHEM_JPL_MOON_ID, xyz, EPHEM_JPL_EARTH_ID);
 	if (!deOk) // fallback...
-		GetElp82bCoor(jde,xyz);
+		GetElp82bCoorCtx(&ctx->elp82b,jde,xyz);
 }
 
 void get_phobos_parent_coordsv(double jd,double xyz[3], void* unused)
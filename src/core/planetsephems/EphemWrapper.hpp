@@ -32,6 +32,9 @@ Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
 #ifndef _EPHEMWRAPPER_HPP_
 #define _EPHEMWRAPPER_HPP_
 
+#include "vsop87.h"
+#include "elp82b.h"
+
 #define DE430_FILENAME  "linux_p1550p2650.430"
 #define DE431_FILENAME  "lnxm13000p17000.431"
 
@@ -39,8 +42,41 @@ class EphemWrapper{
 public:
     static void init_de430(const char* filepath);
     static void init_de431(const char* filepath);
+
+    //! Evaluation context holding the interpolation caches of VSOP87 and ELP2000-82B
+    //! and private handles on the DE430/DE431 files.
+    //! A context must only be used by one thread at a time. The positional functions below
+    //! use the context passed as their last (void*) argument, or the context of the
+    //! calling thread if that is NULL, so planet positions can be computed in worker threads.
+    //! @note The theories for the moons of Mars, Jupiter, Saturn and Uranus still use
+    //! static caches and must only be evaluated by the main thread.
+    class Context
+    {
+    public:
+        Context();
+        ~Context();
+        //! Get the DE430 handle of this context, opened on first use. NULL if DE430 is not available.
+        void* getDe430Handle();
+        //! Get the DE431 handle of this context, opened on first use. NULL if DE431 is not available.
+        void* getDe431Handle();
+
+        Vsop87Context vsop87;
+        Elp82bContext elp82b;
+    private:
+        Context(const Context&);
+        const Context &operator=(const Context&);
+        void* de430;
+        void* de431;
+        bool de430Opened;
+        bool de431Opened;
+    };
+
+    //! Get the context of the calling thread. It is created on first use and deleted when the thread ends.
+    static Context* getThreadContext();
 };
 
+// For all functions with a void* argument, this may point to an EphemWrapper::Context
+// to be used for the computation. If NULL, the context of the calling thread is used.
 void get_sun_helio_coordsv(double jd,double xyz[3], void*);
 void get_mercury_helio_coordsv(double jd,double xyz[3], void*);
 void get_venus_helio_coordsv(double jd,double xyz[3], void*);
@@ -36,17 +36,16 @@ THE SOFTWARE.
 
 static void * ephem;
 
-static Vec3d tempECL = Vec3d(0,0,0);
-static Vec3d tempICRF = Vec3d(0,0,0);
 static char nams[JPL_MAX_N_CONSTANTS][6];
 static double vals[JPL_MAX_N_CONSTANTS];
-static double tempXYZ[6];
 #ifdef UNIT_TEST
 // NOTE: Added hook for unit testing
 static const Mat4d matJ2000ToVsop87(Mat4d::xrotation(-23.4392803055555555556*(M_PI/180)) * Mat4d::zrotation(0.0000275*(M_PI/180)));
 #endif
 
 static bool initDone = false;
+// kept for opening further handles with OpenDE430Handle()
+static QByteArray ephemFilePath;
 
 void InitDE430(const char* filepath)
 {
@@ -62,6 +61,7 @@ void InitDE430(const char* filepath)
 	else
 	{
 		initDone = true;
+		ephemFilePath = QByteArray(filepath);
 		double jd1, jd2;
 		jd1=jpl_get_double(ephem, JPL_EPHEM_START_JD);
 		jd2=jpl_get_double(ephem, JPL_EPHEM_END_JD);
@@ -77,47 +77,71 @@ void TerminateDE430()
 bool GetDe430Coor(const double jde, const int planet_id, double * xyz, const int centralBody_id)
 {
     if(initDone)
+	return GetDe430CoorFromHandle(ephem, jde, planet_id, xyz, centralBody_id);
+    return false;
+}
+
+void* OpenDE430Handle()
+{
+	if(!initDone)
+		return NULL;
+	// Separate file handle and record cache, so that the handle can be used by another thread.
+	void* handle = jpl_init_ephemeris(ephemFilePath.constData(), NULL, NULL);
+	if (!handle)
+		qDebug() << "Error "<< jpl_init_error_code() << "opening further DE430 handle:" << jpl_init_error_message();
+	return handle;
+}
+
+void CloseDE430Handle(void* handle)
+{
+	if(handle)
+		jpl_close_ephemeris(handle);
+}
+
+bool GetDe430CoorFromHandle(void* handle, const double jde, const int planet_id, double * xyz, const int centralBody_id)
+{
+    if(handle)
     {
+	double tempXYZ[6];
 	// This may return some error code!
-	int jplresult=jpl_pleph(ephem, jde, planet_id, centralBody_id, tempXYZ, 0);
+	int jplresult=jpl_pleph(handle, jde, planet_id, centralBody_id, tempXYZ, 0);
 
 	switch (jplresult)
 	{
 		case 0: // all OK.
 			break;
 		case JPL_EPH_OUTSIDE_RANGE:
-			qDebug() << "GetDe430Coor: JPL_EPH_OUTSIDE_RANGE at jde" << jde << "for planet" << planet_id;
+			qDebug() << "GetDe430CoorFromHandle: JPL_EPH_OUTSIDE_RANGE at jde" << jde << "for planet" << planet_id;
 			return false;
 			break;
 		case JPL_EPH_READ_ERROR:
-			qDebug() << "GetDe430Coor: JPL_EPH_READ_ERROR at jde" << jde << "for planet" << planet_id;
+			qDebug() << "GetDe430CoorFromHandle: JPL_EPH_READ_ERROR at jde" << jde << "for planet" << planet_id;
 			return false;
 			break;
 		case JPL_EPH_QUANTITY_NOT_IN_EPHEMERIS:
-			qDebug() << "GetDe430Coor: JPL_EPH_QUANTITY_NOT_IN_EPHEMERIS at jde" << jde << "for planet" << planet_id;
+			qDebug() << "GetDe430CoorFromHandle: JPL_EPH_QUANTITY_NOT_IN_EPHEMERIS at jde" << jde << "for planet" << planet_id;
 			return false;
 			break;
 		case JPL_EPH_INVALID_INDEX:
-			qDebug() << "GetDe430Coor: JPL_EPH_INVALID_INDEX at jde" << jde << "for planet" << planet_id;
+			qDebug() << "GetDe430CoorFromHandle: JPL_EPH_INVALID_INDEX at jde" << jde << "for planet" << planet_id;
 			return false;
 			break;
 		case JPL_EPH_FSEEK_ERROR:
-			qDebug() << "GetDe430Coor: JPL_EPH_FSEEK_ERROR at jde" << jde << "for planet" << planet_id;
+			qDebug() << "GetDe430CoorFromHandle: JPL_EPH_FSEEK_ERROR at jde" << jde << "for planet" << planet_id;
 			return false;
 			break;
 		default: // Should never happen...
-			qDebug() << "GetDe430Coor: unknown error" << jplresult << "at jde" << jde << "for planet" << planet_id;
+			qDebug() << "GetDe430CoorFromHandle: unknown error" << jplresult << "at jde" << jde << "for planet" << planet_id;
 			return false;
 			break;
 	}
 
-	jpl_pleph(ephem, jde, planet_id, centralBody_id, tempXYZ, 0);
 
-        tempICRF = Vec3d(tempXYZ[0], tempXYZ[1], tempXYZ[2]);
+        const Vec3d tempICRF = Vec3d(tempXYZ[0], tempXYZ[1], tempXYZ[2]);
 	#ifdef UNIT_TEST
-	tempECL = matJ2000ToVsop87 * tempICRF;
+	const Vec3d tempECL = matJ2000ToVsop87 * tempICRF;
 	#else
-        tempECL = StelCore::matJ2000ToVsop87 * tempICRF;
+        const Vec3d tempECL = StelCore::matJ2000ToVsop87 * tempICRF;
 	#endif
 
         xyz[0] = tempECL[0];
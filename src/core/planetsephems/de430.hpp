@@ -34,6 +34,13 @@ void InitDE430(const char* filepath);
 // most of the time centralBody_id likely is the Sun. However, for Moon, use centralBody_id=EPHEM_JPL_EARTH_ID=3
 // return true if OK, false if something was wrong with the JPL functions. In this case, see log for details.
 bool GetDe430Coor(const double jde, const int planet_id, double * xyz, const int centralBody_id=CENTRAL_PLANET_ID);
+// Open another handle on the file given to InitDE430(), with its own file pointer and record cache.
+// The global GetDe430Coor() must only be used by the main thread, other threads use their own handle.
+// Returns NULL if DE430 is not initialized.
+void* OpenDE430Handle();
+void CloseDE430Handle(void* handle);
+// Same as GetDe430Coor(), but reading through handle.
+bool GetDe430CoorFromHandle(void* handle, const double jde, const int planet_id, double * xyz, const int centralBody_id=CENTRAL_PLANET_ID);
 // Not possible for a DE.
 //void GetDe430OsculatingCoor(double jd0, double jd, int planet_id, double *xyz, const int centralBody_id=CENTRAL_PLANET_ID);
 
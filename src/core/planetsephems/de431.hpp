@@ -34,6 +34,13 @@ void InitDE431(const char* filepath);
 // most of the time centralBody_id likely is the Sun. However, for Moon, use centralBody_id=EPHEM_JPL_EARTH_ID=3
 // return true if OK, false if something was wrong with the JPL functions. In this case, see log for details.
 bool GetDe431Coor(const double jde, const int planet_id, double * xyz, const int centralBody_id=CENTRAL_PLANET_ID);
+// Open another handle on the file given to InitDE431(), with its own file pointer and record cache.
+// The global GetDe431Coor() must only be used by the main thread, other threads use their own handle.
+// Returns NULL if DE431 is not initialized.
+void* OpenDE431Handle();
+void CloseDE431Handle(void* handle);
+// Same as GetDe431Coor(), but reading through handle.
+bool GetDe431CoorFromHandle(void* handle, const double jde, const int planet_id, double * xyz, const int centralBody_id=CENTRAL_PLANET_ID);
 // Not possible for a DE.
 //void GetDe431OsculatingCoor(double jd0, double jd, int planet_id, double *xyz, const int centralBody_id=CENTRAL_PLANET_ID);
 
@@ -51,6 +51,26 @@ the original Fortran code:
 extern "C" {
 #endif
 
+struct Elp82bContext {
+  /* Interpolation cache, see CalcInterpolatedElements().
+     Must be initialized with InitElp82bContext()
+     and never be changed by the user. */
+  double t_0,t_1,t_2;
+  double r_0[3];
+  double r_1[3];
+  double r_2[3];
+};
+
+void InitElp82bContext(struct Elp82bContext *ctx);
+  /* Prepare a context for GetElp82bCoorCtx().
+     Each thread computing ELP2000-82B positions must use its own context.
+     GetElp82bCoor() uses one static context and must therefore
+     only be called from one thread.
+  */
+
+void GetElp82bCoorCtx(struct Elp82bContext *ctx,double jd,double xyz[3]);
+  /* Same as GetElp82bCoor(), but with the cache in ctx. */
+
 void GetElp82bCoor(double jd,double xyz[3]);
 
   /* Return the rectangular coordinates of the earths moon
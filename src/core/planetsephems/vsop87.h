@@ -51,6 +51,27 @@ so that for given T the functions cos and sin have only to be called 12 times.
 extern "C" {
 #endif
 
+#define VSOP87_DIM (8*6)
+
+struct Vsop87Context {
+  /* Interpolation cache of the orbital elements, see
+     CalcInterpolatedElements(). Must be initialized with
+     InitVsop87Context() and never be changed by the user. */
+  double t_0,t_1,t_2;
+  double elem_0[VSOP87_DIM];
+  double elem_1[VSOP87_DIM];
+  double elem_2[VSOP87_DIM];
+  double jd0;
+  double elem[VSOP87_DIM];
+};
+
+void InitVsop87Context(struct Vsop87Context *ctx);
+  /* Prepare a context for GetVsop87CoorCtx() and GetVsop87OsculatingCoorCtx().
+     Each thread computing VSOP87 positions must use its own context.
+     GetVsop87Coor() and GetVsop87OsculatingCoor() share one static
+     context and must therefore only be called from one thread.
+  */
+
 void GetVsop87Coor(double jd,int body,double *xyz);
   /* Return the rectangular coordinates of the given planet
      and the given julian date jd expressed in dynamical time (TAI+32.184s).
@@ -63,6 +84,13 @@ void GetVsop87OsculatingCoor(const double jd0,const double jd, const int body,do
   /* The oculating orbit of epoch jd0, evaluated at jd, is returned.
   */
 
+void GetVsop87CoorCtx(struct Vsop87Context *ctx,double jd,int body,double *xyz);
+void GetVsop87OsculatingCoorCtx(struct Vsop87Context *ctx,
+                                const double jd0,const double jd,
+                                const int body,double *xyz);
+  /* Same as above, but with the caches in ctx instead of static variables.
+  */
+
 #ifdef __cplusplus
 }
 #endif
@@ -29,6 +29,7 @@
 
 #include "SolarSystem.hpp"
 #include "Planet.hpp"
+#include "SolarSystemEphemeris.hpp"
 #include "NebulaMgr.hpp"
 #include "Nebula.hpp"
 
@@ -333,23 +334,22 @@ void AstroCalcDialog::generateEphemeris()
 			break;
 	}
 
-	StelObjectP obj = solarSystem->searchByName(currentPlanet);
+	PlanetP obj = solarSystem->searchByEnglishName(currentPlanet);
 	if (obj)
 	{
-		double currentJD = core->getJD(); // save current JD
 		double firstJD = StelUtils::qDateTimeToJd(ui->dateFromDateTimeEdit->dateTime());
 		firstJD = firstJD - StelUtils::getGMTShiftFromQT(firstJD)/24;
-		int elements = (int)((StelUtils::qDateTimeToJd(ui->dateToDateTimeEdit->dateTime()) - firstJD)/currentStep);
+		// The positions are computed without changing the time of the core (and redrawing the sky)
+		SolarSystemEphemeris ephem(core);
+		const QVector<SolarSystemEphemeris::Entry> entries = ephem.compute(obj, firstJD, StelUtils::qDateTimeToJd(ui->dateToDateTimeEdit->dateTime()), currentStep);
 		EphemerisListJ2000.clear();
-		EphemerisListJ2000.reserve(elements);
+		EphemerisListJ2000.reserve(entries.size());
 		EphemerisListDates.clear();
-		EphemerisListDates.reserve(elements);
-		for (int i=0; i<elements; i++)
+		EphemerisListDates.reserve(entries.size());
+		foreach (const SolarSystemEphemeris::Entry& entry, entries)
 		{
-			double JD = firstJD + i*currentStep;
-			core->setJD(JD);
-			core->update(0); // force update to get new coordinates			
-			Vec3d pos = obj->getJ2000EquatorialPos(core);
+			double JD = entry.JD;
+			Vec3d pos = entry.j2000Pos;
 			EphemerisListJ2000.append(pos);
 			EphemerisListDates.append(StelUtils::jdToQDateTime(JD + StelUtils::getGMTShiftFromQT(JD)/24).toString("yyyy-MM-dd"));
 			StelUtils::rectToSphe(&ra,&dec,pos);
@@ -361,10 +361,9 @@ void AstroCalcDialog::generateEphemeris()
 			treeItem->setTextAlignment(EphemerisRA, Qt::AlignRight);
 			treeItem->setText(EphemerisDec, StelUtils::radToDmsStr(dec, true));
 			treeItem->setTextAlignment(EphemerisDec, Qt::AlignRight);
-			treeItem->setText(EphemerisMagnitude, QString::number(obj->getVMagnitudeWithExtinction(core), 'f', 2));
+			treeItem->setText(EphemerisMagnitude, QString::number(entry.vMagnitude, 'f', 2));
 			treeItem->setTextAlignment(EphemerisMagnitude, Qt::AlignRight);
 		}
-		core->setJD(currentJD); // restore time
 	}
 
 	// adjust the column width
@@ -709,7 +708,8 @@ void AstroCalcDialog::calculatePhenomena()
 	PlanetP planet = solarSystem->searchByEnglishName(currentPlanet);
 	if (planet)
 	{
-		double currentJD = core->getJD(); // save current JD
+		// The positions are computed without changing the time of the core (and redrawing the sky)
+		SolarSystemEphemeris ephemeris(core);
 		double startJD = StelUtils::qDateTimeToJd(ui->phenomenFromDateEdit->dateTime());
 		double stopJD = StelUtils::qDateTimeToJd(ui->phenomenToDateEdit->dateTime());
 		startJD = startJD - StelUtils::getGMTShiftFromQT(startJD)/24;
@@ -721,9 +721,9 @@ void AstroCalcDialog::calculatePhenomena()
 			foreach (PlanetP obj, objects)
 			{
 				// conjunction
-				fillPhenomenaTable(findClosestApproach(planet, obj, startJD, stopJD, separation, false), planet, obj, false);
+				fillPhenomenaTable(findClosestApproach(ephemeris, planet, obj, startJD, stopJD, separation, false), planet, obj, false);
 				// opposition
-				fillPhenomenaTable(findClosestApproach(planet, obj, startJD, stopJD, separation, true), planet, obj, true);
+				fillPhenomenaTable(findClosestApproach(ephemeris, planet, obj, startJD, stopJD, separation, true), planet, obj, true);
 			}
 		}
 		else
@@ -732,13 +732,9 @@ void AstroCalcDialog::calculatePhenomena()
 			foreach (NebulaP obj, dso)
 			{
 				// conjunction
-				fillPhenomenaTable(findClosestApproach(planet, obj, startJD, stopJD, separation), planet, obj);
+				fillPhenomenaTable(findClosestApproach(ephemeris, planet, obj, startJD, stopJD, separation), planet, obj);
 			}
 		}
-
-
-		core->setJD(currentJD); // restore time
-		core->update(0);
 	}
 
 	// adjust the column width
@@ -791,9 +787,6 @@ void AstroCalcDialog::fillPhenomenaTable(const QMap<double, double> list, const
 	QMap<double, double>::ConstIterator it;
 	for (it=list.constBegin(); it!=list.constEnd(); ++it)
 	{
-		core->setJD(it.key());
-		core->update(0);
-
 		QString phenomenType = q_("Conjunction");
 		double separation = it.value();
 		if (opposition)
@@ -812,7 +805,7 @@ void AstroCalcDialog::fillPhenomenaTable(const QMap<double, double> list, const
 	}
 }
 
-QMap<double, double> AstroCalcDialog::findClosestApproach(PlanetP &object1, PlanetP &object2, double startJD, double stopJD, double maxSeparation, bool opposition)
+QMap<double, double> AstroCalcDialog::findClosestApproach(SolarSystemEphemeris& ephemeris, PlanetP &object1, PlanetP &object2, double startJD, double stopJD, double maxSeparation, bool opposition)
 {
 	double dist, prevDist, step, step0;
 	int sgn, prevSgn = 0;
@@ -841,11 +834,11 @@ QMap<double, double> AstroCalcDialog::findClosestApproach(PlanetP &object1, Plan
 
 	step = step0;
 	double jd = startJD;
-	prevDist = findDistance(jd, object1, object2, opposition);
+	prevDist = findDistance(ephemeris, jd, object1, object2, opposition);
 	jd += step;
 	while(jd <= stopJD)
 	{
-		dist = findDistance(jd, object1, object2, opposition);
+		dist = findDistance(ephemeris, jd, object1, object2, opposition);
 		sgn = StelUtils::sign(dist - prevDist);
 
 		double factor = qAbs((dist - prevDist)/dist);
@@ -863,7 +856,7 @@ QMap<double, double> AstroCalcDialog::findClosestApproach(PlanetP &object1, Plan
 				sgn = prevSgn;
 				while(jd <= stopJD)
 				{
-					dist = findDistance(jd, object1, object2, opposition);
+					dist = findDistance(ephemeris, jd, object1, object2, opposition);
 					sgn = StelUtils::sign(dist - prevDist);
 					if (sgn!=prevSgn)
 						break;
@@ -874,7 +867,7 @@ QMap<double, double> AstroCalcDialog::findClosestApproach(PlanetP &object1, Plan
 				}
 			}
 
-			if (findPrecise(&extremum, object1, object2, jd, step, sgn, opposition))
+			if (findPrecise(ephemeris, &extremum, object1, object2, jd, step, sgn, opposition))
 			{
 				double sep = extremum.second*180./M_PI;
 				if (sep<maxSeparation)
@@ -891,7 +884,7 @@ QMap<double, double> AstroCalcDialog::findClosestApproach(PlanetP &object1, Plan
 	return separations;
 }
 
-bool AstroCalcDialog::findPrecise(QPair<double, double> *out, PlanetP object1, PlanetP object2, double JD, double step, int prevSign, bool opposition)
+bool AstroCalcDialog::findPrecise(SolarSystemEphemeris& ephemeris, QPair<double, double> *out, PlanetP object1, PlanetP object2, double JD, double step, int prevSign, bool opposition)
 {
 	int sgn;
 	double dist, prevDist;
@@ -899,20 +892,20 @@ bool AstroCalcDialog::findPrecise(QPair<double, double> *out, PlanetP object1, P
 	if (out==NULL)
 		return false;
 
-	prevDist = findDistance(JD, object1, object2, opposition);
+	prevDist = findDistance(ephemeris, JD, object1, object2, opposition);
 	step = -step/2.f;
 	prevSign = -prevSign;
 
 	while(true)
 	{
 		JD += step;
-		dist = findDistance(JD, object1, object2, opposition);
+		dist = findDistance(ephemeris, JD, object1, object2, opposition);
 
 		if (qAbs(step)< 1.f/1440.f)
 		{
 			out->first = JD - step/2.0;
-			out->second = findDistance(JD - step/2.0, object1, object2, opposition);
-			if (out->second < findDistance(JD - 5.0, object1, object2, opposition))
+			out->second = findDistance(ephemeris, JD - step/2.0, object1, object2, opposition);
+			if (out->second < findDistance(ephemeris, JD - 5.0, object1, object2, opposition))
 				return true;
 			else
 				return false;
@@ -928,12 +921,10 @@ bool AstroCalcDialog::findPrecise(QPair<double, double> *out, PlanetP object1, P
 	}
 }
 
-double AstroCalcDialog::findDistance(double JD, PlanetP object1, PlanetP object2, bool opposition)
+double AstroCalcDialog::findDistance(SolarSystemEphemeris& ephemeris, double JD, PlanetP object1, PlanetP object2, bool opposition)
 {
-	core->setJD(JD);
-	core->update(0);
-	Vec3d obj1 = object1->getJ2000EquatorialPos(core);
-	Vec3d obj2 = object2->getJ2000EquatorialPos(core);
+	Vec3d obj1 = ephemeris.getJ2000EquatorialPos(object1, JD);
+	Vec3d obj2 = ephemeris.getJ2000EquatorialPos(object2, JD);
 	double angle = obj1.angle(obj2);
 	if (opposition)
 		angle = M_PI - angle;
@@ -945,9 +936,6 @@ void AstroCalcDialog::fillPhenomenaTable(const QMap<double, double> list, const
 	QMap<double, double>::ConstIterator it;
 	for (it=list.constBegin(); it!=list.constEnd(); ++it)
 	{
-		core->setJD(it.key());
-		core->update(0);
-
 		QString phenomenType = q_("Conjunction");
 		double separation = it.value();
 
@@ -964,7 +952,7 @@ void AstroCalcDialog::fillPhenomenaTable(const QMap<double, double> list, const
 	}
 }
 
-QMap<double, double> AstroCalcDialog::findClosestApproach(PlanetP &object1, NebulaP &object2, double startJD, double stopJD, double maxSeparation)
+QMap<double, double> AstroCalcDialog::findClosestApproach(SolarSystemEphemeris& ephemeris, PlanetP &object1, NebulaP &object2, double startJD, double stopJD, double maxSeparation)
 {
 	double dist, prevDist, step, step0;
 	int sgn, prevSgn = 0;
@@ -993,11 +981,11 @@ QMap<double, double> AstroCalcDialog::findClosestApproach(PlanetP &object1, Nebu
 
 	step = step0;
 	double jd = startJD;
-	prevDist = findDistance(jd, object1, object2);
+	prevDist = findDistance(ephemeris, jd, object1, object2);
 	jd += step;
 	while(jd <= stopJD)
 	{
-		dist = findDistance(jd, object1, object2);
+		dist = findDistance(ephemeris, jd, object1, object2);
 		sgn = StelUtils::sign(dist - prevDist);
 
 		double factor = qAbs((dist - prevDist)/dist);
@@ -1015,7 +1003,7 @@ QMap<double, double> AstroCalcDialog::findClosestApproach(PlanetP &object1, Nebu
 				sgn = prevSgn;
 				while(jd <= stopJD)
 				{
-					dist = findDistance(jd, object1, object2);
+					dist = findDistance(ephemeris, jd, object1, object2);
 					sgn = StelUtils::sign(dist - prevDist);
 					if (sgn!=prevSgn)
 						break;
@@ -1026,7 +1014,7 @@ QMap<double, double> AstroCalcDialog::findClosestApproach(PlanetP &object1, Nebu
 				}
 			}
 
-			if (findPrecise(&extremum, object1, object2, jd, step, sgn))
+			if (findPrecise(ephemeris, &extremum, object1, object2, jd, step, sgn))
 			{
 				double sep = extremum.second*180./M_PI;
 				if (sep<maxSeparation)
@@ -1043,7 +1031,7 @@ QMap<double, double> AstroCalcDialog::findClosestApproach(PlanetP &object1, Nebu
 	return separations;
 }
 
-bool AstroCalcDialog::findPrecise(QPair<double, double> *out, PlanetP object1, NebulaP object2, double JD, double step, int prevSign)
+bool AstroCalcDialog::findPrecise(SolarSystemEphemeris& ephemeris, QPair<double, double> *out, PlanetP object1, NebulaP object2, double JD, double step, int prevSign)
 {
 	int sgn;
 	double dist, prevDist;
@@ -1051,20 +1039,20 @@ bool AstroCalcDialog::findPrecise(QPair<double, double> *out, PlanetP object1, N
 	if (out==NULL)
 		return false;
 
-	prevDist = findDistance(JD, object1, object2);
+	prevDist = findDistance(ephemeris, JD, object1, object2);
 	step = -step/2.f;
 	prevSign = -prevSign;
 
 	while(true)
 	{
 		JD += step;
-		dist = findDistance(JD, object1, object2);
+		dist = findDistance(ephemeris, JD, object1, object2);
 
 		if (qAbs(step)< 1.f/1440.f)
 		{
 			out->first = JD - step/2.0;
-			out->second = findDistance(JD - step/2.0, object1, object2);
-			if (out->second < findDistance(JD - 5.0, object1, object2))
+			out->second = findDistance(ephemeris, JD - step/2.0, object1, object2);
+			if (out->second < findDistance(ephemeris, JD - 5.0, object1, object2))
 				return true;
 			else
 				return false;
@@ -1080,11 +1068,9 @@ bool AstroCalcDialog::findPrecise(QPair<double, double> *out, PlanetP object1, N
 	}
 }
 
-double AstroCalcDialog::findDistance(double JD, PlanetP object1, NebulaP object2)
+double AstroCalcDialog::findDistance(SolarSystemEphemeris& ephemeris, double JD, PlanetP object1, NebulaP object2)
 {
-	core->setJD(JD);
-	core->update(0);
-	Vec3d obj1 = object1->getJ2000EquatorialPos(core);
+	Vec3d obj1 = ephemeris.getJ2000EquatorialPos(object1, JD);
 	Vec3d obj2 = object2->getJ2000EquatorialPos(core);
 	return obj1.angle(obj2);
 }
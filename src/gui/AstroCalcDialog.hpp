@@ -36,6 +36,7 @@
 
 class Ui_astroCalcDialogForm;
 class QListWidgetItem;
+class SolarSystemEphemeris;
 
 class AstroCalcDialog : public StelDialog
 {
@@ -148,14 +149,15 @@ private:
 	//! @note Ported from KStars, should be improved, because this feature calculate
 	//! angular separation ("conjunction" defined as equality of right ascension
 	//! of two body) and current solution is not accurate and slow.
-	QMap<double, double> findClosestApproach(PlanetP& object1, PlanetP& object2, double startJD, double stopJD, double maxSeparation, bool opposition);
-	double findDistance(double JD, PlanetP object1, PlanetP object2, bool opposition);
-	bool findPrecise(QPair<double, double>* out, PlanetP object1, PlanetP object2, double JD, double step, int prevSign, bool opposition);
+	//! The positions are taken from ephemeris, without changing the time of the core.
+	QMap<double, double> findClosestApproach(SolarSystemEphemeris& ephemeris, PlanetP& object1, PlanetP& object2, double startJD, double stopJD, double maxSeparation, bool opposition);
+	double findDistance(SolarSystemEphemeris& ephemeris, double JD, PlanetP object1, PlanetP object2, bool opposition);
+	bool findPrecise(SolarSystemEphemeris& ephemeris, QPair<double, double>* out, PlanetP object1, PlanetP object2, double JD, double step, int prevSign, bool opposition);
 	void fillPhenomenaTable(const QMap<double, double> list, const PlanetP object1, const PlanetP object2, bool opposition);
 
-	QMap<double, double> findClosestApproach(PlanetP& object1, NebulaP& object2, double startJD, double stopJD, double maxSeparation);
-	double findDistance(double JD, PlanetP object1, NebulaP object2);
-	bool findPrecise(QPair<double, double>* out, PlanetP object1, NebulaP object2, double JD, double step, int prevSign);
+	QMap<double, double> findClosestApproach(SolarSystemEphemeris& ephemeris, PlanetP& object1, NebulaP& object2, double startJD, double stopJD, double maxSeparation);
+	double findDistance(SolarSystemEphemeris& ephemeris, double JD, PlanetP object1, NebulaP object2);
+	bool findPrecise(SolarSystemEphemeris& ephemeris, QPair<double, double>* out, PlanetP object1, NebulaP object2, double JD, double step, int prevSign);
 	void fillPhenomenaTable(const QMap<double, double> list, const PlanetP object1, const NebulaP object2);
 
 	QString delimiter, acEndl;
@@ -40,12 +40,14 @@
 #include <QSortFilterProxyModel>
 #include <QTimer>
 #include <QStringListModel>
+#include <QRegExp>
 
 LocationDialog::LocationDialog(QObject* parent)
 	: StelDialog(parent)
 	, isEditingNew(false)
 	, allModel(NULL)
 	, pickedModel(NULL)
+	, searchModel(NULL)
 	, proxyModel(NULL)
 {
 	dialogName = "Location";
@@ -96,6 +98,7 @@ void LocationDialog::createDialogContent()
 	//initialize list model
 	allModel = new QStringListModel(this);
 	pickedModel = new QStringListModel(this);
+	searchModel = new QStringListModel(this);
 	connect(&StelApp::getInstance().getLocationMgr(), SIGNAL(locationListChanged()), this, SLOT(reloadLocations()));
 	reloadLocations();
 	proxyModel = new QSortFilterProxyModel(ui->citiesListView);
@@ -114,7 +117,7 @@ void LocationDialog::createDialogContent()
 	populatePlanetList();
 	populateCountryList();
 
-	connect(ui->citySearchLineEdit, SIGNAL(textChanged(const QString&)), proxyModel, SLOT(setFilterWildcard(const QString&)));
+	connect(ui->citySearchLineEdit, SIGNAL(textChanged(const QString&)), this, SLOT(filterLocations(const QString&)));
 	connect(ui->citiesListView, SIGNAL(clicked(const QModelIndex&)),
 		this, SLOT(setPositionFromList(const QModelIndex&)));
 
@@ -384,7 +387,15 @@ void LocationDialog::setPositionFromMap(double longitude, double latitude)
 	setFieldsFromLocation(loc);
 	StelApp::getInstance().getCore()->moveObserverTo(loc, 0.);
 	// GZ: Filter location list for nearby sites. I assume Earth locations are better known. With only few locations on other planets in the list, 30 degrees seem OK.
-	LocationMap results = StelApp::getInstance().getLocationMgr().pickLocationsNearby(loc.planetName, longitude, latitude, loc.planetName=="Earth" ? 3.0f: 30.0f);
+	StelLocationMgr &locMgr=StelApp::getInstance().getLocationMgr();
+	LocationMap results = locMgr.pickLocationsNearby(loc.planetName, longitude, latitude, loc.planetName=="Earth" ? 3.0f: 30.0f);
+	// Far from any known site, list at least the nearest one
+	if (results.isEmpty())
+	{
+		const StelLocation nearest = locMgr.pickNearestLocation(loc.planetName, longitude, latitude);
+		if (nearest.isValid())
+			results.insert(nearest.getID(), nearest);
+	}
 	pickedModel->setStringList(results.keys());
 	proxyModel->setSourceModel(pickedModel);
 	proxyModel->sort(0, Qt::AscendingOrder);
@@ -566,6 +577,30 @@ void LocationDialog::resetCompleteList()
 	proxyModel->sort(0, Qt::AscendingOrder);
 }
 
+// Called when the searched text changes. In the complete list, plain text is looked up in the name index
+// of the location manager and the sites are listed by population. Wildcards, and the shorter lists of
+// nearby sites or of a country, are filtered by the proxy model.
+void LocationDialog::filterLocations(const QString& text)
+{
+	const bool completeList = proxyModel->sourceModel()==allModel || proxyModel->sourceModel()==searchModel;
+	if (completeList && !text.isEmpty() && !text.contains(QRegExp("[*?\\[]")))
+	{
+		const StelLocationMgr &locMgr=StelApp::getInstance().getLocationMgr();
+		searchModel->setStringList(locMgr.findLocationIDs(text, locMgr.getAllMap().size()));
+		proxyModel->setFilterWildcard(QString());
+		if (proxyModel->sourceModel()!=searchModel)
+			proxyModel->setSourceModel(searchModel);
+		proxyModel->sort(-1);
+		return;
+	}
+	if (completeList && proxyModel->sourceModel()!=allModel)
+	{
+		proxyModel->setSourceModel(allModel);
+		proxyModel->sort(0, Qt::AscendingOrder);
+	}
+	proxyModel->setFilterWildcard(text);
+}
+
 // called when user clicks in the country combobox and selects a country. The locations in the list are updated to select only sites in that country.
 void LocationDialog::filterSitesByCountry()
 {
@@ -107,6 +107,9 @@ private slots:
 	//! filter city list to show entries from single country only
 	void filterSitesByCountry();
 
+	//! filter city list with the searched text
+	void filterLocations(const QString& text);
+
 	//! reset city list to complete list (may have been reduced to picked list)
 	void resetCompleteList();
 
@@ -120,6 +123,8 @@ private:
 	QString lastPlanet;
 	QStringListModel* allModel;
 	QStringListModel* pickedModel;
+	//! Locations of the complete list found by the search
+	QStringListModel* searchModel;
 	QSortFilterProxyModel *proxyModel;
 
 	//! Updates the check state and the enabled/disabled status.
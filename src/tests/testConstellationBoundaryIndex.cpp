@@ -0,0 +1,153 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include <QObject>
+#include <QtDebug>
+#include <QtTest>
+
+#include "tests/testConstellationBoundaryIndex.hpp"
+#include "StelUtils.hpp"
+#include "VecMath.hpp"
+
+QTEST_GUILESS_MAIN(TestConstellationBoundaryIndex)
+
+static Vec3d j2000Direction(double raHours, double decDeg)
+{
+	Vec3d v;
+	StelUtils::spheToRect(raHours*M_PI/12., decDeg*M_PI/180., v);
+	return v;
+}
+
+QString TestConstellationBoundaryIndex::find(double raHours, double decDeg) const
+{
+	const int i = index.find(j2000Direction(raHours, decDeg));
+	return i<0 ? QString() : index.getAbbreviations().at(i);
+}
+
+void TestConstellationBoundaryIndex::initTestCase()
+{
+	QVERIFY(index.load(QString(STELLARIUM_SOURCE_DIR) + "/data/constellations_boundaries.dat"));
+	QVERIFY(index.isLoaded());
+	QCOMPARE(index.getAbbreviations().size(), 88);
+}
+
+void TestConstellationBoundaryIndex::testNotLoaded()
+{
+	ConstellationBoundaryIndex empty;
+	QVERIFY(!empty.isLoaded());
+	QCOMPARE(empty.find(Vec3d(1., 0., 0.)), -1);
+	QVERIFY(!empty.load(QString(STELLARIUM_SOURCE_DIR) + "/data/no_such_boundaries.dat"));
+	QVERIFY(!empty.isLoaded());
+}
+
+void TestConstellationBoundaryIndex::testFind_data()
+{
+	QTest::addColumn<double>("ra");
+	QTest::addColumn<double>("dec");
+	QTest::addColumn<QString>("constellation");
+
+	// J2000.0 positions of the stars
+	QTest::newRow("Polaris") << 2.+31./60.+49.09/3600. << 89.+15./60.+50.8/3600. << "UMi";
+	QTest::newRow("Sirius") << 6.+45./60.+8.92/3600. << -(16.+42./60.+58.0/3600.) << "CMa";
+	QTest::newRow("Betelgeuse") << 5.+55./60.+10.31/3600. << 7.+24./60.+25.4/3600. << "Ori";
+	QTest::newRow("Vega") << 18.+36./60.+56.34/3600. << 38.+47./60.+1.3/3600. << "Lyr";
+	QTest::newRow("Acrux") << 12.+26./60.+35.90/3600. << -(63.+5./60.+56.7/3600.) << "Cru";
+	QTest::newRow("Alpheratz") << 0.+8./60.+23.26/3600. << 29.+5./60.+25.6/3600. << "And";
+	// The poles
+	QTest::newRow("north pole") << 0. << 90. << "UMi";
+	QTest::newRow("south pole") << 0. << -90. << "Oct";
+	// On both sides of 0h, between the boundaries of Pisces and Andromeda with Pegasus
+	QTest::newRow("Peg before 0h") << 23.9999 << 20. << "Peg";
+	QTest::newRow("Peg at 0h") << 0. << 20. << "Peg";
+	QTest::newRow("Peg after 0h") << 0.0001 << 20. << "Peg";
+}
+
+void TestConstellationBoundaryIndex::testFind()
+{
+	QFETCH(double, ra);
+	QFETCH(double, dec);
+	QFETCH(QString, constellation);
+	QCOMPARE(find(ra, dec), constellation);
+}
+
+void TestConstellationBoundaryIndex::testBoundary_data()
+{
+	QTest::addColumn<double>("ra");
+	QTest::addColumn<double>("dec");
+	QTest::addColumn<QString>("north");
+	QTest::addColumn<QString>("south");
+
+	// Points of the arcs of constant B1875.0 declination crossing 0h, in constellations_boundaries.dat
+	QTest::newRow("Peg/Psc before 0h") << 23.9398079 << 10.695797 << "Peg" << "Psc";
+	QTest::newRow("Peg/Psc after 0h") << 0.0066261 << 10.6960516 << "Peg" << "Psc";
+	QTest::newRow("And/Peg before 0h") << 23.9224224 << 32.029026 << "And" << "Peg";
+	QTest::newRow("Cas/And after 0h") << 0.2088388 << 48.6955376 << "Cas" << "And";
+	QTest::newRow("Cet/Scl after 0h") << 0.006995 << -24.8039494 << "Cet" << "Scl";
+}
+
+void TestConstellationBoundaryIndex::testBoundary()
+{
+	QFETCH(double, ra);
+	QFETCH(double, dec);
+	QFETCH(QString, north);
+	QFETCH(QString, south);
+
+	// On the boundary, either side is right
+	const QString onBoundary = find(ra, dec);
+	QVERIFY2(onBoundary==north || onBoundary==south, qPrintable(onBoundary));
+	// Well beyond the rounding of the boundary file and the precession of its points
+	const double offset = 1./60.;
+	QCOMPARE(find(ra, dec+offset), north);
+	QCOMPARE(find(ra, dec-offset), south);
+}
+
+void TestConstellationBoundaryIndex::testFindBatch()
+{
+	QVector<Vec3d> directions;
+	directions << j2000Direction(2.+31./60.+49.09/3600., 89.+15./60.+50.8/3600.)
+		   << j2000Direction(6.+45./60.+8.92/3600., -(16.+42./60.+58.0/3600.))
+		   << j2000Direction(0., -90.);
+	// Random directions in the unit ball, not normalized
+	qsrand(1);
+	while (directions.size()<10000)
+	{
+		const Vec3d v(2.*qrand()/RAND_MAX-1., 2.*qrand()/RAND_MAX-1., 2.*qrand()/RAND_MAX-1.);
+		if (v.length()>1e-3 && v.length()<=1.)
+			directions << v;
+	}
+
+	const QVector<int> result = index.find(directions);
+	QCOMPARE(result.size(), directions.size());
+	QCOMPARE(index.getAbbreviations().at(result.at(0)), QString("UMi"));
+	QCOMPARE(index.getAbbreviations().at(result.at(1)), QString("CMa"));
+	QCOMPARE(index.getAbbreviations().at(result.at(2)), QString("Oct"));
+	QSet<int> found;
+	for (int i=0; i<directions.size(); ++i)
+	{
+		QCOMPARE(result.at(i), index.find(directions.at(i)));
+		Vec3d unit = directions.at(i);
+		unit.normalize();
+		QCOMPARE(index.find(unit), result.at(i));
+		found << result.at(i);
+	}
+	// 10000 random directions fall in every constellation, even Crux
+	QCOMPARE(found.size(), 88);
+
+	QVERIFY(index.find(QVector<Vec3d>()).isEmpty());
+}
@@ -0,0 +1,45 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _TESTCONSTELLATIONBOUNDARYINDEX_HPP_
+#define _TESTCONSTELLATIONBOUNDARYINDEX_HPP_
+
+#include <QObject>
+#include <QtTest>
+
+#include "ConstellationBoundaryIndex.hpp"
+
+class TestConstellationBoundaryIndex : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+	void testNotLoaded();
+	void testFind_data();
+	void testFind();
+	void testBoundary_data();
+	void testBoundary();
+	void testFindBatch();
+private:
+	//! The abbreviation of the constellation containing a J2000.0 direction, or an empty string.
+	QString find(double raHours, double decDeg) const;
+	ConstellationBoundaryIndex index;
+};
+
+#endif // _TESTCONSTELLATIONBOUNDARYINDEX_HPP_
@@ -43,3 +43,30 @@ void TestExtinction::testBase()
 	extCls.forward(vert, &mag);
 	QVERIFY(mag==2.25);
 }
+
+void TestExtinction::testTabulated()
+{
+	const Extinction::UndergroundExtinctionMode modes[] = {Extinction::UndergroundExtinctionZero, Extinction::UndergroundExtinctionMax, Extinction::UndergroundExtinctionMirror};
+	for (int m=0; m<3; ++m)
+	{
+		Extinction extCls;
+		extCls.setUndergroundExtinctionMode(modes[m]);
+		for (float k=0.1f; k<=1.f; k+=0.15f)
+		{
+			extCls.setExtinctionCoefficient(k);
+			for (int i=-9000; i<=9000; ++i)
+			{
+				const double alt = i*M_PI/18000.;
+				const Vec3d v(std::cos(alt), 0., std::sin(alt));
+				float mag=0.f;
+				extCls.forward(v, &mag);
+				float magTabulated=0.f;
+				extCls.forwardTabulated(std::sin(alt), &magTabulated);
+				// Less accurate near the horizon, where the airmass increases fast
+				const float tolerance = (alt>=0. ? 0.0025f : 0.015f)*k;
+				QVERIFY2(std::fabs(mag-magTabulated)<=tolerance,
+					 qPrintable(QString("mode %1, k=%2, altitude %3: %4 instead of %5").arg(m).arg(k).arg(alt*180./M_PI).arg(magTabulated).arg(mag)));
+			}
+		}
+	}
+}
@@ -30,6 +30,7 @@ class TestExtinction : public QObject
 private slots:
 	void initTestCase();
 	void testBase();	
+	void testTabulated();
 };
 
 #endif // _TESTEXTINCTION_HPP_
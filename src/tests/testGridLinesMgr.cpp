@@ -0,0 +1,187 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include <QObject>
+#include <QtDebug>
+#include <QtTest>
+#include <QApplication>
+#include <QDir>
+#include <QImage>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+#include <QSettings>
+
+#include "tests/testGridLinesMgr.hpp"
+#include "StelApp.hpp"
+#include "StelCore.hpp"
+#include "StelFileMgr.hpp"
+#include "StelModuleMgr.hpp"
+#include "StelPainter.hpp"
+#include "StelTranslator.hpp"
+#include "GridLinesMgr.hpp"
+
+#define FRAME_WIDTH 1024
+#define FRAME_HEIGHT 768
+
+// As QTEST_MAIN, but without a display the test is drawn offscreen, by Mesa llvmpipe on a machine without a GPU
+int main(int argc, char *argv[])
+{
+	if (qgetenv("QT_QPA_PLATFORM").isEmpty() && qgetenv("DISPLAY").isEmpty())
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	QApplication app(argc, argv);
+	app.setAttribute(Qt::AA_Use96Dpi, true);
+	TestGridLinesMgr test;
+	return QTest::qExec(&test, argc, argv);
+}
+
+// Number of pixels of the frame which are not black
+static int litPixels(const QImage& image)
+{
+	int count = 0;
+	for (int y=0; y<image.height(); ++y)
+	{
+		const QRgb* line = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+		for (int x=0; x<image.width(); ++x)
+			if (qRed(line[x]) || qGreen(line[x]) || qBlue(line[x]))
+				++count;
+	}
+	return count;
+}
+
+void TestGridLinesMgr::initTestCase()
+{
+	surface = NULL;
+	context = NULL;
+	frameBuffer = NULL;
+	settings = NULL;
+	app = NULL;
+
+	// The user directory of StelFileMgr is in the home directory, the data are those of the source tree
+	QVERIFY(userDir.isValid());
+	qputenv("HOME", QFile::encodeName(userDir.path()));
+	QVERIFY(QDir::setCurrent(STELLARIUM_SOURCE_DIR));
+	StelFileMgr::init();
+	StelTranslator::init(StelFileMgr::getInstallationDir() + "/data/iso639-1.utf8");
+
+	surface = new QOffscreenSurface();
+	surface->create();
+	context = new QOpenGLContext();
+	if (!context->create() || !context->makeCurrent(surface))
+		QSKIP("No OpenGL context: install Mesa to draw with its llvmpipe software renderer");
+	if (context->format().majorVersion()<2)
+		QSKIP("OpenGL 2 is not supported");
+	frameBuffer = new QOpenGLFramebufferObject(FRAME_WIDTH, FRAME_HEIGHT, QOpenGLFramebufferObject::CombinedDepthStencil);
+	QVERIFY(frameBuffer->bind());
+
+	StelApp::initStatic();
+	settings = new QSettings(userDir.path() + "/config.ini", QSettings::IniFormat);
+	app = new StelApp();
+	app->init(settings);
+	StelPainter::initGLShaders();
+	app->glWindowHasBeenResized(0, 0, FRAME_WIDTH, FRAME_HEIGHT);
+
+	GridLinesMgr* grids = GETSTELMODULE(GridLinesMgr);
+	QVERIFY(grids!=NULL);
+	grids->setFlagAzimuthalGrid(true);
+	grids->setFlagEquatorGrid(true);
+	grids->setFlagEquatorJ2000Grid(true);
+	grids->setFlagEclipticJ2000Grid(true);
+	grids->setFlagEclipticGrid(true);
+	grids->setFlagGalacticGrid(true);
+	grids->setFlagEquatorLine(true);
+	grids->setFlagEquatorJ2000Line(true);
+	grids->setFlagEclipticLine(true);
+	grids->setFlagEclipticJ2000Line(true);
+	grids->setFlagMeridianLine(true);
+	grids->setFlagHorizonLine(true);
+	grids->setFlagGalacticEquatorLine(true);
+	grids->setFlagPrimeVerticalLine(true);
+	// Let the faders of the grids and lines end
+	app->update(10.);
+}
+
+void TestGridLinesMgr::cleanupTestCase()
+{
+	if (app)
+	{
+		StelPainter::deinitGLShaders();
+		delete app;
+		StelApp::deinitStatic();
+	}
+	delete settings;
+	delete frameBuffer;
+	delete context;
+	delete surface;
+}
+
+int TestGridLinesMgr::drawGrids(bool lineBatch)
+{
+	GridLinesMgr* grids = GETSTELMODULE(GridLinesMgr);
+	grids->setFlagLineBatch(lineBatch);
+	StelCore* core = app->getCore();
+	context->functions()->glClearColor(0.f, 0.f, 0.f, 0.f);
+	context->functions()->glClear(GL_COLOR_BUFFER_BIT);
+	core->preDraw();
+	const int drawCalls = StelPainter::getDrawCallCount();
+	grids->draw(core);
+	const int gridDrawCalls = StelPainter::getDrawCallCount()-drawCalls;
+	core->postDraw();
+	context->functions()->glFinish();
+	return gridDrawCalls;
+}
+
+void TestGridLinesMgr::testDrawCalls()
+{
+	const int direct = drawGrids(false);
+	const QImage directFrame = frameBuffer->toImage();
+	const int batched = drawGrids(true);
+	const QImage batchedFrame = frameBuffer->toImage();
+	QVERIFY(!StelPainter::isLineBatchActive());
+
+	// The labels are drawn in both cases, then the lines in one call instead of one per visible arc
+	QVERIFY2(direct-batched>100, qPrintable(QString("%1 draw calls per arc, %2 batched").arg(direct).arg(batched)));
+
+	// The same lines are drawn. The pixels of the joints of the arcs may differ.
+	const int directPixels = litPixels(directFrame);
+	const int batchedPixels = litPixels(batchedFrame);
+	QVERIFY(directPixels>FRAME_WIDTH*10);
+	QVERIFY2(qAbs(directPixels-batchedPixels)<=directPixels/10, qPrintable(QString("%1 pixels per arc, %2 batched").arg(directPixels).arg(batchedPixels)));
+
+	// The batch is empty after each frame
+	QCOMPARE(drawGrids(true), batched);
+}
+
+void TestGridLinesMgr::benchmarkDraw_data()
+{
+	QTest::addColumn<bool>("lineBatch");
+	QTest::newRow("per arc") << false;
+	QTest::newRow("batched") << true;
+}
+
+void TestGridLinesMgr::benchmarkDraw()
+{
+	QFETCH(bool, lineBatch);
+	int drawCalls = 0;
+	QBENCHMARK {
+		drawCalls = drawGrids(lineBatch);
+	}
+	QVERIFY(drawCalls>0);
+}
@@ -0,0 +1,58 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _TESTGRIDLINESMGR_HPP_
+#define _TESTGRIDLINESMGR_HPP_
+
+#include <QObject>
+#include <QtTest>
+#include <QTemporaryDir>
+
+class QOffscreenSurface;
+class QOpenGLContext;
+class QOpenGLFramebufferObject;
+class QSettings;
+class StelApp;
+
+//! Draws the grids and lines of GridLinesMgr with the real StelApp and StelPainter into an
+//! offscreen OpenGL context (e.g. Mesa llvmpipe), and counts the draw calls of StelPainter
+//! with the line batch and with one call per arc.
+class TestGridLinesMgr : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+	void testDrawCalls();
+	void benchmarkDraw_data();
+	void benchmarkDraw();
+private:
+	//! Draw the grids and lines into a cleared frame.
+	//! @return the number of draw calls of GridLinesMgr::draw().
+	int drawGrids(bool lineBatch);
+
+	QTemporaryDir userDir;
+	QOffscreenSurface* surface;
+	QOpenGLContext* context;
+	QOpenGLFramebufferObject* frameBuffer;
+	QSettings* settings;
+	StelApp* app;
+};
+
+#endif // _TESTGRIDLINESMGR_HPP_
@@ -0,0 +1,123 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include <QObject>
+#include <QtDebug>
+#include <QtTest>
+
+#include "tests/testKeplerOrbitBatch.hpp"
+#include "StelUtils.hpp"
+
+QTEST_GUILESS_MAIN(TestKeplerOrbitBatch)
+
+#define ORBIT_COUNT 20000
+#define TEST_JDE 2457388.5
+
+static double randomValue(double min, double max)
+{
+	return min + (max-min)*qrand()/RAND_MAX;
+}
+
+void TestKeplerOrbitBatch::initTestCase()
+{
+	qsrand(1);
+	for (int i=0; i<ORBIT_COUNT; ++i)
+	{
+		// Main belt like orbits, with some circular and highly eccentric ones for all methods of solving Kepler's equation
+		const double e = (i%100==0) ? 0. : ((i%10==0) ? randomValue(0.9, 0.99) : randomValue(0., 0.5));
+		const double a = randomValue(0.5, 50.);
+		const double q = a*(1.-e);
+		const double period = 365.25*std::sqrt(a*a*a);
+		const double inclination = randomValue(0., M_PI/2.);
+		const double ascendingNode = randomValue(0., 2.*M_PI);
+		const double argOfPericenter = randomValue(0., 2.*M_PI);
+		const double meanAnomaly = randomValue(0., 2.*M_PI);
+		const double epoch = randomValue(2451545.0, 2457500.0);
+		batchOrbits.append(new EllipticalOrbit(q, e, inclination, ascendingNode, argOfPericenter, meanAnomaly, period, epoch, 0., 0., 0.));
+		referenceOrbits.append(new EllipticalOrbit(q, e, inclination, ascendingNode, argOfPericenter, meanAnomaly, period, epoch, 0., 0., 0.));
+		QVERIFY(batch.add(batchOrbits.last()));
+	}
+	QCOMPARE(batch.size(), ORBIT_COUNT);
+}
+
+void TestKeplerOrbitBatch::cleanupTestCase()
+{
+	batch.clear();
+	qDeleteAll(batchOrbits);
+	qDeleteAll(referenceOrbits);
+}
+
+void TestKeplerOrbitBatch::testBatchPositions()
+{
+	batch.compute(TEST_JDE);
+	for (int i=0; i<ORBIT_COUNT; ++i)
+	{
+		Vec3d pos, ref;
+		QVERIFY(batch.getPosition(i, KeplerOrbitBatch::CommonPass, pos));
+		referenceOrbits.at(i)->positionAtTimevInVSOP87Coordinates(TEST_JDE, ref);
+		QVERIFY2((pos-ref).length() <= 1e-12*ref.length(), qPrintable(QString("orbit %1: batch %2 reference %3").arg(i).arg(pos.toString()).arg(ref.toString())));
+	}
+	// Without light time correction, there is no second pass
+	Vec3d pos, ref;
+	QVERIFY(!batch.getPosition(0, KeplerOrbitBatch::LightTimePass, pos));
+	QVERIFY(!batch.getPosition(-1, KeplerOrbitBatch::CommonPass, pos));
+	QVERIFY(!batch.getPosition(ORBIT_COUNT, KeplerOrbitBatch::CommonPass, pos));
+	// The orbits of the batch still compute any date themselves, even the date of the batch
+	batchOrbits.first()->positionAtTimevInVSOP87Coordinates(TEST_JDE, pos);
+	referenceOrbits.first()->positionAtTimevInVSOP87Coordinates(TEST_JDE, ref);
+	QVERIFY(pos==ref);
+	batchOrbits.first()->positionAtTimevInVSOP87Coordinates(TEST_JDE+1., pos);
+	referenceOrbits.first()->positionAtTimevInVSOP87Coordinates(TEST_JDE+1., ref);
+	QVERIFY(pos==ref);
+}
+
+void TestKeplerOrbitBatch::testLightTimePositions()
+{
+	const Vec3d observerPos(0.9, 0.3, 0.);
+	batch.computeWithLightTime(TEST_JDE, observerPos);
+	for (int i=0; i<ORBIT_COUNT; i+=97)
+	{
+		Vec3d pos, ref;
+		QVERIFY(batch.getPosition(i, KeplerOrbitBatch::CommonPass, pos));
+		const double JDE = TEST_JDE - (pos-observerPos).length() * (AU / (SPEED_OF_LIGHT * 86400));
+		QVERIFY(batch.getPosition(i, KeplerOrbitBatch::LightTimePass, pos));
+		referenceOrbits.at(i)->positionAtTimevInVSOP87Coordinates(JDE, ref);
+		QVERIFY((pos-ref).length() <= 1e-12*ref.length());
+	}
+	// A later computation without light time correction drops the second pass
+	batch.compute(TEST_JDE+1.);
+	Vec3d pos;
+	QVERIFY(!batch.getPosition(0, KeplerOrbitBatch::LightTimePass, pos));
+}
+
+void TestKeplerOrbitBatch::benchmarkPerObject()
+{
+	Vec3d pos;
+	QBENCHMARK {
+		foreach (const EllipticalOrbit* orbit, referenceOrbits)
+			orbit->positionAtTimevInVSOP87Coordinates(TEST_JDE, pos);
+	}
+}
+
+void TestKeplerOrbitBatch::benchmarkBatch()
+{
+	QBENCHMARK {
+		batch.compute(TEST_JDE);
+	}
+}
@@ -0,0 +1,224 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include <QObject>
+#include <QtDebug>
+#include <QtTest>
+
+#include <cmath>
+
+#include "tests/testOrbitLineCache.hpp"
+#include "OrbitLineCache.hpp"
+#include "Orbit.hpp"
+
+QTEST_GUILESS_MAIN(TestOrbitLineCache)
+
+#define TEST_JDE 2457700.3
+#define SEGMENTS 60
+
+// Samples the positions of an elliptical orbit, as Planet does with its position function
+class EllipticalOrbitSampler : public OrbitLineCache::Sampler
+{
+public:
+	EllipticalOrbitSampler(const EllipticalOrbit& orbit, bool withParentGM=true)
+		: orbit(orbit), withParentGM(withParentGM), calls(0) {}
+	virtual Vec3d positionAt(double JDE) const
+	{
+		++calls;
+		Vec3d pos;
+		orbit.positionAtTimevInVSOP87Coordinates(JDE, pos);
+		return pos;
+	}
+	virtual double getParentGM() const
+	{
+		return withParentGM ? orbit.getParentGM() : OrbitLineCache::Sampler::getParentGM();
+	}
+	const EllipticalOrbit& orbit;
+	const bool withParentGM;
+	mutable int calls;
+};
+
+// An osculating function whose orbit grows with the epoch, unlike the orbit of positionAt()
+class OsculatingSampler : public EllipticalOrbitSampler
+{
+public:
+	OsculatingSampler(const EllipticalOrbit& orbit) : EllipticalOrbitSampler(orbit), osculatingCalls(0) {}
+	virtual bool osculatingPositionAt(double epoch, double JDE, Vec3d& pos) const
+	{
+		++osculatingCalls;
+		orbit.positionAtTimevInVSOP87Coordinates(JDE, pos);
+		pos *= 1. + (epoch-TEST_JDE)*1e-4;
+		return true;
+	}
+	mutable int osculatingCalls;
+};
+
+// Check that the samples of the line are the positions at the sample dates, in order, and return their indices
+static QVector<int> checkSamples(const QVector<Vec3d>& points, int currentPoint, const EllipticalOrbitSampler& sampler,
+				 double JDE, double step, double tolerance, bool osculating=false)
+{
+	QVector<int> indices;
+	const qint64 current = OrbitLineCache::sampleIndex(JDE, step);
+	int p = 0;
+	for (qint64 k=current-SEGMENTS/2; k<current-SEGMENTS/2+SEGMENTS; ++k)
+	{
+		Vec3d expected;
+		if (osculating)
+			sampler.osculatingPositionAt(current*step, k*step, expected);
+		else
+			expected = sampler.positionAt(k*step);
+		while (p<points.size() && !((points.at(p)-expected).length() <= tolerance))
+			++p;
+		if (p==points.size())
+		{
+			qWarning() << "sample" << k << "not found:" << expected.toString();
+			return QVector<int>();
+		}
+		if (k==current && p!=currentPoint)
+		{
+			qWarning() << "current sample at" << p << "instead of" << currentPoint;
+			return QVector<int>();
+		}
+		indices << p++;
+	}
+	return indices;
+}
+
+void TestOrbitLineCache::testSamples()
+{
+	// Halley like comet, next to the perihelion at TEST_JDE
+	const double q = 0.586, e = 0.967;
+	const double a = q/(1.-e);
+	const EllipticalOrbit orbit(q, e, 162.3*M_PI/180., 58.4*M_PI/180., 111.3*M_PI/180., 0., 365.25*std::sqrt(a*a*a), TEST_JDE, 0., 0., 0.);
+	const EllipticalOrbitSampler sampler(orbit);
+	QVERIFY(std::fabs(sampler.getParentGM()-0.01720209895*0.01720209895) <= 1e-3*sampler.getParentGM());
+
+	OrbitLineCache cache(3*SEGMENTS);
+	QVector<Vec3d> points;
+	const double step = 20.;
+	const int currentPoint = cache.getLine(sampler, TEST_JDE, step, SEGMENTS, false, false, points);
+	QCOMPARE(checkSamples(points, currentPoint, sampler, TEST_JDE, step, 0.).size(), SEGMENTS);
+	// The sharp turn at the perihelion is refined
+	QVERIFY(points.size()>SEGMENTS);
+
+	// All points are on the ellipse: the sum of the distances to the foci is 2a
+	const Vec3d pericenter = sampler.positionAt(TEST_JDE);
+	const Vec3d otherFocus = pericenter*(-2.*a*e/pericenter.length());
+	foreach (const Vec3d& p, points)
+		QVERIFY2(std::fabs(p.length()+(p-otherFocus).length()-2.*a) <= 1e-9*a, qPrintable(p.toString()));
+
+	// A closed line ends with its first point
+	cache.getLine(sampler, TEST_JDE, step, SEGMENTS, true, false, points);
+	QVERIFY(points.last()==points.first());
+}
+
+void TestOrbitLineCache::testTimeJumps()
+{
+	const EllipticalOrbit orbit(1.38, 0.093, 1.85*M_PI/180., 49.6*M_PI/180., 286.5*M_PI/180., 0.3, 686.98, 2451545.0, 0., 0., 0.);
+	const EllipticalOrbitSampler sampler(orbit);
+	const double step = 686.98/SEGMENTS;
+
+	OrbitLineCache cache(6*SEGMENTS);
+	QVector<Vec3d> points;
+	const double dates[] = {TEST_JDE, TEST_JDE+5.*step, TEST_JDE-1000.*step, TEST_JDE+0.5*step, TEST_JDE+40.*step};
+	for (unsigned int i=0; i<sizeof(dates)/sizeof(dates[0]); ++i)
+	{
+		cache.getLine(sampler, dates[i], step, SEGMENTS, true, false, points);
+		// Another time rate
+		cache.getLine(sampler, dates[i], 2.*step, SEGMENTS, true, false, points);
+	}
+
+	// The line after the time jumps is the one computed from scratch
+	OrbitLineCache fresh(6*SEGMENTS);
+	QVector<Vec3d> expected;
+	const int expectedPoint = fresh.getLine(sampler, TEST_JDE, step, SEGMENTS, true, false, expected);
+	int currentPoint = cache.getLine(sampler, TEST_JDE, step, SEGMENTS, true, false, points);
+	QCOMPARE(currentPoint, expectedPoint);
+	QCOMPARE(points.size(), expected.size());
+	for (int i=0; i<points.size(); ++i)
+		QVERIFY(points.at(i)==expected.at(i));
+	QCOMPARE(checkSamples(points, currentPoint, sampler, TEST_JDE, step, 0.).size(), SEGMENTS);
+
+	// Coming back to a cached date computes nothing
+	cache.getLine(sampler, TEST_JDE+5.*step, step, SEGMENTS, true, false, points);
+	sampler.calls = 0;
+	currentPoint = cache.getLine(sampler, TEST_JDE, step, SEGMENTS, true, false, points);
+	QCOMPARE(sampler.calls, 0);
+	QCOMPARE(currentPoint, expectedPoint);
+	QCOMPARE(points.size(), expected.size());
+}
+
+void TestOrbitLineCache::testOsculatingFunction()
+{
+	const EllipticalOrbit orbit(1.38, 0.093, 1.85*M_PI/180., 49.6*M_PI/180., 286.5*M_PI/180., 0.3, 686.98, 2451545.0, 0., 0., 0.);
+	const OsculatingSampler sampler(orbit);
+	const double step = 686.98/SEGMENTS;
+
+	const double tolerance = 1e-6*1.38/(1.-0.093); // of the semi-major axis
+
+	// The line is the osculating orbit at the sample date, positionAt() is not used.
+	// The points are evaluated from the elements, given by a few calls of the osculating function.
+	OrbitLineCache cache(3*SEGMENTS);
+	QVector<Vec3d> points;
+	int currentPoint = cache.getLine(sampler, TEST_JDE, step, SEGMENTS, false, true, points);
+	QCOMPARE(sampler.calls, 0);
+	const int callsPerEpoch = sampler.osculatingCalls;
+	QVERIFY(callsPerEpoch>0 && callsPerEpoch<=5);
+	QCOMPARE(checkSamples(points, currentPoint, sampler, TEST_JDE, step, tolerance, true).size(), SEGMENTS);
+
+	// Another epoch gives another orbit, for the same number of calls
+	const double JDE = TEST_JDE+3.*step;
+	sampler.osculatingCalls = 0;
+	currentPoint = cache.getLine(sampler, JDE, step, SEGMENTS, false, true, points);
+	QCOMPARE(sampler.osculatingCalls, callsPerEpoch);
+	QCOMPARE(checkSamples(points, currentPoint, sampler, JDE, step, tolerance, true).size(), SEGMENTS);
+	QVERIFY(checkSamples(points, currentPoint, sampler, TEST_JDE, step, tolerance, true).isEmpty());
+
+	// The elements of a previous epoch are cached
+	sampler.osculatingCalls = 0;
+	currentPoint = cache.getLine(sampler, TEST_JDE, step, SEGMENTS, false, true, points);
+	QCOMPARE(sampler.osculatingCalls, 0);
+	QCOMPARE(checkSamples(points, currentPoint, sampler, TEST_JDE, step, tolerance, true).size(), SEGMENTS);
+	QCOMPARE(sampler.calls, 0);
+}
+
+void TestOrbitLineCache::testFittedOrbit()
+{
+	// Callisto around Jupiter, a body without osculating function
+	const double q = 0.012585*(1.-0.0074);
+	const double period = 16.689;
+	const EllipticalOrbit orbit(q, 0.0074, 0.19*M_PI/180., 298.8*M_PI/180., 52.6*M_PI/180., 1.2, period, 2451545.0, 0., 0., 0.);
+	const EllipticalOrbitSampler sampler(orbit);
+	// GM of Jupiter
+	QVERIFY(std::fabs(sampler.getParentGM()*1047.35/(0.01720209895*0.01720209895)-1.) <= 0.01);
+
+	const double step = period/50.;
+	const double a = 0.012585;
+	OrbitLineCache cache(3*SEGMENTS);
+	QVector<Vec3d> points;
+	const int currentPoint = cache.getLine(sampler, TEST_JDE, step, SEGMENTS, false, true, points);
+	// The ellipse fitted to the position and velocity at the sample date follows the orbit
+	QCOMPARE(checkSamples(points, currentPoint, sampler, TEST_JDE, step, 1e-5*a).size(), SEGMENTS);
+
+	// With the GM of the Sun, the fitted ellipse does not follow the orbit of a moon
+	const EllipticalOrbitSampler sunSampler(orbit, false);
+	OrbitLineCache sunCache(3*SEGMENTS);
+	const int sunPoint = sunCache.getLine(sunSampler, TEST_JDE, step, SEGMENTS, false, true, points);
+	QVERIFY(checkSamples(points, sunPoint, sunSampler, TEST_JDE, step, 0.1*a).isEmpty());
+}
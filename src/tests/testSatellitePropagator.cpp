@@ -0,0 +1,215 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include <QObject>
+#include <QtDebug>
+#include <QtTest>
+#include <QByteArray>
+
+#include <cmath>
+
+#include "tests/testSatellitePropagator.hpp"
+#include "gSatWrapper.hpp"
+#include "StelUtils.hpp"
+#include "gsatellite/gTime.hpp"
+#include "gsatellite/mathUtils.hpp"
+#include "gsatellite/stdsat.h"
+
+QTEST_GUILESS_MAIN(TestSatellitePropagator)
+
+#define SATELLITE_COUNT 25000
+// 2016-11-05, 10 to 110 days after the epochs of the elements
+#define TEST_JD 2457698.1234
+#define TEST_LATITUDE 48.85
+#define TEST_LONGITUDE 2.35
+#define TEST_ALTITUDE 35
+
+static double randomValue(double min, double max)
+{
+	return min + (max-min)*qrand()/RAND_MAX;
+}
+
+// Sun of the test in the equinox equatorial frame (AU), at night for the observer
+static const Vec3d testSunPos(-0.6, -0.7, -0.3);
+
+// The observer of gSatWrapper::calcObserverECIPosition() for the test location
+static void referenceObserver(const gTime& epoch, Vec3d& position, Vec3d& velocity)
+{
+	const double radLatitude = TEST_LATITUDE * KDEG2RAD;
+	const double theta = epoch.toThetaLMST(TEST_LONGITUDE * KDEG2RAD);
+	const double c = 1/std::sqrt(1 + __f*(__f - 2)*Sqr(sin(radLatitude)));
+	const double sq = Sqr(1 - __f)*c;
+	const double r = (KEARTHRADIUS*c + (TEST_ALTITUDE/1000.))*cos(radLatitude);
+	position.set(r * cos(theta), r * sin(theta), (KEARTHRADIUS*sq + (TEST_ALTITUDE/1000.))*sin(radLatitude));
+	velocity.set(-KMFACTOR*position[1], KMFACTOR*position[0], 0.);
+}
+
+void TestSatellitePropagator::initTestCase()
+{
+	qsrand(1);
+	for (int i=0; i<SATELLITE_COUNT; ++i)
+	{
+		// Mostly low orbits, with some of the deep space orbits of the public catalogue
+		double meanMotion, e, inclination;
+		if (i%50==0)
+		{
+			// Molniya
+			meanMotion = 2.0057;
+			e = randomValue(0.6, 0.75);
+			inclination = 63.4;
+		}
+		else if (i%20==0)
+		{
+			// Geostationary
+			meanMotion = randomValue(1.0, 1.01);
+			e = randomValue(0., 0.001);
+			inclination = randomValue(0., 5.);
+		}
+		else if (i%10==0)
+		{
+			// Navigation satellites
+			meanMotion = randomValue(2.0, 2.2);
+			e = randomValue(0., 0.02);
+			inclination = randomValue(50., 65.);
+		}
+		else
+		{
+			meanMotion = randomValue(11., 15.);
+			e = randomValue(0., 0.02);
+			inclination = randomValue(0., 110.);
+		}
+		char tle1[130], tle2[130];
+		qsnprintf(tle1, sizeof(tle1), "1 %05dU 16%03dA   16%012.8f  .00000000  00000-0  %05d-5 0  9990",
+			  i, i%1000, randomValue(200., 300.), (int)randomValue(10000., 99999.));
+		qsnprintf(tle2, sizeof(tle2), "2 %05d %8.4f %8.4f %07d %8.4f %8.4f %11.8f%05d0",
+			  i, inclination, randomValue(0., 360.), (int)(e*1e7), randomValue(0., 360.), randomValue(0., 360.),
+			  meanMotion, (int)randomValue(0., 99999.));
+		// The TLE library modifies the lines, so each satellite gets its copy (as in gSatWrapper)
+		QByteArray b1(tle1), b2(tle2), r1(tle1), r2(tle2);
+		batchSatellites.append(new gSatTEME("TEST", b1.data(), b2.data()));
+		referenceSatellites.append(new gSatTEME("TEST", r1.data(), r2.data()));
+		QCOMPARE(propagator.add(batchSatellites.last()), i);
+	}
+	QCOMPARE(propagator.size(), SATELLITE_COUNT);
+}
+
+void TestSatellitePropagator::cleanupTestCase()
+{
+	propagator.clear();
+	qDeleteAll(batchSatellites);
+	qDeleteAll(referenceSatellites);
+}
+
+void TestSatellitePropagator::testObserver()
+{
+	const gTime epoch(TEST_JD);
+	Vec3d position, velocity;
+	referenceObserver(epoch, position, velocity);
+	const SatellitePropagator::Observer observer = SatellitePropagator::computeObserver(TEST_JD, TEST_LATITUDE, TEST_LONGITUDE, TEST_ALTITUDE, testSunPos, false);
+	QVERIFY((observer.position-position).length() <= 1e-9);
+	QVERIFY((observer.velocity-velocity).length() <= 1e-12);
+	QCOMPARE(observer.thetaGMST, epoch.toThetaGMST());
+	const Vec3d sun = testSunPos*AU + position;
+	QVERIFY((observer.sunPosition-sun).length() <= 1e-9*sun.length());
+}
+
+void TestSatellitePropagator::testPropagation()
+{
+	const SatellitePropagator::Observer observer = SatellitePropagator::computeObserver(TEST_JD, TEST_LATITUDE, TEST_LONGITUDE, TEST_ALTITUDE, testSunPos, false);
+	propagator.propagate(observer);
+	QCOMPARE(propagator.getEpoch(), TEST_JD);
+
+	const gTime epoch(TEST_JD);
+	const double radLatitude = TEST_LATITUDE * KDEG2RAD;
+	const double theta = epoch.toThetaLMST(TEST_LONGITUDE * KDEG2RAD);
+	Vec3d observerPos, observerVel;
+	referenceObserver(epoch, observerPos, observerVel);
+	const Vec3d sunPos = testSunPos*AU + observerPos;
+	int visibleCount = 0;
+	for (int i=0; i<SATELLITE_COUNT; ++i)
+	{
+		// The computations of Satellite::update() with gSatWrapper, one satellite at a time
+		gSatTEME* sat = referenceSatellites.at(i);
+		sat->setEpoch(epoch);
+		const Vec3d pos(sat->getPos()[0], sat->getPos()[1], sat->getPos()[2]);
+		const Vec3d vel(sat->getVel()[0], sat->getVel()[1], sat->getVel()[2]);
+		const Vec3d subPoint(sat->getSubPoint()[0], sat->getSubPoint()[1], sat->getSubPoint()[2]);
+		QVERIFY2(propagator.getPosition(i)==pos, qPrintable(QString("satellite %1: batch %2 reference %3").arg(i).arg(propagator.getPosition(i).toString()).arg(pos.toString())));
+		QVERIFY(propagator.getVelocity(i)==vel);
+		QVERIFY(propagator.getSubPoint(i)==subPoint);
+		QVERIFY(subPoint[2]>0.);
+
+		const Vec3d slantRange = pos - observerPos;
+		const Vec3d altAz(sin(radLatitude)*cos(theta)*slantRange[0] + sin(radLatitude)*sin(theta)*slantRange[1] - cos(radLatitude)*slantRange[2],
+				  -sin(theta)*slantRange[0] + cos(theta)*slantRange[1],
+				  cos(radLatitude)*cos(theta)*slantRange[0] + cos(radLatitude)*sin(theta)*slantRange[1] + sin(radLatitude)*slantRange[2]);
+		QVERIFY((propagator.getAltAz(i)-altAz).length() <= 1e-9*slantRange.length());
+		const double range = slantRange.length();
+		QVERIFY(std::fabs(propagator.getRange(i)-range) <= 1e-9*range);
+		const double rangeRate = slantRange.dot(vel - observerVel)/range;
+		QVERIFY(std::fabs(propagator.getRangeRate(i)-rangeRate) <= 1e-9);
+
+		int visibility = NOT_VISIBLE;
+		if (altAz[2] > 0)
+		{
+			const double dist = pos.length()*cos(sunPos.angle(pos) - (M_PI/2));
+			visibility = dist > KEARTHRADIUS ? VISIBLE : RADAR_NIGHT;
+		}
+		QCOMPARE(propagator.getVisibility(i), visibility);
+		QVERIFY(std::fabs(propagator.getPhaseAngle(i)-sunPos.angle(pos)) <= 1e-9);
+		if (visibility==VISIBLE)
+			++visibleCount;
+	}
+	// The Sun is below the horizon of the observer, some satellites are lit
+	QVERIFY(visibleCount>0);
+
+	// In daylight, the satellites above the horizon are all in the sunlit
+	const SatellitePropagator::Observer dayObserver = SatellitePropagator::computeObserver(TEST_JD, TEST_LATITUDE, TEST_LONGITUDE, TEST_ALTITUDE, -testSunPos, true);
+	propagator.propagate(dayObserver);
+	for (int i=0; i<SATELLITE_COUNT; ++i)
+		QCOMPARE(propagator.getVisibility(i), propagator.getAltAz(i)[2] > 0 ? RADAR_SUN : NOT_VISIBLE);
+}
+
+void TestSatellitePropagator::benchmarkPerObject()
+{
+	// What Satellites::update() did: each satellite computes the sidereal time and
+	// the observer again, here once for its position and once for the Sun
+	double sum = 0.;
+	QBENCHMARK {
+		foreach (gSatTEME* sat, referenceSatellites)
+		{
+			const gTime epoch(TEST_JD);
+			sat->setEpoch(epoch);
+			Vec3d observerPos, observerVel, sunObserverPos, sunObserverVel;
+			referenceObserver(epoch, observerPos, observerVel);
+			referenceObserver(epoch, sunObserverPos, sunObserverVel);
+			const Vec3d pos(sat->getPos()[0], sat->getPos()[1], sat->getPos()[2]);
+			const Vec3d sunPos = testSunPos*AU + sunObserverPos;
+			sum += (pos - observerPos).length() + sunPos.angle(pos);
+		}
+	}
+	QVERIFY(sum>0.);
+}
+
+void TestSatellitePropagator::benchmarkBatch()
+{
+	QBENCHMARK {
+		propagator.propagate(SatellitePropagator::computeObserver(TEST_JD, TEST_LATITUDE, TEST_LONGITUDE, TEST_ALTITUDE, testSunPos, false));
+	}
+}
@@ -0,0 +1,50 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _TESTSATELLITEPROPAGATOR_HPP_
+#define _TESTSATELLITEPROPAGATOR_HPP_
+
+#include <QObject>
+#include <QtTest>
+#include <QList>
+
+#include "gsatellite/gSatTEME.hpp"
+#include "SatellitePropagator.hpp"
+
+//! Compares the batch propagation of the Satellites plugin with the
+//! per-satellite computations of gSatWrapper, on a catalogue of 25000 TLEs.
+class TestSatellitePropagator : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+	void testObserver();
+	void testPropagation();
+	void benchmarkPerObject();
+	void benchmarkBatch();
+private:
+	//! Satellites propagated by the batch
+	QList<gSatTEME*> batchSatellites;
+	//! The same satellites, propagated one by one
+	QList<gSatTEME*> referenceSatellites;
+	SatellitePropagator propagator;
+};
+
+#endif // _TESTSATELLITEPROPAGATOR_HPP_
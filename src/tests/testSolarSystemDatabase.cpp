@@ -0,0 +1,164 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include <QObject>
+#include <QtDebug>
+#include <QtTest>
+#include <QDir>
+#include <QFile>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QTextStream>
+
+#include "tests/testSolarSystemDatabase.hpp"
+#include "SolarSystemDatabase.hpp"
+#include "StelFileMgr.hpp"
+#include "StelIniParser.hpp"
+
+QTEST_GUILESS_MAIN(TestSolarSystemDatabase)
+
+// Minor bodies as imported with the Solar System Editor plugin
+#define MINOR_BODY_COUNT 10000
+
+void TestSolarSystemDatabase::initTestCase()
+{
+	// The compiled copies go to the test cache directory
+	QStandardPaths::setTestModeEnabled(true);
+	QDir(StelFileMgr::getCacheDir()+"/solarsystem").removeRecursively();
+	QVERIFY(tempDir.isValid());
+	iniPath = tempDir.path()+"/ssystem.ini";
+	writeIni("0.2056");
+}
+
+void TestSolarSystemDatabase::cleanupTestCase()
+{
+	QDir(StelFileMgr::getCacheDir()+"/solarsystem").removeRecursively();
+}
+
+void TestSolarSystemDatabase::writeIni(const QString& eccentricity)
+{
+	QFile file(iniPath);
+	QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+	QTextStream out(&file);
+	out << "[sun]\nname = Sun\nparent = none\nradius = 696000\ncoord_func = sun_special\n"
+	       "color = 1., 1., 1.\nhalo = true\ntype = star\n\n";
+	for (int i=0; i<MINOR_BODY_COUNT; ++i)
+	{
+		out << "[minor" << i << "]\n"
+		    << "name = Minor " << i << "\n"
+		    << "parent = Sun\n"
+		    << "type = " << (i%10 ? "asteroid" : "comet") << "\n"
+		    << "coord_func = comet_orbit\n"
+		    << "orbit_Epoch = 2457600.5\n"
+		    << "orbit_TimeAtPericenter = " << 2457000.5+i*0.37 << "\n"
+		    << "orbit_PericenterDistance = " << 1.1+(i%300)*0.01 << "\n"
+		    << "orbit_Eccentricity = " << (i==0 ? eccentricity : QString::number(0.01+(i%90)*0.01)) << "\n"
+		    << "orbit_ArgOfPericenter = " << (i*7)%360 << "\n"
+		    << "orbit_AscendingNode = " << (i*13)%360 << "\n"
+		    << "orbit_Inclination = " << (i*3)%90 << "\n"
+		    << "absolute_magnitude = " << 10.+(i%80)*0.1 << "\n"
+		    << "slope_parameter = 0.15\n"
+		    << "albedo = 0.1\n"
+		    << "radius = " << 1+i%50 << "\n"
+		    << "color = 1., 1., 1.\n"
+		    << "lighting = true\n\n";
+	}
+	out.flush();
+	QVERIFY(out.status()==QTextStream::Ok);
+}
+
+void TestSolarSystemDatabase::compareWithQSettings()
+{
+	SolarSystemDatabase db;
+	QVERIFY(db.load(iniPath));
+	QSettings settings(iniPath, StelIniFormat);
+	QVERIFY(settings.status()==QSettings::NoError);
+	const QStringList groups = settings.childGroups();
+	QCOMPARE(db.sectionNames(), groups);
+	foreach (const QString& group, groups)
+	{
+		settings.beginGroup(group);
+		const QStringList keys = settings.childKeys();
+		const SolarSystemDatabase::Section& section = db.section(group);
+		QCOMPARE(section.values.size(), keys.size());
+		foreach (const QString& key, keys)
+			QCOMPARE(section.value(key).toString(), settings.value(key).toString());
+		settings.endGroup();
+	}
+	// Unknown sections and keys give the default values, as with QSettings
+	QCOMPARE(db.section("pluto").value("name", "none").toString(), QString("none"));
+	QCOMPARE(db.section("sun").value("albedo", 0.5).toDouble(), 0.5);
+	QVERIFY(db.section("minor1").value("lighting").toBool());
+}
+
+void TestSolarSystemDatabase::testParse()
+{
+	// No compiled copy yet: the ini file is parsed
+	compareWithQSettings();
+	QStringList compiled = QDir(StelFileMgr::getCacheDir()+"/solarsystem").entryList(QDir::Files);
+	QCOMPARE(compiled.size(), 1);
+}
+
+void TestSolarSystemDatabase::testCompiled()
+{
+	compareWithQSettings();
+}
+
+void TestSolarSystemDatabase::testModifiedSource()
+{
+	// A different size, as the modification time may not change within the test
+	writeIni("0.20563");
+	SolarSystemDatabase db;
+	QVERIFY(db.load(iniPath));
+	QCOMPARE(db.section("minor0").value("orbit_Eccentricity").toString(), QString("0.20563"));
+	compareWithQSettings();
+}
+
+void TestSolarSystemDatabase::benchmarkQSettings()
+{
+	// What SolarSystem::loadPlanets() did: read each key of each body through QSettings
+	int count = 0;
+	QBENCHMARK {
+		QSettings settings(iniPath, StelIniFormat);
+		foreach (const QString& group, settings.childGroups())
+		{
+			settings.beginGroup(group);
+			foreach (const QString& key, settings.childKeys())
+				count += settings.value(key).toString().size();
+			settings.endGroup();
+		}
+	}
+	QVERIFY(count>0);
+}
+
+void TestSolarSystemDatabase::benchmarkCompiled()
+{
+	int count = 0;
+	QBENCHMARK {
+		SolarSystemDatabase db;
+		db.load(iniPath);
+		foreach (const QString& name, db.sectionNames())
+		{
+			const SolarSystemDatabase::Section& section = db.section(name);
+			for (QHash<QString, QString>::const_iterator it=section.values.constBegin(); it!=section.values.constEnd(); ++it)
+				count += section.value(it.key()).toString().size();
+		}
+	}
+	QVERIFY(count>0);
+}
@@ -0,0 +1,49 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _TESTSOLARSYSTEMDATABASE_HPP_
+#define _TESTSOLARSYSTEMDATABASE_HPP_
+
+#include <QObject>
+#include <QtTest>
+#include <QTemporaryDir>
+
+//! Compares SolarSystemDatabase with QSettings on a large generated ssystem.ini,
+//! and measures the load of the compiled copy against the parse of the ini file.
+class TestSolarSystemDatabase : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+	void testParse();
+	void testCompiled();
+	void testModifiedSource();
+	void benchmarkQSettings();
+	void benchmarkCompiled();
+private:
+	//! Write the generated file, with the given eccentricity for the first minor body.
+	void writeIni(const QString& eccentricity);
+	//! Compare the contents of the database with those read by QSettings.
+	void compareWithQSettings();
+	QTemporaryDir tempDir;
+	QString iniPath;
+};
+
+#endif // _TESTSOLARSYSTEMDATABASE_HPP_
@@ -0,0 +1,143 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include "tests/testStelGeodesicGrid.hpp"
+
+#include <QObject>
+#include <QDebug>
+#include <QTest>
+
+#include "StelGeodesicGrid.hpp"
+#include "StelUtils.hpp"
+
+#include <algorithm>
+
+QTEST_GUILESS_MAIN(TestStelGeodesicGrid)
+
+// A region of the size of a typical field of view around the direction (ra, dec) in degree
+static QVector<SphericalCap> fieldOfView(double ra, double dec)
+{
+	Vec3d v;
+	StelUtils::spheToRect(ra*M_PI/180., dec*M_PI/180., v);
+	QVector<SphericalCap> region;
+	region << SphericalCap(v, std::cos(30.*M_PI/180.));
+	return region;
+}
+
+struct CollectZones
+{
+	void operator()(int zone) {zones << zone;}
+	QList<int> zones;
+};
+
+void TestStelGeodesicGrid::testExtend()
+{
+	StelGeodesicGrid extended(2);
+	extended.extend(5);
+	QCOMPARE(extended.getMaxLevel(), 5);
+	StelGeodesicGrid grid(5);
+	for (int lev=0;lev<=5;lev++)
+	{
+		for (int i=0;i<StelGeodesicGrid::nrOfZones(lev);i+=7)
+		{
+			Vec3f a0, a1, a2, b0, b1, b2;
+			extended.getTriangleCorners(lev, i, a0, a1, a2);
+			grid.getTriangleCorners(lev, i, b0, b1, b2);
+			QVERIFY(a0==b0 && a1==b1 && a2==b2);
+		}
+	}
+	const Vec3f v = Vec3f(0.3f, -0.5f, 0.8f);
+	Vec3f n = v;
+	n.normalize();
+	QCOMPARE(extended.getZoneNumberForPoint(n, 5), grid.getZoneNumberForPoint(n, 5));
+}
+
+void TestStelGeodesicGrid::testSearchCache()
+{
+	StelGeodesicGrid grid(4);
+	const GeodesicSearchResult* stars = grid.search(fieldOfView(10., 20.), 4);
+	const GeodesicSearchResult* picking = grid.search(fieldOfView(200., -40.), 4);
+	QVERIFY(stars!=picking);
+	// Both regions are searched in every frame
+	QVERIFY(grid.search(fieldOfView(10., 20.), 4)==stars);
+	QVERIFY(grid.search(fieldOfView(200., -40.), 4)==picking);
+	// The least recently used results are replaced
+	QVector<const GeodesicSearchResult*> results;
+	for (int i=0;i<StelGeodesicGrid::searchCacheSize;i++)
+		results << grid.search(fieldOfView(30.*i, 0.), 4);
+	for (int i=0;i<StelGeodesicGrid::searchCacheSize;i++)
+		QVERIFY(grid.search(fieldOfView(30.*i, 0.), 4)==results.at(i));
+}
+
+void TestStelGeodesicGrid::testZoneBits()
+{
+	StelGeodesicGrid grid(5);
+	const GeodesicSearchResult* result = grid.search(fieldOfView(120., 60.), 4);
+	for (int lev=0;lev<=5;lev++)
+	{
+		QList<int> inside, border;
+		int zone;
+		for (GeodesicSearchInsideIterator it(*result, lev);(zone = it.next()) >= 0;)
+			inside << zone;
+		for (GeodesicSearchBorderIterator it(*result, lev);(zone = it.next()) >= 0;)
+			border << zone;
+		std::sort(inside.begin(), inside.end());
+		std::sort(border.begin(), border.end());
+
+		const GeodesicZoneBits& insideBits = result->getInsideZones(lev);
+		CollectZones insideZones;
+		insideBits.visit(insideZones);
+		QCOMPARE(insideZones.zones, inside);
+		QCOMPARE(insideBits.count(), inside.size());
+
+		// Visiting ranges of words gives the same zones, in the same order
+		const GeodesicZoneBits& borderBits = result->getBorderZones(lev);
+		CollectZones borderZones;
+		const int half = borderBits.getNrOfWords()/2;
+		borderBits.visit(borderZones, 0, half);
+		borderBits.visit(borderZones, half);
+		QCOMPARE(borderZones.zones, border);
+		foreach (int z, border)
+			QVERIFY(borderBits.contains(z) && !insideBits.contains(z));
+	}
+}
+
+void TestStelGeodesicGrid::benchmarkSearch_data()
+{
+	QTest::addColumn<int>("level");
+	QTest::newRow("7") << 7;
+	QTest::newRow("8") << 8;
+	QTest::newRow("9") << 9;
+	QTest::newRow("10") << 10;
+}
+
+void TestStelGeodesicGrid::benchmarkSearch()
+{
+	QFETCH(int, level);
+	StelGeodesicGrid grid(level);
+	// One more region than the cache holds, so that each search is computed
+	QVector<QVector<SphericalCap> > regions;
+	for (int i=0;i<=StelGeodesicGrid::searchCacheSize;i++)
+		regions << fieldOfView(72.*i, 15.*i-30.);
+	int i = 0;
+	QBENCHMARK
+	{
+		grid.search(regions.at(i++%regions.size()), level);
+	}
+}
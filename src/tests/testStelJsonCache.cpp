@@ -0,0 +1,237 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include <QObject>
+#include <QtDebug>
+#include <QtTest>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QStandardPaths>
+
+#include <stdexcept>
+
+#include "tests/testStelJsonCache.hpp"
+#include "StelCompiledCache.hpp"
+#include "StelFileMgr.hpp"
+#include "StelJsonCache.hpp"
+#include "StelJsonParser.hpp"
+
+QTEST_GUILESS_MAIN(TestStelJsonCache)
+
+static const QByteArray catalog(
+	"{\n"
+	"\t\"version\": \"1.0\",\n"
+	"\t\"shortName\": \"Test catalogue\",\n"
+	"\t\"count\": 2,\n"
+	"\t\"objects\": {\n"
+	"\t\t\"QSO J0001\": {\"RA\": \"0h0m1.5s\", \"DE\": \"+12d30m0s\", \"mag\": 17.25},\n"
+	"\t\t\"QSO J0002\": {\"RA\": \"0h0m2.5s\", \"DE\": \"-45d0m0s\", \"mag\": 18.5, \"names\": [\"a\", \"b\"]}\n"
+	"\t}\n"
+	"}\n");
+
+QString TestStelJsonCache::writeJson(const QString& name, const QByteArray& json)
+{
+	const QString path = tempDir.path() + "/" + name;
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly) || file.write(json)!=json.size())
+		return QString();
+	file.close();
+	return path;
+}
+
+QString TestStelJsonCache::compiledPath(const QString& filePath)
+{
+	StelCompiledCache cache(filePath, "json", StelJsonCache::compiledMagic, StelJsonCache::compiledVersion, StelCompiledCache::CheckContentHash);
+	return cache.getCachePath();
+}
+
+bool TestStelJsonCache::isCompiledCopyUpToDate(const QString& filePath)
+{
+	QFile file(filePath);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+	StelCompiledCache cache(filePath, "json", StelJsonCache::compiledMagic, StelJsonCache::compiledVersion, StelCompiledCache::CheckContentHash);
+	cache.setSourceData(file.readAll());
+	QDataStream* in = cache.beginRead();
+	if (!in)
+		return false;
+	QVariantMap members;
+	StelJsonCache::readMembers(*in, QStringList(), members);
+	return cache.endRead();
+}
+
+void TestStelJsonCache::writeCompiledCopy(const QString& filePath, const QVariantMap& members)
+{
+	QFile file(filePath);
+	QVERIFY(file.open(QIODevice::ReadOnly));
+	StelCompiledCache cache(filePath, "json", StelJsonCache::compiledMagic, StelJsonCache::compiledVersion, StelCompiledCache::CheckContentHash);
+	cache.setSourceData(file.readAll());
+	QDataStream* out = cache.beginWrite();
+	QVERIFY(out!=NULL);
+	StelJsonCache::writeMembers(*out, members);
+	cache.endWrite();
+}
+
+void TestStelJsonCache::initTestCase()
+{
+	QStandardPaths::setTestModeEnabled(true);
+	QDir(StelFileMgr::getCacheDir()+"/json").removeRecursively();
+	QVERIFY(tempDir.isValid());
+}
+
+void TestStelJsonCache::cleanupTestCase()
+{
+	QDir(StelFileMgr::getCacheDir()+"/json").removeRecursively();
+}
+
+void TestStelJsonCache::testCompiledCopy()
+{
+	const QString path = writeJson("compiled.json", catalog);
+	QVERIFY(!path.isEmpty());
+	QVERIFY(!QFile::exists(compiledPath(path)));
+
+	// The first load parses the JSON file and writes its compiled copy
+	const QVariantMap expected = StelJsonParser::parse(catalog).toMap();
+	const QVariantMap parsed = StelJsonCache::load(path);
+	QCOMPARE(parsed, expected);
+	QVERIFY(QFile::exists(compiledPath(path)));
+	QVERIFY(isCompiledCopyUpToDate(path));
+
+	// The next one reads the compiled copy, with the same result
+	const QVariantMap compiled = StelJsonCache::load(path);
+	QCOMPARE(compiled, expected);
+	QCOMPARE(compiled.value("objects").toMap().value("QSO J0002").toMap().value("names").toList().size(), 2);
+	QCOMPARE(compiled.value("objects").toMap().value("QSO J0001").toMap().value("mag").toDouble(), 17.25);
+
+	// It really is the compiled copy which is read: a different one for the same source is returned as is
+	QVariantMap forged = expected;
+	forged.insert("version", "compiled");
+	writeCompiledCopy(path, forged);
+	QCOMPARE(StelJsonCache::load(path).value("version").toString(), QString("compiled"));
+}
+
+void TestStelJsonCache::testModifiedSameSize()
+{
+	const QString path = writeJson("modified.json", catalog);
+	QVERIFY(!path.isEmpty());
+	QCOMPARE(StelJsonCache::load(path).value("version").toString(), QString("1.0"));
+	QVERIFY(isCompiledCopyUpToDate(path));
+
+	// A download replaces the catalogue by another one of the same size, possibly within the same second
+	QByteArray modified = catalog;
+	modified.replace("\"1.0\"", "\"2.0\"");
+	modified.replace("17.25", "16.75");
+	QCOMPARE(modified.size(), catalog.size());
+	QCOMPARE(writeJson("modified.json", modified), path);
+	QVERIFY(!isCompiledCopyUpToDate(path));
+
+	const QVariantMap reloaded = StelJsonCache::load(path);
+	QCOMPARE(reloaded, StelJsonParser::parse(modified).toMap());
+	QCOMPARE(reloaded.value("version").toString(), QString("2.0"));
+	QCOMPARE(reloaded.value("objects").toMap().value("QSO J0001").toMap().value("mag").toDouble(), 16.75);
+	// The compiled copy was written again for the new contents
+	QVERIFY(isCompiledCopyUpToDate(path));
+	QCOMPARE(StelJsonCache::load(path), reloaded);
+}
+
+void TestStelJsonCache::testTruncatedCompiledCopy()
+{
+	const QString path = writeJson("truncated.json", catalog);
+	QVERIFY(!path.isEmpty());
+	const QVariantMap expected = StelJsonCache::load(path);
+	const QString compiled = compiledPath(path);
+	const qint64 compiledSize = QFileInfo(compiled).size();
+	QVERIFY(compiledSize>16);
+
+	// Truncated in its last record: the compiled copy is reported as damaged, the JSON file is parsed
+	QVERIFY(QFile::resize(compiled, compiledSize-8));
+	QTest::ignoreMessage(QtWarningMsg, QRegularExpression("^Compiled file .* is damaged"));
+	QCOMPARE(StelJsonCache::load(path), expected);
+	// and the compiled copy is written again
+	QCOMPARE(QFileInfo(compiled).size(), compiledSize);
+	QVERIFY(isCompiledCopyUpToDate(path));
+
+	// Truncated in its header: it does not match the JSON file
+	QVERIFY(QFile::resize(compiled, 10));
+	QVERIFY(!isCompiledCopyUpToDate(path));
+	QCOMPARE(StelJsonCache::load(path), expected);
+	QVERIFY(isCompiledCopyUpToDate(path));
+
+	// Empty
+	QVERIFY(QFile::resize(compiled, 0));
+	QCOMPARE(StelJsonCache::load(path), expected);
+	QVERIFY(isCompiledCopyUpToDate(path));
+}
+
+void TestStelJsonCache::testKeys()
+{
+	const QString path = writeJson("keys.json", catalog);
+	QVERIFY(!path.isEmpty());
+	const QVariantMap all = StelJsonParser::parse(catalog).toMap();
+
+	// From the JSON file, then from the compiled copy
+	for (int pass=0; pass<2; ++pass)
+	{
+		QCOMPARE(isCompiledCopyUpToDate(path), pass>0);
+
+		const QVariantMap version = StelJsonCache::load(path, QStringList() << "version");
+		QCOMPARE(QStringList(version.keys()), QStringList() << "version");
+		QCOMPARE(version.value("version").toString(), QString("1.0"));
+
+		// The missing members are left out
+		const QVariantMap some = StelJsonCache::load(path, QStringList() << "objects" << "count" << "missing");
+		QCOMPARE(QStringList(some.keys()), QStringList() << "count" << "objects");
+		QCOMPARE(some.value("objects"), all.value("objects"));
+		QCOMPARE(some.value("count").toInt(), 2);
+
+		QVERIFY(StelJsonCache::load(path, QStringList() << "missing").isEmpty());
+		QCOMPARE(StelJsonCache::load(path, QStringList()), all);
+	}
+}
+
+void TestStelJsonCache::testErrors()
+{
+	bool thrown = false;
+	try
+	{
+		StelJsonCache::load(tempDir.path() + "/missing.json");
+	}
+	catch (std::runtime_error&)
+	{
+		thrown = true;
+	}
+	QVERIFY(thrown);
+
+	// Invalid JSON has no compiled copy
+	const QString path = writeJson("invalid.json", "{\"version\": \"1.0\", \"objects\": {");
+	QVERIFY(!path.isEmpty());
+	thrown = false;
+	try
+	{
+		StelJsonCache::load(path);
+	}
+	catch (std::runtime_error&)
+	{
+		thrown = true;
+	}
+	QVERIFY(thrown);
+	QVERIFY(!QFile::exists(compiledPath(path)));
+}
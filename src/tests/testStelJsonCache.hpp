@@ -0,0 +1,52 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _TESTSTELJSONCACHE_HPP_
+#define _TESTSTELJSONCACHE_HPP_
+
+#include <QObject>
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QVariantMap>
+
+//! Loads JSON files through StelJsonCache, and checks when their compiled copies are used.
+class TestStelJsonCache : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+	void testCompiledCopy();
+	void testModifiedSameSize();
+	void testTruncatedCompiledCopy();
+	void testKeys();
+	void testErrors();
+private:
+	//! Write a JSON file in the temporary directory.
+	QString writeJson(const QString& name, const QByteArray& json);
+	//! Whether the compiled copy of a JSON file matches its contents.
+	static bool isCompiledCopyUpToDate(const QString& filePath);
+	//! Replace the compiled copy of a JSON file by the given members.
+	static void writeCompiledCopy(const QString& filePath, const QVariantMap& members);
+	//! Path of the compiled copy of a JSON file.
+	static QString compiledPath(const QString& filePath);
+	QTemporaryDir tempDir;
+};
+
+#endif // _TESTSTELJSONCACHE_HPP_
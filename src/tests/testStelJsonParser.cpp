@@ -23,6 +23,7 @@
 #include <QDebug>
 #include <QTest>
 #include <QBuffer>
+#include <QStringList>
 #include <stdexcept>
 
 #include "StelJsonParser.hpp"
@@ -30,6 +31,33 @@
 
 QTEST_GUILESS_MAIN(TestStelJsonParser);
 
+// Records the events as text
+class EventRecorder : public StelJsonHandler
+{
+public:
+	QStringList events;
+	virtual void beginObject() {events << "{";}
+	virtual void key(const QString& name) {events << name+":";}
+	virtual void endObject() {events << "}";}
+	virtual void beginArray() {events << "[";}
+	virtual void endArray() {events << "]";}
+	virtual void value(const QVariant& v) {events << v.toString();}
+};
+
+// Counts the events, to time the parser alone
+class EventCounter : public StelJsonHandler
+{
+public:
+	EventCounter() : count(0) {}
+	int count;
+	virtual void beginObject() {++count;}
+	virtual void key(const QString&) {++count;}
+	virtual void endObject() {++count;}
+	virtual void beginArray() {++count;}
+	virtual void endArray() {++count;}
+	virtual void value(const QVariant&) {++count;}
+};
+
 void TestStelJsonParser::initTestCase()
 {
 	largeJsonBuff = "{\"test1\": {\"worldCoords\": [[[-0.5,0.5],[0.5,0.5],[0.5,-0.5],[-0.5,-0.5]], [[-0.2,-0.2],[0.2,-0.2],[0.2,0.2],[-0.2,0.2]]]}, \
@@ -46,6 +74,20 @@ void TestStelJsonParser::initTestCase()
  \"test12\": {\"worldCoords\": [[[-0.5,0.5],[0.5,0.5],[0.5,-0.5],[-0.5,-0.5]], [[-0.2,-0.2],[0.2,-0.2],[0.2,0.2],[-0.2,0.2]]]}}";
 
 	listJsonBuff = "[{\"project\":\"GOODS\",\"license\":\"ESO Data License : http://www.myLicenseToBeDefinedAtSomePoint.html\",\"copyright\":\"(c) GOODS Sep 10 2007 12:00AM\",\"creator\":\"C. Cesarsky\",\"dataType\":\"image\",\"characterization\":{\"spatialAxis\":{\"footprint\":{\"worldCoords\":[[[53.111991,-27.725812],[53.164780,-27.725812],[53.164780,-27.772234],[53.111991,-27.772234]]]},\"boundingBox\":[[53.111991,-27.725812],[53.164780,-27.725812],[53.164780,-27.772234],[53.111991,-27.772234]],\"centralPos\":[53.138382,-27.749026]},\"temporalAxis\":{\"boundingBox\":[52220.243068,52263.181794],\"integratedCoverage\":0.208333,\"centralPos\":52241.712431,\"coverage\":[52220.243068,52263.181794]}},\"publisher\":\"ESO SAF\",\"collection\":\"168.A-0485(A\",\"targetSource\":{\"names\":[\"GOODS_09\"]},\"ESO\":{\"NGASFileId\":\"GOODS_ISAAC_09_H_V2.0\",\"metadataType\":\"DataProduct\",\"processingType\":\"HighlyProcessed\"},\"acquisitionSetup\":{\"filter\":\"H\",\"instrument\":\"ISAAC\",\"facility\":\"ESO-Paranal\",\"telescope\":\"ESO-VLT-U1\",\"mode\":\"Short Wavelength\"},\"title\":\"GOODS_ISAAC_09_H_v2.0\",\"id\":\"GOODS_ISAAC_09_H_V2.0\"},{\"project\":\"GOODS\",\"license\":\"ESO Data License : http://www.myLicenseToBeDefinedAtSomePoint.html\",\"copyright\":\"(c) GOODS Sep 10 2007 12:00AM\",\"creator\":\"C. Cesarsky\",\"dataType\":\"image\",\"characterization\":{\"spatialAxis\":{\"footprint\":{\"worldCoords\":[[[53.121222,-27.641601],[53.174252,-27.641601],[53.174252,-27.687943],[53.121222,-27.687943]]]},\"boundingBox\":[[53.121222,-27.641601],[53.174252,-27.641601],[53.174252,-27.687943],[53.121222,-27.687943]],\"centralPos\":[53.147732,-27.664775]},\"temporalAxis\":{\"boundingBox\":[53729.079417,53747.174968],\"integratedCoverage\":0.122222,\"centralPos\":53738.127193,\"coverage\":[53729.079417,53747.174968]}},\"publisher\":\"ESO SAF\",\"collection\":\"168.A-0485(G)\",\"targetSource\":{\"names\":[\"GOODS_01\"]},\"ESO\":{\"NGASFileId\":\"GOODS_ISAAC_01_J_V2.0\",\"metadataType\":\"DataProduct\",\"processingType\":\"HighlyProcessed\"},\"acquisitionSetup\":{\"filter\":\"J\",\"instrument\":\"ISAAC\",\"facility\":\"ESO-Paranal\",\"telescope\":\"ESO-VLT-U1\",\"mode\":\"Short Wavelength\"},\"title\":\"GOODS_ISAAC_01_J_v2.0\",\"id\":\"GOODS_ISAAC_01_J_V2.0\"},{\"project\":\"GOODS\",\"license\":\"ESO Data License : http://www.myLicenseToBeDefinedAtSomePoint.html\",\"copyright\":\"(c) GOODS Sep 10 2007 12:00AM\",\"creator\":\"C. Cesarsky\",\"dataType\":\"image\",\"characterization\":{\"spatialAxis\":{\"footprint\":{\"worldCoords\":[[[53.121081,-27.641392],[53.174488,-27.641392],[53.174488,-27.688027],[53.121081,-27.688027]]]},\"boundingBox\":[[53.121081,-27.641392],[53.174488,-27.641392],[53.174488,-27.688027],[53.121081,-27.688027]],\"centralPos\":[53.147779,-27.664712]},\"temporalAxis\":{\"boundingBox\":[53729.179656,53749.175133],\"integratedCoverage\":0.207292,\"centralPos\":53739.177395,\"coverage\":[53729.179656,53749.175133]}},\"publisher\":\"ESO SAF\",\"collection\":\"168.A-0485(G)\",\"targetSource\":{\"names\":[\"GOODS_01\"]},\"ESO\":{\"NGASFileId\":\"GOODS_ISAAC_01_KS_V2.0\",\"metadataType\":\"DataProduct\",\"processingType\":\"HighlyProcessed\"},\"acquisitionSetup\":{\"filter\":\"Ks\",\"instrument\":\"ISAAC\",\"facility\":\"ESO-Paranal\",\"telescope\":\"ESO-VLT-U1\",\"mode\":\"Short Wavelength\"},\"title\":\"GOODS_ISAAC_01_Ks_v2.0\",\"id\":\"GOODS_ISAAC_01_KS_V2.0\"}]";
+
+	// Like the catalogue of the Quasars plugin
+	catalogJsonBuff = "{\n\t\"version\": \"0.2.1\",\n\t\"shortName\": \"A catalogue of quasars\",\n\t\"quasars\":\n\t{\n";
+	for (int i=0; i<50000; ++i)
+	{
+		if (i>0)
+			catalogJsonBuff += ",\n";
+		catalogJsonBuff += QString("\t\t\"Q %1+%2\":\n\t\t{\n\t\t\t\"RA\": \"%3h%4m%5s\",\n\t\t\t\"DE\": \"+%6d%7m%8s\",\n"
+					   "\t\t\t\"Vmag\": %9,\n\t\t\t\"Amag\": %10,\n\t\t\t\"bV\": %11,\n\t\t\t\"z\": %12,\n\t\t\t\"f6\": %13\n\t\t}")
+				.arg(i).arg(i%90).arg(i%24).arg(i%60).arg(0.37*(i%160), 0, 'f', 2).arg(i%90).arg(i%60).arg(0.61*(i%98), 0, 'f', 1)
+				.arg(12.+0.0001*i, 0, 'f', 2).arg(-20.-0.00007*i, 0, 'f', 1).arg(0.001*(i%700)-0.2, 0, 'f', 3)
+				.arg(0.00013*i, 0, 'f', 6).arg(i%3 ? 0.000314*i : 0.).toUtf8();
+	}
+	catalogJsonBuff += "\n\t}\n}\n";
 }
 
 void TestStelJsonParser::testBase()
@@ -142,3 +184,107 @@ void TestStelJsonParser::benchmarkParse()
 		result = StelJsonParser::parse(&buf);
 	}
 }
+
+void TestStelJsonParser::testHandler()
+{
+	EventRecorder recorder;
+	StelJsonParser::parse(QByteArray("{\"a\": [1, \"b\", {}], \"c\": {\"d\": true}, \"e\": []}"), recorder);
+	QCOMPARE(recorder.events.join(" "), QString("{ a: [ 1 b { } ] c: { d: true } e: [ ] }"));
+
+	// Same events from a device
+	QByteArray data("// comment\n[0.5, -2, null]");
+	QBuffer buf(&data);
+	buf.open(QIODevice::ReadOnly);
+	recorder.events.clear();
+	StelJsonParser::parse(&buf, recorder);
+	QCOMPARE(recorder.events.join(" "), QString("[ 0.5 -2  ]"));
+	buf.close();
+
+	// The tree is built from the same events
+	QVariantMap map = StelJsonParser::parse("{\"a\": [1, \"b\", {}], \"c\": {\"d\": true}}").toMap();
+	QCOMPARE(map.size(), 2);
+	QCOMPARE(map.value("a").toList().size(), 3);
+	QCOMPARE(map.value("a").toList().at(1).toString(), QString("b"));
+	QVERIFY(map.value("a").toList().at(2).toMap().isEmpty());
+	QVERIFY(map.value("c").toMap().value("d").toBool());
+}
+
+void TestStelJsonParser::testNumbers()
+{
+	// The fast conversions must give the same values as QByteArray
+	static const char* const numbers[] = {"0", "-0", "7", "-12356", "123456789", "1234567890", "-2147483648",
+					      "0.000280", "0.5", "-0.2", "53.111991", "52263.181794", "1.5e3", "-2.5E-7",
+					      "1e22", "1e23", "1e-22", "1e-23", "123456789012345.6", "0.1234567890123456789",
+					      "3.14159265358979", "-27.725812", "1.7976931348623157e308", "4.9e-324"};
+	for (unsigned int i=0; i<sizeof(numbers)/sizeof(numbers[0]); ++i)
+	{
+		const QByteArray str(numbers[i]);
+		const QVariant v = StelJsonParser::parse(QByteArray("[")+str+"]").toList().at(0);
+		bool ok;
+		const int intValue = str.toInt(&ok);
+		if (ok)
+		{
+			QVERIFY2(v.type()==QVariant::Int, numbers[i]);
+			QCOMPARE(v.toInt(), intValue);
+		}
+		else
+		{
+			QVERIFY2(v.type()==QVariant::Double, numbers[i]);
+			// Exactly the same double
+			QVERIFY2(v.toDouble()==str.toDouble(), numbers[i]);
+		}
+	}
+}
+
+void TestStelJsonParser::testStrings()
+{
+	QVariantMap map = StelJsonParser::parse("{\"a\\\"b\": \"line\\nnext\\ttab\", \"\xc3\xa9toile\": \"\"}").toMap();
+	QCOMPARE(map.value("a\"b").toString(), QString("line\nnext\ttab"));
+	QVERIFY(map.contains(QString::fromUtf8("\xc3\xa9toile")));
+	QVERIFY(map.value(QString::fromUtf8("\xc3\xa9toile")).toString().isEmpty());
+
+	// Strings over several blocks of a device
+	const QString longString = QString::fromUtf8("\xc3\xa9toile ").repeated(20000);
+	QByteArray data = "[\"" + longString.toUtf8() + "\", \"" + longString.toUtf8() + "\\n\", 1234.5678]";
+	QBuffer buf(&data);
+	buf.open(QIODevice::ReadOnly);
+	const QVariantList list = StelJsonParser::parse(&buf).toList();
+	buf.close();
+	QCOMPARE(list.size(), 3);
+	QCOMPARE(list.at(0).toString(), longString);
+	QCOMPARE(list.at(1).toString(), longString+"\n");
+	QCOMPARE(list.at(2).toDouble(), 1234.5678);
+}
+
+void TestStelJsonParser::benchmarkParseCatalog()
+{
+	QVariant result;
+	QBENCHMARK {
+		result = StelJsonParser::parse(catalogJsonBuff);
+	}
+	QCOMPARE(result.toMap().value("quasars").toMap().size(), 50000);
+}
+
+void TestStelJsonParser::benchmarkParseCatalogDevice()
+{
+	QBuffer buf(&catalogJsonBuff);
+	buf.open(QIODevice::ReadOnly);
+	QVariant result;
+	QBENCHMARK {
+		buf.seek(0);
+		result = StelJsonParser::parse(&buf);
+	}
+	buf.close();
+	QCOMPARE(result.toMap().value("quasars").toMap().size(), 50000);
+}
+
+void TestStelJsonParser::benchmarkParseCatalogHandler()
+{
+	EventCounter counter;
+	QBENCHMARK {
+		counter.count = 0;
+		StelJsonParser::parse(catalogJsonBuff, counter);
+	}
+	// The top-level object with 3 members, the quasars object, then each quasar with 7 members
+	QCOMPARE(counter.count, 2+3+2+2+50000*(3+7*2));
+}
@@ -32,9 +32,17 @@ private slots:
 	void testIterator();
 	void benchmarkParse();
 	void testErrors();
+	void testHandler();
+	void testNumbers();
+	void testStrings();
+	void benchmarkParseCatalog();
+	void benchmarkParseCatalogDevice();
+	void benchmarkParseCatalogHandler();
 private:
 	QByteArray largeJsonBuff;
 	QByteArray listJsonBuff;
+	//! A few megabytes, with the structure of the catalogues of the plugins.
+	QByteArray catalogJsonBuff;
 };
 
 #endif // _TESTSTELJSONPARSER_HPP_
@@ -0,0 +1,62 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include <QObject>
+#include <QtDebug>
+#include <QtTest>
+
+#include "tests/testStelLineBatch.hpp"
+#include "StelLineBatch.hpp"
+
+QTEST_GUILESS_MAIN(TestStelLineBatch)
+
+void TestStelLineBatch::testStrips()
+{
+	StelLineBatch batch;
+	QVERIFY(!batch.isActive());
+	batch.begin();
+	QVERIFY(batch.isActive());
+
+	const Vec4f red(1.f, 0.f, 0.f, 1.f);
+	QVector<Vec2f> strip;
+	strip << Vec2f(0.f, 0.f) << Vec2f(1.f, 0.f) << Vec2f(1.f, 1.f);
+	batch.addStrip(strip, QVector<Vec4f>(), red);
+	QVector<Vec4f> colors;
+	colors << Vec4f(0.f, 1.f, 0.f, 1.f) << Vec4f(0.f, 0.f, 1.f, 1.f);
+	batch.addStrip(strip.mid(1), colors, red);
+	batch.end();
+	QVERIFY(!batch.isActive());
+
+	// 2 segments of the first strip, 1 of the second, not joined
+	QCOMPARE(batch.getVertices().size(), 6);
+	QCOMPARE(batch.getColors().size(), 6);
+	QVERIFY(batch.getVertices().at(0)==strip.at(0));
+	QVERIFY(batch.getVertices().at(1)==strip.at(1));
+	QVERIFY(batch.getVertices().at(2)==strip.at(1));
+	QVERIFY(batch.getVertices().at(3)==strip.at(2));
+	QVERIFY(batch.getVertices().at(4)==strip.at(1));
+	QVERIFY(batch.getVertices().at(5)==strip.at(2));
+	for (int i=0; i<4; ++i)
+		QVERIFY(batch.getColors().at(i)==red);
+	QVERIFY(batch.getColors().at(4)==colors.at(0));
+	QVERIFY(batch.getColors().at(5)==colors.at(1));
+
+	batch.clear();
+	QVERIFY(batch.isEmpty());
+}
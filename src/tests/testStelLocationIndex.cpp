@@ -0,0 +1,273 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include <QObject>
+#include <QtDebug>
+#include <QtTest>
+#include <QDir>
+#include <QFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QtConcurrent>
+
+#include "tests/testStelLocationIndex.hpp"
+#include "StelCompiledCache.hpp"
+#include "StelFileMgr.hpp"
+
+QTEST_GUILESS_MAIN(TestStelLocationIndex)
+
+// Same order of magnitude as a GeoNames import
+#define LOCATION_COUNT 200000
+#define TEST_MAGIC 0x54455354
+
+static double randomValue(double min, double max)
+{
+	return min + (max-min)*qrand()/RAND_MAX;
+}
+
+void TestStelLocationIndex::addLocation(const QString& line)
+{
+	const StelLocation loc = StelLocation::createFromLine(line);
+	locations.insert(loc.getID(), loc);
+}
+
+void TestStelLocationIndex::initTestCase()
+{
+	QStandardPaths::setTestModeEnabled(true);
+	QDir(StelFileMgr::getCacheDir()+"/testlocations").removeRecursively();
+	QVERIFY(tempDir.isValid());
+
+	// Name, state, country, role, population (thousands), latitude, longitude, altitude, Bortle index, time zone, planet
+	addLocation("Paris\tIle-de-France\tFrance\tC\t2200\t48.853N\t2.349E\t35\t9\t\tEarth");
+	addLocation("Lyon\tRhone-Alpes\tFrance\tR\t500\t45.764N\t4.835E\t170\t8\t\tEarth");
+	addLocation("Parakou\tBorgou\tBenin\tR\t250\t9.337N\t2.630E\t350\t6\t\tEarth");
+	addLocation("São Paulo\tSão Paulo\tBrazil\tR\t12300\t23.550S\t46.633W\t760\t9\t\tEarth");
+	addLocation("Suva\tCentral\tFiji\tC\t90\t18.141S\t178.442E\t10\t6\t\tEarth");
+	addLocation("Taveuni\tNorthern\tFiji\tN\t9\t16.850S\t179.970W\t10\t3\t\tEarth");
+	addLocation("McMurdo Station\t\tAntarctica\tO\t1\t77.846S\t166.676E\t10\t1\t\tEarth");
+	addLocation("Olympus Mons\t\t\tX\t0\t18.650N\t133.800W\t21000\t1\t\tMars");
+	const int namedCount = locations.size();
+
+	qsrand(1);
+	for (int i=0; i<LOCATION_COUNT; ++i)
+	{
+		// Spread over the whole sphere, with more sites at the middle latitudes
+		const double latitude = std::asin(randomValue(-1., 1.))*180./M_PI;
+		const double longitude = randomValue(-180., 180.);
+		addLocation(QString("Site %1\t\tCountry %2\tN\t%3\t%4%5\t%6%7\t%8\t4\t\tEarth")
+			    .arg(i).arg(i%200).arg(randomValue(0., 100.), 0, 'f', 3)
+			    .arg(std::fabs(latitude), 0, 'f', 4).arg(latitude<0 ? 'S' : 'N')
+			    .arg(std::fabs(longitude), 0, 'f', 4).arg(longitude<0 ? 'W' : 'E')
+			    .arg(i%3000));
+	}
+	QCOMPARE(locations.size(), namedCount+LOCATION_COUNT);
+	QCOMPARE(locations.value("São Paulo, Brazil").longitude, -46.633f);
+	index.build(locations);
+}
+
+void TestStelLocationIndex::cleanupTestCase()
+{
+	QDir(StelFileMgr::getCacheDir()+"/testlocations").removeRecursively();
+}
+
+void TestStelLocationIndex::testNearby()
+{
+	const float centers[][2] = {{2.349f, 48.853f}, {179.5f, -17.5f}, {-179.9f, 10.f}, {0.f, 89.5f}, {166.f, -80.f}, {-46.f, -23.f}, {100.f, 0.f}};
+	const float radii[] = {0.f, 0.5f, 3.f, 12.f, 45.f, 100.f, 180.f};
+	for (unsigned int c=0; c<sizeof(centers)/sizeof(centers[0]); ++c)
+	{
+		for (unsigned int r=0; r<sizeof(radii)/sizeof(radii[0]); ++r)
+		{
+			const float longitude = centers[c][0], latitude = centers[c][1], radius = radii[r];
+			// What StelLocationMgr::pickLocationsNearby() did
+			QSet<QString> expected;
+			for (QMap<QString, StelLocation>::const_iterator it=locations.constBegin(); it!=locations.constEnd(); ++it)
+			{
+				if (it->planetName=="Earth" && StelLocation::distanceDegrees(longitude, latitude, it->longitude, it->latitude)<=radius)
+					expected.insert(it.key());
+			}
+			QSet<QString> found;
+			typedef QPair<float, QString> DistanceID;
+			foreach (const DistanceID& loc, index.findNearby("Earth", longitude, latitude, radius))
+			{
+				const StelLocation& l = locations.value(loc.second);
+				QCOMPARE(loc.first, StelLocation::distanceDegrees(longitude, latitude, l.longitude, l.latitude));
+				found.insert(loc.second);
+			}
+			QVERIFY2(found==expected, qPrintable(QString("center %1 %2 radius %3: %4 found, %5 expected")
+							     .arg(longitude).arg(latitude).arg(radius).arg(found.size()).arg(expected.size())));
+		}
+	}
+	// The sites across the antimeridian
+	QSet<QString> fiji;
+	typedef QPair<float, QString> DistanceID;
+	foreach (const DistanceID& loc, index.findNearby("Earth", 179.5f, -17.5f, 3.f))
+		fiji.insert(loc.second);
+	QVERIFY(fiji.contains("Suva, Fiji"));
+	QVERIFY(fiji.contains("Taveuni, Fiji"));
+	QCOMPARE(index.findNearby("Mars", -133.8f, 18.65f, 1.f).size(), 1);
+	QVERIFY(index.findNearby("Moon", 0.f, 0.f, 180.f).isEmpty());
+}
+
+void TestStelLocationIndex::testNearest()
+{
+	qsrand(2);
+	for (int i=0; i<50; ++i)
+	{
+		const float latitude = randomValue(-90., 90.);
+		const float longitude = randomValue(-180., 180.);
+		float best = 1000.f;
+		for (QMap<QString, StelLocation>::const_iterator it=locations.constBegin(); it!=locations.constEnd(); ++it)
+		{
+			if (it->planetName=="Earth")
+				best = qMin(best, StelLocation::distanceDegrees(longitude, latitude, it->longitude, it->latitude));
+		}
+		const StelLocation& nearest = locations.value(index.findNearest("Earth", longitude, latitude));
+		QCOMPARE(StelLocation::distanceDegrees(longitude, latitude, nearest.longitude, nearest.latitude), best);
+	}
+	// Only one site on Mars, far from the searched point
+	QCOMPARE(index.findNearest("Mars", 46.f, -18.f), QString("Olympus Mons"));
+	QVERIFY(index.findNearest("Moon", 0.f, 0.f).isEmpty());
+}
+
+void TestStelLocationIndex::testCountry()
+{
+	QCOMPARE(index.findInCountry("France"), QStringList() << "Lyon, France" << "Paris, France");
+	QCOMPARE(index.findInCountry("Fiji"), QStringList() << "Suva, Fiji" << "Taveuni, Fiji");
+	QCOMPARE(index.findInCountry("Country 7").size(), LOCATION_COUNT/200);
+	QVERIFY(index.findInCountry("Atlantis").isEmpty());
+}
+
+void TestStelLocationIndex::testSearch()
+{
+	// Most populated first
+	QCOMPARE(index.findIDs("par", 10), QStringList() << "Paris, France" << "Parakou, Benin");
+	QCOMPARE(index.findIDs("fran", 10), QStringList() << "Paris, France" << "Lyon, France");
+	// Without the case and the diacritics
+	QCOMPARE(index.findIDs("SAO PAULO", 10), QStringList() << "São Paulo, Brazil");
+	QCOMPARE(index.findIDs("paulo", 10), QStringList() << "São Paulo, Brazil");
+	QCOMPARE(index.findIDs("a", 1), QStringList() << "São Paulo, Brazil");
+	// The limit
+	QCOMPARE(index.findIDs("site 1", 25).size(), 25);
+	// Site 1999, 19990 to 19999 and 199900 to 199999
+	QCOMPARE(index.findIDs("site 1999", LOCATION_COUNT).size(), 111);
+	QVERIFY(index.findIDs("atlantis", 10).isEmpty());
+}
+
+// Searches the index from a thread of the pool
+struct IndexSearch
+{
+	IndexSearch(const StelLocationIndex& index) : index(index) {}
+	typedef QStringList result_type;
+	QStringList operator()(const QString& text) const {return index.findIDs(text, 50);}
+	const StelLocationIndex& index;
+};
+
+void TestStelLocationIndex::testConcurrentSearch()
+{
+	// The name index is built with the other indexes, so the searches only read it
+	QStringList terms;
+	for (int i=0; i<2000; ++i)
+		terms << QString("site %1").arg(i) << "par" << "paulo";
+	const QList<QStringList> results = QtConcurrent::blockingMapped<QList<QStringList> >(terms, IndexSearch(index));
+	QCOMPARE(results.size(), terms.size());
+	for (int i=0; i<terms.size(); ++i)
+		QCOMPARE(results.at(i), index.findIDs(terms.at(i), 50));
+}
+
+void TestStelLocationIndex::testCompiledFile()
+{
+	// The compiled copy of a source file, here a dummy one
+	const QString sourcePath = tempDir.path()+"/locations.bin.gz";
+	QFile source(sourcePath);
+	QVERIFY(source.open(QIODevice::WriteOnly));
+	source.write("locations");
+	source.close();
+
+	{
+		StelCompiledCache cache(sourcePath, "testlocations", TEST_MAGIC, 1);
+		QVERIFY(cache.beginRead()==NULL);
+		QDataStream* out = cache.beginWrite();
+		QVERIFY(out!=NULL);
+		StelLocationIndex::writeLocations(*out, locations);
+		cache.endWrite();
+		QVERIFY(QFile::exists(cache.getCachePath()));
+	}
+
+	QMap<QString, StelLocation> loaded;
+	{
+		StelCompiledCache cache(sourcePath, "testlocations", TEST_MAGIC, 1);
+		QDataStream* in = cache.beginRead();
+		QVERIFY(in!=NULL);
+		StelLocationIndex::readLocations(*in, loaded);
+		QVERIFY(cache.endRead());
+	}
+	QCOMPARE(loaded.size(), locations.size());
+	QCOMPARE(loaded.keys(), locations.keys());
+	for (QMap<QString, StelLocation>::const_iterator it=locations.constBegin(); it!=locations.constEnd(); ++it)
+	{
+		const StelLocation& loc = loaded.value(it.key());
+		QCOMPARE(loc.serializeToLine(), it->serializeToLine());
+		QCOMPARE(loc.longitude, it->longitude);
+		QCOMPARE(loc.latitude, it->latitude);
+		QCOMPARE(loc.population, it->population);
+		QCOMPARE(loc.isUserLocation, it->isUserLocation);
+	}
+
+	// The searches give the same results on the loaded locations
+	StelLocationIndex loadedIndex;
+	loadedIndex.build(loaded);
+	QCOMPARE(loadedIndex.findIDs("par", 10), index.findIDs("par", 10));
+	QCOMPARE(loadedIndex.findNearest("Earth", 10.f, 20.f), index.findNearest("Earth", 10.f, 20.f));
+
+	// Another version of the format, or a modified source, is not read
+	{
+		StelCompiledCache cache(sourcePath, "testlocations", TEST_MAGIC, 2);
+		QVERIFY(cache.beginRead()==NULL);
+	}
+	QVERIFY(source.open(QIODevice::WriteOnly | QIODevice::Append));
+	source.write(" and more locations");
+	source.close();
+	{
+		StelCompiledCache cache(sourcePath, "testlocations", TEST_MAGIC, 1);
+		QVERIFY(cache.beginRead()==NULL);
+	}
+}
+
+void TestStelLocationIndex::benchmarkScanNearby()
+{
+	int count = 0;
+	QBENCHMARK {
+		for (QMap<QString, StelLocation>::const_iterator it=locations.constBegin(); it!=locations.constEnd(); ++it)
+		{
+			if (it->planetName=="Earth" && StelLocation::distanceDegrees(2.349f, 48.853f, it->longitude, it->latitude)<=3.f)
+				++count;
+		}
+	}
+	QVERIFY(count>0);
+}
+
+void TestStelLocationIndex::benchmarkIndexNearby()
+{
+	int count = 0;
+	QBENCHMARK {
+		count += index.findNearby("Earth", 2.349f, 48.853f, 3.f).size();
+	}
+	QVERIFY(count>0);
+}
@@ -0,0 +1,55 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _TESTSTELLOCATIONINDEX_HPP_
+#define _TESTSTELLOCATIONINDEX_HPP_
+
+#include <QObject>
+#include <QtTest>
+#include <QMap>
+#include <QTemporaryDir>
+
+#include "StelLocation.hpp"
+#include "StelLocationIndex.hpp"
+
+//! Compares the queries of StelLocationIndex with a scan of all locations,
+//! and reads back a compiled location file.
+class TestStelLocationIndex : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+	void testNearby();
+	void testNearest();
+	void testCountry();
+	void testSearch();
+	void testConcurrentSearch();
+	void testCompiledFile();
+	void benchmarkScanNearby();
+	void benchmarkIndexNearby();
+private:
+	//! Add a location in the format of the location files.
+	void addLocation(const QString& line);
+	QMap<QString, StelLocation> locations;
+	StelLocationIndex index;
+	QTemporaryDir tempDir;
+};
+
+#endif // _TESTSTELLOCATIONINDEX_HPP_
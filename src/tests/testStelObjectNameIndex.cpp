@@ -0,0 +1,135 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include <QObject>
+#include <QtDebug>
+#include <QtTest>
+
+#include "tests/testStelObjectNameIndex.hpp"
+
+QTEST_GUILESS_MAIN(TestStelObjectNameIndex)
+
+typedef StelObjectNameIndex::Entry Entry;
+
+void TestStelObjectNameIndex::initTestCase()
+{
+	// The group is the object of the name in its source
+	QVector<Entry> stars;
+	stars << Entry("Sirius", -1.46f, 0)
+	      << Entry("Sirius", -1.46f, 0, "alf CMa")
+	      << Entry("Mirach", 2.05f, 1)
+	      << Entry("Markab", 2.48f, 2)
+	      << Entry("Mira", 3.0f, 3)
+	      << Entry("Alpheratz", 2.06f, 4)
+	      << Entry("Alpha Andromedae", 2.06f, 4);
+	index.setNames("Stars", true, stars);
+
+	QVector<Entry> nebulae;
+	nebulae << Entry("Ghost of Jupiter", 8.6f, 0)
+		<< Entry("M 31", 3.4f, 1)
+		<< Entry("Andromeda Galaxy", 3.4f, 1)
+		<< Entry("NGC 224", 3.4f, 1)
+		<< Entry("Omega Centauri", 3.9f, 2)
+		<< Entry("Maia Nebula", 5.f, 3);
+	index.setNames("Nebulae", true, nebulae);
+
+	QVector<Entry> translatedStars;
+	translatedStars << Entry("Bételgeuse", 0.5f, 0)
+			<< Entry("Sirius", -1.46f, 1);
+	index.setNames("Stars", false, translatedStars);
+}
+
+void TestStelObjectNameIndex::testFold()
+{
+	QCOMPARE(StelObjectNameIndex::fold("m 31"), QString("M31"));
+	QCOMPARE(StelObjectNameIndex::fold("  NGC   224 "), QString("NGC224"));
+	QCOMPARE(StelObjectNameIndex::fold("Ghost  of Jupiter"), QString("GHOST OF JUPITER"));
+	QCOMPARE(StelObjectNameIndex::fold("Bételgeuse"), QString("BETELGEUSE"));
+}
+
+void TestStelObjectNameIndex::testPrefix()
+{
+	QCOMPARE(index.find("mira", 10, StelObjectNameIndex::MatchPrefix, true), QStringList() << "Mirach" << "Mira");
+	// Designations match with or without the space
+	QCOMPARE(index.find("m31", 10, StelObjectNameIndex::MatchPrefix, true), QStringList() << "M 31");
+	QCOMPARE(index.find("ngc 22", 10, StelObjectNameIndex::MatchPrefix, true), QStringList() << "NGC 224");
+	// The alias is matched, the name is returned
+	QCOMPARE(index.find("alf c", 10, StelObjectNameIndex::MatchPrefix, true), QStringList() << "Sirius");
+	// Only the start of the name
+	QVERIFY(index.find("jup", 10, StelObjectNameIndex::MatchPrefix, true).isEmpty());
+	QVERIFY(index.find("xyz", 10, StelObjectNameIndex::MatchPrefix, true).isEmpty());
+	QVERIFY(index.find("", 10, StelObjectNameIndex::MatchPrefix, true).isEmpty());
+}
+
+void TestStelObjectNameIndex::testWordStart()
+{
+	QCOMPARE(index.find("jup", 10, StelObjectNameIndex::MatchWordStart, true), QStringList() << "Ghost of Jupiter");
+	QCOMPARE(index.find("gal", 10, StelObjectNameIndex::MatchWordStart, true), QStringList() << "Andromeda Galaxy");
+	QCOMPARE(index.find("andro", 10, StelObjectNameIndex::MatchWordStart, true), QStringList() << "Alpha Andromedae" << "Andromeda Galaxy");
+	// Not inside a word
+	QVERIFY(index.find("upi", 10, StelObjectNameIndex::MatchWordStart, true).isEmpty());
+	// An object matching by several names is listed once, by its best name
+	QCOMPARE(index.find("alph", 10, StelObjectNameIndex::MatchWordStart, true), QStringList() << "Alpha Andromedae");
+}
+
+void TestStelObjectNameIndex::testSubstring()
+{
+	// Texts shorter than a trigram are searched in all names
+	QCOMPARE(index.find("ir", 10, StelObjectNameIndex::MatchSubstring, true), QStringList() << "Sirius" << "Mirach" << "Mira");
+	// Longer texts through the trigram lists
+	QCOMPARE(index.find("ira", 10, StelObjectNameIndex::MatchSubstring, true), QStringList() << "Mirach" << "Mira");
+	QCOMPARE(index.find("upit", 10, StelObjectNameIndex::MatchSubstring, true), QStringList() << "Ghost of Jupiter");
+	QCOMPARE(index.find("c 22", 10, StelObjectNameIndex::MatchSubstring, true), QStringList() << "NGC 224");
+	QVERIFY(index.find("upiz", 10, StelObjectNameIndex::MatchSubstring, true).isEmpty());
+}
+
+void TestStelObjectNameIndex::testRanking()
+{
+	// The names of both sources, brightest first
+	const QStringList expected = QStringList() << "Mirach" << "Markab" << "Mira" << "M 31" << "Maia Nebula";
+	QCOMPARE(index.find("m", 10, StelObjectNameIndex::MatchPrefix, true), expected);
+	QCOMPARE(index.find("M", 10, StelObjectNameIndex::MatchWordStart, true), expected);
+	QCOMPARE(index.find("a", 3, StelObjectNameIndex::MatchSubstring, true), QStringList() << "Sirius" << "Mirach" << "Alpha Andromedae");
+}
+
+void TestStelObjectNameIndex::testMaxNbItem()
+{
+	QCOMPARE(index.find("m", 2, StelObjectNameIndex::MatchPrefix, true), QStringList() << "Mirach" << "Markab");
+	QCOMPARE(index.find("m", 1, StelObjectNameIndex::MatchWordStart, true), QStringList() << "Mirach");
+	QCOMPARE(index.find("i", 2, StelObjectNameIndex::MatchSubstring, true), QStringList() << "Sirius" << "Mirach");
+	QVERIFY(index.find("m", 0, StelObjectNameIndex::MatchPrefix, true).isEmpty());
+}
+
+void TestStelObjectNameIndex::testLanguages()
+{
+	QCOMPARE(index.find("betel", 10, StelObjectNameIndex::MatchPrefix, false), QStringList() << "Bételgeuse");
+	QVERIFY(index.find("betel", 10, StelObjectNameIndex::MatchPrefix, true).isEmpty());
+	QVERIFY(index.find("mira", 10, StelObjectNameIndex::MatchPrefix, false).isEmpty());
+}
+
+void TestStelObjectNameIndex::testRemoveNames()
+{
+	QVERIFY(index.hasNames("Nebulae"));
+	QVERIFY(!index.hasNames("SolarSystem"));
+	index.removeNames("Nebulae");
+	QVERIFY(!index.hasNames("Nebulae"));
+	QCOMPARE(index.find("m", 10, StelObjectNameIndex::MatchPrefix, true), QStringList() << "Mirach" << "Markab" << "Mira");
+	// The translated names of the other source are kept
+	QCOMPARE(index.find("s", 10, StelObjectNameIndex::MatchPrefix, false), QStringList() << "Sirius");
+}
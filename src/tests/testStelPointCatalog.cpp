@@ -0,0 +1,328 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include "tests/testStelPointCatalog.hpp"
+
+#include <QObject>
+#include <QDebug>
+#include <QTest>
+
+#include <algorithm>
+#include <cmath>
+
+#include "StelGeodesicGrid.hpp"
+#include "StelProjectorClasses.hpp"
+#include "StelSphereGeometry.hpp"
+#include "StelUtils.hpp"
+
+QTEST_GUILESS_MAIN(TestStelPointCatalog)
+
+// Size of the catalogue of the benchmarks
+#define LARGE_COUNT 1000000
+
+enum ProjectionType
+{
+	Perspective, Stereographic
+};
+
+// Uniformly distributed random direction
+static Vec3d randomDirection()
+{
+	Vec3d v;
+	StelUtils::spheToRect(2.*M_PI*qrand()/RAND_MAX, std::asin(2.*qrand()/RAND_MAX-1.), v);
+	return v;
+}
+
+static Vec3d toVec3d(const Vec3f& v)
+{
+	Vec3d res(v[0], v[1], v[2]);
+	res.normalize();
+	return res;
+}
+
+// Random magnitudes in steps of 0.1, so that many are equal to the limits
+static QVector<float> randomMagnitudes(int n)
+{
+	QVector<float> magnitudes(n);
+	for (int i=0; i<n; ++i)
+		magnitudes[i] = (qrand()%101)*0.1f;
+	return magnitudes;
+}
+
+// Directions on the corners and the sides of the zones of a level, and random ones
+static QVector<Vec3d> queryDirections(const StelGeodesicGrid* grid, int level)
+{
+	QVector<Vec3d> directions;
+	const int nrOfZones = StelGeodesicGrid::nrOfZones(level);
+	for (int z=0; z<nrOfZones; z+=nrOfZones/5)
+	{
+		Vec3f c0, c1, c2;
+		grid->getTriangleCorners(level, z, c0, c1, c2);
+		directions << toVec3d(c0) << toVec3d(c0+c1);
+	}
+	for (int i=0; i<10; ++i)
+		directions << randomDirection();
+	return directions;
+}
+
+// A catalogue of about n objects on the borders of the zones of its level, on the borders of the caps of
+// radius fov [deg] around the queries and just inside and outside them, and at random.
+static QVector<Vec3d> createPositions(const StelGeodesicGrid* grid, int n, const QVector<Vec3d>& queries, double fov)
+{
+	QVector<Vec3d> positions;
+	const int level = StelPointCatalog::getLevelFor(n);
+	for (int z=0; z<StelGeodesicGrid::nrOfZones(level) && positions.size()<n/2; ++z)
+	{
+		Vec3f c0, c1, c2;
+		grid->getTriangleCorners(level, z, c0, c1, c2);
+		positions << toVec3d(c0) << toVec3d(c0+c1);
+	}
+	foreach (const Vec3d& v, queries)
+	{
+		Vec3d w = v^Vec3d(0.36, 0.48, 0.8);
+		w.normalize();
+		foreach (double angle, QVector<double>() << fov << fov*(1.-1e-9) << fov*(1.+1e-9))
+			positions << v*std::cos(angle*M_PI/180.) + w*std::sin(angle*M_PI/180.);
+	}
+	while (positions.size()<n)
+		positions << randomDirection();
+	return positions;
+}
+
+// The objects inside all the caps and not fainter than maxMag, by a scan of the whole catalogue
+static QVector<int> scan(const StelPointCatalog& catalog, const QVector<float>& magnitudes, const QVector<SphericalCap>& caps, float maxMag=99.f)
+{
+	QVector<int> result;
+	for (int i=0; i<catalog.size(); ++i)
+	{
+		if (!magnitudes.isEmpty() && magnitudes.at(i)>maxMag)
+			continue;
+		const Vec3d& p = catalog.getPosition(i);
+		bool inside = true;
+		foreach (const SphericalCap& cap, caps)
+		{
+			if (p*cap.n<cap.d)
+			{
+				inside = false;
+				break;
+			}
+		}
+		if (inside)
+			result << i;
+	}
+	return result;
+}
+
+// The cap of findAround()
+static SphericalCap aroundCap(const Vec3d& v, double fov)
+{
+	Vec3d n(v);
+	n.normalize();
+	return SphericalCap(n, std::cos(fov*M_PI/180.));
+}
+
+StelProjectorP TestStelPointCatalog::createProjector(int type, float fov, double a, double b)
+{
+	const StelProjector::ModelViewTranformP mv(new StelProjector::Mat4dTransform(Mat4d::xrotation(b)*Mat4d::zrotation(a)));
+	StelProjector* prj;
+	if (type==Perspective)
+		prj = new StelProjectorPerspective(mv);
+	else
+		prj = new StelProjectorStereographic(mv);
+	StelProjector::StelProjectorParams params;
+	params.viewportXywh = Vec4i(0, 0, 800, 600);
+	params.viewportCenter = Vec2f(400.f, 300.f);
+	params.viewportFovDiameter = 600.f;
+	params.fov = fov;
+	params.zNear = 0.000001f;
+	params.zFar = 500.f;
+	prj->init(params);
+	return StelProjectorP(prj);
+}
+
+void TestStelPointCatalog::initTestCase()
+{
+	grid = new StelGeodesicGrid(StelPointCatalog::getLevelFor(LARGE_COUNT));
+	qsrand(1);
+	QVector<Vec3d> positions(LARGE_COUNT);
+	for (int i=0; i<LARGE_COUNT; ++i)
+		positions[i] = randomDirection();
+	largeMagnitudes = randomMagnitudes(LARGE_COUNT);
+	largeCatalog.setPositions(grid, positions, largeMagnitudes);
+	QCOMPARE(largeCatalog.getLevel(), grid->getMaxLevel());
+}
+
+void TestStelPointCatalog::cleanupTestCase()
+{
+	delete grid;
+}
+
+void TestStelPointCatalog::testFindAround_data()
+{
+	QTest::addColumn<int>("nbPoints");
+	QTest::addColumn<double>("fov");
+	// Levels 0, 2 and 4 of the grid, caps smaller than a zone to larger than a hemisphere
+	foreach (int n, QVector<int>() << 200 << 5000 << 50000)
+	{
+		foreach (double fov, QVector<double>() << 0.1 << 1. << 10. << 60. << 120.)
+			QTest::newRow(qPrintable(QString("%1 points, %2 deg").arg(n).arg(fov))) << n << fov;
+	}
+}
+
+void TestStelPointCatalog::testFindAround()
+{
+	QFETCH(int, nbPoints);
+	QFETCH(double, fov);
+	qsrand(2);
+	const QVector<Vec3d> queries = queryDirections(grid, StelPointCatalog::getLevelFor(nbPoints));
+	StelPointCatalog catalog;
+	catalog.setPositions(grid, createPositions(grid, nbPoints, queries, fov));
+	QCOMPARE(catalog.getLevel(), StelPointCatalog::getLevelFor(catalog.size()));
+
+	int found = 0;
+	foreach (const Vec3d& v, queries)
+	{
+		const QVector<int> expected = scan(catalog, QVector<float>(), QVector<SphericalCap>() << aroundCap(v, fov));
+		const QVector<int> around = catalog.findAround(grid, v, fov);
+		QVERIFY2(around==expected, qPrintable(QString("around %1: %2 objects found instead of %3").arg(v.toString()).arg(around.size()).arg(expected.size())));
+		found += around.size();
+	}
+	QVERIFY(found>0);
+}
+
+void TestStelPointCatalog::testFindVisible_data()
+{
+	QTest::addColumn<int>("type");
+	QTest::addColumn<float>("fov");
+	QTest::addColumn<double>("horizon");
+	QTest::addColumn<bool>("withMagnitudes");
+	QTest::addColumn<float>("maxMag");
+	// The horizon is the d of the visible cap around the zenith: the whole sky, a hemisphere, and less than a hemisphere
+	QTest::newRow("perspective 60 deg") << (int)Perspective << 60.f << -1. << true << 99.f;
+	QTest::newRow("perspective 60 deg, no magnitude") << (int)Perspective << 60.f << -1. << false << 5.5f;
+	QTest::newRow("perspective 5 deg, mag 5.5") << (int)Perspective << 5.f << -1. << true << 5.5f;
+	QTest::newRow("perspective 60 deg, horizon, mag 5.5") << (int)Perspective << 60.f << 0. << true << 5.5f;
+	QTest::newRow("perspective 60 deg, mountains") << (int)Perspective << 60.f << 0.6 << true << 99.f;
+	QTest::newRow("perspective 60 deg, too faint") << (int)Perspective << 60.f << -1. << true << -1.f;
+	QTest::newRow("stereographic 180 deg, horizon, mag 5.5") << (int)Stereographic << 180.f << -0.1 << true << 5.5f;
+}
+
+void TestStelPointCatalog::testFindVisible()
+{
+	QFETCH(int, type);
+	QFETCH(float, fov);
+	QFETCH(double, horizon);
+	QFETCH(bool, withMagnitudes);
+	QFETCH(float, maxMag);
+	qsrand(3);
+	const QVector<Vec3d> positions = createPositions(grid, 50000, QVector<Vec3d>(), 0.);
+	const QVector<float> magnitudes = withMagnitudes ? randomMagnitudes(positions.size()) : QVector<float>();
+	StelPointCatalog catalog;
+	catalog.setPositions(grid, positions, magnitudes);
+	const SphericalCap visibleSkyArea(Vec3d(0., 0., 1.), horizon);
+
+	int found = 0;
+	for (int view=0; view<10; ++view)
+	{
+		const StelProjectorP prj = createProjector(type, fov, 2.*M_PI*qrand()/RAND_MAX, M_PI*qrand()/RAND_MAX);
+		const QVector<SphericalCap> viewportCaps = prj->getViewportConvexPolygon()->getBoundingSphericalCaps();
+		QVector<SphericalCap> caps = viewportCaps;
+		caps << visibleSkyArea;
+		const QVector<int> expected = scan(catalog, magnitudes, caps, maxMag);
+		const QVector<int> visible = catalog.findVisible(grid, prj, visibleSkyArea, maxMag);
+		QVERIFY2(visible==expected, qPrintable(QString("view %1: %2 objects found instead of %3").arg(view).arg(visible.size()).arg(expected.size())));
+		found += visible.size();
+
+		if (type!=Perspective)
+			continue;
+		// The viewport of the perspective projection is the polygon: the objects drawn in it are found,
+		// except those closer to its sides than the rounding of the projection
+		for (int i=0; i<catalog.size(); ++i)
+		{
+			const Vec3d& p = catalog.getPosition(i);
+			bool nearSide = false;
+			foreach (const SphericalCap& cap, viewportCaps)
+				nearSide |= std::fabs(p*cap.n/cap.n.length()-cap.d)<1e-6;
+			Vec3d win;
+			if (!nearSide && (magnitudes.isEmpty() || magnitudes.at(i)<=maxMag) && p*visibleSkyArea.n>=visibleSkyArea.d && prj->projectCheck(p, win))
+				QVERIFY2(std::binary_search(visible.constBegin(), visible.constEnd(), i), qPrintable(QString("view %1: object %2 in the viewport not found").arg(view).arg(i)));
+		}
+	}
+	if (maxMag>=0.f)
+		QVERIFY(found>0);
+	else
+		QCOMPARE(found, 0);
+}
+
+void TestStelPointCatalog::benchmarkFindAround_data()
+{
+	QTest::addColumn<bool>("index");
+	QTest::addColumn<double>("fov");
+	QTest::newRow("index, 0.1 deg") << true << 0.1;
+	QTest::newRow("scan, 0.1 deg") << false << 0.1;
+	QTest::newRow("index, 1 deg") << true << 1.;
+	QTest::newRow("scan, 1 deg") << false << 1.;
+}
+
+void TestStelPointCatalog::benchmarkFindAround()
+{
+	QFETCH(bool, index);
+	QFETCH(double, fov);
+	qsrand(4);
+	const Vec3d v = randomDirection();
+	QVector<int> result;
+	QBENCHMARK
+	{
+		if (index)
+			result = largeCatalog.findAround(grid, v, fov);
+		else
+			result = scan(largeCatalog, QVector<float>(), QVector<SphericalCap>() << aroundCap(v, fov));
+	}
+	QVERIFY(!result.isEmpty());
+}
+
+void TestStelPointCatalog::benchmarkFindVisible_data()
+{
+	QTest::addColumn<bool>("index");
+	QTest::addColumn<float>("fov");
+	QTest::newRow("index, 60 deg") << true << 60.f;
+	QTest::newRow("scan, 60 deg") << false << 60.f;
+	QTest::newRow("index, 5 deg") << true << 5.f;
+	QTest::newRow("scan, 5 deg") << false << 5.f;
+}
+
+void TestStelPointCatalog::benchmarkFindVisible()
+{
+	QFETCH(bool, index);
+	QFETCH(float, fov);
+	// Looking above the horizon
+	const StelProjectorP prj = createProjector(Perspective, fov, 1.1, M_PI-0.4);
+	const SphericalCap visibleSkyArea(Vec3d(0., 0., 1.), -0.1);
+	QVector<SphericalCap> caps = prj->getViewportConvexPolygon()->getBoundingSphericalCaps();
+	caps << visibleSkyArea;
+	QVector<int> result;
+	QBENCHMARK
+	{
+		if (index)
+			result = largeCatalog.findVisible(grid, prj, visibleSkyArea, 6.f);
+		else
+			result = scan(largeCatalog, largeMagnitudes, caps, 6.f);
+	}
+	QVERIFY(!result.isEmpty());
+}
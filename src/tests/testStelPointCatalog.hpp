@@ -0,0 +1,55 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _TESTSTELPOINTCATALOG_HPP_
+#define _TESTSTELPOINTCATALOG_HPP_
+
+#include <QObject>
+#include <QTest>
+#include <QVector>
+
+#include "StelPointCatalog.hpp"
+
+class StelGeodesicGrid;
+
+class TestStelPointCatalog : public QObject
+{
+Q_OBJECT
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+	void testFindAround_data();
+	void testFindAround();
+	void testFindVisible_data();
+	void testFindVisible();
+	void benchmarkFindAround_data();
+	void benchmarkFindAround();
+	void benchmarkFindVisible_data();
+	void benchmarkFindVisible();
+private:
+	//! A projector of 800x600 pixels, whose view is rotated by a around the z axis, then by b around the x axis.
+	static StelProjectorP createProjector(int type, float fov, double a, double b);
+
+	StelGeodesicGrid* grid;
+	// The catalogue of the benchmarks
+	StelPointCatalog largeCatalog;
+	QVector<float> largeMagnitudes;
+};
+
+#endif // _TESTSTELPOINTCATALOG_HPP_
@@ -0,0 +1,270 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include <QObject>
+#include <QtDebug>
+#include <QtTest>
+
+#include "tests/testStelProjector.hpp"
+#include "StelProjectorClasses.hpp"
+
+QTEST_GUILESS_MAIN(TestStelProjector)
+
+#define VECTOR_COUNT 1000000
+// Number of vectors compared with the per-vector functions
+#define CHECK_COUNT 20000
+
+enum ProjectionType
+{
+	Perspective, EqualArea, Stereographic, Fisheye, Hammer, Cylinder, Mercator, Orthographic, Sinusoidal, Miller
+};
+
+// Gives access to the batch kernel of a projection
+template<class P> class TestProjector : public P
+{
+public:
+	TestProjector(StelProjector::ModelViewTranformP transform) : P(transform) {}
+	void forwardBatch(int n, float* x, float* y, float* z, quint8* valid) const {P::forwardBatch(n, x, y, z, valid);}
+};
+
+static StelProjector::ModelViewTranformP createModelView()
+{
+	return StelProjector::ModelViewTranformP(new StelProjector::Mat4dTransform(Mat4d::xrotation(0.4)*Mat4d::zrotation(1.1)));
+}
+
+static StelProjectorP createProjector(int type)
+{
+	const StelProjector::ModelViewTranformP mv = createModelView();
+	switch (type)
+	{
+		case Perspective: return StelProjectorP(new StelProjectorPerspective(mv));
+		case EqualArea: return StelProjectorP(new StelProjectorEqualArea(mv));
+		case Stereographic: return StelProjectorP(new StelProjectorStereographic(mv));
+		case Fisheye: return StelProjectorP(new StelProjectorFisheye(mv));
+		case Hammer: return StelProjectorP(new StelProjectorHammer(mv));
+		case Cylinder: return StelProjectorP(new StelProjectorCylinder(mv));
+		case Mercator: return StelProjectorP(new StelProjectorMercator(mv));
+		case Orthographic: return StelProjectorP(new StelProjectorOrthographic(mv));
+		case Sinusoidal: return StelProjectorP(new StelProjectorSinusoidal(mv));
+		case Miller: return StelProjectorP(new StelProjectorMiller(mv));
+	}
+	return StelProjectorP();
+}
+
+static bool fuzzyEqual(float a, float b, float tolerance=1e-5f)
+{
+	return a==b || qAbs(a-b) <= tolerance*qMax(1.f, qAbs(a));
+}
+
+// Compare the batch kernel of projection P with its forward() function.
+template<class P> static void checkForwardBatch(const QVector<float>& x, const QVector<float>& y, const QVector<float>& z)
+{
+	const TestProjector<P> prj(createModelView());
+	QVector<float> bx(x.mid(0, CHECK_COUNT)), by(y.mid(0, CHECK_COUNT)), bz(z.mid(0, CHECK_COUNT));
+	QVector<quint8> valid(CHECK_COUNT);
+	prj.forwardBatch(CHECK_COUNT, bx.data(), by.data(), bz.data(), valid.data());
+	for (int i=0; i<CHECK_COUNT; ++i)
+	{
+		Vec3f v(x.at(i), y.at(i), z.at(i));
+		const bool ok = prj.forward(v);
+		QVERIFY2(ok==(bool)valid.at(i) && fuzzyEqual(v[0], bx.at(i)) && fuzzyEqual(v[1], by.at(i)) && fuzzyEqual(v[2], bz.at(i)),
+			 qPrintable(QString("vector %1: forward() %2 %3, forwardBatch() [%4, %5, %6] %7").arg(i).arg(v.toString()).arg(ok)
+				    .arg(bx.at(i)).arg(by.at(i)).arg(bz.at(i)).arg(valid.at(i))));
+	}
+}
+
+void TestStelProjector::initTestCase()
+{
+	qsrand(1);
+	x.resize(VECTOR_COUNT);
+	y.resize(VECTOR_COUNT);
+	z.resize(VECTOR_COUNT);
+	for (int i=0; i<VECTOR_COUNT; ++i)
+	{
+		// Uniform on the sphere
+		const double zi = 2.*qrand()/RAND_MAX - 1.;
+		const double phi = 2.*M_PI*qrand()/RAND_MAX;
+		const double r = std::sqrt(1.-zi*zi);
+		x[i] = r*std::cos(phi);
+		y[i] = r*std::sin(phi);
+		z[i] = zi;
+	}
+}
+
+void TestStelProjector::addProjectionRows()
+{
+	QTest::addColumn<int>("type");
+	QTest::newRow("Perspective") << (int)Perspective;
+	QTest::newRow("EqualArea") << (int)EqualArea;
+	QTest::newRow("Stereographic") << (int)Stereographic;
+	QTest::newRow("Fisheye") << (int)Fisheye;
+	QTest::newRow("Hammer") << (int)Hammer;
+	QTest::newRow("Cylinder") << (int)Cylinder;
+	QTest::newRow("Mercator") << (int)Mercator;
+	QTest::newRow("Orthographic") << (int)Orthographic;
+	QTest::newRow("Sinusoidal") << (int)Sinusoidal;
+	QTest::newRow("Miller") << (int)Miller;
+}
+
+void TestStelProjector::testForwardBatch_data()
+{
+	addProjectionRows();
+}
+
+void TestStelProjector::testForwardBatch()
+{
+	QFETCH(int, type);
+	switch (type)
+	{
+		case Perspective: checkForwardBatch<StelProjectorPerspective>(x, y, z); break;
+		case EqualArea: checkForwardBatch<StelProjectorEqualArea>(x, y, z); break;
+		case Stereographic: checkForwardBatch<StelProjectorStereographic>(x, y, z); break;
+		case Fisheye: checkForwardBatch<StelProjectorFisheye>(x, y, z); break;
+		case Hammer: checkForwardBatch<StelProjectorHammer>(x, y, z); break;
+		case Cylinder: checkForwardBatch<StelProjectorCylinder>(x, y, z); break;
+		case Mercator: checkForwardBatch<StelProjectorMercator>(x, y, z); break;
+		case Orthographic: checkForwardBatch<StelProjectorOrthographic>(x, y, z); break;
+		case Sinusoidal: checkForwardBatch<StelProjectorSinusoidal>(x, y, z); break;
+		case Miller: checkForwardBatch<StelProjectorMiller>(x, y, z); break;
+	}
+}
+
+void TestStelProjector::testModelViewBatch()
+{
+	const StelProjector::ModelViewTranformP mv = createModelView();
+	QVector<float> bx(CHECK_COUNT), by(CHECK_COUNT), bz(CHECK_COUNT);
+	mv->forwardBatch(CHECK_COUNT, x.constData(), y.constData(), z.constData(), bx.data(), by.data(), bz.data());
+	for (int i=0; i<CHECK_COUNT; ++i)
+	{
+		Vec3f v(x.at(i), y.at(i), z.at(i));
+		mv->forward(v);
+		QVERIFY(fuzzyEqual(v[0], bx.at(i)) && fuzzyEqual(v[1], by.at(i)) && fuzzyEqual(v[2], bz.at(i)));
+	}
+
+	// In place
+	bx = x.mid(0, CHECK_COUNT);
+	by = y.mid(0, CHECK_COUNT);
+	bz = z.mid(0, CHECK_COUNT);
+	mv->forwardBatch(CHECK_COUNT, bx.constData(), by.constData(), bz.constData(), bx.data(), by.data(), bz.data());
+	for (int i=0; i<CHECK_COUNT; ++i)
+	{
+		Vec3f v(x.at(i), y.at(i), z.at(i));
+		mv->forward(v);
+		QVERIFY(fuzzyEqual(v[0], bx.at(i)) && fuzzyEqual(v[1], by.at(i)) && fuzzyEqual(v[2], bz.at(i)));
+	}
+}
+
+void TestStelProjector::testShaderProjection_data()
+{
+	addProjectionRows();
+}
+
+void TestStelProjector::testShaderProjection()
+{
+	QFETCH(int, type);
+	const StelProjectorP prj = createProjector(type);
+	StelProjector::StelProjectorParams params;
+	params.viewportXywh.set(0, 0, 1024, 768);
+	params.viewportCenter.set(512.f, 384.f);
+	params.viewportFovDiameter = 768.f;
+	params.zNear = 0.001f;
+	params.zFar = 500.f;
+	params.flipHorz = true;
+	params.widthStretch = 1.2f;
+	prj->init(params);
+
+	// The retained geometry shader of StelPainter only applies to the perspective and orthographic projections
+	const StelProjector::ShaderParameters shader = prj->getShaderParameters();
+	QCOMPARE(shader.projection!=StelProjector::ShaderProjectionNone, type==Perspective || type==Orthographic);
+	if (shader.projection==StelProjector::ShaderProjectionNone)
+		return;
+
+	// The random vectors, then points behind the viewer
+	QVector<Vec3d> vectors;
+	for (int i=0; i<CHECK_COUNT; ++i)
+		vectors << Vec3d(x.at(i), y.at(i), z.at(i));
+	const Vec3d behind[] = {Vec3d(0., 0., 1.), Vec3d(0.6, 0., 0.8), Vec3d(0., -0.999, 0.0447), Vec3d(0.1, 0.1, 1e-5)};
+	for (unsigned int i=0; i<sizeof(behind)/sizeof(behind[0]); ++i)
+	{
+		Vec3d v(behind[i]);
+		prj->getModelViewTransform()->backward(v);
+		vectors << v;
+	}
+
+	// The shader gives the same window coordinates as the CPU, and in the perspective
+	// projection clips the points behind the viewer, which the CPU sends beyond zFar
+	int compared = 0, clipped = 0;
+	for (int i=0; i<vectors.size(); ++i)
+	{
+		const Vec3d& v = vectors.at(i);
+		Vec3d eye(v);
+		prj->getModelViewTransform()->forward(eye);
+		Vec3d win;
+		const bool visible = prj->project(v, win);
+		Vec3f gpu;
+		const bool drawn = StelProjector::shaderProject(shader, v, gpu);
+		if (type==Perspective && eye[2]>=0.)
+		{
+			QVERIFY2(!visible && win[2]>1. && !drawn, qPrintable(QString("vector %1 behind the viewer: project() %2").arg(i).arg(win.toString())));
+			++clipped;
+			continue;
+		}
+		QVERIFY(drawn);
+		QVERIFY2(fuzzyEqual(win[0], gpu[0], 1e-4f) && fuzzyEqual(win[1], gpu[1], 1e-4f) && fuzzyEqual(win[2], gpu[2], 1e-4f),
+			 qPrintable(QString("vector %1: project() %2, shader %3").arg(i).arg(win.toString()).arg(gpu.toString())));
+		++compared;
+	}
+	QVERIFY(compared>CHECK_COUNT/4);
+	if (type==Perspective)
+		QVERIFY(clipped>CHECK_COUNT/4);
+}
+
+void TestStelProjector::benchmarkProjectCheck_data()
+{
+	addProjectionRows();
+}
+
+void TestStelProjector::benchmarkProjectCheck()
+{
+	QFETCH(int, type);
+	const StelProjectorP prj = createProjector(type);
+	QVector<float> winX(VECTOR_COUNT), winY(VECTOR_COUNT), winZ(VECTOR_COUNT);
+	QVector<quint8> visible(VECTOR_COUNT);
+	QBENCHMARK {
+		prj->projectCheck(VECTOR_COUNT, x.constData(), y.constData(), z.constData(), winX.data(), winY.data(), winZ.data(), visible.data());
+	}
+}
+
+void TestStelProjector::benchmarkProjectCheckPerVector_data()
+{
+	addProjectionRows();
+}
+
+void TestStelProjector::benchmarkProjectCheckPerVector()
+{
+	QFETCH(int, type);
+	const StelProjectorP prj = createProjector(type);
+	Vec3f win;
+	int nbVisible = 0;
+	QBENCHMARK {
+		for (int i=0; i<VECTOR_COUNT; ++i)
+			nbVisible += prj->projectCheck(Vec3f(x.at(i), y.at(i), z.at(i)), win);
+	}
+	Q_UNUSED(nbVisible);
+}
@@ -0,0 +1,234 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include <QObject>
+#include <QtDebug>
+#include <QtTest>
+#include <QApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QNetworkAccessManager>
+#include <QNetworkDiskCache>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QSettings>
+
+#include "tests/testStelSkyImageTile.hpp"
+#include "StelApp.hpp"
+#include "StelCore.hpp"
+#include "StelFileMgr.hpp"
+#include "StelPainter.hpp"
+#include "StelSkyImageTile.hpp"
+#include "StelTileLoader.hpp"
+#include "StelTranslator.hpp"
+
+#define FRAME_WIDTH 1024
+#define FRAME_HEIGHT 768
+// Timeout of the loading of a tree [ms]
+#define LOAD_TIMEOUT 20000
+
+// As QTEST_MAIN, but without a display the test is drawn offscreen, by Mesa llvmpipe on a machine without a GPU
+int main(int argc, char *argv[])
+{
+	if (qgetenv("QT_QPA_PLATFORM").isEmpty() && qgetenv("DISPLAY").isEmpty())
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	QApplication app(argc, argv);
+	app.setAttribute(Qt::AA_Use96Dpi, true);
+	TestStelSkyImageTile test;
+	return QTest::qExec(&test, argc, argv);
+}
+
+static bool writeFile(const QString& path, const QByteArray& content)
+{
+	QFile file(path);
+	return file.open(QIODevice::WriteOnly) && file.write(content)==content.size();
+}
+
+void TestStelSkyImageTile::initTestCase()
+{
+	surface = NULL;
+	context = NULL;
+	frameBuffer = NULL;
+	settings = NULL;
+	app = NULL;
+
+	// The user directory of StelFileMgr is in the home directory, the data are those of the source tree
+	QVERIFY(userDir.isValid());
+	qputenv("HOME", QFile::encodeName(userDir.path()));
+	QVERIFY(QDir::setCurrent(STELLARIUM_SOURCE_DIR));
+	StelFileMgr::init();
+	StelTranslator::init(StelFileMgr::getInstallationDir() + "/data/iso639-1.utf8");
+
+	surface = new QOffscreenSurface();
+	surface->create();
+	context = new QOpenGLContext();
+	if (!context->create() || !context->makeCurrent(surface))
+		QSKIP("No OpenGL context: install Mesa to draw with its llvmpipe software renderer");
+	if (context->format().majorVersion()<2)
+		QSKIP("OpenGL 2 is not supported");
+	frameBuffer = new QOpenGLFramebufferObject(FRAME_WIDTH, FRAME_HEIGHT, QOpenGLFramebufferObject::CombinedDepthStencil);
+	QVERIFY(frameBuffer->bind());
+
+	StelApp::initStatic();
+	settings = new QSettings(userDir.path() + "/config.ini", QSettings::IniFormat);
+	app = new StelApp();
+	app->init(settings);
+	StelPainter::initGLShaders();
+	app->glWindowHasBeenResized(0, 0, FRAME_WIDTH, FRAME_HEIGHT);
+	app->update(1.);
+}
+
+void TestStelSkyImageTile::cleanupTestCase()
+{
+	if (app)
+	{
+		StelPainter::deinitGLShaders();
+		delete app;
+		StelApp::deinitStatic();
+	}
+	delete settings;
+	delete frameBuffer;
+	delete context;
+	delete surface;
+}
+
+int TestStelSkyImageTile::loadTree(StelSkyImageTile* root, int nbTiles, int timeout)
+{
+	StelCore* core = app->getCore();
+	const StelTileLoader& loader = MultiLevelJsonBase::getTileLoader();
+	maxLoading = 0;
+	QElapsedTimer timer;
+	timer.start();
+	for (int frame=1; timer.elapsed()<timeout; ++frame)
+	{
+		core->preDraw();
+		{
+			StelPainter sPainter(core->getProjection(StelCore::FrameJ2000));
+			root->draw(core, sPainter);
+		}
+		core->postDraw();
+		MultiLevelJsonBase::updateTileLoading();
+		maxLoading = qMax(maxLoading, loader.getNbLoading());
+
+		int ready = 0;
+		foreach (const StelSkyImageTile* tile, root->findChildren<StelSkyImageTile*>())
+		{
+			if (tile->hasErrorOccured())
+			{
+				qWarning() << "tile" << tile->getShortName() << "failed to load";
+				return -1;
+			}
+			if (tile->isReadyToDisplay())
+				++ready;
+		}
+		if (ready==nbTiles)
+			return frame;
+		// The downloads, the parsing threads and the textures progress in the events
+		QTest::qWait(10);
+	}
+	return -1;
+}
+
+void TestStelSkyImageTile::testFileTree()
+{
+	// A root without texture, with 8 tiles of 2 sub tiles each, all with a texture: more tiles than loading slots.
+	// The screen resolution is finer than the resolution of the tiles, so that all of them are needed.
+	QVERIFY(treeDir.isValid());
+	QImage image(16, 16, QImage::Format_RGB32);
+	image.fill(Qt::gray);
+	QVERIFY(image.save(treeDir.filePath("tile.png")));
+	QStringList subTiles;
+	for (int i=0; i<8; ++i)
+	{
+		const QString name = QString("tile%1").arg(i);
+		QVERIFY(writeFile(treeDir.filePath(name+".json"), QString("{\"shortName\": \"%1\", \"minResolution\": 0.5, \"imageUrl\": \"tile.png\", "
+			"\"subTiles\": [\"%1a.json\", {\"$ref\": \"%1b.json\"}]}").arg(name).toUtf8()));
+		QVERIFY(writeFile(treeDir.filePath(name+"a.json"), QString("{\"shortName\": \"%1a\", \"minResolution\": 0.0001, \"imageUrl\": \"tile.png\"}").arg(name).toUtf8()));
+		QVERIFY(writeFile(treeDir.filePath(name+"b.json"), QString("{\"shortName\": \"%1b\", \"minResolution\": 0.0001, \"imageUrl\": \"tile.png\"}").arg(name).toUtf8()));
+		subTiles << QString("\"%1.json\"").arg(name);
+	}
+	QVERIFY(writeFile(treeDir.filePath("root.json"), QString("{\"shortName\": \"root\", \"minResolution\": 10, \"subTiles\": [%1]}").arg(subTiles.join(", ")).toUtf8()));
+
+	// The descriptions are downloaded and parsed in threads as those of a remote survey
+	StelSkyImageTile* root = new StelSkyImageTile(QUrl::fromLocalFile(treeDir.filePath("root.json")).toString());
+	const int frames = loadTree(root, 24, LOAD_TIMEOUT);
+	QVERIFY2(frames>0, "the tree was not loaded");
+	QCOMPARE(root->getShortName(), QString("root"));
+	const QList<StelSkyImageTile*> tiles = root->findChildren<StelSkyImageTile*>();
+	QCOMPARE(tiles.size(), 24);
+	foreach (const StelSkyImageTile* tile, tiles)
+		QCOMPARE(tile->getAbsoluteImageURI(), treeDir.filePath("tile.png"));
+
+	// The tiles waited for their loading slots
+	const StelTileLoader& loader = MultiLevelJsonBase::getTileLoader();
+	QVERIFY2(maxLoading>0 && maxLoading<=loader.getMaxLoads(), qPrintable(QString("%1 tiles loading at the same time").arg(maxLoading)));
+	QVERIFY(frames>1);
+
+	// All slots are free once the tree is loaded
+	QCOMPARE(loadTree(root, 24, LOAD_TIMEOUT), 1);
+	QCOMPARE(loader.getNbLoading(), 0);
+	QCOMPARE(loader.getNbPending(), 0);
+	delete root;
+}
+
+void TestStelSkyImageTile::testJsonCache()
+{
+	QNetworkAccessManager probe;
+	if (probe.networkAccessible()==QNetworkAccessManager::NotAccessible)
+		QSKIP("The network is disabled, so is the network cache");
+
+	// A description in the JSON cache, which the server asked to validate before using it
+	QNetworkDiskCache cache;
+	cache.setCacheDirectory(StelFileMgr::getCacheDir()+"/JSONCache");
+	const QUrl url("http://tiles.invalid/survey/cached.json");
+	QNetworkCacheMetaData metaData;
+	metaData.setUrl(url);
+	metaData.setSaveToDisk(true);
+	QNetworkCacheMetaData::RawHeaderList headers;
+	headers << qMakePair(QByteArray("Content-Type"), QByteArray("application/json"));
+	headers << qMakePair(QByteArray("Cache-Control"), QByteArray("no-cache"));
+	metaData.setRawHeaders(headers);
+	QNetworkCacheMetaData::AttributesMap attributes;
+	attributes.insert(QNetworkRequest::HttpStatusCodeAttribute, 200);
+	metaData.setAttributes(attributes);
+	QIODevice* data = cache.prepare(metaData);
+	QVERIFY(data!=NULL);
+	data->write("{\"shortName\": \"cached\", \"minResolution\": 1}");
+	cache.insert(data);
+
+	// The host does not exist: the description can only be read from the cache
+	StelSkyImageTile tile(url.toString());
+	QElapsedTimer timer;
+	timer.start();
+	while (tile.getShortName().isEmpty() && !tile.hasErrorOccured() && timer.elapsed()<LOAD_TIMEOUT)
+		QTest::qWait(10);
+	QVERIFY(!tile.hasErrorOccured());
+	QCOMPARE(tile.getShortName(), QString("cached"));
+
+	// The cached copy is now used without validation
+	const QNetworkCacheMetaData fresh = cache.metaData(url);
+	QVERIFY(fresh.isValid());
+	QVERIFY(fresh.expirationDate()>QDateTime::currentDateTimeUtc());
+	foreach (const QNetworkCacheMetaData::RawHeader& header, fresh.rawHeaders())
+		QVERIFY(header.first.toLower()!="cache-control");
+}
@@ -0,0 +1,61 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _TESTSTELSKYIMAGETILE_HPP_
+#define _TESTSTELSKYIMAGETILE_HPP_
+
+#include <QObject>
+#include <QtTest>
+#include <QTemporaryDir>
+
+class QOffscreenSurface;
+class QOpenGLContext;
+class QOpenGLFramebufferObject;
+class QSettings;
+class StelApp;
+class StelSkyImageTile;
+
+//! Loads tile trees with StelSkyImageTile and MultiLevelJsonBase in the real StelApp, drawn into an
+//! offscreen OpenGL context (e.g. Mesa llvmpipe): a file:// tree, downloaded as a remote survey through
+//! the loading slots of StelTileLoader, and a remote description read from the JSON disk cache.
+class TestStelSkyImageTile : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+	void testFileTree();
+	void testJsonCache();
+private:
+	//! Draw the tile until all the tiles of its tree are loaded, or until the timeout.
+	//! @return the number of frames drawn, or -1 after the timeout.
+	int loadTree(StelSkyImageTile* root, int nbTiles, int timeout);
+
+	QTemporaryDir userDir;
+	QTemporaryDir treeDir;
+	QOffscreenSurface* surface;
+	QOpenGLContext* context;
+	QOpenGLFramebufferObject* frameBuffer;
+	QSettings* settings;
+	StelApp* app;
+	//! The largest number of tiles loading at the same time while loading the tree
+	int maxLoading;
+};
+
+#endif // _TESTSTELSKYIMAGETILE_HPP_
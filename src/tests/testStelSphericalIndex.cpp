@@ -40,6 +40,31 @@ class TestRegionObject : public StelRegionObject
 		SphericalRegionP region;
 };
 
+class TestPointObject : public StelRegionObject
+{
+	public:
+		TestPointObject(const Vec3d& p) : point(p) {;}
+		virtual SphericalRegionP getRegion() const { return SphericalRegionP(new SphericalPoint(point)); }
+		virtual Vec3d getPointInRegion() const { return point; }
+		Vec3d point;
+};
+
+// Uniformly distributed random direction
+static Vec3d randomDirection()
+{
+	Vec3d v;
+	StelUtils::spheToRect(2.*M_PI*qrand()/RAND_MAX, std::asin(2.*qrand()/RAND_MAX-1.), v);
+	return v;
+}
+
+// Fill grid with nb random points
+static void fillRandomPoints(StelSphericalIndex& grid, int nb)
+{
+	qsrand(1);
+	for (int i=0;i<nb;++i)
+		grid.insert(StelRegionObjectP(new TestPointObject(randomDirection())));
+}
+
 void TestStelSphericalIndex::initTestCase()
 {
 }
@@ -102,3 +127,90 @@ void TestStelSphericalIndex::testBase()
 	QVERIFY(countFunc.count==30000);
 }
 
+
+struct CollectFuncObject
+{
+	void operator()(const StelRegionObject* obj)
+	{
+		points << obj->getPointInRegion();
+	}
+	QVector<Vec3d> points;
+};
+
+void TestStelSphericalIndex::testPointQueries()
+{
+	StelSphericalIndex grid(10);
+	fillRandomPoints(grid, 5000);
+	CollectFuncObject all;
+	grid.processAll(all);
+	QVERIFY(all.points.size()==5000);
+
+	for (int q=0;q<20;++q)
+	{
+		const Vec3d v = randomDirection();
+		const SphericalCap cap(v, std::cos(5.*M_PI/180.));
+
+		// Cone search against all the points
+		int expected = 0;
+		foreach (const Vec3d& p, all.points)
+			if (p*v>=cap.d)
+				++expected;
+		QVector<StelRegionObjectP> inCap = grid.findPointsInCap(cap);
+		QVERIFY(inCap.size()==expected);
+		foreach (const StelRegionObjectP& obj, inCap)
+			QVERIFY(obj->getPointInRegion()*v>=cap.d);
+
+		// The nearest points are sorted, and no other point is nearer than the last one
+		QVector<StelRegionObjectP> nearest = grid.findNearestPoints(v, 10);
+		QVERIFY(nearest.size()==10);
+		for (int i=1;i<nearest.size();++i)
+			QVERIFY(nearest.at(i-1)->getPointInRegion()*v>=nearest.at(i)->getPointInRegion()*v);
+		int nearer = 0;
+		foreach (const Vec3d& p, all.points)
+			if (p*v>nearest.last()->getPointInRegion()*v)
+				++nearer;
+		QVERIFY(nearer<10);
+
+		// The distance limit
+		nearest = grid.findNearestPoints(v, 5000, 5.*M_PI/180.);
+		QVERIFY(nearest.size()==expected);
+	}
+}
+
+void TestStelSphericalIndex::benchmarkFindPointsInCap_data()
+{
+	QTest::addColumn<int>("nbPoints");
+	QTest::newRow("100k") << 100000;
+	QTest::newRow("1M") << 1000000;
+}
+
+void TestStelSphericalIndex::benchmarkFindPointsInCap()
+{
+	QFETCH(int, nbPoints);
+	StelSphericalIndex grid(100);
+	fillRandomPoints(grid, nbPoints);
+	const SphericalCap cap(randomDirection(), std::cos(1.*M_PI/180.));
+	QBENCHMARK
+	{
+		grid.findPointsInCap(cap);
+	}
+}
+
+void TestStelSphericalIndex::benchmarkFindNearestPoints_data()
+{
+	QTest::addColumn<int>("nbPoints");
+	QTest::newRow("100k") << 100000;
+	QTest::newRow("1M") << 1000000;
+}
+
+void TestStelSphericalIndex::benchmarkFindNearestPoints()
+{
+	QFETCH(int, nbPoints);
+	StelSphericalIndex grid(100);
+	fillRandomPoints(grid, nbPoints);
+	const Vec3d v = randomDirection();
+	QBENCHMARK
+	{
+		grid.findNearestPoints(v, 10);
+	}
+}
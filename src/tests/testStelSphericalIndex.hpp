@@ -31,6 +31,11 @@ Q_OBJECT
 private slots:
 	void initTestCase();
 	void testBase();
+	void testPointQueries();
+	void benchmarkFindPointsInCap_data();
+	void benchmarkFindPointsInCap();
+	void benchmarkFindNearestPoints_data();
+	void benchmarkFindNearestPoints();
 private:
 };
 
@@ -0,0 +1,131 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include "tests/testStelTileLoader.hpp"
+
+#include <QObject>
+#include <QTest>
+
+#include "StelTileLoader.hpp"
+
+QTEST_GUILESS_MAIN(TestStelTileLoader)
+
+void TestStelTileLoader::testPriority()
+{
+	StelTileLoader loader(3);
+	QObject tiles[10];
+	for (int i=0;i<10;i++)
+		QVERIFY(!loader.request(&tiles[i], i));
+	QCOMPARE(loader.getNbPending(), 10);
+	QVERIFY(loader.update().isEmpty());
+	QCOMPARE(loader.getNbLoading(), 3);
+	QCOMPARE(loader.getNbPending(), 0);
+	// The best requests got the slots
+	for (int i=0;i<10;i++)
+		QCOMPARE(loader.request(&tiles[i], i), i>=7);
+
+	// A pending request can get a better priority in the same frame, e.g. when it is also prefetched
+	StelTileLoader prefetch(1);
+	QVERIFY(!prefetch.request(&tiles[0], 1.));
+	QVERIFY(!prefetch.request(&tiles[1], 2.));
+	QVERIFY(!prefetch.request(&tiles[0], 3.));
+	prefetch.update();
+	QVERIFY(prefetch.hasSlot(&tiles[0]));
+	QVERIFY(!prefetch.hasSlot(&tiles[1]));
+}
+
+void TestStelTileLoader::testCancel()
+{
+	StelTileLoader loader(2);
+	QObject visible, leaving, waiting;
+	loader.request(&visible, 2.);
+	loader.request(&leaving, 1.);
+	loader.request(&waiting, 0.);
+	loader.update();
+
+	// The tiles which are still visible renew their requests
+	QVERIFY(loader.request(&visible, 2.));
+	QVERIFY(loader.request(&leaving, 1.));
+	QVERIFY(!loader.request(&waiting, 0.));
+	QVERIFY(loader.update().isEmpty());
+
+	// One tile left the view: its slot goes to the waiting tile
+	QVERIFY(loader.request(&visible, 2.));
+	QVERIFY(!loader.request(&waiting, 0.));
+	const QList<const QObject*> cancelled = loader.update();
+	QCOMPARE(cancelled.size(), 1);
+	QVERIFY(cancelled.first()==&leaving);
+	QVERIFY(loader.hasSlot(&waiting));
+	QVERIFY(!loader.hasSlot(&leaving));
+
+	// The pending requests which are not renewed are forgotten
+	QObject gone;
+	QVERIFY(!loader.request(&gone, 10.));
+	QVERIFY(loader.request(&visible, 2.));
+	QVERIFY(loader.request(&waiting, 0.));
+	loader.update();
+	QVERIFY(loader.request(&visible, 2.));
+	QVERIFY(loader.request(&waiting, 0.));
+	QVERIFY(loader.update().isEmpty());
+	QVERIFY(!loader.hasSlot(&gone));
+	QCOMPARE(loader.getNbPending(), 0);
+}
+
+void TestStelTileLoader::testRelease()
+{
+	StelTileLoader loader(1);
+	QObject loaded, next;
+	loader.request(&loaded, 1.);
+	loader.update();
+	QVERIFY(loader.request(&loaded, 1.));
+	QVERIFY(!loader.request(&next, 0.));
+	// The tile is loaded: its slot is free for the next one
+	loader.release(&loaded);
+	QVERIFY(loader.update().isEmpty());
+	QVERIFY(loader.hasSlot(&next));
+	QVERIFY(!loader.hasSlot(&loaded));
+}
+
+void TestStelTileLoader::testHold()
+{
+	StelTileLoader loader(1);
+	QObject parsing, next;
+	loader.request(&parsing, 1.);
+	loader.update();
+	QVERIFY(loader.request(&parsing, 1.));
+	loader.hold(&parsing);
+
+	// The tile left the view while it cannot stop loading: it keeps its slot
+	QVERIFY(!loader.request(&next, 2.));
+	QVERIFY(loader.update().isEmpty());
+	QVERIFY(loader.hasSlot(&parsing));
+	QVERIFY(!loader.hasSlot(&next));
+	QCOMPARE(loader.getNbLoading(), 1);
+
+	// Until it ends
+	loader.release(&parsing);
+	QVERIFY(!loader.request(&next, 2.));
+	QVERIFY(loader.update().isEmpty());
+	QVERIFY(loader.hasSlot(&next));
+
+	// A tile without slot cannot hold one
+	QObject waiting;
+	loader.hold(&waiting);
+	QVERIFY(!loader.hasSlot(&waiting));
+}
@@ -0,0 +1,183 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include <QObject>
+#include <QtDebug>
+#include <QtTest>
+#include <QThread>
+
+#include <cmath>
+
+#include "tests/testTelescopeQueues.hpp"
+#include "SingleProducerQueue.hpp"
+#include "InterpolatedPosition.hpp"
+
+QTEST_GUILESS_MAIN(TestTelescopeQueues)
+
+#define VALUE_COUNT 200000
+
+// Pushes 0..VALUE_COUNT-1, waiting when the queue is full
+class IntProducer : public QThread
+{
+public:
+	IntProducer(SingleProducerQueue<int, 16>& q) : queue(q) {}
+protected:
+	void run()
+	{
+		for (int i=0; i<VALUE_COUNT; ++i)
+		{
+			while (!queue.push(i))
+				yieldCurrentThread();
+		}
+	}
+private:
+	SingleProducerQueue<int, 16>& queue;
+};
+
+// Publishes positions moving along the equator, one per microsecond of client time,
+// then resets the positions as after a disconnection
+class PositionProducer : public QThread
+{
+public:
+	PositionProducer(SingleProducerQueue<Position, 64>& q) : queue(q) {}
+protected:
+	void run()
+	{
+		Position p;
+		for (int i=0; i<=VALUE_COUNT; ++i)
+		{
+			p.pos.set(std::cos(i*1e-5), std::sin(i*1e-5), 0.);
+			p.server_micros = i;
+			p.client_micros = i;
+			p.status = 0;
+			if (i==VALUE_COUNT)
+				p.client_micros = INT64_MAX;
+			while (!queue.push(p))
+				yieldCurrentThread();
+		}
+	}
+private:
+	SingleProducerQueue<Position, 64>& queue;
+};
+
+void TestTelescopeQueues::testQueue()
+{
+	SingleProducerQueue<int, 4> queue;
+	int value = -1;
+	QVERIFY(queue.isEmpty());
+	QVERIFY(!queue.pop(value));
+
+	// Holds Size-1 values
+	QVERIFY(queue.push(1));
+	QVERIFY(queue.push(2));
+	QVERIFY(queue.push(3));
+	QVERIFY(!queue.push(4));
+	QVERIFY(!queue.isEmpty());
+	QVERIFY(queue.pop(value));
+	QCOMPARE(value, 1);
+
+	// In order across the end of the buffer
+	QVERIFY(queue.push(5));
+	QVERIFY(queue.pop(value));
+	QCOMPARE(value, 2);
+	QVERIFY(queue.pop(value));
+	QCOMPARE(value, 3);
+	QVERIFY(queue.pop(value));
+	QCOMPARE(value, 5);
+	QVERIFY(!queue.pop(value));
+	QVERIFY(queue.isEmpty());
+}
+
+void TestTelescopeQueues::testQueueThreads()
+{
+	SingleProducerQueue<int, 16> queue;
+	IntProducer producer(queue);
+	producer.start();
+
+	// No value is lost, duplicated or reordered
+	int expected = 0;
+	while (expected<VALUE_COUNT)
+	{
+		int value;
+		if (queue.pop(value))
+		{
+			QCOMPARE(value, expected);
+			++expected;
+		}
+		else
+			QThread::yieldCurrentThread();
+	}
+	QVERIFY(producer.wait(10000));
+	QVERIFY(queue.isEmpty());
+}
+
+void TestTelescopeQueues::testInterpolatedPosition()
+{
+	InterpolatedPosition position;
+	QVERIFY(!position.isKnown());
+	Vec3d x(1., 0., 0.), y(0., 1., 0.);
+	position.add(x, 1000, 1000);
+	position.add(y, 2000, 2000);
+	QVERIFY(position.isKnown());
+
+	// Between two positions
+	const Vec3d middle = position.get(1500);
+	QVERIFY(std::fabs(middle[0]-std::sqrt(0.5))<1e-12);
+	QVERIFY(std::fabs(middle[1]-std::sqrt(0.5))<1e-12);
+
+	// After the last position, e.g. without time delay
+	QVERIFY(position.get(2000)==y);
+	QVERIFY(position.get(5000)==y);
+
+	position.reset();
+	QVERIFY(!position.isKnown());
+}
+
+void TestTelescopeQueues::testPositionThreads()
+{
+	// As in TelescopeClient::updatePosition(), called for each frame
+	SingleProducerQueue<Position, 64> queue;
+	InterpolatedPosition interpolatedPosition;
+	PositionProducer producer(queue);
+	producer.start();
+
+	qint64 last = -1;
+	bool reset = false;
+	while (!reset)
+	{
+		Position p;
+		while (queue.pop(p))
+		{
+			if (p.client_micros==INT64_MAX)
+			{
+				interpolatedPosition.reset();
+				reset = true;
+				break;
+			}
+			QCOMPARE(p.client_micros, last+1);
+			last = p.client_micros;
+			interpolatedPosition.add(p.pos, p.client_micros, p.server_micros, p.status);
+			QVERIFY(interpolatedPosition.get(last)==p.pos);
+		}
+		QThread::yieldCurrentThread();
+	}
+	QVERIFY(producer.wait(10000));
+	QCOMPARE(last, (qint64)VALUE_COUNT-1);
+	QVERIFY(!interpolatedPosition.isKnown());
+}
@@ -0,0 +1,247 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#include <QObject>
+#include <QtDebug>
+#include <QtTest>
+#include <QDataStream>
+#include <QElapsedTimer>
+
+#include <cmath>
+
+#include "tests/testTelescopeTCPConnection.hpp"
+#include "InterpolatedPosition.hpp"
+
+QTEST_GUILESS_MAIN(TestTelescopeTCPConnection)
+
+// A position packet of the "Stellarium telescope control protocol"
+static QByteArray positionPacket(quint32 ra, qint32 dec, qint64 serverMicros, qint32 status)
+{
+	QByteArray packet;
+	QDataStream out(&packet, QIODevice::WriteOnly);
+	out.setByteOrder(QDataStream::LittleEndian);
+	out << (quint16)24 << (quint16)0 << serverMicros << ra << dec << status;
+	return packet;
+}
+
+static Vec3d direction(double ra, double dec)
+{
+	return Vec3d(std::cos(ra)*std::cos(dec), std::sin(ra)*std::cos(dec), std::sin(dec));
+}
+
+bool TestTelescopeTCPConnection::communicateUntil(const QSignalSpy& spy, int count)
+{
+	QElapsedTimer timer;
+	timer.start();
+	while (spy.count()<count && timer.elapsed()<5000)
+	{
+		QTest::qWait(5);
+		connection->performCommunication();
+	}
+	return spy.count()==count;
+}
+
+bool TestTelescopeTCPConnection::waitForBytes(qint64 size)
+{
+	QElapsedTimer timer;
+	timer.start();
+	// The event loop sends the data written to the socket of the connection
+	while (peer->bytesAvailable()<size && timer.elapsed()<5000)
+		QTest::qWait(5);
+	return peer->bytesAvailable()==size;
+}
+
+void TestTelescopeTCPConnection::initTestCase()
+{
+	qRegisterMetaType<Vec3d>("Vec3d");
+	server = NULL;
+	connection = NULL;
+	peer = NULL;
+}
+
+void TestTelescopeTCPConnection::init()
+{
+	server = new QTcpServer(this);
+	QVERIFY(server->listen(QHostAddress::LocalHost));
+	connection = new TelescopeTCPConnection("test", QHostAddress::LocalHost, server->serverPort(), this);
+
+	// The connection is started by the first step, then established without blocking
+	QVERIFY(!connection->prepareCommunication());
+	QVERIFY(server->waitForNewConnection(5000));
+	peer = server->nextPendingConnection();
+	QVERIFY(peer!=NULL);
+	QTRY_VERIFY(connection->isOpen());
+}
+
+void TestTelescopeTCPConnection::cleanup()
+{
+	delete connection;
+	connection = NULL;
+	delete server;
+	server = NULL;
+	peer = NULL;
+}
+
+void TestTelescopeTCPConnection::testConnect()
+{
+	QVERIFY(connection->prepareCommunication());
+	QCOMPARE(peer->state(), QAbstractSocket::ConnectedState);
+}
+
+void TestTelescopeTCPConnection::testGoto()
+{
+	QVERIFY(connection->prepareCommunication());
+	const qint64 before = getNow();
+	// 6h +0°, then 18h -30°
+	connection->sendGoto(Vec3d(0., 1., 0.));
+	connection->sendGoto(direction(1.5*M_PI, -M_PI/6.));
+	const qint64 after = getNow();
+	// Nothing is written before the communication step
+	QTest::qWait(50);
+	QCOMPARE(peer->bytesAvailable(), (qint64)0);
+	connection->performCommunication();
+	QVERIFY(waitForBytes(40));
+
+	QDataStream in(peer);
+	in.setByteOrder(QDataStream::LittleEndian);
+	const quint32 expectedRa[2] = {0x40000000u, 0xC0000000u};
+	const qint32 expectedDec[2] = {0, -0x15555555};
+	for (int i=0; i<2; ++i)
+	{
+		quint16 size, type;
+		qint64 clientMicros;
+		quint32 ra;
+		qint32 dec;
+		in >> size >> type >> clientMicros >> ra >> dec;
+		QCOMPARE(size, (quint16)20);
+		QCOMPARE(type, (quint16)0);
+		QVERIFY(clientMicros>=before && clientMicros<=after);
+		QCOMPARE(ra, expectedRa[i]);
+		QVERIFY(qAbs(dec-expectedDec[i])<=1);
+	}
+	QCOMPARE(in.status(), QDataStream::Ok);
+}
+
+void TestTelescopeTCPConnection::testPosition()
+{
+	QSignalSpy positions(connection, SIGNAL(positionReceived(Vec3d,qint64,int)));
+	QSignalSpy readyRead(connection, SIGNAL(readyRead()));
+	QVERIFY(connection->prepareCommunication());
+
+	// 12h +45°, and the 3 quarters of a turn expressed as a negative declination of the south
+	peer->write(positionPacket(0x80000000u, 0x20000000, 1234567890123LL, 0));
+	peer->write(positionPacket(0x60000000u, -0x20000000, 1234567890124LL, -3));
+	peer->flush();
+	QVERIFY(communicateUntil(positions, 2));
+	QVERIFY(readyRead.count()>0);
+
+	const Vec3d expected[2] = {direction(M_PI, M_PI/4.), direction(0.75*M_PI, -M_PI/4.)};
+	const qint64 serverMicros[2] = {1234567890123LL, 1234567890124LL};
+	const int status[2] = {0, -3};
+	for (int i=0; i<2; ++i)
+	{
+		const QList<QVariant> args = positions.at(i);
+		const Vec3d position = args.at(0).value<Vec3d>();
+		QVERIFY((position-expected[i]).length()<1e-9);
+		QCOMPARE(args.at(1).toLongLong(), serverMicros[i]);
+		QCOMPARE(args.at(2).toInt(), status[i]);
+	}
+	QVERIFY(connection->isOpen());
+}
+
+void TestTelescopeTCPConnection::testPartialPackets()
+{
+	QSignalSpy positions(connection, SIGNAL(positionReceived(Vec3d,qint64,int)));
+	QVERIFY(connection->prepareCommunication());
+
+	QByteArray data = positionPacket(0x40000000u, 0, 1, 1);
+	// A packet of an unknown type is skipped
+	QByteArray unknown;
+	QDataStream out(&unknown, QIODevice::WriteOnly);
+	out.setByteOrder(QDataStream::LittleEndian);
+	out << (quint16)8 << (quint16)7 << (quint32)0;
+	data += unknown;
+	data += positionPacket(0x80000000u, 0, 2, 2);
+	data += positionPacket(0xC0000000u, 0, 3, 3);
+
+	// Cut inside the size, the body, and between the packets
+	const int cuts[] = {1, 10, 24, 30, 40, data.size()};
+	int start = 0;
+	for (unsigned int i=0; i<sizeof(cuts)/sizeof(cuts[0]); ++i)
+	{
+		peer->write(data.mid(start, cuts[i]-start));
+		peer->flush();
+		start = cuts[i];
+		// Only the complete packets are handled
+		const int complete = start<24 ? 0 : (start<56 ? 1 : (start<80 ? 2 : 3));
+		QVERIFY(communicateUntil(positions, complete));
+		QTest::qWait(20);
+		connection->performCommunication();
+		QCOMPARE(positions.count(), complete);
+	}
+	for (int i=0; i<3; ++i)
+	{
+		QCOMPARE(positions.at(i).at(1).toLongLong(), (qint64)i+1);
+		QCOMPARE(positions.at(i).at(2).toInt(), i+1);
+	}
+	QVERIFY(connection->isOpen());
+}
+
+void TestTelescopeTCPConnection::testBadPacket()
+{
+	QSignalSpy positions(connection, SIGNAL(positionReceived(Vec3d,qint64,int)));
+	QSignalSpy resets(connection, SIGNAL(connectionReset()));
+	QVERIFY(connection->prepareCommunication());
+
+	// A size smaller than the header closes the connection
+	QByteArray bad;
+	QDataStream out(&bad, QIODevice::WriteOnly);
+	out.setByteOrder(QDataStream::LittleEndian);
+	out << (quint16)2 << (quint16)0;
+	peer->write(bad);
+	peer->flush();
+	QTRY_VERIFY((connection->performCommunication(), resets.count()==1));
+	QVERIFY(!connection->isOpen());
+	QCOMPARE(positions.count(), 0);
+	QTRY_COMPARE(peer->state(), QAbstractSocket::UnconnectedState);
+}
+
+void TestTelescopeTCPConnection::testHangup()
+{
+	QSignalSpy resets(connection, SIGNAL(connectionReset()));
+	QVERIFY(connection->prepareCommunication());
+	// The queued command is dropped with the connection
+	connection->sendGoto(Vec3d(1., 0., 0.));
+	connection->hangup();
+	QCOMPARE(resets.count(), 1);
+	QVERIFY(!connection->isOpen());
+	QTRY_COMPARE(peer->state(), QAbstractSocket::UnconnectedState);
+	QCOMPARE(peer->bytesAvailable(), (qint64)0);
+}
+
+void TestTelescopeTCPConnection::testServerClosed()
+{
+	QVERIFY(connection->prepareCommunication());
+	peer->disconnectFromHost();
+	QTRY_VERIFY(!connection->isOpen());
+	// The step neither writes nor reads on the closed socket
+	connection->sendGoto(Vec3d(1., 0., 0.));
+	connection->performCommunication();
+	QVERIFY(!connection->prepareCommunication());
+}
@@ -0,0 +1,56 @@
+/*
+ * Stellarium
+ * Copyright (C) 2016 Stellarium Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA  02110-1335, USA.
+ */
+
+#ifndef _TESTTELESCOPETCPCONNECTION_HPP_
+#define _TESTTELESCOPETCPCONNECTION_HPP_
+
+#include <QObject>
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include "TelescopeTCPConnection.hpp"
+
+//! Tests the protocol of TelescopeTCP with a QTcpServer standing in for the telescope server.
+class TestTelescopeTCPConnection : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+	void init();
+	void cleanup();
+	void testConnect();
+	void testGoto();
+	void testPosition();
+	void testPartialPackets();
+	void testBadPacket();
+	void testHangup();
+	void testServerClosed();
+private:
+	//! Calls performCommunication() until count positions were received, or 5 s passed.
+	bool communicateUntil(const QSignalSpy& spy, int count);
+	//! Waits until the server received size bytes, or 5 s passed.
+	bool waitForBytes(qint64 size);
+
+	QTcpServer* server;
+	TelescopeTCPConnection* connection;
+	QTcpSocket* peer;
+};
+
+#endif // _TESTTELESCOPETCPCONNECTION_HPP_